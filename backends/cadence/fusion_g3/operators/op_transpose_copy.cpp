@@ -117,9 +117,13 @@ Tensor& transpose_copy_int_out(
         InvalidArgument,
         out);
 
-    ET_SWITCH_ALL_TYPES(in.scalar_type(), ctx, __func__, CTYPE, [&] {
-      torch::executor::transpose_tensors<CTYPE>(in, dim0, dim1, out);
-    });
+    ET_KERNEL_CHECK(
+        ctx,
+        torch::executor::is_strided_copy_dtype(in.scalar_type()),
+        InvalidArgument,
+        out);
+
+    torch::executor::transpose_tensors(in, dim0, dim1, out);
   }
 
   return out;
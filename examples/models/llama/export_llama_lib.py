@@ -33,6 +33,7 @@ from executorch.examples.models.llama.hf_download import (
 from executorch.exir.passes.init_mutable_pass import InitializedMutableBufferPass
 from executorch.extension.llm.export.builder import DType, LLMEdgeManager
 from executorch.extension.llm.export.config.llm_config import LlmConfig
+from executorch.extension.llm.export.export_passes import FuseElementwiseChains
 from executorch.extension.llm.export.partitioner_lib import (
     get_coreml_partitioner,
     get_mps_partitioner,
@@ -65,6 +66,7 @@ from .source_transformation.quantize import (
     get_quant_embedding_transform,
     get_quant_weight_transform,
 )
+from .source_transformation.rms_norm import replace_rms_norm_with_custom_op
 from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
 from .source_transformation.sdpa import (
     replace_causal_mask,
@@ -299,6 +301,19 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether or not to export a model using int8 per token quantized kv cache",
     )
+    parser.add_argument(
+        "--quantize_kv_cache_bits",
+        type=int,
+        default=8,
+        choices=[4, 8],
+        help="Bits of the quantized kv cache. 4 bit caches are quantized group-wise.",
+    )
+    parser.add_argument(
+        "--quantize_kv_cache_group_size",
+        type=int,
+        default=None,
+        help="Quantize the kv cache in groups of this many elements per token and head, instead of per token.",
+    )
     parser.add_argument(
         "--num_sharding",
         type=int,
@@ -472,6 +487,20 @@ def build_args_parser() -> argparse.ArgumentParser:
         help="Delegate llama2 to qnn backend (Qualcomm), please use it --kv_cahce=True",
     )
 
+    parser.add_argument(
+        "--use_custom_rms_norm",
+        default=False,
+        action="store_true",
+        help="Replace RMSNorm with the fused llama::rms_norm custom op from the custom ops library.",
+    )
+
+    parser.add_argument(
+        "--fuse_elementwise_ops",
+        default=False,
+        action="store_true",
+        help="Fuse chains of float32 elementwise ops into the llama::fused_elementwise custom op. Fused ops are not delegated.",
+    )
+
     parser.add_argument(
         "--expand_rope_table",
         default=False,
@@ -739,7 +768,10 @@ def _prepare_for_llama_export(llm_config: LlmConfig) -> LLMEdgeManager:
                 llm_config.model, "use_custom_sdpa_with_attention_mask", False
             ),
             use_sdpa_with_kv_cache=llm_config.model.use_sdpa_with_kv_cache,
+            use_custom_rms_norm=llm_config.model.use_custom_rms_norm,
             quantize_kv_cache=llm_config.model.quantize_kv_cache,
+            quantize_kv_cache_bits=llm_config.model.quantize_kv_cache_bits,
+            quantize_kv_cache_group_size=llm_config.model.quantize_kv_cache_group_size,
             use_kv_cache=llm_config.model.use_kv_cache,
             qnn=llm_config.backend.qnn.enabled,
             use_qnn_sha=llm_config.backend.qnn.use_sha,
@@ -761,6 +793,10 @@ def _prepare_for_llama_export(llm_config: LlmConfig) -> LLMEdgeManager:
         )
     )
 
+    # Runs on the graph after export(), see run_canonical_optimizations().
+    if llm_config.model.fuse_elementwise_ops:
+        edge_manager.canonical_passes.append(FuseElementwiseChains())
+
     return edge_manager
 
 
@@ -1305,7 +1341,10 @@ def _get_source_transforms(  # noqa
     expand_rope_table: bool = False,
     use_custom_sdpa_with_attention_mask: bool = False,
     use_sdpa_with_kv_cache: bool = False,
+    use_custom_rms_norm: bool = False,
     quantize_kv_cache: bool = False,
+    quantize_kv_cache_bits: int = 8,
+    quantize_kv_cache_group_size: Optional[int] = None,
     use_kv_cache: bool = False,
     qnn: bool = False,
     use_qnn_sha: bool = False,
@@ -1340,7 +1379,11 @@ def _get_source_transforms(  # noqa
         expand_rope_table: Whether to expand rope table.
         use_custom_sdpa_with_attention_mask: Whether to use custom SDPA with attention mask.
         use_sdpa_with_kv_cache: Whether to use SDPA with KV cache.
+        use_custom_rms_norm: Whether to replace RMSNorm with the fused
+            llama::rms_norm custom op.
         quantize_kv_cache: Whether to quantize KV cache.
+        quantize_kv_cache_bits: Bits of the quantized KV cache, 8 or 4.
+        quantize_kv_cache_group_size: Group size of a group-wise quantized KV cache.
         use_kv_cache: Whether to use KV cache.
         qnn: Whether to use QNN.
         use_qnn_sha: Whether to use QNN SHA.
@@ -1442,9 +1485,18 @@ def _get_source_transforms(  # noqa
         else:
             transforms.append(replace_sdpa_with_custom_op)
 
+    if use_custom_rms_norm:
+        transforms.append(replace_rms_norm_with_custom_op)
+
     if quantize_kv_cache:
         assert use_kv_cache, "quantize_kv_cache requires use_kv_cache=True"
-        transforms.append(replace_kv_cache_with_quantized_kv_cache)
+        transforms.append(
+            partial(
+                replace_kv_cache_with_quantized_kv_cache,
+                bits=quantize_kv_cache_bits,
+                group_size=quantize_kv_cache_group_size,
+            )
+        )
         # Right now
         transforms.append(replace_sdpa_with_quantized_sdpa)
 
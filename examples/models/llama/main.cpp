@@ -52,6 +52,11 @@ DEFINE_int32(
     0,
     "Number of EOS tokens to append to the prompt. Defaults to 0. If > 0, the prompt will be appended with EOS tokens. This is useful for models that expect one or more EOS token at the end.");
 
+DEFINE_int32(
+    prefill_chunk_size,
+    0,
+    "Number of prompt tokens prefilled per model execution, for models exported with dynamic shapes and a KV cache. Defaults to 0, which implies max_seq_len. -1 picks the fastest size while prefilling the first prompt longer than max_seq_len.");
+
 DEFINE_bool(warmup, false, "Whether to run a warmup run.");
 
 int32_t main(int32_t argc, char** argv) {
@@ -111,6 +116,7 @@ int32_t main(int32_t argc, char** argv) {
   // generate
   executorch::extension::llm::GenerationConfig config{
       .seq_len = seq_len, .temperature = temperature};
+  config.prefill_chunk_size = FLAGS_prefill_chunk_size;
   auto error = runner->generate(prompt, config);
   if (error != executorch::runtime::Error::Ok) {
     ET_LOG(Error, "Failed to warmup llama runner");
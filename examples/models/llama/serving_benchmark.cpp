@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Replays a synthetic serving workload against a local model and reports
+// latency percentiles and throughput.
+//
+// Requests arrive at a given rate with prompt and response lengths drawn from
+// the given distributions, and are served first come, first served by
+// --num_sessions runners, each holding its own copy of the model state. The
+// summary is printed to stdout as a line starting with "LLMServingBenchmark"
+// and, if --output_path is set, written to that file as JSON. Generated text
+// is printed to stdout as well, so redirect it when the output is not wanted.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <executorch/examples/models/llama/runner/runner.h>
+#include <executorch/extension/llm/runner/util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#endif
+
+DEFINE_string(
+    model_path,
+    "llama2.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(data_path, "", "Data file for the model.");
+
+DEFINE_string(tokenizer_path, "tokenizer.bin", "Tokenizer stuff.");
+
+DEFINE_string(
+    prompt_file,
+    "",
+    "Text file the prompts are cut from. Defaults to a built-in passage.");
+
+DEFINE_int32(num_requests, 32, "Number of requests to send.");
+
+DEFINE_double(
+    request_rate,
+    0.0,
+    "Requests per second. Defaults to 0, which sends all requests at once.");
+
+DEFINE_string(
+    arrival,
+    "poisson",
+    "Arrival process of the requests at --request_rate: poisson or constant.");
+
+DEFINE_string(
+    prompt_len,
+    "uniform:64:256",
+    "Distribution of the prompt lengths in tokens: N, fixed:N, "
+    "uniform:MIN:MAX or normal:MEAN:STDDEV.");
+
+DEFINE_string(
+    response_len,
+    "uniform:32:128",
+    "Distribution of the number of tokens to generate per request, in the "
+    "same format as --prompt_len. Generation may stop earlier at an EOS "
+    "token.");
+
+DEFINE_int32(
+    num_sessions,
+    1,
+    "Number of requests served concurrently, each by its own runner.");
+
+DEFINE_double(
+    temperature,
+    0.0f,
+    "Temperature; Default is 0, greedy argmax sampling.");
+
+DEFINE_int32(seed, 42, "Seed of the workload generator.");
+
+DEFINE_int32(
+    cpu_threads,
+    -1,
+    "Number of CPU threads for inference. Defaults to -1, which implies we'll "
+    "use a heuristic to derive the # of performant cores for a specific "
+    "device.");
+
+DEFINE_bool(warmup, true, "Whether to run a warmup request per session.");
+
+DEFINE_string(output_path, "", "File to write the results to as JSON.");
+
+namespace {
+
+namespace llm = ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+using Clock = std::chrono::steady_clock;
+
+constexpr char kDefaultPassage[] =
+    "The quick brown fox jumps over the lazy dog. A journey of a thousand "
+    "miles begins with a single step. It was the best of times, it was the "
+    "worst of times, it was the age of wisdom, it was the age of foolishness. "
+    "In the beginning the universe was created, which has made a lot of "
+    "people very angry and been widely regarded as a bad move. All happy "
+    "families are alike; each unhappy family is unhappy in its own way. "
+    "Call me Ishmael. Some years ago, never mind how long precisely, having "
+    "little or no money in my purse, I thought I would sail about a little "
+    "and see the watery part of the world.";
+
+// A distribution of token counts, parsed from --prompt_len or
+// --response_len.
+struct LengthDistribution {
+  enum class Kind { Fixed, Uniform, Normal };
+  Kind kind = Kind::Fixed;
+  double a = 0;
+  double b = 0;
+
+  bool parse(const std::string& spec) {
+    std::vector<std::string> parts;
+    std::stringstream ss(spec);
+    for (std::string part; std::getline(ss, part, ':');) {
+      parts.push_back(part);
+    }
+    try {
+      if (parts.size() == 1) {
+        kind = Kind::Fixed;
+        a = std::stod(parts[0]);
+      } else if (parts.size() == 2 && parts[0] == "fixed") {
+        kind = Kind::Fixed;
+        a = std::stod(parts[1]);
+      } else if (parts.size() == 3 && parts[0] == "uniform") {
+        kind = Kind::Uniform;
+        a = std::stod(parts[1]);
+        b = std::stod(parts[2]);
+        if (b < a) {
+          return false;
+        }
+      } else if (parts.size() == 3 && parts[0] == "normal") {
+        kind = Kind::Normal;
+        a = std::stod(parts[1]);
+        b = std::stod(parts[2]);
+        if (b < 0) {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    } catch (const std::exception&) {
+      return false;
+    }
+    return a >= 1;
+  }
+
+  int32_t sample(std::mt19937_64& rng) const {
+    double value = a;
+    if (kind == Kind::Uniform) {
+      value = std::uniform_int_distribution<int64_t>(
+          std::llround(a), std::llround(b))(rng);
+    } else if (kind == Kind::Normal) {
+      value = std::normal_distribution<double>(a, b)(rng);
+    }
+    return static_cast<int32_t>(std::max<int64_t>(1, std::llround(value)));
+  }
+};
+
+struct Request {
+  std::string prompt;
+  int32_t max_new_tokens;
+  // Seconds since the start of the benchmark.
+  double arrival_s;
+};
+
+struct RequestResult {
+  bool ok = false;
+  // Time from arrival until a session picked the request up.
+  double queue_ms = 0;
+  // Time from arrival until the first generated token.
+  double ttft_ms = 0;
+  // Time from arrival until the last generated token.
+  double e2e_ms = 0;
+  // Gaps between consecutive generated tokens.
+  std::vector<double> itl_ms;
+  int64_t num_prompt_tokens = 0;
+  int64_t num_generated_tokens = 0;
+  Clock::time_point end;
+};
+
+double to_ms(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Builds a prompt of about num_tokens tokens by decoding a window of the
+// tokenized passage, wrapping around at its end. The runner tokenizes the
+// text again, so the actual count may differ slightly; it's reported as is.
+std::string make_prompt(
+    ::tokenizers::Tokenizer& tokenizer,
+    const std::vector<uint64_t>& passage,
+    int32_t num_tokens,
+    std::mt19937_64& rng) {
+  const size_t offset =
+      std::uniform_int_distribution<size_t>(0, passage.size() - 1)(rng);
+  std::string prompt;
+  uint64_t prev = passage[(offset + passage.size() - 1) % passage.size()];
+  for (int32_t i = 0; i < num_tokens; ++i) {
+    const uint64_t token = passage[(offset + i) % passage.size()];
+    auto piece = tokenizer.decode(prev, token);
+    if (piece.ok()) {
+      prompt += piece.get();
+    }
+    prev = token;
+  }
+  return prompt;
+}
+
+RequestResult serve(
+    llm::TextLLMRunner& runner,
+    const Request& request,
+    Clock::time_point arrival) {
+  RequestResult result;
+  result.queue_ms = to_ms(Clock::now() - arrival);
+  std::vector<Clock::time_point> token_times;
+  token_times.reserve(request.max_new_tokens);
+
+  runner.reset();
+  llm::GenerationConfig config;
+  config.echo = false;
+  config.max_new_tokens = request.max_new_tokens;
+  config.temperature = FLAGS_temperature;
+  const Error error = runner.generate(
+      request.prompt,
+      config,
+      [&token_times](const std::string&) {
+        token_times.push_back(Clock::now());
+      },
+      [&result](const llm::Stats& stats) {
+        result.num_prompt_tokens = stats.num_prompt_tokens;
+        result.num_generated_tokens = stats.num_generated_tokens;
+      });
+  result.end = Clock::now();
+  if (error != Error::Ok || token_times.empty()) {
+    ET_LOG(
+        Error,
+        "Request failed with error 0x%" PRIx32,
+        static_cast<uint32_t>(error));
+    return result;
+  }
+  result.ok = true;
+  result.ttft_ms = to_ms(token_times.front() - arrival);
+  result.e2e_ms = to_ms(token_times.back() - arrival);
+  for (size_t i = 1; i < token_times.size(); ++i) {
+    result.itl_ms.push_back(to_ms(token_times[i] - token_times[i - 1]));
+  }
+  return result;
+}
+
+// Returns the p-th percentile of the sorted values, interpolating linearly
+// between the closest ranks.
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const double rank = p / 100.0 * (sorted.size() - 1);
+  const size_t lower = static_cast<size_t>(rank);
+  const size_t upper = std::min(lower + 1, sorted.size() - 1);
+  return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+}
+
+std::string summarize(const char* name, std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const double mean = values.empty()
+      ? 0
+      : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  ET_LOG(
+      Info,
+      "\t%s: mean %.2f p50 %.2f p90 %.2f p99 %.2f max %.2f",
+      name,
+      mean,
+      percentile(values, 50),
+      percentile(values, 90),
+      percentile(values, 99),
+      values.empty() ? 0 : values.back());
+  std::stringstream ss;
+  ss << "\"" << name << "\":{\"mean\":" << mean
+     << ",\"p50\":" << percentile(values, 50)
+     << ",\"p90\":" << percentile(values, 90)
+     << ",\"p99\":" << percentile(values, 99)
+     << ",\"max\":" << (values.empty() ? 0 : values.back()) << "}";
+  return ss.str();
+}
+
+} // namespace
+
+int32_t main(int32_t argc, char** argv) {
+  executorch::runtime::runtime_init();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::optional<std::string> data_path = std::nullopt;
+  if (!FLAGS_data_path.empty()) {
+    data_path = FLAGS_data_path.c_str();
+  }
+
+  LengthDistribution prompt_len;
+  LengthDistribution response_len;
+  if (!prompt_len.parse(FLAGS_prompt_len) ||
+      !response_len.parse(FLAGS_response_len)) {
+    ET_LOG(Error, "Invalid --prompt_len or --response_len");
+    return 1;
+  }
+  if (FLAGS_num_requests <= 0 || FLAGS_num_sessions <= 0 ||
+      FLAGS_request_rate < 0 ||
+      (FLAGS_arrival != "poisson" && FLAGS_arrival != "constant")) {
+    ET_LOG(
+        Error,
+        "Invalid --num_requests, --num_sessions, --request_rate or --arrival");
+    return 1;
+  }
+
+#if defined(ET_USE_THREADPOOL)
+  uint32_t num_performant_cores = FLAGS_cpu_threads == -1
+      ? ::executorch::extension::cpuinfo::get_num_performant_cores()
+      : static_cast<uint32_t>(FLAGS_cpu_threads);
+  ET_LOG(
+      Info, "Resetting threadpool with num threads = %d", num_performant_cores);
+  if (num_performant_cores > 0) {
+    ::executorch::extension::threadpool::get_threadpool()
+        ->_unsafe_reset_threadpool(num_performant_cores);
+  }
+#endif
+
+  // Generate the workload up front so that it doesn't depend on timing.
+  std::string passage_text = kDefaultPassage;
+  if (!FLAGS_prompt_file.empty()) {
+    std::ifstream file(FLAGS_prompt_file);
+    if (!file) {
+      ET_LOG(Error, "Failed to open %s", FLAGS_prompt_file.c_str());
+      return 1;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    passage_text = ss.str();
+  }
+  auto tokenizer = example::load_llama_tokenizer(FLAGS_tokenizer_path);
+  if (tokenizer == nullptr) {
+    ET_LOG(Error, "Failed to load %s", FLAGS_tokenizer_path.c_str());
+    return 1;
+  }
+  auto passage = tokenizer->encode(passage_text, /*bos=*/0, /*eos=*/0);
+  if (!passage.ok() || passage.get().empty()) {
+    ET_LOG(Error, "Failed to tokenize the prompt passage");
+    return 1;
+  }
+  std::mt19937_64 rng(FLAGS_seed);
+  std::vector<Request> requests(FLAGS_num_requests);
+  double arrival_s = 0;
+  for (auto& request : requests) {
+    request.prompt =
+        make_prompt(*tokenizer, passage.get(), prompt_len.sample(rng), rng);
+    request.max_new_tokens = response_len.sample(rng);
+    request.arrival_s = arrival_s;
+    if (FLAGS_request_rate > 0) {
+      arrival_s += FLAGS_arrival == "poisson"
+          ? std::exponential_distribution<double>(FLAGS_request_rate)(rng)
+          : 1.0 / FLAGS_request_rate;
+    }
+  }
+
+  std::vector<std::unique_ptr<llm::TextLLMRunner>> runners;
+  for (int32_t i = 0; i < FLAGS_num_sessions; ++i) {
+    runners.push_back(example::create_llama_runner(
+        FLAGS_model_path, FLAGS_tokenizer_path, data_path));
+    if (runners.back() == nullptr ||
+        runners.back()->load() != Error::Ok) {
+      ET_LOG(Error, "Failed to create runner %d", i);
+      return 1;
+    }
+    if (FLAGS_warmup) {
+      if (runners.back()->warmup(
+              requests[0].prompt, requests[0].max_new_tokens) != Error::Ok) {
+        ET_LOG(Error, "Failed to warm up runner %d", i);
+        return 1;
+      }
+    }
+  }
+
+  // Each session serves the oldest request that hasn't been picked up yet,
+  // waiting for it to arrive if necessary.
+  std::vector<RequestResult> results(requests.size());
+  std::atomic<size_t> next_request{0};
+  const Clock::time_point start = Clock::now();
+  std::vector<std::thread> sessions;
+  for (auto& runner : runners) {
+    sessions.emplace_back([&, runner = runner.get()]() {
+      for (size_t i = next_request++; i < requests.size();
+           i = next_request++) {
+        const Clock::time_point arrival = start +
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(requests[i].arrival_s));
+        std::this_thread::sleep_until(arrival);
+        results[i] = serve(*runner, requests[i], arrival);
+      }
+    });
+  }
+  for (auto& session : sessions) {
+    session.join();
+  }
+
+  std::vector<double> queue_ms, ttft_ms, itl_ms, tpot_ms, e2e_ms;
+  int64_t num_failed = 0;
+  int64_t num_prompt_tokens = 0;
+  int64_t num_generated_tokens = 0;
+  Clock::time_point end = start;
+  for (const auto& result : results) {
+    if (!result.ok) {
+      ++num_failed;
+      continue;
+    }
+    queue_ms.push_back(result.queue_ms);
+    ttft_ms.push_back(result.ttft_ms);
+    e2e_ms.push_back(result.e2e_ms);
+    itl_ms.insert(itl_ms.end(), result.itl_ms.begin(), result.itl_ms.end());
+    if (!result.itl_ms.empty()) {
+      tpot_ms.push_back(
+          (result.e2e_ms - result.ttft_ms) / result.itl_ms.size());
+    }
+    num_prompt_tokens += result.num_prompt_tokens;
+    num_generated_tokens += result.num_generated_tokens;
+    end = std::max(end, result.end);
+  }
+  const double duration_s = to_ms(end - start) / 1000.0;
+  const double peak_rss_mib = llm::get_rss_bytes() / 1024.0 / 1024.0;
+
+  ET_LOG(
+      Info,
+      "Served %zu requests (%" PRId64 " failed) in %.2f s with %d sessions",
+      requests.size(),
+      num_failed,
+      duration_s,
+      FLAGS_num_sessions);
+  std::stringstream ss;
+  ss << "{\"model_path\":\"" << FLAGS_model_path << "\","
+     << "\"num_requests\":" << requests.size() << ","
+     << "\"num_failed_requests\":" << num_failed << ","
+     << "\"num_sessions\":" << FLAGS_num_sessions << ","
+     << "\"request_rate\":" << FLAGS_request_rate << ","
+     << "\"arrival\":\"" << FLAGS_arrival << "\","
+     << "\"prompt_len\":\"" << FLAGS_prompt_len << "\","
+     << "\"response_len\":\"" << FLAGS_response_len << "\","
+     << "\"seed\":" << FLAGS_seed << ","
+     << "\"duration_s\":" << duration_s << ","
+     << "\"prompt_tokens\":" << num_prompt_tokens << ","
+     << "\"generated_tokens\":" << num_generated_tokens << ","
+     << "\"request_throughput\":"
+     << (duration_s > 0 ? (requests.size() - num_failed) / duration_s : 0)
+     << ","
+     << "\"output_token_throughput\":"
+     << (duration_s > 0 ? num_generated_tokens / duration_s : 0) << ","
+     << "\"total_token_throughput\":"
+     << (duration_s > 0
+             ? (num_prompt_tokens + num_generated_tokens) / duration_s
+             : 0)
+     << "," << "\"peak_rss_mib\":" << peak_rss_mib << ","
+     << summarize("queue_ms", queue_ms) << ","
+     << summarize("ttft_ms", ttft_ms) << ","
+     << summarize("itl_ms", itl_ms) << ","
+     << summarize("tpot_ms", tpot_ms) << ","
+     << summarize("e2e_latency_ms", e2e_ms) << "}";
+  ET_LOG(
+      Info,
+      "\tThroughput: %.2f generated tokens/s, peak RSS %.2f MiB "
+      "(0 if unsupported)",
+      duration_s > 0 ? num_generated_tokens / duration_s : 0,
+      peak_rss_mib);
+  printf("LLMServingBenchmark %s\n", ss.str().c_str());
+
+  if (!FLAGS_output_path.empty()) {
+    std::ofstream output(FLAGS_output_path);
+    output << ss.str() << "\n";
+    if (!output) {
+      ET_LOG(Error, "Failed to write %s", FLAGS_output_path.c_str());
+      return 1;
+    }
+  }
+  return num_failed == 0 ? 0 : 1;
+}
@@ -35,6 +35,17 @@ class QuantizedCacheType(Enum):
 
 
 class QuantizedKVCache(nn.Module):
+    """
+    KV cache stored as int8, with one scale and zero point per token and head.
+
+    With QuantizedCacheType.AffineAsymmetricGroupWise every token and head is
+    instead quantized in groups of group_size elements, to int8 or, with
+    bits=4, to int4 packed in pairs into uint8 (even element in the low
+    nibble, offset by 8). The group-wise cache is updated with
+    llama.quantize_and_update_cache, and custom_quantized_sdpa reads it with a
+    float query, dequantizing K/V tiles as it goes.
+    """
+
     def __init__(
         self,
         max_batch_size,
@@ -44,24 +55,57 @@ class QuantizedKVCache(nn.Module):
         cache_type: QuantizedCacheType = QuantizedCacheType.AffineSymmetric,
         use_custom_update_cache_op: bool = False,
         return_float_values: bool = True,
+        bits: int = 8,
+        group_size: Optional[int] = None,
     ):
         super().__init__()
         if cache_type not in (
             QuantizedCacheType.AffineSymmetric,
             QuantizedCacheType.AffineAsymmetric,
+            QuantizedCacheType.AffineAsymmetricGroupWise,
         ):
             raise ValueError(
-                f"Only affine symmetric and asymmetric cache types are supported: got {cache_type}"
+                f"Only affine symmetric, asymmetric and asymmetric group-wise cache types are supported: got {cache_type}"
             )
 
-        # For now supporting int8 only
+        self.is_group_wise = cache_type == QuantizedCacheType.AffineAsymmetricGroupWise
+        if bits not in (4, 8) or (bits == 4 and not self.is_group_wise):
+            raise ValueError(
+                f"Only 8 bit, or 4 bit group-wise, caches are supported: got {bits} bits for {cache_type}"
+            )
+        if self.is_group_wise:
+            group_size = group_size or head_dim
+            if head_dim % group_size != 0 or group_size % (8 // bits) != 0:
+                raise ValueError(
+                    f"group_size {group_size} must divide head_dim {head_dim} into groups of whole bytes"
+                )
+            if not use_custom_update_cache_op:
+                raise ValueError(
+                    "Group-wise quantized caches require use_custom_update_cache_op"
+                )
+        else:
+            group_size = head_dim
+
         self.use_custom_update_cache_op = use_custom_update_cache_op
-        self.quantized_cache_dtype = torch.int8
+        self.bits = bits
+        self.group_size = group_size
+        # int4 values are stored in pairs, so the int4 cache is uint8.
+        self.quantized_cache_dtype = torch.uint8 if bits == 4 else torch.int8
         self.cache_fp_type = torch.float32
         self.return_float_values = return_float_values
         self.max_context_length = max_context_length
-        cache_shape = (max_batch_size, max_context_length, n_heads, head_dim)
-        scale_shape = (max_batch_size, max_context_length, n_heads, 1)
+        cache_shape = (
+            max_batch_size,
+            max_context_length,
+            n_heads,
+            head_dim * bits // 8,
+        )
+        scale_shape = (
+            max_batch_size,
+            max_context_length,
+            n_heads,
+            head_dim // group_size,
+        )
         self.register_buffer(
             "k_cache", torch.zeros(cache_shape, dtype=self.quantized_cache_dtype)
         )
@@ -74,7 +118,10 @@ class QuantizedKVCache(nn.Module):
         self.register_buffer(
             "v_cache_scales", torch.ones(scale_shape, dtype=torch.float32)
         )
-        if cache_type == QuantizedCacheType.AffineAsymmetric:
+        if cache_type in (
+            QuantizedCacheType.AffineAsymmetric,
+            QuantizedCacheType.AffineAsymmetricGroupWise,
+        ):
             self.register_buffer(
                 "k_cache_zero_points", torch.ones(scale_shape, dtype=torch.int8)
             )
@@ -100,7 +147,35 @@ class QuantizedKVCache(nn.Module):
         )
         return quantized_value, scales, zero_points
 
+    def _quantize_and_update_group_wise(self, input_pos, k_val, v_val, indices=None):
+        assert indices is None, "Indices not supported for group-wise caches"
+        start_pos = input_pos[0].item()
+        _ = torch.ops.llama.quantize_and_update_cache(
+            k_val, self.k_cache, self.k_cache_scales, self.k_cache_zero_points, start_pos
+        )
+        _ = torch.ops.llama.quantize_and_update_cache(
+            v_val, self.v_cache, self.v_cache_scales, self.v_cache_zero_points, start_pos
+        )
+
+    def _dequantize_group_wise(self, cache, scales, zero_points):
+        if self.bits == 4:
+            low = (cache & 0xF).to(torch.int16)
+            high = (cache >> 4).to(torch.int16)
+            values = torch.stack([low, high], dim=-1).flatten(-2) - 8
+        else:
+            values = cache.to(torch.int16)
+        bsz, seq_len, n_heads, head_dim = values.shape
+        values = values.view(bsz, seq_len, n_heads, -1, self.group_size)
+        out = (values - zero_points.to(torch.int16).unsqueeze(-1)).to(
+            self.cache_fp_type
+        ) * scales.unsqueeze(-1)
+        return out.view(bsz, seq_len, n_heads, head_dim)
+
     def _quantize_and_update(self, input_pos, k_val, v_val, indices=None):
+        if self.is_group_wise:
+            self._quantize_and_update_group_wise(input_pos, k_val, v_val, indices)
+            return
+
         quantized_k_val, k_scales, k_zero_points = self._quantize(k_val)
         quantized_v_val, v_scales, v_zero_points = self._quantize(v_val)
 
@@ -163,24 +238,32 @@ class QuantizedKVCache(nn.Module):
     def _update_and_return_float_values(self, input_pos, k_val, v_val, indices=None):
         self._quantize_and_update(input_pos, k_val, v_val, indices)
 
-        k_out = torch.ops.quantized_decomposed.dequantize_per_token(
-            self.k_cache,
-            self.k_cache_scales.to(torch.float64),
-            self.k_cache_zero_points.to(torch.int64),
-            torch.iinfo(self.quantized_cache_dtype).min,
-            torch.iinfo(self.quantized_cache_dtype).max,
-            self.quantized_cache_dtype,
-            self.cache_fp_type,
-        )
-        v_out = torch.ops.quantized_decomposed.dequantize_per_token(
-            self.v_cache,
-            self.v_cache_scales.to(torch.float64),
-            self.v_cache_zero_points.to(torch.int64),
-            torch.iinfo(self.quantized_cache_dtype).min,
-            torch.iinfo(self.quantized_cache_dtype).max,
-            self.quantized_cache_dtype,
-            self.cache_fp_type,
-        )
+        if self.is_group_wise:
+            k_out = self._dequantize_group_wise(
+                self.k_cache, self.k_cache_scales, self.k_cache_zero_points
+            )
+            v_out = self._dequantize_group_wise(
+                self.v_cache, self.v_cache_scales, self.v_cache_zero_points
+            )
+        else:
+            k_out = torch.ops.quantized_decomposed.dequantize_per_token(
+                self.k_cache,
+                self.k_cache_scales.to(torch.float64),
+                self.k_cache_zero_points.to(torch.int64),
+                torch.iinfo(self.quantized_cache_dtype).min,
+                torch.iinfo(self.quantized_cache_dtype).max,
+                self.quantized_cache_dtype,
+                self.cache_fp_type,
+            )
+            v_out = torch.ops.quantized_decomposed.dequantize_per_token(
+                self.v_cache,
+                self.v_cache_scales.to(torch.float64),
+                self.v_cache_zero_points.to(torch.int64),
+                torch.iinfo(self.quantized_cache_dtype).min,
+                torch.iinfo(self.quantized_cache_dtype).max,
+                self.quantized_cache_dtype,
+                self.cache_fp_type,
+            )
 
         # When returning float values we just use the last value
         # instead of dequantized value.
@@ -236,6 +319,8 @@ class QuantizedKVCache(nn.Module):
         kv_cache,
         cache_type: QuantizedCacheType,
         use_custom_update_cache_op: bool = False,
+        bits: int = 8,
+        group_size: Optional[int] = None,
     ):
         max_batch_size, n_heads, max_context_length, head_dim = kv_cache.k_cache.shape
         if isinstance(kv_cache, CustomKVCache):
@@ -250,10 +335,19 @@ class QuantizedKVCache(nn.Module):
             head_dim,
             cache_type,
             use_custom_update_cache_op,
+            bits=bits,
+            group_size=group_size,
         )
 
 
-def replace_kv_cache_with_quantized_kv_cache(module):
+def replace_kv_cache_with_quantized_kv_cache(
+    module, bits: int = 8, group_size: Optional[int] = None
+):
+    """
+    Replaces every KVCache with a QuantizedKVCache: int8 per token by default,
+    or int8/int4 in groups of group_size elements per token and head when
+    group_size is set or bits is 4.
+    """
     try:
         op = torch.ops.quantized_decomposed.quantize_per_token.out
         assert op is not None
@@ -284,10 +378,17 @@ def replace_kv_cache_with_quantized_kv_cache(module):
     logging.info(
         "Replacing KVCache with QuantizedKVCache. This modifies the model in place."
     )
-    return _replace_kv_cache_with_quantized_kv_cache(module)
+    return _replace_kv_cache_with_quantized_kv_cache(module, bits, group_size)
 
 
-def _replace_kv_cache_with_quantized_kv_cache(module):
+def _replace_kv_cache_with_quantized_kv_cache(
+    module, bits: int = 8, group_size: Optional[int] = None
+):
+    cache_type = (
+        QuantizedCacheType.AffineAsymmetricGroupWise
+        if group_size is not None or bits != 8
+        else QuantizedCacheType.AffineAsymmetric
+    )
     for name, child in module.named_children():
         if isinstance(child, KVCache) or isinstance(child, CustomKVCache):
             setattr(
@@ -295,12 +396,14 @@ def _replace_kv_cache_with_quantized_kv_cache(module):
                 name,
                 QuantizedKVCache.from_float(
                     child,
-                    QuantizedCacheType.AffineAsymmetric,
+                    cache_type,
                     use_custom_update_cache_op=True,
+                    bits=bits,
+                    group_size=group_size,
                 ),
             )
         else:
-            _replace_kv_cache_with_quantized_kv_cache(child)
+            _replace_kv_cache_with_quantized_kv_cache(child, bits, group_size)
     return module
 
 
@@ -454,6 +557,9 @@ class QuantizedRingKVCache(QuantizedKVCache):
         assert isinstance(
             kv_cache, QuantizedKVCache
         ), "For QuantizedRingKVCache expect QuantizedKVCache as input kv_cache"
+        assert (
+            not kv_cache.is_group_wise
+        ), "QuantizedRingKVCache does not support group-wise quantized caches"
         max_batch_size, _, n_heads, head_dim = kv_cache.k_cache.shape
         return cls(
             max_batch_size,
@@ -21,3 +21,38 @@ def replace_rms_norm_with_native_rms_norm(module: torch.nn.Module):
         else:
             replace_rms_norm_with_native_rms_norm(child)
     return module
+
+
+class RMSNormCustom(torch.nn.Module):
+    """RMSNorm computed by the fused llama::rms_norm custom op."""
+
+    def __init__(self, weight: torch.nn.Parameter, eps: float):
+        super().__init__()
+        self.weight = weight
+        self.eps = eps
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        if self.weight.dtype != x.dtype:
+            # The op returns the dtype of x, while the eager module promotes to
+            # the wider of x and the weight, so compute it the eager way.
+            x_fp32 = x.float()
+            output = x_fp32 * torch.rsqrt(
+                (x_fp32 * x_fp32).mean(-1, keepdim=True) + self.eps
+            )
+            return output.type_as(x) * self.weight
+        return torch.ops.llama.rms_norm(x, self.weight, self.eps)
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child.weight, child.eps))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
@@ -141,6 +141,13 @@ class QuantizedSDPA(torch.nn.Module):
         k_quantized = k_quantized.transpose(1, 2)
         v_quantized = v_quantized.transpose(1, 2)
 
+        if getattr(self.kv_cache, "is_group_wise", False):
+            # Group-wise int8/int4 caches are read with a float query; the
+            # kernel dequantizes K/V tiles right before its gemms.
+            return self._forward_float_query(
+                input_pos, q, k_quantized, v_quantized, bsz, seqlen, mask
+            )
+
         q_scale, q_zero_point = (
             torch.ops.quantized_decomposed.choose_qparams_per_token_asymmetric.default(
                 q, self.quantized_dtype
@@ -200,6 +207,28 @@ class QuantizedSDPA(torch.nn.Module):
 
         return output.view(bsz, seqlen, self.dim)
 
+    def _forward_float_query(
+        self, input_pos, q, k_quantized, v_quantized, bsz, seqlen, mask
+    ):
+        start_pos = input_pos[0].item()
+        output = torch.ops.llama.custom_quantized_sdpa(
+            q.to(dtype=self.float_dtype),
+            k_quantized,
+            v_quantized,
+            start_pos,
+            mask if self.use_attention_mask else None,
+            0,
+            not self.use_attention_mask,
+            None,
+            None,
+            None,
+            self.kv_cache.k_cache_zero_points,
+            self.kv_cache.k_cache_scales,
+            self.kv_cache.v_cache_zero_points,
+            self.kv_cache.v_cache_scales,
+        )
+        return output.view(bsz, seqlen, self.dim)
+
 
 def _update_attention_module_with_quantized_sdpa(
     module: torch.nn.Module, kv_cache: QuantizedKVCache
@@ -124,3 +124,60 @@ class QuantizedKVCacheTest(unittest.TestCase):
         self._test_simple_update_fetch(
             is_dynamic_shape=True, use_custom_update_cache_op=True
         )
+
+    def _test_group_wise_update_fetch(self, bits, group_size, atol):
+        # Group-wise caches are updated with llama.quantize_and_update_cache.
+        from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+        self.head_dim = 16
+        input_pos = torch.tensor([0, 1, 2])
+        self.seq_len = input_pos.size(0)
+        self._init_cache()
+        k, v = self._init_kv()
+        quantized_kv_cache = QuantizedKVCache.from_float(
+            self.kv_cache,
+            QuantizedCacheType.AffineAsymmetricGroupWise,
+            use_custom_update_cache_op=True,
+            bits=bits,
+            group_size=group_size,
+        )
+        self.assertEqual(
+            quantized_kv_cache.k_cache.shape,
+            (1, self.max_context_len, self.n_kv_heads, self.head_dim * bits // 8),
+        )
+        self.assertEqual(
+            quantized_kv_cache.k_cache_scales.shape,
+            (1, self.max_context_len, self.n_kv_heads, self.head_dim // group_size),
+        )
+        quantized_kv_cache.update(input_pos, k, v)
+
+        input_pos = torch.tensor([3])
+        self.seq_len = input_pos.size(0)
+        next_k, next_v = self._init_kv()
+        quantized_kv_cache.update(input_pos, next_k, next_v)
+
+        expected_k = torch.cat([k, next_k], dim=2).transpose(1, 2)
+        expected_v = torch.cat([v, next_v], dim=2).transpose(1, 2)
+        dequantized_k = quantized_kv_cache._dequantize_group_wise(
+            quantized_kv_cache.k_cache,
+            quantized_kv_cache.k_cache_scales,
+            quantized_kv_cache.k_cache_zero_points,
+        )
+        dequantized_v = quantized_kv_cache._dequantize_group_wise(
+            quantized_kv_cache.v_cache,
+            quantized_kv_cache.v_cache_scales,
+            quantized_kv_cache.v_cache_zero_points,
+        )
+        torch.testing.assert_close(
+            dequantized_k[:, :4], expected_k, rtol=0, atol=atol
+        )
+        torch.testing.assert_close(
+            dequantized_v[:, :4], expected_v, rtol=0, atol=atol
+        )
+
+    def test_group_wise_int8_update_fetch(self):
+        # Half a quantization step of values in [0, 1).
+        self._test_group_wise_update_fetch(bits=8, group_size=4, atol=0.5 / 255 + 1e-6)
+
+    def test_group_wise_int4_update_fetch(self):
+        self._test_group_wise_update_fetch(bits=4, group_size=8, atol=0.5 / 15 + 1e-6)
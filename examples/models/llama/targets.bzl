@@ -25,3 +25,23 @@ def define_common_targets():
                 ],
                 **get_oss_build_kwargs()
             )
+
+            runtime.cxx_binary(
+                name = "serving_benchmark" + aten_suffix,
+                srcs = [
+                    "serving_benchmark.cpp",
+                ],
+                compiler_flags = ["-Wno-global-constructors"],
+                preprocessor_flags = [
+                    "-DUSE_ATEN_LIB",
+                ] if aten else [],
+                deps = [
+                    "//executorch/examples/models/llama/runner:runner" + aten_suffix,
+                    "//executorch/extension/threadpool:threadpool",
+                    "//executorch/extension/threadpool:cpuinfo_utils",
+                ],
+                external_deps = [
+                    "gflags",
+                ],
+                **get_oss_build_kwargs()
+            )
@@ -180,6 +180,41 @@ def custom_sdpa(
     return torch.empty_like(query)
 
 
+@impl(custom_ops_lib, "custom_sdpa_sliding_window", "Meta")
+def custom_sdpa_sliding_window(
+    query,
+    key_cache,
+    value_cache,
+    start_pos,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+    window_size=-1,
+    num_sink_tokens=0,
+):
+    seq_len = query.size(1)
+    _validate_params(
+        query,
+        key_cache,
+        value_cache,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+    assert (
+        window_size <= 0 or is_causal
+    ), "window_size requires is_causal to be set"
+    assert num_sink_tokens >= 0, "num_sink_tokens must be non-negative"
+
+    return torch.empty_like(query)
+
+
 def _validate_update_cache_params(
     value,
     cache,
@@ -265,6 +300,120 @@ def update_cache_with_indices_meta(
     return torch.empty((1,), dtype=value.dtype, device="meta")
 
 
+@impl(custom_ops_lib, "quantize_and_update_cache", "Meta")
+def quantize_and_update_cache_meta(
+    value,
+    cache,
+    scales,
+    zero_points,
+    start_pos,
+):
+    assert (
+        value.dtype == torch.float32
+    ), f"Expected value to be float32 but got {value.dtype}"
+    assert cache.dtype in [
+        torch.int8,
+        torch.uint8,
+    ], f"Expected cache to be int8 or uint8 (packed int4) but got {cache.dtype}"
+    values_per_element = 2 if cache.dtype == torch.uint8 else 1
+    assert (
+        cache.size(-1) * values_per_element == value.size(-1)
+    ), f"Expected cache of {value.size(-1)} values per row but got {cache.size()}"
+    _validate_quantized_kv_cache_params(
+        value, cache, cache, scales, zero_points, scales, zero_points
+    )
+
+    torch._check_is_size(start_pos)
+    torch._check((start_pos + value.size(1)) <= cache.size(1))
+    assert (start_pos + value.size(1)) <= cache.size(
+        1
+    ), f"Start position + length = {start_pos + value.size(1)} must not exceed sequence length {cache.size(1)}"
+
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "fused_elementwise", "Meta")
+def fused_elementwise_meta(
+    inputs,
+    scalars,
+    program,
+):
+    assert len(inputs) > 0, "Expected at least one input"
+    for t in inputs:
+        assert (
+            t.dtype == torch.float32
+        ), f"Expected all inputs to be float32 but got {t.dtype}"
+        assert (
+            t.size() == inputs[0].size()
+        ), f"Expected all inputs to have the same size but got {t.size()} and {inputs[0].size()}"
+    assert (
+        len(program) > 0 and len(program) % 3 == 0
+    ), f"Expected program to be a list of (opcode, a, b) triples but got {len(program)} values"
+
+    return torch.empty(inputs[0].size(), dtype=torch.float32, device="meta")
+
+
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(
+    input,
+    weight,
+    eps,
+):
+    assert input.dtype in [
+        torch.float32,
+        torch.float16,
+        torch.bfloat16,
+    ], f"Expected input to be float32, float16 or bfloat16 but got {input.dtype}"
+    assert (
+        weight.dtype == input.dtype
+    ), f"Expected weight dtype {weight.dtype} to match input dtype {input.dtype}"
+    assert (
+        weight.dim() == 1 and weight.size(0) == input.size(-1)
+    ), f"Expected weight of size {input.size(-1)} but got {weight.size()}"
+
+    return torch.empty_like(input)
+
+
+def _validate_quantized_kv_cache_params(
+    query, key, value, k_scale, k_zero_point, v_scale, v_zero_point
+):
+    assert key.dtype in [
+        torch.int8,
+        torch.uint8,
+    ], f"Expected key to be int8 or uint8 but got {key.dtype}"
+    assert (
+        value.dtype == key.dtype
+    ), f"Expected key and value to have the same dtype but got {key.dtype} and {value.dtype}"
+    values_per_element = 2 if key.dtype == torch.uint8 else 1
+    head_dim = query.size(-1)
+    assert (
+        key.size(-1) * values_per_element == head_dim
+        and value.size(-1) == key.size(-1)
+    ), f"Expected key and value to hold head dim {head_dim} but got {key.size()} and {value.size()}"
+    for t, t_scale, t_zero_point in [
+        (key, k_scale, k_zero_point),
+        (value, v_scale, v_zero_point),
+    ]:
+        assert (
+            t_scale.dtype == torch.float32
+        ), f"Expected scales to be float32 but got {t_scale.dtype}"
+        assert (
+            t_zero_point.dtype == torch.int8
+        ), f"Expected zero points to be int8 but got {t_zero_point.dtype}"
+        assert (
+            t.size()[:-1] == t_scale.size()[:-1]
+            and t_scale.size() == t_zero_point.size()
+        ), f"Expected cache and its quant params to have same size except last dimensions but got {t.size()}, {t_scale.size()} and {t_zero_point.size()}"
+        num_groups = t_scale.size(-1)
+        assert (
+            head_dim % num_groups == 0
+            and (head_dim // num_groups) % values_per_element == 0
+        ), f"Expected {num_groups} quant groups to evenly split head dim {head_dim}"
+    assert k_scale.size(-1) == v_scale.size(
+        -1
+    ), f"Expected key and value to have the same number of quant groups but got {k_scale.size(-1)} and {v_scale.size(-1)}"
+
+
 def _validate_quantized_sdpa_params(
     query,
     key,
@@ -293,9 +442,6 @@ def _validate_quantized_sdpa_params(
         value.dim() == 4
     ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
 
-    assert (q_scale is not None) and (
-        q_zero_point is not None
-    ), "q_scale and q_zero_point must be provided"
     assert (k_scale is not None) and (
         k_zero_point is not None
     ), "k_scale and k_zero_point must be provided"
@@ -303,6 +449,18 @@ def _validate_quantized_sdpa_params(
         v_zero_point is not None
     ), "v_scale and v_zero_point must be provided"
 
+    if query.dtype == torch.float32:
+        # Only the KV cache is quantized, group-wise to int8 or to int4 packed
+        # in pairs into uint8, see quantize_and_update_cache.
+        _validate_quantized_kv_cache_params(
+            query, key, value, k_scale, k_zero_point, v_scale, v_zero_point
+        )
+        return
+
+    assert (q_scale is not None) and (
+        q_zero_point is not None
+    ), "q_scale and q_zero_point must be provided"
+
     assert query.dtype == torch.int8, f"Expected query to be int8 but got {query.dtype}"
     assert key.dtype == torch.int8, f"Expected key to be int8 but got {key.dtype}"
     assert value.dtype == torch.int8, f"Expected value to be int8 but got {value.dtype}"
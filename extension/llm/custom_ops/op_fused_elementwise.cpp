@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_fused_elementwise.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+// Number of elements that each instruction processes at a time. With at most
+// kMaxFusedElementwiseRegisters scratch registers of this size, the working
+// set of a program stays in L1.
+constexpr int64_t kBlockSize = 256;
+
+constexpr int64_t kNumOps =
+    static_cast<int64_t>(FusedElementwiseOp::Rsqrt) + 1;
+
+bool is_binary(FusedElementwiseOp op) {
+  return op <= FusedElementwiseOp::Minimum;
+}
+
+bool check_fused_elementwise_args(
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    const Tensor& out) {
+  ET_CHECK_OR_RETURN_FALSE(
+      inputs.size() > 0, "fused_elementwise needs at least one input");
+  ET_CHECK_OR_RETURN_FALSE(
+      out.scalar_type() == ScalarType::Float,
+      "fused_elementwise only supports Float, got %" PRId8,
+      static_cast<int8_t>(out.scalar_type()));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(out));
+  for (const auto& input : inputs) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_shape_and_dtype(input, out));
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  }
+
+  ET_CHECK_OR_RETURN_FALSE(
+      !program.empty() && program.size() % 3 == 0,
+      "program must be a non-empty list of (opcode, a, b) triples, got "
+      "%" ET_PRIsize_t " values",
+      program.size());
+  const size_t num_instructions = program.size() / 3;
+  // The last instruction writes to out and needs no scratch register.
+  const size_t num_scratch_registers = scalars.size() + num_instructions - 1;
+  ET_CHECK_OR_RETURN_FALSE(
+      num_scratch_registers <= kMaxFusedElementwiseRegisters,
+      "program uses %" ET_PRIsize_t " scalar and intermediate registers, at "
+      "most %" ET_PRIsize_t " are supported",
+      num_scratch_registers,
+      kMaxFusedElementwiseRegisters);
+
+  int64_t num_registers = inputs.size() + scalars.size();
+  for (size_t i = 0; i < program.size(); i += 3) {
+    const int64_t opcode = program[i];
+    ET_CHECK_OR_RETURN_FALSE(
+        opcode >= 0 && opcode < kNumOps,
+        "invalid opcode %" PRId64 " in instruction %" ET_PRIsize_t,
+        opcode,
+        i / 3);
+    const bool binary = is_binary(static_cast<FusedElementwiseOp>(opcode));
+    for (size_t j = 1; j <= (binary ? 2 : 1); ++j) {
+      ET_CHECK_OR_RETURN_FALSE(
+          program[i + j] >= 0 && program[i + j] < num_registers,
+          "instruction %" ET_PRIsize_t " reads register %" PRId64
+          ", only %" PRId64 " registers are defined",
+          i / 3,
+          program[i + j],
+          num_registers);
+    }
+    ++num_registers;
+  }
+  return true;
+}
+
+float sigmoid(float x) {
+  return 1.0f / (1.0f + std::exp(-x));
+}
+
+// Applies one instruction to n elements. The loops are simple enough for the
+// compiler to vectorize.
+void run_instruction(
+    FusedElementwiseOp op,
+    const float* a,
+    const float* b,
+    float* out,
+    int64_t n) {
+  switch (op) {
+    case FusedElementwiseOp::Add:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] + b[i];
+      }
+      break;
+    case FusedElementwiseOp::Sub:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] - b[i];
+      }
+      break;
+    case FusedElementwiseOp::Mul:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] * b[i];
+      }
+      break;
+    case FusedElementwiseOp::Div:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] / b[i];
+      }
+      break;
+    case FusedElementwiseOp::Maximum:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = (std::isnan(a[i]) || a[i] > b[i]) ? a[i] : b[i];
+      }
+      break;
+    case FusedElementwiseOp::Minimum:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = (std::isnan(a[i]) || a[i] < b[i]) ? a[i] : b[i];
+      }
+      break;
+    case FusedElementwiseOp::Neg:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = -a[i];
+      }
+      break;
+    case FusedElementwiseOp::Relu:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] > 0.0f ? a[i] : (std::isnan(a[i]) ? a[i] : 0.0f);
+      }
+      break;
+    case FusedElementwiseOp::Exp:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = std::exp(a[i]);
+      }
+      break;
+    case FusedElementwiseOp::Sigmoid:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = sigmoid(a[i]);
+      }
+      break;
+    case FusedElementwiseOp::Tanh:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = std::tanh(a[i]);
+      }
+      break;
+    case FusedElementwiseOp::Silu:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = a[i] * sigmoid(a[i]);
+      }
+      break;
+    case FusedElementwiseOp::Sqrt:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = std::sqrt(a[i]);
+      }
+      break;
+    case FusedElementwiseOp::Rsqrt:
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = 1.0f / std::sqrt(a[i]);
+      }
+      break;
+  }
+}
+
+void fused_elementwise_impl(
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    Tensor& out) {
+  const size_t num_inputs = inputs.size();
+  const size_t num_scalars = scalars.size();
+  const size_t num_instructions = program.size() / 3;
+  float* const out_data = out.mutable_data_ptr<float>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.numel(),
+      ::executorch::extension::internal::GRAIN_SIZE,
+      [&](const int64_t begin, const int64_t end) {
+        // Scalar registers followed by intermediate registers.
+        // @lint-ignore CLANGTIDY facebook-hte-CArray
+        float scratch[kMaxFusedElementwiseRegisters][kBlockSize];
+        for (size_t s = 0; s < num_scalars; ++s) {
+          std::fill(
+              scratch[s],
+              scratch[s] + kBlockSize,
+              static_cast<float>(scalars[s]));
+        }
+
+        for (int64_t block = begin; block < end; block += kBlockSize) {
+          const int64_t n = std::min(kBlockSize, end - block);
+          auto read = [&](int64_t reg) -> const float* {
+            if (static_cast<size_t>(reg) < num_inputs) {
+              return inputs[reg].const_data_ptr<float>() + block;
+            }
+            return scratch[reg - num_inputs];
+          };
+          for (size_t k = 0; k < num_instructions; ++k) {
+            const auto op = static_cast<FusedElementwiseOp>(program[3 * k]);
+            const float* a = read(program[3 * k + 1]);
+            const float* b = is_binary(op) ? read(program[3 * k + 2]) : a;
+            float* dst = k + 1 == num_instructions
+                ? out_data + block
+                : scratch[num_scalars + k];
+            run_instruction(op, a, b, dst, n);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& fused_elementwise_out(
+    RuntimeContext& ctx,
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      inputs.size() > 0 &&
+          resize_tensor(out, inputs[0].sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_fused_elementwise_args(inputs, scalars, program, out),
+      InvalidArgument,
+      out);
+
+  fused_elementwise_impl(inputs, scalars, program, out);
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "fused_elementwise.out",
+    torch::executor::native::fused_elementwise_out);
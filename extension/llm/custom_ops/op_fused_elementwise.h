@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Opcodes of the programs run by fused_elementwise_out(). Binary ops read
+ * both operand registers, unary ops only read the first one.
+ */
+enum class FusedElementwiseOp : int64_t {
+  Add = 0,
+  Sub = 1,
+  Mul = 2,
+  Div = 3,
+  Maximum = 4,
+  Minimum = 5,
+  Neg = 6,
+  Relu = 7,
+  Exp = 8,
+  Sigmoid = 9,
+  Tanh = 10,
+  Silu = 11,
+  Sqrt = 12,
+  Rsqrt = 13,
+};
+
+/// Maximum number of scalar registers plus intermediate registers that a
+/// program run by fused_elementwise_out() may use.
+constexpr size_t kMaxFusedElementwiseRegisters = 16;
+
+/**
+ * Runs a chain of elementwise ops over `inputs` in a single pass and writes
+ * the result to `out`, so that intermediate results stay in cache instead of
+ * round-tripping through memory.
+ *
+ * `program` is a flat list of (opcode, a, b) triples, where a and b index the
+ * registers that hold the operands. Registers [0, inputs.size()) hold the
+ * inputs, the next scalars.size() registers hold the scalars broadcast to
+ * every element, and each instruction appends one register that holds its
+ * result. The result of the last instruction is written to `out`.
+ *
+ * All inputs and `out` must be Float tensors with the same sizes and the
+ * default dim order.
+ */
+Tensor& fused_elementwise_out(
+    RuntimeContext& ctx,
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
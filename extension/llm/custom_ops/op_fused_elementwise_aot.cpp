@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/llm/custom_ops/op_fused_elementwise.h>
+
+#include <torch/library.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+Tensor& fused_elementwise_out_no_context(
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    Tensor& out);
+
+Tensor& fused_elementwise_out_no_context(
+    const TensorList inputs,
+    const ArrayRef<double> scalars,
+    const IntArrayRef program,
+    Tensor& out) {
+  executorch::aten::RuntimeContext context{};
+  return fused_elementwise_out(context, inputs, scalars, program, out);
+}
+
+at::Tensor fused_elementwise_aten(
+    at::TensorList inputs,
+    c10::ArrayRef<double> scalars,
+    at::IntArrayRef program);
+
+at::Tensor fused_elementwise_aten(
+    at::TensorList inputs,
+    c10::ArrayRef<double> scalars,
+    at::IntArrayRef program) {
+  TORCH_CHECK(!inputs.empty(), "fused_elementwise needs at least one input");
+  auto output = at::empty(inputs[0].sizes(), inputs[0].options());
+  WRAP_TO_ATEN(fused_elementwise_out_no_context, 3)
+  (inputs, scalars, program, output);
+  return output;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "fused_elementwise(Tensor[] inputs, float[] scalars, int[] program) "
+      "-> Tensor");
+  m.def(
+      "fused_elementwise.out(Tensor[] inputs, float[] scalars, int[] program, "
+      "*, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl(
+      "fused_elementwise", torch::executor::native::fused_elementwise_aten);
+  m.impl(
+      "fused_elementwise.out",
+      WRAP_TO_ATEN(torch::executor::native::fused_elementwise_out_no_context, 3));
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_fused_elementwise.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::native::FusedElementwiseOp;
+
+namespace {
+
+constexpr int64_t op(FusedElementwiseOp o) {
+  return static_cast<int64_t>(o);
+}
+
+} // namespace
+
+class OpFusedElementwiseOutTest : public OperatorTest {
+ protected:
+  Tensor& op_fused_elementwise_out(
+      const std::vector<Tensor>& inputs,
+      const std::vector<double>& scalars,
+      const std::vector<int64_t>& program,
+      Tensor& out) {
+    return torch::executor::native::fused_elementwise_out(
+        context_,
+        ArrayRef<Tensor>(inputs.data(), inputs.size()),
+        ArrayRef<double>(scalars.data(), scalars.size()),
+        ArrayRef<int64_t>(program.data(), program.size()),
+        out);
+  }
+
+  TensorFactory<ScalarType::Float> tf_;
+};
+
+TEST_F(OpFusedElementwiseOutTest, ScaledAddRelu) {
+  // relu(x * 2 + y)
+  Tensor x = tf_.make({2, 3}, {-3, -2, -1, 0, 1, 2});
+  Tensor y = tf_.make({2, 3}, {1, 1, 1, 1, 1, 1});
+  Tensor out = tf_.zeros({2, 3});
+  op_fused_elementwise_out(
+      {x, y},
+      {2.0},
+      {
+          op(FusedElementwiseOp::Mul), 0, 2, // r3 = x * 2
+          op(FusedElementwiseOp::Add), 3, 1, // r4 = r3 + y
+          op(FusedElementwiseOp::Relu), 4, 0, // out = relu(r4)
+      },
+      out);
+  EXPECT_TENSOR_EQ(out, tf_.make({2, 3}, {0, 0, 0, 1, 3, 5}));
+}
+
+TEST_F(OpFusedElementwiseOutTest, SwiGLUMatchesReference) {
+  // silu(gate) * up over enough elements to span several blocks and threads.
+  const int64_t n = 3 * 32768 + 17;
+  std::vector<float> gate(n);
+  std::vector<float> up(n);
+  std::vector<float> expected(n);
+  for (int64_t i = 0; i < n; ++i) {
+    gate[i] = static_cast<float>((i % 97) - 48) / 8.0f;
+    up[i] = static_cast<float>((i % 13) - 6) / 4.0f;
+    expected[i] = gate[i] / (1.0f + std::exp(-gate[i])) * up[i];
+  }
+  const std::vector<int32_t> sizes = {1, static_cast<int32_t>(n)};
+  Tensor out = tf_.zeros(sizes);
+  op_fused_elementwise_out(
+      {tf_.make(sizes, gate), tf_.make(sizes, up)},
+      {},
+      {
+          op(FusedElementwiseOp::Silu), 0, 0,
+          op(FusedElementwiseOp::Mul), 2, 1,
+      },
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf_.make(sizes, expected));
+}
+
+TEST_F(OpFusedElementwiseOutTest, UnaryChain) {
+  // rsqrt(exp(-x) + 1) - tanh(sigmoid(x)), reusing x.
+  const std::vector<float> x = {-2.0f, -0.5f, 0.0f, 0.5f, 2.0f};
+  std::vector<float> expected;
+  for (float v : x) {
+    expected.push_back(
+        1.0f / std::sqrt(std::exp(-v) + 1.0f) -
+        std::tanh(1.0f / (1.0f + std::exp(-v))));
+  }
+  Tensor out = tf_.zeros({5});
+  op_fused_elementwise_out(
+      {tf_.make({5}, x)},
+      {1.0},
+      {
+          op(FusedElementwiseOp::Neg), 0, 0, // r2
+          op(FusedElementwiseOp::Exp), 2, 0, // r3
+          op(FusedElementwiseOp::Add), 3, 1, // r4
+          op(FusedElementwiseOp::Rsqrt), 4, 0, // r5
+          op(FusedElementwiseOp::Sigmoid), 0, 0, // r6
+          op(FusedElementwiseOp::Tanh), 6, 0, // r7
+          op(FusedElementwiseOp::Sub), 5, 7,
+      },
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf_.make({5}, expected));
+}
+
+TEST_F(OpFusedElementwiseOutTest, MaximumMinimumDivSqrt) {
+  // sqrt(min(max(x, y), 4) / 2)
+  Tensor x = tf_.make({4}, {1, 9, 16, 0});
+  Tensor y = tf_.make({4}, {2, 3, 25, 8});
+  Tensor out = tf_.zeros({4});
+  op_fused_elementwise_out(
+      {x, y},
+      {4.0, 2.0},
+      {
+          op(FusedElementwiseOp::Maximum), 0, 1, // r4
+          op(FusedElementwiseOp::Minimum), 4, 2, // r5
+          op(FusedElementwiseOp::Div), 5, 3, // r6
+          op(FusedElementwiseOp::Sqrt), 6, 0,
+      },
+      out);
+  const float sqrt2 = std::sqrt(2.0f);
+  EXPECT_TENSOR_CLOSE(out, tf_.make({4}, {1.0f, sqrt2, sqrt2, sqrt2}));
+}
+
+TEST_F(OpFusedElementwiseOutTest, OutIsResized) {
+  Tensor x = tf_.make({2, 2}, {1, 2, 3, 4});
+  Tensor out = tf_.zeros(
+      {4, 4}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+  op_fused_elementwise_out({x}, {}, {op(FusedElementwiseOp::Neg), 0, 0}, out);
+  EXPECT_TENSOR_EQ(out, tf_.make({2, 2}, {-1, -2, -3, -4}));
+}
+
+TEST_F(OpFusedElementwiseOutTest, InvalidProgramsFail) {
+  Tensor x = tf_.make({2}, {1, 2});
+  Tensor out = tf_.zeros({2});
+
+  // Not a list of triples.
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_fused_elementwise_out({x}, {}, {op(FusedElementwiseOp::Neg), 0}, out));
+  // Unknown opcode.
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_elementwise_out({x}, {}, {99, 0, 0}, out));
+  // Reads a register that is not defined yet.
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_fused_elementwise_out(
+          {x}, {}, {op(FusedElementwiseOp::Add), 0, 1}, out));
+  // Too many registers.
+  std::vector<int64_t> long_program;
+  for (int64_t i = 0; i < 18; ++i) {
+    long_program.insert(
+        long_program.end(), {op(FusedElementwiseOp::Neg), i, 0});
+  }
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_elementwise_out({x}, {}, long_program, out));
+}
+
+TEST_F(OpFusedElementwiseOutTest, MismatchedInputsFail) {
+  Tensor x = tf_.make({2}, {1, 2});
+  Tensor y = tf_.make({3}, {1, 2, 3});
+  Tensor out = tf_.zeros({2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_fused_elementwise_out(
+          {x, y}, {}, {op(FusedElementwiseOp::Add), 0, 1}, out));
+
+  TensorFactory<ScalarType::Int> tf_int;
+  Tensor xi = tf_int.make({2}, {1, 2});
+  Tensor out_int = tf_int.zeros({2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_fused_elementwise_out(
+          {xi}, {}, {op(FusedElementwiseOp::Neg), 0, 0}, out_int));
+}
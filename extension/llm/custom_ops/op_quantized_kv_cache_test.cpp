@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+// Deterministic values in [-range, range).
+std::vector<float> make_values(size_t n, uint32_t seed, float range) {
+  std::vector<float> values(n);
+  uint32_t state = seed;
+  for (auto& v : values) {
+    state = state * 1664525u + 1013904223u;
+    v = range * (static_cast<float>(state >> 8) / (1 << 23) - 1.0f);
+  }
+  return values;
+}
+
+// Dequantizes a [B, S, H, D] group-wise quantized cache back to float.
+std::vector<float> dequantize_cache(
+    const Tensor& cache,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t head_dim) {
+  const bool is_int4 = cache.scalar_type() == ScalarType::Byte;
+  const int64_t num_rows = cache.numel() / cache.size(3);
+  const int64_t num_groups = scales.size(3);
+  const int64_t group_size = head_dim / num_groups;
+  const uint8_t* q = static_cast<const uint8_t*>(cache.const_data_ptr());
+  const float* s = scales.const_data_ptr<float>();
+  const int8_t* zp = zero_points.const_data_ptr<int8_t>();
+
+  std::vector<float> out(num_rows * head_dim);
+  for (int64_t row = 0; row < num_rows; ++row) {
+    for (int64_t i = 0; i < head_dim; ++i) {
+      int32_t qv;
+      if (is_int4) {
+        const uint8_t packed = q[row * head_dim / 2 + i / 2];
+        qv = static_cast<int32_t>(i % 2 == 0 ? packed & 0xF : packed >> 4) - 8;
+      } else {
+        qv = static_cast<int8_t>(q[row * head_dim + i]);
+      }
+      const int64_t g = row * num_groups + i / group_size;
+      out[row * head_dim + i] = (qv - zp[g]) * s[g];
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+class OpQuantizedKVCacheTest : public OperatorTest {
+ protected:
+  Tensor& op_quantize_and_update_cache_out(
+      const Tensor& value,
+      Tensor& cache,
+      Tensor& scales,
+      Tensor& zero_points,
+      int64_t start_pos,
+      Tensor& out) {
+    return torch::executor::native::quantize_and_update_cache_out(
+        context_, value, cache, scales, zero_points, start_pos, out);
+  }
+
+  // Quantizes a float [B, S, H, D] cache into an int8 or packed int4 cache
+  // with num_groups groups per row.
+  void quantize_cache(
+      const Tensor& value,
+      int64_t num_groups,
+      bool is_int4,
+      Tensor& cache,
+      Tensor& scales,
+      Tensor& zero_points) {
+    const int32_t b = value.size(0);
+    const int32_t s = value.size(1);
+    const int32_t h = value.size(2);
+    const int32_t d = value.size(3);
+    cache = is_int4 ? tf_byte_.zeros({b, s, h, d / 2})
+                    : tf_char_.zeros({b, s, h, d});
+    scales = tf_float_.zeros({b, s, h, static_cast<int32_t>(num_groups)});
+    zero_points = tf_char_.zeros({b, s, h, static_cast<int32_t>(num_groups)});
+    Tensor out = tf_float_.zeros({1});
+    op_quantize_and_update_cache_out(value, cache, scales, zero_points, 0, out);
+  }
+
+  // Runs custom_quantized_sdpa_out with a float query on a quantized cache
+  // and checks it against custom_sdpa_out on the dequantized cache, and
+  // against custom_sdpa_out on the original float cache within tol.
+  void test_quantized_kv_sdpa(
+      int32_t num_heads,
+      int32_t num_heads_kv,
+      int32_t head_dim,
+      int32_t seq_len,
+      int32_t max_seq_len,
+      int64_t start_pos,
+      int64_t num_groups,
+      bool is_int4,
+      float tol) {
+    Tensor q = tf_float_.make(
+        {1, seq_len, num_heads, head_dim},
+        make_values(seq_len * num_heads * head_dim, 1, 1.0f));
+    const std::vector<int32_t> cache_sizes = {
+        1, max_seq_len, num_heads_kv, head_dim};
+    const size_t cache_numel = max_seq_len * num_heads_kv * head_dim;
+    Tensor k = tf_float_.make(cache_sizes, make_values(cache_numel, 2, 2.0f));
+    Tensor v = tf_float_.make(cache_sizes, make_values(cache_numel, 3, 2.0f));
+
+    Tensor k_cache = tf_char_.zeros({1});
+    Tensor k_scales = tf_float_.zeros({1});
+    Tensor k_zero_points = tf_char_.zeros({1});
+    Tensor v_cache = tf_char_.zeros({1});
+    Tensor v_scales = tf_float_.zeros({1});
+    Tensor v_zero_points = tf_char_.zeros({1});
+    quantize_cache(k, num_groups, is_int4, k_cache, k_scales, k_zero_points);
+    quantize_cache(v, num_groups, is_int4, v_cache, v_scales, v_zero_points);
+
+    Tensor out = tf_float_.zeros({1, seq_len, num_heads, head_dim});
+    torch::executor::native::custom_quantized_sdpa_out(
+        context_,
+        q,
+        k_cache,
+        v_cache,
+        start_pos,
+        {},
+        0.0,
+        true,
+        {},
+        {},
+        {},
+        optional<Tensor>(k_zero_points),
+        optional<Tensor>(k_scales),
+        optional<Tensor>(v_zero_points),
+        optional<Tensor>(v_scales),
+        false,
+        out);
+    ASSERT_EQ(context_.failure_state(), executorch::runtime::Error::Ok);
+
+    Tensor k_dequant = tf_float_.make(
+        cache_sizes,
+        dequantize_cache(k_cache, k_scales, k_zero_points, head_dim));
+    Tensor v_dequant = tf_float_.make(
+        cache_sizes,
+        dequantize_cache(v_cache, v_scales, v_zero_points, head_dim));
+    Tensor expected = tf_float_.zeros({1, seq_len, num_heads, head_dim});
+    torch::executor::native::custom_sdpa_out(
+        context_,
+        q,
+        k_dequant,
+        v_dequant,
+        start_pos,
+        {},
+        0.0,
+        true,
+        {},
+        expected);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+
+    Tensor expected_float = tf_float_.zeros({1, seq_len, num_heads, head_dim});
+    torch::executor::native::custom_sdpa_out(
+        context_, q, k, v, start_pos, {}, 0.0, true, {}, expected_float);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected_float, 0, tol);
+  }
+
+  TensorFactory<ScalarType::Float> tf_float_;
+  TensorFactory<ScalarType::Char> tf_char_;
+  TensorFactory<ScalarType::Byte> tf_byte_;
+};
+
+TEST_F(OpQuantizedKVCacheTest, QuantizeAndUpdateCacheInt8) {
+  // 3 positions of 2 heads with 2 groups of 4, written at position 1.
+  const std::vector<float> values = make_values(3 * 2 * 8, 7, 3.0f);
+  Tensor value = tf_float_.make({1, 3, 2, 8}, values);
+  Tensor cache = tf_char_.zeros({1, 5, 2, 8});
+  Tensor scales = tf_float_.zeros({1, 5, 2, 2});
+  Tensor zero_points = tf_char_.zeros({1, 5, 2, 2});
+  Tensor out = tf_float_.zeros({1});
+  op_quantize_and_update_cache_out(value, cache, scales, zero_points, 1, out);
+
+  const std::vector<float> dequant =
+      dequantize_cache(cache, scales, zero_points, 8);
+  const float* s = scales.const_data_ptr<float>();
+  for (int64_t p = 0; p < 5; ++p) {
+    for (int64_t i = 0; i < 16; ++i) {
+      const int64_t idx = p * 16 + i;
+      if (p < 1 || p > 3) {
+        // Positions outside of [start_pos, start_pos + seq_len) are untouched.
+        EXPECT_EQ(s[idx / 4], 0.0f);
+        continue;
+      }
+      // Within half a quantization step of the group.
+      EXPECT_NEAR(dequant[idx], values[idx - 16], s[idx / 4] * 0.5f + 1e-6f);
+    }
+  }
+}
+
+TEST_F(OpQuantizedKVCacheTest, QuantizeAndUpdateCacheInt4) {
+  const std::vector<float> values = make_values(2 * 2 * 8, 11, 3.0f);
+  Tensor value = tf_float_.make({1, 2, 2, 8}, values);
+  Tensor cache = tf_byte_.zeros({1, 4, 2, 4});
+  Tensor scales = tf_float_.zeros({1, 4, 2, 2});
+  Tensor zero_points = tf_char_.zeros({1, 4, 2, 2});
+  Tensor out = tf_float_.zeros({1});
+  op_quantize_and_update_cache_out(value, cache, scales, zero_points, 2, out);
+
+  const std::vector<float> dequant =
+      dequantize_cache(cache, scales, zero_points, 8);
+  const float* s = scales.const_data_ptr<float>();
+  for (int64_t i = 0; i < 32; ++i) {
+    const int64_t idx = 32 + i;
+    // 4-bit groups of 4 elements: 15 steps across the group's range.
+    EXPECT_GT(s[idx / 4], 0.0f);
+    EXPECT_NEAR(dequant[idx], values[i], s[idx / 4] * 0.5f + 1e-6f);
+  }
+  EXPECT_EQ(s[0], 0.0f);
+}
+
+TEST_F(OpQuantizedKVCacheTest, QuantizeAndUpdateCacheRejectsBadShapes) {
+  Tensor value = tf_float_.zeros({1, 2, 2, 6});
+  Tensor out = tf_float_.zeros({1});
+
+  // int4 groups of 3 can't be packed into bytes.
+  Tensor cache = tf_byte_.zeros({1, 4, 2, 3});
+  Tensor scales = tf_float_.zeros({1, 4, 2, 2});
+  Tensor zero_points = tf_char_.zeros({1, 4, 2, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_quantize_and_update_cache_out(
+          value, cache, scales, zero_points, 0, out));
+
+  // The number of groups must divide the head dim.
+  Tensor int8_cache = tf_char_.zeros({1, 4, 2, 6});
+  Tensor bad_scales = tf_float_.zeros({1, 4, 2, 4});
+  Tensor bad_zero_points = tf_char_.zeros({1, 4, 2, 4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_quantize_and_update_cache_out(
+          value, int8_cache, bad_scales, bad_zero_points, 0, out));
+
+  // Writing past the end of the cache.
+  Tensor int8_scales = tf_float_.zeros({1, 4, 2, 2});
+  Tensor int8_zero_points = tf_char_.zeros({1, 4, 2, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_quantize_and_update_cache_out(
+          value, int8_cache, int8_scales, int8_zero_points, 3, out));
+}
+
+TEST_F(OpQuantizedKVCacheTest, Int8PerTokenPrefill) {
+  test_quantized_kv_sdpa(
+      /*num_heads=*/2,
+      /*num_heads_kv=*/2,
+      /*head_dim=*/16,
+      /*seq_len=*/5,
+      /*max_seq_len=*/32,
+      /*start_pos=*/3,
+      /*num_groups=*/1,
+      /*is_int4=*/false,
+      /*tol=*/2e-2);
+}
+
+TEST_F(OpQuantizedKVCacheTest, Int8GroupWiseDecodeAcrossKVTiles) {
+  // More than one 512 wide KV tile, with GQA decode grouping.
+  test_quantized_kv_sdpa(
+      /*num_heads=*/4,
+      /*num_heads_kv=*/2,
+      /*head_dim=*/16,
+      /*seq_len=*/1,
+      /*max_seq_len=*/600,
+      /*start_pos=*/590,
+      /*num_groups=*/2,
+      /*is_int4=*/false,
+      /*tol=*/2e-2);
+}
+
+TEST_F(OpQuantizedKVCacheTest, Int4GroupWisePrefillAcrossKVTiles) {
+  test_quantized_kv_sdpa(
+      /*num_heads=*/4,
+      /*num_heads_kv=*/2,
+      /*head_dim=*/16,
+      /*seq_len=*/4,
+      /*max_seq_len=*/600,
+      /*start_pos=*/590,
+      /*num_groups=*/4,
+      /*is_int4=*/true,
+      /*tol=*/0.25);
+}
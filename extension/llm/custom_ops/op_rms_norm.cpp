@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+bool check_rms_norm_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& out) {
+  ET_CHECK_OR_RETURN_FALSE(
+      input.scalar_type() == ScalarType::Float ||
+          input.scalar_type() == ScalarType::Half ||
+          input.scalar_type() == ScalarType::BFloat16,
+      "rms_norm only supports Float, Half and BFloat16, got %" PRId8,
+      static_cast<int8_t>(input.scalar_type()));
+  ET_CHECK_OR_RETURN_FALSE(
+      input.dim() >= 1, "rms_norm input must have at least one dim");
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 1));
+  ET_CHECK_OR_RETURN_FALSE(
+      weight.size(0) == input.size(input.dim() - 1),
+      "weight.size(0) %" ET_PRIsize_t " != input.size(-1) %" ET_PRIsize_t,
+      static_cast<size_t>(weight.size(0)),
+      static_cast<size_t>(input.size(input.dim() - 1)));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(out));
+  return true;
+}
+
+// Sum of squares of n elements, accumulated in float. Independent partial
+// sums let the compiler vectorize the loop without reassociating it.
+template <typename CTYPE>
+float sum_of_squares(const CTYPE* x, const int64_t n) {
+  constexpr int64_t kLanes = 8;
+  float partial[kLanes] = {};
+  int64_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int64_t j = 0; j < kLanes; ++j) {
+      const float v = static_cast<float>(x[i + j]);
+      partial[j] += v * v;
+    }
+  }
+  float sum = 0;
+  for (; i < n; ++i) {
+    const float v = static_cast<float>(x[i]);
+    sum += v * v;
+  }
+  for (int64_t j = 0; j < kLanes; ++j) {
+    sum += partial[j];
+  }
+  return sum;
+}
+
+template <typename CTYPE>
+void rms_norm(
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  const int64_t dim = input.size(input.dim() - 1);
+  if (dim == 0) {
+    return;
+  }
+  const int64_t num_rows = input.numel() / dim;
+
+  const CTYPE* const in_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* const weight_data = weight.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_rows,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / dim),
+      [&](const auto begin, const auto end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const CTYPE* const x = in_data + row * dim;
+          CTYPE* const y = out_data + row * dim;
+          const float scale = 1.0f /
+              std::sqrt(sum_of_squares(x, dim) / static_cast<float>(dim) +
+                        static_cast<float>(eps));
+          // Round the normalized value to CTYPE before applying the weight,
+          // as the eager module does with _norm(x.float()).type_as(x) *
+          // weight.
+          for (int64_t i = 0; i < dim; ++i) {
+            const CTYPE normalized =
+                static_cast<CTYPE>(static_cast<float>(x[i]) * scale);
+            y[i] = static_cast<CTYPE>(
+                static_cast<float>(normalized) *
+                static_cast<float>(weight_data[i]));
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, check_rms_norm_args(input, weight, out), InvalidArgument, out);
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      input.scalar_type(), ctx, "rms_norm.out", CTYPE, [&]() {
+        rms_norm<CTYPE>(input, weight, eps, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "rms_norm.out",
+    torch::executor::native::rms_norm_out);
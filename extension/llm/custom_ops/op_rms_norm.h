@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Fused RMSNorm over the last dim of `input`:
+ *
+ *   out = input * rsqrt(mean(input^2, -1) + eps) * weight
+ *
+ * This replaces the pow/mean/add/rsqrt/mul chain that RMSNorm otherwise
+ * decomposes into, reading the input once for the statistics and once for
+ * the output. Rows are normalized in parallel, and Half and BFloat16 are
+ * accumulated in float.
+ *
+ * `input`, `weight` and `out` must share a Float, Half or BFloat16 dtype and
+ * the default dim order, and `weight` must be 1-D with the size of the last
+ * dim of `input`.
+ */
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
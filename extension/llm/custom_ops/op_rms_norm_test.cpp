@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+// Reference RMSNorm over the last dim, computed in double.
+std::vector<float> rms_norm_reference(
+    const std::vector<float>& x,
+    const std::vector<float>& w,
+    double eps) {
+  const size_t dim = w.size();
+  std::vector<float> out(x.size());
+  for (size_t row = 0; row < x.size() / dim; ++row) {
+    double sum = 0;
+    for (size_t i = 0; i < dim; ++i) {
+      sum += static_cast<double>(x[row * dim + i]) * x[row * dim + i];
+    }
+    const double scale = 1.0 / std::sqrt(sum / dim + eps);
+    for (size_t i = 0; i < dim; ++i) {
+      out[row * dim + i] =
+          static_cast<float>(x[row * dim + i] * scale * w[i]);
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+class OpRmsNormOutTest : public OperatorTest {
+ protected:
+  Tensor& op_rms_norm_out(
+      const Tensor& input,
+      const Tensor& weight,
+      double eps,
+      Tensor& out) {
+    return torch::executor::native::rms_norm_out(
+        context_, input, weight, eps, out);
+  }
+};
+
+TEST_F(OpRmsNormOutTest, SmallRows) {
+  TensorFactory<ScalarType::Float> tf;
+  // Row 0 has mean square 7.5, row 1 has mean square 0.
+  Tensor input = tf.make({2, 4}, {1, 2, 3, 4, 0, 0, 0, 0});
+  Tensor weight = tf.make({4}, {1, 1, 2, 0.5});
+  Tensor out = tf.zeros({2, 4});
+  op_rms_norm_out(input, weight, 0, out);
+
+  const float s = 1.0f / std::sqrt(7.5f);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, 4}, {s, 2 * s, 6 * s, 2 * s, NAN, NAN, NAN, NAN}));
+}
+
+TEST_F(OpRmsNormOutTest, TransformerShapeMatchesReference) {
+  // {batch, seq_len, dim} with enough rows to be normalized in parallel.
+  TensorFactory<ScalarType::Float> tf;
+  constexpr int32_t kSeqLen = 37;
+  constexpr int32_t kDim = 2048;
+  std::vector<float> x(2 * kSeqLen * kDim);
+  std::vector<float> w(kDim);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(static_cast<int>(i % 101) - 50) / 16.0f;
+  }
+  for (size_t i = 0; i < w.size(); ++i) {
+    w[i] = 0.5f + static_cast<float>(i % 7) / 4.0f;
+  }
+
+  Tensor input = tf.make({2, kSeqLen, kDim}, x);
+  Tensor weight = tf.make({kDim}, w);
+  Tensor out = tf.zeros({2, kSeqLen, kDim});
+  op_rms_norm_out(input, weight, 1e-5, out);
+
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, kSeqLen, kDim}, rms_norm_reference(x, w, 1e-5)));
+}
+
+TEST_F(OpRmsNormOutTest, HalfAccumulatesInFloat) {
+  // The sum of squares of this row overflows Half.
+  TensorFactory<ScalarType::Half> tf;
+  Tensor input = tf.full({1, 4096}, 200);
+  Tensor weight = tf.full({4096}, 1);
+  Tensor out = tf.zeros({1, 4096});
+  op_rms_norm_out(input, weight, 1e-6, out);
+  EXPECT_TENSOR_CLOSE(out, tf.full({1, 4096}, 1));
+}
+
+TEST_F(OpRmsNormOutTest, BFloat16) {
+  TensorFactory<ScalarType::BFloat16> tf;
+  Tensor input = tf.make({1, 4}, {2, -2, 2, -2});
+  Tensor weight = tf.make({4}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 4});
+  op_rms_norm_out(input, weight, 0, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 4}, {1, -2, 3, -4}));
+}
+
+TEST_F(OpRmsNormOutTest, BFloat16MatchesModuleRounding) {
+  // RMSNorm.forward() rounds the normalized input to BFloat16 before
+  // multiplying by the weight. With dim 8 the kernel sums the squares in the
+  // same order as below, so the outputs must match exactly.
+  using executorch::aten::BFloat16;
+  TensorFactory<ScalarType::BFloat16> tf;
+  const std::vector<float> x = {
+      0.3f, -1.7f, 2.9f, 0.05f, -0.6f, 1.1f, 3.3f, -2.2f};
+  const std::vector<float> w = {
+      1.9f, 0.7f, -1.3f, 2.3f, 0.9f, -0.1f, 1.7f, 3.1f};
+  std::vector<BFloat16> x_bf16(x.begin(), x.end());
+  std::vector<BFloat16> w_bf16(w.begin(), w.end());
+
+  float sum = 0;
+  for (const BFloat16 v : x_bf16) {
+    sum += static_cast<float>(v) * static_cast<float>(v);
+  }
+  const float scale = 1.0f / std::sqrt(sum / 8.0f + 1e-6f);
+  std::vector<BFloat16> expected;
+  bool differs_from_fused_rounding = false;
+  for (size_t i = 0; i < x.size(); ++i) {
+    const BFloat16 normalized(static_cast<float>(x_bf16[i]) * scale);
+    expected.emplace_back(
+        static_cast<float>(normalized) * static_cast<float>(w_bf16[i]));
+    const BFloat16 fused(
+        static_cast<float>(x_bf16[i]) * scale * static_cast<float>(w_bf16[i]));
+    differs_from_fused_rounding |=
+        static_cast<float>(fused) != static_cast<float>(expected.back());
+  }
+  // Otherwise the test couldn't tell the rounding orders apart.
+  ASSERT_TRUE(differs_from_fused_rounding);
+
+  Tensor input = tf.make({1, 8}, x_bf16);
+  Tensor weight = tf.make({8}, w_bf16);
+  Tensor out = tf.zeros({1, 8});
+  op_rms_norm_out(input, weight, 1e-6, out);
+  EXPECT_TENSOR_EQ(out, tf.make({1, 8}, expected));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 0, out));
+}
+
+TEST_F(OpRmsNormOutTest, IntInputDies) {
+  TensorFactory<ScalarType::Int> tf;
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({4});
+  Tensor out = tf.zeros({2, 4});
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 0, out));
+}
@@ -29,18 +29,33 @@ namespace native {
 
 namespace {
 
+// True for a float query with an int8 or packed int4 KV cache.
+bool is_kv_only_quantized(const Tensor& query, const Tensor& key) {
+  return query.scalar_type() == ScalarType::Float &&
+      (key.scalar_type() == ScalarType::Char ||
+       key.scalar_type() == ScalarType::Byte);
+}
+
 bool validate_flash_attention_args(
     const Tensor& query,
     const Tensor& key,
     const Tensor& value,
-    const optional<Tensor>& attn_mask) {
+    const optional<Tensor>& attn_mask,
+    bool allow_quantized_kv = false) {
   ET_CHECK_OR_RETURN_FALSE(query.dim() == 4, "query must be a 4D tensor");
   ET_CHECK_OR_RETURN_FALSE(key.dim() == 4, "key must be a 4D tensor");
   ET_CHECK_OR_RETURN_FALSE(value.dim() == 4, "value must be a 4D tensor");
 
+  const bool kv_only_quantized =
+      allow_quantized_kv && is_kv_only_quantized(query, key);
+  // A packed int4 cache holds two values per element.
+  const int64_t kv_values_per_element =
+      kv_only_quantized && key.scalar_type() == ScalarType::Byte ? 2 : 1;
+
   // Sizes
   ET_CHECK_OR_RETURN_FALSE(
-      (query.size(3) == value.size(3)) && (key.size(3) == value.size(3)),
+      (query.size(3) == value.size(3) * kv_values_per_element) &&
+          (key.size(3) == value.size(3)),
       "scaled_dot_product_attention_flash_attention: Q/K/V should have the same head size");
 
   ET_CHECK_OR_RETURN_FALSE(
@@ -49,8 +64,8 @@ bool validate_flash_attention_args(
       "Query must be Float type");
 
   ET_CHECK_OR_RETURN_FALSE(
-      (query.scalar_type() == key.scalar_type()) &&
-          (query.scalar_type() == value.scalar_type()),
+      (kv_only_quantized || query.scalar_type() == key.scalar_type()) &&
+          (key.scalar_type() == value.scalar_type()),
       "Key and Value must have the same data type as Query");
 
   ET_CHECK_OR_RETURN_FALSE(
@@ -129,6 +144,51 @@ bool validate_cache_quant_params_args(
   return true;
 }
 
+// Validates the group-wise quantization params of an int8 or packed int4 KV
+// cache used with a float query.
+bool validate_kv_cache_quant_params_args(
+    const Tensor& t,
+    const Tensor& t_zero_points,
+    const Tensor& t_scales,
+    int64_t head_dim) {
+  ET_CHECK_OR_RETURN_FALSE(
+      t.dim() == 4 && t_scales.dim() == 4 && t_zero_points.dim() == 4,
+      "Quantized cache, scales and zero points must be 4D tensors");
+  ET_CHECK_OR_RETURN_FALSE(
+      (t_scales.scalar_type() == ScalarType::Float),
+      "Scales tensor must be of float type");
+  ET_CHECK_OR_RETURN_FALSE(
+      (t_zero_points.scalar_type() == ScalarType::Char),
+      "Zero points tensor must be of int8_t type");
+  for (int64_t i = 0; i < 3; i++) {
+    ET_CHECK_OR_RETURN_FALSE(
+        (t.size(i) == t_scales.size(i)) &&
+            (t.size(i) == t_zero_points.size(i)),
+        "Quantized cache and its quant params have different shape"
+        "at dim: %" PRId64 ", t: %zd, t_scales: %zd",
+        i,
+        t.size(i),
+        t_scales.size(i));
+  }
+  const int64_t num_groups = t_scales.size(3);
+  ET_CHECK_OR_RETURN_FALSE(
+      num_groups > 0 && head_dim % num_groups == 0 &&
+          t_zero_points.size(3) == num_groups,
+      "Number of quant groups %" PRId64 " must divide head dim %" PRId64,
+      num_groups,
+      head_dim);
+  ET_CHECK_OR_RETURN_FALSE(
+      t.scalar_type() == ScalarType::Char ||
+          (head_dim / num_groups) % 2 == 0,
+      "int4 quant groups must have an even size");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(t_scales.dim_order().data(), t_scales.dim()) &&
+          is_contiguous_dim_order(
+              t_zero_points.dim_order().data(), t_zero_points.dim()),
+      "Quant params must be in contiguous dim order");
+  return true;
+}
+
 bool validate_cache_params(
     const Tensor& k_cache,
     const Tensor& v_cache,
@@ -342,7 +402,9 @@ Tensor& custom_sdpa_out_impl(
     const optional<Tensor>& k_scales = nullopt,
     const optional<Tensor>& v_zero_points = nullopt,
     const optional<Tensor>& v_scales = nullopt,
-    bool is_seq_at_dim_2 = false) {
+    bool is_seq_at_dim_2 = false,
+    const int64_t window_size = -1,
+    const int64_t num_sink_tokens = 0) {
   ET_KERNEL_CHECK_MSG(
       ctx,
       !attn_mask.has_value() || !is_causal,
@@ -352,7 +414,23 @@ Tensor& custom_sdpa_out_impl(
 
   ET_KERNEL_CHECK_MSG(
       ctx,
-      validate_flash_attention_args(q, k, v, attn_mask),
+      window_size <= 0 || is_causal,
+      InvalidArgument,
+      output,
+      "window_size requires is_causal to be set");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      num_sink_tokens >= 0,
+      InvalidArgument,
+      output,
+      "num_sink_tokens must be non-negative, got %" PRId64,
+      num_sink_tokens);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      validate_flash_attention_args(
+          q, k, v, attn_mask, /*allow_quantized_kv=*/true),
       InvalidArgument,
       output,
       "Invalid arguments");
@@ -396,6 +474,24 @@ Tensor& custom_sdpa_out_impl(
         InvalidArgument,
         output,
         "Invalid arguments for quantized value");
+  } else if (is_kv_only_quantized(q, k)) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        k_scales.has_value() && k_zero_points.has_value() &&
+            v_scales.has_value() && v_zero_points.has_value(),
+        InvalidArgument,
+        output,
+        "A quantized KV cache needs its scales and zero points");
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        validate_kv_cache_quant_params_args(
+            k, k_zero_points.value(), k_scales.value(), q.size(3)) &&
+            validate_kv_cache_quant_params_args(
+                v, v_zero_points.value(), v_scales.value(), q.size(3)) &&
+            k_scales.value().size(3) == v_scales.value().size(3),
+        InvalidArgument,
+        output,
+        "Invalid arguments for quantized KV cache");
   }
 
   ET_CHECK_MSG(q.dim() == 4, "query must be a 4D tensor");
@@ -434,7 +530,9 @@ Tensor& custom_sdpa_out_impl(
               v_scales, // v_scales
               seq_dim, /* seq_dim */
               start_pos,
-              num_keys_for_causal_attention);
+              num_keys_for_causal_attention,
+              window_size,
+              num_sink_tokens);
         } else if (seq_len >= 192) {
           sdpa::impl::cpu_flash_attention<CTYPE, 64, 512>(
               output,
@@ -453,7 +551,9 @@ Tensor& custom_sdpa_out_impl(
               v_scales, // v_scales
               seq_dim, /* seq_dim */
               start_pos,
-              num_keys_for_causal_attention);
+              num_keys_for_causal_attention,
+              window_size,
+              num_sink_tokens);
         } else {
           sdpa::impl::cpu_flash_attention<CTYPE, 32, 512>(
               output,
@@ -472,7 +572,9 @@ Tensor& custom_sdpa_out_impl(
               v_scales, // v_scales
               seq_dim, /* seq_dim */
               start_pos,
-              num_keys_for_causal_attention);
+              num_keys_for_causal_attention,
+              window_size,
+              num_sink_tokens);
         }
       });
   return output;
@@ -547,6 +649,50 @@ Tensor& custom_sdpa_out(
   return custom_sdpa_out_impl(
       ctx, q, k, v, start_pos, attn_mask, dropout_p, is_causal, scale, output);
 }
+
+/*
+  Same as custom_sdpa_out, with causal sliding window attention.
+  @param[in] window_size: Each query attends to the window_size most recent
+  keys up to and including its own position. Key blocks entirely outside of
+  the window are not computed. -1 disables the window.
+  @param[in] num_sink_tokens: Number of leading keys that every query attends
+  to regardless of the window (attention sinks).
+*/
+Tensor& custom_sdpa_sliding_window_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens,
+    Tensor& output) {
+  return custom_sdpa_out_impl(
+      ctx,
+      q,
+      k,
+      v,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output,
+      nullopt,
+      nullopt,
+      nullopt,
+      nullopt,
+      nullopt,
+      nullopt,
+      false,
+      window_size,
+      num_sink_tokens);
+}
 /*
   Input params
   @param[in] q_projected Projected query with query weights.
@@ -618,6 +764,11 @@ EXECUTORCH_LIBRARY(
     "custom_sdpa.out",
     torch::executor::native::custom_sdpa_out);
 
+EXECUTORCH_LIBRARY(
+    llama,
+    "custom_sdpa_sliding_window.out",
+    torch::executor::native::custom_sdpa_sliding_window_out);
+
 EXECUTORCH_LIBRARY(
     llama,
     "custom_quantized_sdpa.out",
@@ -44,6 +44,21 @@ Tensor& custom_sdpa_out(
     const optional<double> scale,
     Tensor& output);
 
+Tensor& custom_sdpa_sliding_window_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens,
+    Tensor& output);
+
 Tensor& flash_attention_kernel_out(
     KernelRuntimeContext& ctx,
     const Tensor& query,
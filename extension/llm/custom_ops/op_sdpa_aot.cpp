@@ -77,6 +77,37 @@ at::Tensor custom_sdpa_aten(
     // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
     const std::optional<double> scale);
 
+Tensor& custom_sdpa_sliding_window_out_no_context(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens,
+    Tensor& output);
+
+at::Tensor custom_sdpa_sliding_window_aten(
+    const at::Tensor& q,
+    const at::Tensor& k,
+    const at::Tensor& v,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens);
+
 Tensor& custom_quantized_sdpa_out_no_context(
     const Tensor& q,
     const Tensor& k,
@@ -143,6 +174,21 @@ at::Tensor update_cache_with_indices_aten(
     const int64_t start_pos,
     const at::Tensor& indices);
 
+Tensor& quantize_and_update_cache_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    Tensor& zero_points,
+    const int64_t start_pos,
+    Tensor& output);
+
+at::Tensor quantize_and_update_cache_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    at::Tensor& scales,
+    at::Tensor& zero_points,
+    const int64_t start_pos);
+
 Tensor& sdpa_with_kv_cache_out_no_context(
     const Tensor& q_projected,
     const Tensor& k_projected,
@@ -253,6 +299,67 @@ at::Tensor custom_sdpa_aten(
   return output;
 }
 
+Tensor& custom_sdpa_sliding_window_out_no_context(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens,
+    Tensor& output) {
+  executorch::aten::RuntimeContext context{};
+  return torch::executor::native::custom_sdpa_sliding_window_out(
+      context,
+      q,
+      k,
+      v,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      window_size,
+      num_sink_tokens,
+      output);
+}
+
+at::Tensor custom_sdpa_sliding_window_aten(
+    const at::Tensor& q,
+    const at::Tensor& k,
+    const at::Tensor& v,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale,
+    const int64_t window_size,
+    const int64_t num_sink_tokens) {
+  auto output = at::empty(q.sizes());
+  WRAP_TO_ATEN(custom_sdpa_sliding_window_out_no_context, 10)
+  (q,
+   k,
+   v,
+   start_pos,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   window_size,
+   num_sink_tokens,
+   output);
+  return output;
+}
+
 Tensor& custom_quantized_sdpa_out_no_context(
     const Tensor& q,
     const Tensor& k,
@@ -377,6 +484,30 @@ at::Tensor update_cache_with_indices_aten(
   return output;
 }
 
+Tensor& quantize_and_update_cache_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    Tensor& zero_points,
+    const int64_t start_pos,
+    Tensor& output) {
+  executorch::aten::RuntimeContext context{};
+  return torch::executor::native::quantize_and_update_cache_out(
+      context, value, cache, scales, zero_points, start_pos, output);
+}
+
+at::Tensor quantize_and_update_cache_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    at::Tensor& scales,
+    at::Tensor& zero_points,
+    const int64_t start_pos) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(quantize_and_update_cache_out_no_context, 5)
+  (value, cache, scales, zero_points, start_pos, output);
+  return output;
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -398,6 +529,16 @@ TORCH_LIBRARY_FRAGMENT(llama, m) {
       "custom_sdpa.out(Tensor query, Tensor key, Tensor value, SymInt start_pos, "
       "Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, "
       "float? scale=None, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "custom_sdpa_sliding_window(Tensor query, Tensor key, Tensor value, "
+      "SymInt start_pos, Tensor? attn_mask=None, float drpout_p=0.0, "
+      "bool is_causal=False, float? scale=None, int window_size=-1, "
+      "int num_sink_tokens=0) -> Tensor");
+  m.def(
+      "custom_sdpa_sliding_window.out(Tensor query, Tensor key, Tensor value, "
+      "SymInt start_pos, Tensor? attn_mask=None, float drpout_p=0.0, "
+      "bool is_causal=False, float? scale=None, int window_size=-1, "
+      "int num_sink_tokens=0, *, Tensor(a!) out) -> Tensor(a!)");
   m.def(
       "update_cache(Tensor value, Tensor(a!) cache, "
       "SymInt start_pos) -> Tensor");
@@ -410,6 +551,13 @@ TORCH_LIBRARY_FRAGMENT(llama, m) {
   m.def(
       "update_cache_with_indices.out(Tensor value, Tensor(a!) cache, "
       "SymInt start_pos, Tensor indices, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "quantize_and_update_cache(Tensor value, Tensor(a!) cache, "
+      "Tensor(b!) scales, Tensor(c!) zero_points, SymInt start_pos) -> Tensor");
+  m.def(
+      "quantize_and_update_cache.out(Tensor value, Tensor(a!) cache, "
+      "Tensor(b!) scales, Tensor(c!) zero_points, SymInt start_pos, *, "
+      "Tensor(d!) out) -> Tensor(d!)");
   m.def(
       "custom_quantized_sdpa(Tensor query, Tensor key, Tensor value, SymInt start_pos, "
       "Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, "
@@ -436,6 +584,14 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
   m.impl(
       "custom_sdpa.out",
       WRAP_TO_ATEN(torch::executor::native::custom_sdpa_out_no_context, 8));
+  m.impl(
+      "custom_sdpa_sliding_window",
+      torch::executor::native::custom_sdpa_sliding_window_aten);
+  m.impl(
+      "custom_sdpa_sliding_window.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::custom_sdpa_sliding_window_out_no_context,
+          10));
   m.impl("update_cache", torch::executor::native::update_cache_aten);
   m.impl(
       "update_cache.out",
@@ -448,6 +604,14 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
       WRAP_TO_ATEN(
           torch::executor::native::update_cache_with_indices_out_no_context,
           4));
+  m.impl(
+      "quantize_and_update_cache",
+      torch::executor::native::quantize_and_update_cache_aten);
+  m.impl(
+      "quantize_and_update_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::quantize_and_update_cache_out_no_context,
+          5));
   m.impl(
       "custom_quantized_sdpa",
       torch::executor::native::custom_quantized_sdpa_aten);
@@ -246,6 +246,53 @@ void dequant_and_gemm(
       o_stride_m);
 }
 
+// Dequantizes num_rows rows of a group-wise quantized KV cache into out, a
+// [num_rows, head_dim] matrix. in holds int8 values, or pairs of int4 values
+// (offset by 8, even element in the low nibble) when is_int4. Every row has
+// head_dim / group_size scales and zero points.
+inline void dequantize_kv_rows(
+    const uint8_t* in,
+    const int64_t in_row_stride,
+    const float* scales,
+    const int8_t* zero_points,
+    const int64_t qparams_row_stride,
+    const int64_t num_rows,
+    const int64_t head_dim,
+    const int64_t group_size,
+    const bool is_int4,
+    float* out) {
+  const int64_t num_groups = head_dim / group_size;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    const uint8_t* in_row = in + row * in_row_stride;
+    const float* row_scales = scales + row * qparams_row_stride;
+    const int8_t* row_zero_points = zero_points + row * qparams_row_stride;
+    float* out_row = out + row * head_dim;
+    for (int64_t g = 0; g < num_groups; ++g) {
+      const float scale = row_scales[g];
+      float* out_group = out_row + g * group_size;
+      if (is_int4) {
+        const uint8_t* in_group = in_row + g * group_size / 2;
+        const float offset = static_cast<float>(8 + row_zero_points[g]);
+        for (int64_t i = 0; i < group_size / 2; ++i) {
+          out_group[2 * i] =
+              (static_cast<float>(in_group[i] & 0xF) - offset) * scale;
+          out_group[2 * i + 1] =
+              (static_cast<float>(in_group[i] >> 4) - offset) * scale;
+        }
+      } else {
+        dequantize_optimized(
+            reinterpret_cast<const int8_t*>(in_row) + g * group_size,
+            scale,
+            row_zero_points[g],
+            out_group,
+            -128,
+            127,
+            group_size);
+      }
+    }
+  }
+}
+
 template <typename accum_t>
 void _qk_at_v_gemm(
     const int64_t m,
@@ -538,6 +585,17 @@ TODO: Just handle conversion of bool mask to float
  * @param start_pos Starting position for causal masking in generation
  * @param num_keys_for_causal_attention Number of keys to consider for causal
  attention (-1 for all)
+ * @param window_size Sliding window size for causal attention. When positive,
+ the query at position p only attends to keys in [p - window_size + 1, p], and
+ key blocks that lie entirely before the window are skipped. Requires
+ is_causal. (-1 to disable)
+ * @param num_sink_tokens Number of leading keys (attention sinks) that remain
+ visible to every query when window_size is positive.
+ *
+ * When query is float but key and value are int8, or uint8 holding pairs of
+ int4 values, only the KV cache is quantized: k/v scales and zero points then
+ have one entry per group of head_dim / scales.size(-1) elements of a row, and
+ every K/V tile is dequantized into a per-thread buffer right before its gemm.
  */
 template <typename scalar_t, int64_t q_split_size, int64_t kv_split_size>
 void cpu_flash_attention(
@@ -557,7 +615,9 @@ void cpu_flash_attention(
     const optional<Tensor>& v_scales,
     const SeqDim seq_dim = SeqDim::TWO,
     const int64_t start_pos = 0,
-    const int64_t num_keys_for_causal_attention = -1) {
+    const int64_t num_keys_for_causal_attention = -1,
+    const int64_t window_size = -1,
+    const int64_t num_sink_tokens = 0) {
   (void)dropout_p;
 
   // Without this we have out-of-bounds writes for
@@ -612,6 +672,12 @@ void cpu_flash_attention(
       num_heads_kv);
   int64_t num_reps = num_head / num_heads_kv;
 
+  const bool has_window = window_size > 0;
+  ET_CHECK_MSG(
+      !has_window || is_causal,
+      "Sliding window attention requires is_causal to be true");
+  ET_CHECK_MSG(num_sink_tokens >= 0, "num_sink_tokens must be non-negative");
+
   bool has_attn_mask = attn_mask.has_value() && attn_mask.value().numel();
   if (has_attn_mask) {
     /*
@@ -638,6 +704,11 @@ void cpu_flash_attention(
 
   bool is_quantized_sdpa = false;
   is_quantized_sdpa = query.scalar_type() == ScalarType::Char;
+  const bool is_kv_quantized =
+      !is_quantized_sdpa && key.scalar_type() != query.scalar_type();
+  const bool is_kv_int4 = key.scalar_type() == ScalarType::Byte;
+  const int64_t kv_group_size =
+      is_kv_quantized ? headSize / k_scales.value().size(3) : 0;
 
   auto strides = query.strides();
   int64_t qStrideB = strides[0];
@@ -679,12 +750,7 @@ void cpu_flash_attention(
   int64_t v_quant_params_StrideH = 0;
   int64_t v_quant_params_StrideN = 0;
 
-  if (is_quantized_sdpa) {
-    auto q_strides = q_zero_points.value().strides();
-    q_quant_params_StrideB = q_strides[0];
-    q_quant_params_StrideH = q_strides[1];
-    q_quant_params_StrideM = q_strides[2];
-
+  if (is_quantized_sdpa || is_kv_quantized) {
     auto k_strides = k_zero_points.value().strides();
     k_quant_params_StrideB = k_strides[0];
     k_quant_params_StrideH = k_strides[1];
@@ -695,15 +761,7 @@ void cpu_flash_attention(
     v_quant_params_StrideH = v_strides[1];
     v_quant_params_StrideN = v_strides[2];
 
-    ET_CHECK_MSG(
-        (v_quant_params_StrideN == k_quant_params_StrideN) &&
-            (v_quant_params_StrideN == q_quant_params_StrideM),
-        "Quant params strides must be same for seq dim");
-
     if (seq_dim == SeqDim::ONE) {
-      q_quant_params_StrideH = q_strides[2];
-      q_quant_params_StrideM = q_strides[1];
-
       k_quant_params_StrideH = k_strides[2];
       k_quant_params_StrideN = k_strides[1];
 
@@ -712,6 +770,24 @@ void cpu_flash_attention(
     }
   }
 
+  if (is_quantized_sdpa) {
+    auto q_strides = q_zero_points.value().strides();
+    q_quant_params_StrideB = q_strides[0];
+    q_quant_params_StrideH = q_strides[1];
+    q_quant_params_StrideM = q_strides[2];
+
+    const auto k_stride_2 = k_zero_points.value().strides()[2];
+    const auto v_stride_2 = v_zero_points.value().strides()[2];
+    ET_CHECK_MSG(
+        (v_stride_2 == k_stride_2) && (v_stride_2 == q_strides[2]),
+        "Quant params strides must be same for seq dim");
+
+    if (seq_dim == SeqDim::ONE) {
+      q_quant_params_StrideH = q_strides[2];
+      q_quant_params_StrideM = q_strides[1];
+    }
+  }
+
   strides = output.strides();
   int64_t oStrideB = strides[0];
   int64_t oStrideH = strides[1];
@@ -722,6 +798,10 @@ void cpu_flash_attention(
     oStrideM = strides[1];
   }
 
+  // Row strides of the K/V tiles that the gemms read.
+  const int64_t kRowStride = is_kv_quantized ? headSize : kStrideN;
+  const int64_t vRowStride = is_kv_quantized ? headSize : vStrideN;
+
   int64_t mStrideB = 0;
   int64_t mStrideH = 0;
   int64_t mStrideM = 0;
@@ -748,16 +828,33 @@ void cpu_flash_attention(
   int64_t num_thread = 1;
 #endif
 
+  // For single token decode with GQA, all query heads that share a kv head
+  // are processed together as the rows of one q block. Each K/V block is then
+  // loaded once per group instead of once per query head, and the gemms see
+  // num_reps rows instead of 1. Only do this when there are enough kv heads
+  // to keep all threads busy.
+  const bool is_gqa_grouped = num_reps > 1 && qSize == 1 &&
+      !is_quantized_sdpa && batchSize * num_heads_kv >= num_thread;
+  const int64_t num_head_iters = is_gqa_grouped ? num_heads_kv : num_head;
+  const int64_t qBlockRows = is_gqa_grouped ? num_reps : qSplitSize;
+  // Stride between the rows of a q block in q and in the output, and the
+  // position step between consecutive rows. Grouped rows are different heads
+  // at the same position.
+  const int64_t qRowStride = is_gqa_grouped ? qStrideH : qStrideM;
+  const int64_t oRowStride = is_gqa_grouped ? oStrideH : oStrideM;
+  const int64_t mRowStride = is_gqa_grouped ? 0 : mStrideM;
+  const int64_t rowPosStep = is_gqa_grouped ? 0 : 1;
+
   // const auto dtype = query.scalar_type();
   // Following will be revisited in the future
   // const auto accumulate_dtype = dtype; // toOpMathType(dtype);
 
   // allocate per thread temp buf (accumulate type)
   int64_t size_per_thread =
-      /* qk     */ qSplitSize * kvSplitSize +
-      /* qk_max */ qSplitSize +
-      /* qk_sum */ qSplitSize +
-      /* dst    */ qSplitSize * headSize;
+      /* qk     */ qBlockRows * kvSplitSize +
+      /* qk_max */ qBlockRows +
+      /* qk_sum */ qBlockRows +
+      /* dst    */ qBlockRows * headSize;
 
   // Since all intermediate compute is accum_t, we need to
   // allocate a buffer accordingly.
@@ -767,9 +864,13 @@ void cpu_flash_attention(
   std::vector<char> buf_vec(size_bytes);
   void* buf = reinterpret_cast<void*>(buf_vec.data());
   // Need to double check the following
-  size_bytes = num_thread * qSplitSize * kvSplitSize * query.element_size();
+  size_bytes = num_thread * qBlockRows * kvSplitSize * query.element_size();
   std::vector<char> buf_reduced_vec(size_bytes);
   void* buf_reduced = reinterpret_cast<void*>(buf_reduced_vec.data());
+  // Per-thread K and V tiles dequantized from a quantized KV cache.
+  const int64_t kv_dequant_size_per_thread =
+      is_kv_quantized ? 2 * kvSplitSize * headSize : 0;
+  std::vector<float> kv_dequant_buf(num_thread * kv_dequant_size_per_thread);
   // at::Tensor buf_reduced = at::empty(
   //    {num_thread, qSplitSize, is_reduced_type ? kvSplitSize : 0},
   //    query.options());
@@ -787,23 +888,30 @@ void cpu_flash_attention(
 
   auto compute_lambda = [&](int64_t begin, int64_t end) {
     int64_t i = 0, j = 0, k = 0;
-    data_index_init(begin, i, batchSize, j, num_head, k, qSlice);
+    data_index_init(begin, i, batchSize, j, num_head_iters, k, qSlice);
     int ompIdx = torch::executor::get_thread_num();
     accum_t* buf_ptr = buf_data + ompIdx * size_per_thread;
     accum_t* qk_data = buf_ptr;
-    accum_t* qk_max_data = qk_data + qSplitSize * kvSplitSize;
-    accum_t* qk_sum_data = qk_max_data + qSplitSize;
-    accum_t* dst_data = qk_sum_data + qSplitSize;
+    accum_t* qk_max_data = qk_data + qBlockRows * kvSplitSize;
+    accum_t* qk_sum_data = qk_max_data + qBlockRows;
+    accum_t* dst_data = qk_sum_data + qBlockRows;
     scalar_t* qk_reduced_data = is_reduced_type
-        ? buf_reduced_data + ompIdx * qSplitSize * kvSplitSize
+        ? buf_reduced_data + ompIdx * qBlockRows * kvSplitSize
         : nullptr;
+    float* k_dequant_data =
+        kv_dequant_buf.data() + ompIdx * kv_dequant_size_per_thread;
+    float* v_dequant_data =
+        is_kv_quantized ? k_dequant_data + kvSplitSize * headSize : nullptr;
 
     for (int64_t z = begin; z < end; z++) {
       int64_t m = k * qSplitSize;
-      int64_t qBlockSize = std::min(qSplitSize, qSize - m);
+      // Number of distinct positions in the q block.
+      int64_t qNumPositions = std::min(qSplitSize, qSize - m);
+      int64_t qBlockSize = is_gqa_grouped ? num_reps : qNumPositions;
       // Initialize max and sum
       fill_stub(
           qk_max_data, -std::numeric_limits<accum_t>::infinity(), qBlockSize);
+      fill_stub(qk_sum_data, static_cast<accum_t>(0), qBlockSize);
       // Original flash sdpa wasnt really meant to be used
       // for decode the way we are using via start_pos here.
       // Thus when num_keys is 1 during decode phase, we
@@ -832,13 +940,33 @@ void cpu_flash_attention(
       // code doesnt support bool attention mask.
       // However, lets just fix that as well.
       int64_t num_keys =
-          is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
+          is_causal ? std::min(m + start_pos + qNumPositions, kvSize) : kvSize;
       int64_t m_start_pos = m + start_pos;
-      auto j_kv = j / num_reps;
-      for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
+      auto j_q = is_gqa_grouped ? j * num_reps : j;
+      auto j_kv = is_gqa_grouped ? j : j / num_reps;
+      // First key inside the sliding window of the first row of the block.
+      // Later rows only see later keys.
+      int64_t window_begin =
+          has_window ? std::max<int64_t>(m_start_pos - window_size + 1, 0) : 0;
+      bool first_block = true;
+      int64_t n = 0;
+      while (n < num_keys) {
+        if (has_window && n >= num_sink_tokens && n < window_begin) {
+          // Skip the kv blocks between the sink tokens and the window.
+          n = window_begin;
+          if (n >= num_keys) {
+            break;
+          }
+        }
         int64_t kvBlockSize = std::min(kvSplitSize, kvSize - n);
+        if (has_window && n < num_sink_tokens &&
+            num_sink_tokens < window_begin) {
+          // Stop the block at the last sink token so that the next one can
+          // start at the window.
+          kvBlockSize = std::min(kvBlockSize, num_sink_tokens - n);
+        }
         // Calculate scale * q @ k.T
-        fill_stub(qk_data, static_cast<accum_t>(0), qSplitSize * kvSplitSize);
+        fill_stub(qk_data, static_cast<accum_t>(0), qBlockRows * kvSplitSize);
 
         const void* q_sub_matrix_data_ptr;
         const void* k_sub_matrix_data_ptr;
@@ -846,7 +974,7 @@ void cpu_flash_attention(
         const float* k_scales_ptr = nullptr;
         const int8_t* q_zero_points_ptr = nullptr;
         const int8_t* k_zero_points_ptr = nullptr;
-        int64_t q_offset = i * qStrideB + j * qStrideH + m * qStrideM;
+        int64_t q_offset = i * qStrideB + j_q * qStrideH + m * qStrideM;
         int64_t k_offset = i * kStrideB + j_kv * kStrideH + n * kStrideN;
         if (is_quantized_sdpa) {
           int64_t q_quant_params_offset = i * q_quant_params_StrideB +
@@ -863,6 +991,23 @@ void cpu_flash_attention(
               k_quant_params_offset;
           q_sub_matrix_data_ptr = (const int8_t*)(q_data) + q_offset;
           k_sub_matrix_data_ptr = (const int8_t*)(k_data) + k_offset;
+        } else if (is_kv_quantized) {
+          int64_t k_quant_params_offset = i * k_quant_params_StrideB +
+              j_kv * k_quant_params_StrideH + n * k_quant_params_StrideN;
+          dequantize_kv_rows(
+              (const uint8_t*)(k_data) + k_offset,
+              kStrideN,
+              k_scales.value().const_data_ptr<float>() + k_quant_params_offset,
+              k_zero_points.value().const_data_ptr<int8_t>() +
+                  k_quant_params_offset,
+              k_quant_params_StrideN,
+              kvBlockSize,
+              headSize,
+              kv_group_size,
+              is_kv_int4,
+              k_dequant_data);
+          q_sub_matrix_data_ptr = (const scalar_t*)(q_data) + q_offset;
+          k_sub_matrix_data_ptr = k_dequant_data;
         } else {
           q_sub_matrix_data_ptr = (const scalar_t*)(q_data) + q_offset;
           k_sub_matrix_data_ptr = (const scalar_t*)(k_data) + k_offset;
@@ -882,15 +1027,15 @@ void cpu_flash_attention(
             kvBlockSize,
             headSize,
             k_quant_params_StrideN,
-            key.scalar_type());
+            is_kv_quantized ? query.scalar_type() : key.scalar_type());
         _q_at_k_gemm<accum_t>(
             qBlockSize,
             kvBlockSize,
             headSize,
             q_sub_matrix_data,
-            qStrideM,
+            qRowStride,
             k_sub_matrix_data,
-            kStrideN,
+            kRowStride,
             qk_data);
 
         // There are 4 cases that is_causal has to cover to fill
@@ -936,14 +1081,14 @@ void cpu_flash_attention(
         */
         if (is_causal && m_start_pos <= n + kvSplitSize) {
           // For this fn to work k_split_size > q_split_size
-          for (int32_t row = 0;
-               row < qBlockSize && (m_start_pos + row < n + (kvSplitSize - 1));
+          for (int32_t row = 0; row < qBlockSize &&
+               (m_start_pos + row * rowPosStep < n + (kvBlockSize - 1));
                ++row) {
+            int64_t row_pos = m_start_pos + row * rowPosStep;
             // When last_col is 0, it means that the entire row is not attended
             // to because m_pos is smaller than n_pos. So everything in n is for
             // future.
-            int64_t last_col =
-                n > (m_start_pos + row) ? 0 : row + m_start_pos + 1 - n;
+            int64_t last_col = n > row_pos ? 0 : row_pos + 1 - n;
             accum_t* row_ptr = qk_data + row * kvBlockSize;
             fill_stub(
                 row_ptr + last_col,
@@ -951,6 +1096,22 @@ void cpu_flash_attention(
                 kvBlockSize - last_col);
           }
         }
+        // Mask the keys that are neither sink tokens nor inside the sliding
+        // window of each row.
+        if (has_window && n + kvBlockSize > num_sink_tokens) {
+          int64_t first_col = std::max<int64_t>(num_sink_tokens - n, 0);
+          for (int64_t row = 0; row < qBlockSize; ++row) {
+            int64_t row_pos = m_start_pos + row * rowPosStep;
+            int64_t end_col =
+                std::min(row_pos - window_size + 1 - n, kvBlockSize);
+            if (end_col > first_col) {
+              fill_stub(
+                  qk_data + row * kvBlockSize + first_col,
+                  -std::numeric_limits<accum_t>::infinity(),
+                  end_col - first_col);
+            }
+          }
+        }
         // Update attention weights with attention mask
         // And apply scaling factor
         // qk <- qk * scaling + attn_mask
@@ -962,8 +1123,8 @@ void cpu_flash_attention(
                 },
                 qk_data + row * kvBlockSize,
                 qk_data + row * kvBlockSize,
-                mask_data + i * mStrideB + j * mStrideH + (m + row) * mStrideM +
-                    n,
+                mask_data + i * mStrideB + j_q * mStrideH + m * mStrideM +
+                    row * mRowStride + n,
                 kvBlockSize);
           }
         }
@@ -1009,7 +1170,7 @@ void cpu_flash_attention(
             // max[row] <- max
             qk_max_data[row] = tmp_max;
             // dst <- dst * exp_tmp
-            if (n > 0) {
+            if (!first_block) {
               vec::map<accum_t>(
                   [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
                   dst_data + row * headSize,
@@ -1031,6 +1192,22 @@ void cpu_flash_attention(
           v_zero_points_ptr = v_zero_points.value().const_data_ptr<int8_t>() +
               v_quant_params_offset;
           v_sub_matrix_data_ptr = (const int8_t*)(v_data) + v_offset;
+        } else if (is_kv_quantized) {
+          int64_t v_quant_params_offset = i * v_quant_params_StrideB +
+              j_kv * v_quant_params_StrideH + n * v_quant_params_StrideN;
+          dequantize_kv_rows(
+              (const uint8_t*)(v_data) + v_offset,
+              vStrideN,
+              v_scales.value().const_data_ptr<float>() + v_quant_params_offset,
+              v_zero_points.value().const_data_ptr<int8_t>() +
+                  v_quant_params_offset,
+              v_quant_params_StrideN,
+              kvBlockSize,
+              headSize,
+              kv_group_size,
+              is_kv_int4,
+              v_dequant_data);
+          v_sub_matrix_data_ptr = v_dequant_data;
         } else {
           v_sub_matrix_data_ptr = (const scalar_t*)(v_data) + v_offset;
         }
@@ -1041,7 +1218,7 @@ void cpu_flash_attention(
             kvBlockSize,
             headSize,
             v_quant_params_StrideN,
-            value.scalar_type());
+            is_kv_quantized ? query.scalar_type() : value.scalar_type());
         // Calculate Softmax(q @ k.T) @ v
         _qk_at_v_gemm<accum_t>(
             qBlockSize,
@@ -1050,10 +1227,12 @@ void cpu_flash_attention(
             qk_data,
             kvBlockSize,
             v_sub_matrix_data,
-            vStrideN,
+            vRowStride,
             dst_data,
             headSize,
-            n == 0 ? static_cast<accum_t>(0) : static_cast<accum_t>(1));
+            first_block ? static_cast<accum_t>(0) : static_cast<accum_t>(1));
+        n += kvBlockSize;
+        first_block = false;
       }
       // dst <- dst / sum[row]
       // reorder MHA output with strides
@@ -1061,17 +1240,17 @@ void cpu_flash_attention(
         accum_t sum_reciprocal = 1 / qk_sum_data[row];
         vec::map<scalar_t>(
             [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
-            out_data + i * oStrideB + j * oStrideH + m * oStrideM +
-                row * oStrideM,
+            out_data + i * oStrideB + j_q * oStrideH + m * oStrideM +
+                row * oRowStride,
             dst_data + row * headSize,
             headSize);
       }
       // Move to the next query
-      data_index_step(i, batchSize, j, num_head, k, qSlice);
+      data_index_step(i, batchSize, j, num_head_iters, k, qSlice);
     }
   };
   torch::executor::parallel_for(
-      0, batchSize * num_head * qSlice, 1, compute_lambda);
+      0, batchSize * num_head_iters * qSlice, 1, compute_lambda);
 }
 } // namespace sdpa::impl
 } // namespace native
@@ -8,11 +8,16 @@
 
 #include <executorch/extension/llm/custom_ops/op_update_cache.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 // @lint-ignore CLANGTIDY facebook-unused-include-check
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -205,6 +210,139 @@ Tensor& update_cache_impl(
   // Noone uses output. Just a placeholder.
   return output;
 }
+
+bool validate_quantized_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t start_pos) {
+  ET_CHECK_OR_RETURN_FALSE(
+      value.scalar_type() == ScalarType::Float, "value must be a Float tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      cache.scalar_type() == ScalarType::Char ||
+          cache.scalar_type() == ScalarType::Byte,
+      "cache must be an int8 tensor, or a uint8 tensor of packed int4 values");
+  ET_CHECK_OR_RETURN_FALSE(
+      scales.scalar_type() == ScalarType::Float,
+      "scales must be a Float tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      zero_points.scalar_type() == ScalarType::Char,
+      "zero_points must be an int8 tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      scales.dim() == 4 && zero_points.dim() == 4,
+      "scales and zero_points must be 4D tensors");
+
+  ET_CHECK_OR_RETURN_FALSE(
+      validate_cache_params(value, cache, start_pos, value.size(1)),
+      "Invalid cache params");
+
+  const int64_t head_dim = value.size(3);
+  const int64_t bits = cache.scalar_type() == ScalarType::Byte ? 4 : 8;
+  for (int64_t i = 0; i < 3; ++i) {
+    ET_CHECK_OR_RETURN_FALSE(
+        cache.size(i) == scales.size(i) &&
+            zero_points.size(i) == scales.size(i),
+        "cache, scales and zero_points differ at dim %" PRId64,
+        i);
+  }
+  ET_CHECK_OR_RETURN_FALSE(
+      cache.size(3) * 8 == head_dim * bits,
+      "cache.size(3) %zd doesn't hold head_dim %" PRId64 " %" PRId64
+      "-bit values",
+      cache.size(3),
+      head_dim,
+      bits);
+  ET_CHECK_OR_RETURN_FALSE(
+      zero_points.size(3) == scales.size(3) && scales.size(3) > 0 &&
+          head_dim % scales.size(3) == 0,
+      "scales.size(3) %zd must divide head_dim %" PRId64,
+      scales.size(3),
+      head_dim);
+  ET_CHECK_OR_RETURN_FALSE(
+      bits == 8 || (head_dim / scales.size(3)) % 2 == 0,
+      "int4 groups must have an even size");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.size(0) == cache.size(0) && value.size(2) == cache.size(2),
+      "value and cache must have the same batch size and number of heads");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()) &&
+          is_contiguous_dim_order(scales.dim_order().data(), scales.dim()) &&
+          is_contiguous_dim_order(
+              zero_points.dim_order().data(), zero_points.dim()),
+      "cache, scales and zero_points must be in contiguous dim order");
+  return true;
+}
+
+// Asymmetric quantization parameters of a group, computed the same way as
+// quantized_decomposed.choose_qparams_per_token_asymmetric.
+void choose_group_qparams(
+    const float* x,
+    int64_t n,
+    int32_t qmin,
+    int32_t qmax,
+    float& scale,
+    int32_t& zero_point) {
+  float min_val = 0.0f;
+  float max_val = 0.0f;
+  for (int64_t i = 0; i < n; ++i) {
+    min_val = std::min(min_val, x[i]);
+    max_val = std::max(max_val, x[i]);
+  }
+  scale = std::max(
+      (max_val - min_val) / static_cast<float>(qmax - qmin),
+      std::numeric_limits<float>::epsilon());
+  const float descaled_min = min_val / scale;
+  const float descaled_max = max_val / scale;
+  const float zp = (qmin + descaled_min) + (qmax + descaled_max) > 0
+      ? qmin - descaled_min
+      : qmax - descaled_max;
+  zero_point = static_cast<int32_t>(std::nearbyint(std::min(
+      std::max(zp, static_cast<float>(qmin)), static_cast<float>(qmax))));
+}
+
+// Quantizes a row of head_dim values in groups of group_size into q, which
+// holds int8 values, or pairs of int4 values (offset by 8, even element in
+// the low nibble) when kInt4.
+template <bool kInt4>
+void quantize_row(
+    const float* x,
+    int64_t head_dim,
+    int64_t group_size,
+    uint8_t* q,
+    float* scales,
+    int8_t* zero_points) {
+  constexpr int32_t qmin = kInt4 ? -8 : -128;
+  constexpr int32_t qmax = kInt4 ? 7 : 127;
+  for (int64_t g = 0; g < head_dim / group_size; ++g) {
+    const float* xg = x + g * group_size;
+    float scale;
+    int32_t zero_point;
+    choose_group_qparams(xg, group_size, qmin, qmax, scale, zero_point);
+    scales[g] = scale;
+    zero_points[g] = static_cast<int8_t>(zero_point);
+
+    const float inv_scale = 1.0f / scale;
+    auto quantize = [&](float v) {
+      const int32_t qv =
+          static_cast<int32_t>(std::nearbyint(v * inv_scale)) + zero_point;
+      return std::min(std::max(qv, qmin), qmax);
+    };
+    if constexpr (kInt4) {
+      uint8_t* qg = q + g * group_size / 2;
+      for (int64_t i = 0; i < group_size; i += 2) {
+        qg[i / 2] = static_cast<uint8_t>(
+            (quantize(xg[i]) + 8) | ((quantize(xg[i + 1]) + 8) << 4));
+      }
+    } else {
+      int8_t* qg = reinterpret_cast<int8_t*>(q) + g * group_size;
+      for (int64_t i = 0; i < group_size; ++i) {
+        qg[i] = static_cast<int8_t>(quantize(xg[i]));
+      }
+    }
+  }
+}
+
 } // anonymous namespace
 
 // Original update_cache_out function without indices parameter
@@ -242,6 +380,78 @@ Tensor& update_cache_with_indices_out(
   return update_cache_impl(ctx, value, cache, start_pos, output, indices);
 }
 
+Tensor& quantize_and_update_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    Tensor& zero_points,
+    const int64_t start_pos,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_quantized_cache_params(
+          value, cache, scales, zero_points, start_pos),
+      InvalidArgument,
+      output);
+
+  const int64_t batch_size = value.size(0);
+  const int64_t seq_len = value.size(1);
+  const int64_t num_heads = value.size(2);
+  const int64_t head_dim = value.size(3);
+  const int64_t num_groups = scales.size(3);
+  const int64_t group_size = head_dim / num_groups;
+  const bool is_int4 = cache.scalar_type() == ScalarType::Byte;
+
+  const float* value_data = value.const_data_ptr<float>();
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  float* scales_data = scales.mutable_data_ptr<float>();
+  int8_t* zero_points_data = zero_points.mutable_data_ptr<int8_t>();
+
+  // Every (batch, position, head) row is quantized independently.
+  const int64_t num_rows = batch_size * seq_len * num_heads;
+  const int64_t rows_per_batch = seq_len * num_heads;
+  const int64_t cache_batch_stride = cache.strides()[0];
+  const int64_t qparams_batch_stride = scales.strides()[0];
+  ::executorch::extension::parallel_for(
+      0,
+      num_rows,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / head_dim),
+      [&](const auto begin, const auto end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t b = row / rows_per_batch;
+          // Offset of the row within its batch, in rows of the cache.
+          const int64_t cache_row =
+              start_pos * num_heads + row % rows_per_batch;
+          uint8_t* q = cache_data + b * cache_batch_stride +
+              cache_row * cache.size(3);
+          const int64_t qparams_offset =
+              b * qparams_batch_stride + cache_row * num_groups;
+          if (is_int4) {
+            quantize_row<true>(
+                value_data + row * head_dim,
+                head_dim,
+                group_size,
+                q,
+                scales_data + qparams_offset,
+                zero_points_data + qparams_offset);
+          } else {
+            quantize_row<false>(
+                value_data + row * head_dim,
+                head_dim,
+                group_size,
+                q,
+                scales_data + qparams_offset,
+                zero_points_data + qparams_offset);
+          }
+        }
+      });
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -262,3 +472,10 @@ EXECUTORCH_LIBRARY(
     llama,
     "update_cache_with_indices.out",
     torch::executor::native::update_cache_with_indices_out);
+
+// Quantizes value group-wise to int8 or packed int4 and writes it, along with
+// its scales and zero points, to the cache at start_pos.
+EXECUTORCH_LIBRARY(
+    llama,
+    "quantize_and_update_cache.out",
+    torch::executor::native::quantize_and_update_cache_out);
@@ -31,6 +31,19 @@ Tensor& update_cache_with_indices_out(
     const int64_t start_pos,
     const Tensor& indices,
     Tensor& output);
+
+// Quantizes value [B, S, H, D] per (token, head) groups of
+// D / scales.size(3) elements and writes it to cache at start_pos. cache is
+// int8 [B, max_S, H, D], or uint8 [B, max_S, H, D / 2] holding pairs of int4
+// values. scales (float) and zero_points (int8) are [B, max_S, H, num_groups].
+Tensor& quantize_and_update_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    Tensor& zero_points,
+    const int64_t start_pos,
+    Tensor& output);
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -35,6 +35,8 @@ def define_common_targets():
             exported_headers = [
                 "op_fallback.h",
                 "op_fast_hadamard_transform.h",
+                "op_fused_elementwise.h",
+                "op_rms_norm.h",
                 "op_sdpa.h",
                 "op_update_cache.h",
             ],
@@ -74,6 +76,8 @@ def define_common_targets():
             name = "custom_ops_aot_lib" + mkl_dep,
             srcs = [
                 "op_fast_hadamard_transform_aten.cpp",
+                "op_fused_elementwise_aot.cpp",
+                "op_rms_norm_aot.cpp",
                 "op_sdpa_aot.cpp",
                 "op_tile_crop.cpp",
                 "op_tile_crop_aot.cpp",
@@ -135,6 +139,48 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "op_fused_elementwise_test",
+        srcs = [
+            "op_fused_elementwise_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rms_norm_test",
+        srcs = [
+            "op_rms_norm_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_quantized_kv_cache_test",
+        srcs = [
+            "op_quantized_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
     ## For preprocess
     runtime.python_library(
         name = "preprocess_custom_ops_py",
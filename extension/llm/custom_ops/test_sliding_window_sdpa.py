@@ -0,0 +1,123 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import unittest
+
+import torch
+import torch.nn.functional as F
+
+from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+
+def _sliding_window_sdpa_ref(
+    q, k_cache, v_cache, start_pos, window_size, num_sink_tokens
+):
+    seq_len = q.size(1)
+    num_keys = start_pos + seq_len
+    q = q.transpose(1, 2)
+    k = k_cache[:, :num_keys].transpose(1, 2)
+    v = v_cache[:, :num_keys].transpose(1, 2)
+    n_reps = q.size(1) // k.size(1)
+    if n_reps > 1:
+        k = k.repeat_interleave(n_reps, dim=1)
+        v = v.repeat_interleave(n_reps, dim=1)
+
+    q_pos = torch.arange(start_pos, num_keys).unsqueeze(1)
+    k_pos = torch.arange(num_keys).unsqueeze(0)
+    allowed = k_pos <= q_pos
+    if window_size > 0:
+        allowed &= (k_pos > q_pos - window_size) | (k_pos < num_sink_tokens)
+    out = F.scaled_dot_product_attention(q, k, v, attn_mask=allowed)
+    return out.transpose(1, 2)
+
+
+class SlidingWindowSDPATest(unittest.TestCase):
+
+    def setUp(self):
+        torch.manual_seed(42)
+        self.n_batch = 2
+        self.max_seq_len = 1200
+        self.head_dim = 64
+
+    def _test(
+        self,
+        n_heads_q,
+        n_heads_kv,
+        start_pos,
+        seq_len,
+        window_size,
+        num_sink_tokens=0,
+    ):
+        k_cache = torch.rand(
+            (self.n_batch, self.max_seq_len, n_heads_kv, self.head_dim)
+        )
+        v_cache = torch.rand(
+            (self.n_batch, self.max_seq_len, n_heads_kv, self.head_dim)
+        )
+        q = torch.rand((self.n_batch, seq_len, n_heads_q, self.head_dim))
+        ref_output = _sliding_window_sdpa_ref(
+            q, k_cache, v_cache, start_pos, window_size, num_sink_tokens
+        )
+        op_output = torch.ops.llama.custom_sdpa_sliding_window(
+            q,
+            k_cache,
+            v_cache,
+            start_pos,
+            None,
+            0,
+            True,
+            None,
+            window_size,
+            num_sink_tokens,
+        )
+        self.assertTrue(torch.allclose(ref_output, op_output, atol=1e-5))
+
+    def test_no_window_matches_custom_sdpa(self):
+        q = torch.rand((self.n_batch, 1, 8, self.head_dim))
+        k_cache = torch.rand((self.n_batch, self.max_seq_len, 8, self.head_dim))
+        v_cache = torch.rand((self.n_batch, self.max_seq_len, 8, self.head_dim))
+        ref_output = torch.ops.llama.custom_sdpa(
+            q, k_cache, v_cache, 700, None, 0, True
+        )
+        op_output = torch.ops.llama.custom_sdpa_sliding_window(
+            q, k_cache, v_cache, 700, None, 0, True, None, -1, 0
+        )
+        self.assertTrue(torch.allclose(ref_output, op_output, atol=1e-6))
+
+    def test_decode_window_within_one_block(self):
+        self._test(8, 8, start_pos=100, seq_len=1, window_size=32)
+
+    def test_decode_window_skips_blocks(self):
+        self._test(8, 8, start_pos=1100, seq_len=1, window_size=256)
+
+    def test_decode_window_with_sinks(self):
+        self._test(
+            8, 8, start_pos=1100, seq_len=1, window_size=256, num_sink_tokens=4
+        )
+
+    def test_decode_window_covers_all_keys(self):
+        self._test(8, 8, start_pos=100, seq_len=1, window_size=1000)
+
+    def test_prefill_window(self):
+        self._test(8, 8, start_pos=0, seq_len=200, window_size=48)
+
+    def test_chunked_prefill_window_with_sinks(self):
+        self._test(
+            8, 8, start_pos=600, seq_len=100, window_size=128, num_sink_tokens=4
+        )
+
+    def test_gqa_decode(self):
+        self._test(32, 8, start_pos=900, seq_len=1, window_size=-1)
+
+    def test_gqa_decode_window_with_sinks(self):
+        self._test(
+            32, 4, start_pos=1100, seq_len=1, window_size=300, num_sink_tokens=2
+        )
+
+    def test_gqa_prefill_window(self):
+        self._test(16, 4, start_pos=0, seq_len=130, window_size=64)
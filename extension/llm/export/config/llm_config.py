@@ -147,6 +147,11 @@ class ModelConfig:
         use_sdpa_with_kv_cache: Whether to use flash attention by substituting
             for our custom SDPA op. Note that the naming is poor and this
             doesn't actually have anything to do with the kv_cache at the moment.
+        use_custom_rms_norm: Whether to replace RMSNorm with the fused
+            llama::rms_norm custom op from the custom ops library.
+        fuse_elementwise_ops: Whether to fuse chains of float32 elementwise
+            ops into the llama::fused_elementwise custom op. Fused ops are
+            not delegated.
         expand_rope_table: Temporary workaround to expand sin/cos table in head
             dim to take vectorized path in optimized kernels.
         use_attention_sink: Whether to use attention sink to support multi-round
@@ -157,6 +162,10 @@ class ModelConfig:
         input_prune_map: Path to the output pruning token mapping file (token_map.json).
         use_kv_cache: Whether to use KV cache.
         quantize_kv_cache: Whether to perform int8 per token quantization on the KV cache.
+        quantize_kv_cache_bits: Bits of the quantized KV cache, 8 or 4. 4 bit
+            caches are always quantized group-wise.
+        quantize_kv_cache_group_size: Quantize the KV cache in groups of this
+            many elements of each token and head instead of per token.
         local_global_attention: List of integers specifying local and global attention pattern.
             e.g., [0, 16, 0, 16] to specify that every other layer is sliding window of 16.
             [0, 16, 32] pattern specifies 2nd and 3rd layers have sliding windows of 16 and 32.
@@ -167,12 +176,16 @@ class ModelConfig:
     enable_dynamic_shape: bool = True
     use_shared_embedding: bool = False
     use_sdpa_with_kv_cache: bool = False
+    use_custom_rms_norm: bool = False
+    fuse_elementwise_ops: bool = False
     expand_rope_table: bool = False
     use_attention_sink: Optional[str] = None
     output_prune_map: Optional[str] = None
     input_prune_map: Optional[str] = None
     use_kv_cache: bool = False
     quantize_kv_cache: bool = False
+    quantize_kv_cache_bits: int = 8
+    quantize_kv_cache_group_size: Optional[int] = None
     local_global_attention: Optional[List[int]] = None
 
     def __post_init__(self):
@@ -183,6 +196,11 @@ class ModelConfig:
                 "Cannot quantize the KV cache (quantize_kv_cache) without enabling the KV cache (use_kv_cache)"
             )
 
+        if self.quantize_kv_cache_bits not in (4, 8):
+            raise ValueError(
+                f"quantize_kv_cache_bits must be 4 or 8, got {self.quantize_kv_cache_bits}"
+            )
+
         if self.local_global_attention and not self.use_kv_cache:
             raise ValueError(
                 "Cannot use local_global_attention without enabling the KV cache (use_kv_cache)"
@@ -542,6 +560,10 @@ class LlmConfig:
             llm_config.model.use_shared_embedding = args.use_shared_embedding
         if hasattr(args, "use_sdpa_with_kv_cache"):
             llm_config.model.use_sdpa_with_kv_cache = args.use_sdpa_with_kv_cache
+        if hasattr(args, "use_custom_rms_norm"):
+            llm_config.model.use_custom_rms_norm = args.use_custom_rms_norm
+        if hasattr(args, "fuse_elementwise_ops"):
+            llm_config.model.fuse_elementwise_ops = args.fuse_elementwise_ops
         if hasattr(args, "expand_rope_table"):
             llm_config.model.expand_rope_table = args.expand_rope_table
         if hasattr(args, "use_attention_sink"):
@@ -554,6 +576,12 @@ class LlmConfig:
             llm_config.model.use_kv_cache = args.use_kv_cache
         if hasattr(args, "quantize_kv_cache"):
             llm_config.model.quantize_kv_cache = args.quantize_kv_cache
+        if hasattr(args, "quantize_kv_cache_bits"):
+            llm_config.model.quantize_kv_cache_bits = args.quantize_kv_cache_bits
+        if hasattr(args, "quantize_kv_cache_group_size"):
+            llm_config.model.quantize_kv_cache_group_size = (
+                args.quantize_kv_cache_group_size
+            )
         if hasattr(args, "local_global_attention"):
             llm_config.model.local_global_attention = args.local_global_attention
 
@@ -99,6 +99,199 @@ class RemoveRedundantTransposes(ExportPass):
         return PassResult(graph_module, graph_changed)
 
 
+# Opcodes of llama.fused_elementwise, see FusedElementwiseOp in
+# extension/llm/custom_ops/op_fused_elementwise.h.
+_FUSED_ELEMENTWISE_BINARY_OPS = {
+    torch.ops.aten.add.Tensor: 0,
+    torch.ops.aten.sub.Tensor: 1,
+    torch.ops.aten.mul.Tensor: 2,
+    torch.ops.aten.div.Tensor: 3,
+    torch.ops.aten.maximum.default: 4,
+    torch.ops.aten.minimum.default: 5,
+}
+_FUSED_ELEMENTWISE_UNARY_OPS = {
+    torch.ops.aten.neg.default: 6,
+    torch.ops.aten.relu.default: 7,
+    torch.ops.aten.exp.default: 8,
+    torch.ops.aten.sigmoid.default: 9,
+    torch.ops.aten.tanh.default: 10,
+    torch.ops.aten.silu.default: 11,
+    torch.ops.aten.sqrt.default: 12,
+    torch.ops.aten.rsqrt.default: 13,
+}
+# Maximum number of scalar and intermediate registers of a fused program, see
+# kMaxFusedElementwiseRegisters.
+_FUSED_ELEMENTWISE_MAX_REGISTERS = 16
+
+
+def _is_fusable_tensor(val, shape=None) -> bool:
+    return (
+        isinstance(val, torch.Tensor)
+        and val.dtype == torch.float32
+        and val.is_contiguous()
+        and (shape is None or val.shape == shape)
+    )
+
+
+def _get_fused_elementwise_instruction(node: torch.fx.Node):
+    """
+    Returns the opcode and operands of node if it can be evaluated by
+    llama.fused_elementwise, None otherwise.
+    """
+    if node.op != "call_function":
+        return None
+    if node.target in _FUSED_ELEMENTWISE_UNARY_OPS:
+        if len(node.args) != 1 or node.kwargs:
+            return None
+        opcode = _FUSED_ELEMENTWISE_UNARY_OPS[node.target]
+        operands = [node.args[0]]
+    elif node.target in _FUSED_ELEMENTWISE_BINARY_OPS:
+        if len(node.args) != 2 or any(
+            k != "alpha" or v != 1 for k, v in node.kwargs.items()
+        ):
+            return None
+        opcode = _FUSED_ELEMENTWISE_BINARY_OPS[node.target]
+        operands = list(node.args)
+    elif node.target == torch.ops.aten.rsub.Scalar:
+        if len(node.args) != 2 or node.kwargs:
+            return None
+        # rsub(x, other) is other - x.
+        opcode = _FUSED_ELEMENTWISE_BINARY_OPS[torch.ops.aten.sub.Tensor]
+        operands = [node.args[1], node.args[0]]
+    else:
+        return None
+
+    val = node.meta.get("val")
+    if not _is_fusable_tensor(val):
+        return None
+    for operand in operands:
+        if isinstance(operand, torch.fx.Node):
+            # Broadcasting operands are not supported.
+            if not _is_fusable_tensor(operand.meta.get("val"), val.shape):
+                return None
+        elif isinstance(operand, bool) or not isinstance(operand, (int, float)):
+            return None
+    return opcode, operands
+
+
+class FuseElementwiseChains(ExportPass):
+    """
+    This pass fuses chains of float32 elementwise ops into a single
+    llama.fused_elementwise op, which evaluates the whole chain block by block
+    instead of writing every intermediate result to memory and reading it back.
+    For example:
+
+    node1 = torch.ops.aten.mul.Tensor(x, 2.0)
+    node2 = torch.ops.aten.add.Tensor(node1, y)
+    node3 = torch.ops.aten.relu.default(node2)
+
+    becomes torch.ops.llama.fused_elementwise([x, y], [2.0], program), which
+    reads x and y once and only writes the result of node3.
+
+    An op is only fused when all of its tensor operands have the shape of its
+    output, and a node is only fused into its user when it has no other users,
+    so that no intermediate result has to be materialized.
+    """
+
+    def __init__(self, min_ops=2):
+        super().__init__()
+        self.min_ops = min_ops
+
+    def call(self, graph_module: torch.fx.GraphModule):
+        from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+        graph = graph_module.graph
+        order = {node: i for i, node in enumerate(graph.nodes)}
+        instructions = {}
+        # Maps each fusable node to the nodes of the chain it belongs to, in
+        # graph order. The last node of a chain is the only one with users
+        # outside of it.
+        chains = {}
+        for node in graph.nodes:
+            instruction = _get_fused_elementwise_instruction(node)
+            if instruction is None:
+                continue
+            instructions[node] = instruction
+
+            chain = [node]
+            for operand in instruction[1]:
+                if (
+                    isinstance(operand, torch.fx.Node)
+                    and operand in chains
+                    and operand not in chain
+                    and len(operand.users) == 1
+                ):
+                    chain = chains[operand] + chain
+            chain.sort(key=order.__getitem__)
+            if (
+                self._num_scratch_registers(chain, instructions)
+                > _FUSED_ELEMENTWISE_MAX_REGISTERS
+            ):
+                chain = [node]
+            for member in chain:
+                chains[member] = chain
+
+        graph_changed = False
+        for node in list(graph.nodes):
+            chain = chains.get(node)
+            if chain is None or chain[-1] is not node or len(chain) < self.min_ops:
+                continue
+            self._fuse(graph, chain, instructions)
+            graph_changed = True
+
+        if graph_changed:
+            graph.eliminate_dead_code()
+            graph_module.recompile()
+
+        return PassResult(graph_module, graph_changed)
+
+    @staticmethod
+    def _num_scratch_registers(chain, instructions):
+        num_scalars = sum(
+            not isinstance(operand, torch.fx.Node)
+            for node in chain
+            for operand in instructions[node][1]
+        )
+        # The last instruction writes to the output.
+        return num_scalars + len(chain) - 1
+
+    @staticmethod
+    def _fuse(graph, chain, instructions):
+        members = set(chain)
+        inputs = []
+        scalars = []
+        for node in chain:
+            for operand in instructions[node][1]:
+                if not isinstance(operand, torch.fx.Node):
+                    scalars.append(float(operand))
+                elif operand not in members and operand not in inputs:
+                    inputs.append(operand)
+
+        registers = {node: i for i, node in enumerate(inputs)}
+        next_scalar_register = len(inputs)
+        program = []
+        for i, node in enumerate(chain):
+            opcode, operands = instructions[node]
+            operand_registers = [0, 0]
+            for j, operand in enumerate(operands):
+                if isinstance(operand, torch.fx.Node):
+                    operand_registers[j] = registers[operand]
+                else:
+                    operand_registers[j] = next_scalar_register
+                    next_scalar_register += 1
+            program += [opcode, *operand_registers]
+            registers[node] = len(inputs) + len(scalars) + i
+
+        output = chain[-1]
+        with graph.inserting_before(output):
+            fused = graph.call_function(
+                torch.ops.llama.fused_elementwise.default,
+                (inputs, scalars, program),
+            )
+        fused.meta = output.meta.copy()
+        output.replace_all_uses_with(fused)
+
+
 class ReplaceSDPAWithCustomSDPAPass(ExportPass):
     """
     This pass replaces aten.scaled_dot_product_attention.default with llama.custom_sdpa.default.
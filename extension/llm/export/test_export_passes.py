@@ -3,6 +3,7 @@ import unittest
 import torch
 
 from executorch.extension.llm.export.export_passes import (
+    FuseElementwiseChains,
     RemoveRedundantTransposes,
     ReplaceSDPAWithCustomSDPAPass,
 )
@@ -207,3 +208,81 @@ class ReplaceSDPAWithCustomSDPAPassTest(unittest.TestCase):
         m2 = torch.tril(torch.ones(32, 32, dtype=torch.bool), diagonal=-16)
         m = torch.logical_xor(m1, m2).view(1, 1, 32, 32)
         self._test((torch.rand(1, 4, 32, 64), m, False))
+
+
+class FuseElementwiseChainsTest(unittest.TestCase):
+    fused_key = "torch.ops.llama.fused_elementwise.default"
+
+    def setUp(self):
+        torch.manual_seed(0)
+
+    def _test(self, model, example_inputs, num_fused, remaining_ops=()):
+        gm = export(model, example_inputs, strict=True).module()
+        gm = FuseElementwiseChains()(gm).graph_module
+        FileCheck().check_count(self.fused_key, num_fused, exactly=True).run(
+            gm.code
+        )
+        for key, count in remaining_ops:
+            FileCheck().check_count(key, count, exactly=True).run(gm.code)
+
+        self.assertTrue(torch.allclose(model(*example_inputs), gm(*example_inputs)))
+
+    def test_chain_is_fused(self):
+        class TestModule(torch.nn.Module):
+            def forward(self, x, y):
+                return torch.relu(x * 2 + y) - 0.5
+
+        self._test(
+            TestModule(),
+            (torch.randn(2, 3, 4), torch.randn(2, 3, 4)),
+            1,
+            [("torch.ops.aten.relu.default", 0), ("torch.ops.aten.add.Tensor", 0)],
+        )
+
+    def test_swiglu_is_fused(self):
+        class TestModule(torch.nn.Module):
+            def forward(self, gate, up):
+                return torch.nn.functional.silu(gate) * up
+
+        self._test(
+            TestModule(),
+            (torch.randn(4, 64), torch.randn(4, 64)),
+            1,
+            [("torch.ops.aten.silu.default", 0), ("torch.ops.aten.mul.Tensor", 0)],
+        )
+
+    def test_rsub_and_unary_ops(self):
+        class TestModule(torch.nn.Module):
+            def forward(self, x):
+                return torch.rsqrt(1 - torch.sigmoid(x)) + torch.tanh(-x).exp()
+
+        self._test(TestModule(), (torch.randn(3, 5),), 1)
+
+    def test_broadcast_is_not_fused(self):
+        class TestModule(torch.nn.Module):
+            def forward(self, x, bias):
+                return torch.relu(x + bias)
+
+        self._test(
+            TestModule(),
+            (torch.randn(2, 3, 4), torch.randn(4)),
+            0,
+            [("torch.ops.aten.relu.default", 1), ("torch.ops.aten.add.Tensor", 1)],
+        )
+
+    def test_shared_intermediate_is_materialized(self):
+        class TestModule(torch.nn.Module):
+            def forward(self, x):
+                y = torch.exp(x)
+                return torch.relu(y + 1), y * 2
+
+        gm = export(TestModule(), (torch.randn(8),), strict=True).module()
+        gm = FuseElementwiseChains()(gm).graph_module
+        # exp has two users, so it is kept and only add + relu are fused.
+        FileCheck().check_count(self.fused_key, 1, exactly=True).run(gm.code)
+        FileCheck().check_count("torch.ops.aten.exp.default", 1, exactly=True).run(
+            gm.code
+        )
+        FileCheck().check_count("torch.ops.aten.mul.Tensor", 1, exactly=True).run(
+            gm.code
+        )
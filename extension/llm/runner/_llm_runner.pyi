@@ -32,6 +32,36 @@ class GenerationConfig:
     num_eos: int
     """Number of EOS tokens to add to the prompt."""
 
+    reuse_prompt_prefix: bool
+    """Whether to reuse the resident KV cache of a prompt prefix shared with an earlier generate() call."""
+
+    prefill_chunk_size: int
+    """Prompt tokens prefilled per model execution (0 for max_seq_len, -1 to pick the fastest size)."""
+
+    num_lookup_draft_tokens: int
+    """Maximum number of prompt lookup draft tokens verified per decode step (0 to disable)."""
+
+    lookup_ngram_size: int
+    """Longest n-gram of the last generated tokens looked up to draft tokens."""
+
+    top_p: float
+    """Nucleus sampling threshold, disabled when <= 0 or >= 1."""
+
+    top_k: int
+    """Sample only from the top_k most likely tokens, disabled when <= 0."""
+
+    repetition_penalty: float
+    """Divides positive and multiplies negative logits of seen tokens (1.0 to disable)."""
+
+    frequency_penalty: float
+    """Subtracted from the logit of a seen token once per occurrence."""
+
+    presence_penalty: float
+    """Subtracted from the logit of every seen token."""
+
+    seed: int
+    """Seed of the sampling RNG for this request (-1 to continue the runner's RNG stream)."""
+
     def __init__(
         self,
         *,
@@ -42,6 +72,16 @@ class GenerationConfig:
         temperature: float = 0.8,
         num_bos: int = 0,
         num_eos: int = 0,
+        reuse_prompt_prefix: bool = False,
+        prefill_chunk_size: int = 0,
+        num_lookup_draft_tokens: int = 0,
+        lookup_ngram_size: int = 3,
+        top_p: float = 0.9,
+        top_k: int = 0,
+        repetition_penalty: float = 1.0,
+        frequency_penalty: float = 0.0,
+        presence_penalty: float = 0.0,
+        seed: int = -1,
     ) -> None:
         """Initialize GenerationConfig with optional keyword arguments for all fields."""
         ...
@@ -63,6 +103,21 @@ class GenerationConfig:
 
     def __repr__(self) -> str: ...
 
+class PrefillChunkStats:
+    """Timing of one chunk of a prompt prefilled by the runner."""
+
+    start_pos: int
+    """Position in the KV cache of the first token of the chunk."""
+
+    num_tokens: int
+    """Number of prompt tokens in the chunk."""
+
+    start_ms: int
+    """Start time of the model execution for the chunk in milliseconds."""
+
+    end_ms: int
+    """End time of the model execution for the chunk in milliseconds."""
+
 class Stats:
     """Statistics for LLM generation performance."""
 
@@ -102,9 +157,24 @@ class Stats:
     num_prompt_tokens: int
     """Number of tokens in the input prompt."""
 
+    num_cached_prompt_tokens: int
+    """Number of prompt tokens reused from the KV cache instead of prefilled."""
+
     num_generated_tokens: int
     """Number of tokens generated."""
 
+    num_decode_steps: int
+    """Number of model executions to generate the tokens."""
+
+    num_draft_tokens: int
+    """Number of tokens drafted by prompt lookup decoding."""
+
+    num_accepted_draft_tokens: int
+    """Number of draft tokens that matched the model's samples and were kept."""
+
+    prefill_chunks: List[PrefillChunkStats]
+    """Timing of each chunk the prompt was prefilled in."""
+
     def on_sampling_begin(self) -> None:
         """Mark the beginning of a sampling operation."""
         ...
@@ -454,6 +524,19 @@ class MultimodalRunner:
         """Reset the runner state and KV cache."""
         ...
 
+    def set_encoder_cache_budget(self, max_bytes: int) -> None:
+        """
+        Cache encoder outputs of image and audio inputs across calls.
+
+        Inputs with the same content as a cached one skip their encoder. The
+        least recently used outputs are evicted once the cache exceeds the
+        budget.
+
+        Args:
+            max_bytes: Memory budget of the cache in bytes; 0 disables it
+        """
+        ...
+
     def get_vocab_size(self) -> int:
         """
         Get the vocabulary size of the model.
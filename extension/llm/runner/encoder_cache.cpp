@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/encoder_cache.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace executorch::extension::llm {
+namespace {
+
+constexpr uint64_t kMul0 = 0x9e3779b97f4a7c15ull;
+constexpr uint64_t kMul1 = 0xbf58476d1ce4e5b9ull;
+
+inline uint64_t rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// The murmur3 finalizer.
+inline uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+// The data of an image or audio input, and what it represents.
+struct InputContent {
+  uint64_t tag;
+  std::array<int32_t, 3> dims;
+  const uint8_t* data;
+  size_t nbytes;
+};
+
+template <typename T>
+InputContent make_content(
+    const std::vector<T>& data,
+    uint64_t tag,
+    std::array<int32_t, 3> dims) {
+  return {
+      tag,
+      dims,
+      reinterpret_cast<const uint8_t*>(data.data()),
+      data.size() * sizeof(T)};
+}
+
+std::optional<InputContent> input_content(const MultimodalInput& input) {
+  if (const Image* image = input.try_get_image()) {
+    const std::array<int32_t, 3> dims = {
+        image->channels(), image->height(), image->width()};
+    if (image->is_uint8()) {
+      return make_content(image->get_uint8_data(), 1, dims);
+    }
+    if (image->is_float()) {
+      return make_content(image->get_float_data(), 2, dims);
+    }
+  } else if (const Audio* audio = input.try_get_audio()) {
+    const std::array<int32_t, 3> dims = {
+        audio->get_batch_size(), audio->get_n_bins(), audio->get_n_frames()};
+    if (audio->is_uint8()) {
+      return make_content(audio->get_uint8_data(), 3, dims);
+    }
+    if (audio->is_float()) {
+      return make_content(audio->get_float_data(), 4, dims);
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+uint64_t EncoderCache::hash_bytes(
+    const void* data,
+    size_t size,
+    uint64_t seed) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  // Four independent lanes of 8 bytes keep the multiplies pipelined.
+  uint64_t h[4] = {
+      seed ^ kMul0, seed ^ kMul1, rotl(seed, 17) ^ kMul0, rotl(seed, 41)};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (int lane = 0; lane < 4; ++lane) {
+      uint64_t word;
+      std::memcpy(&word, bytes + i + 8 * lane, sizeof(word));
+      h[lane] = rotl(h[lane] ^ (word * kMul1), 31) * kMul0;
+    }
+  }
+  uint64_t result = static_cast<uint64_t>(size) * kMul0;
+  for (int lane = 0; lane < 4; ++lane) {
+    result = mix(result ^ h[lane]);
+  }
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    result = mix(result ^ word);
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, size - i);
+    result = mix(result ^ word);
+  }
+  return result;
+}
+
+std::optional<uint64_t> EncoderCache::key(const MultimodalInput& input) {
+  const auto content = input_content(input);
+  if (!content) {
+    return std::nullopt;
+  }
+  uint64_t seed = content->tag;
+  for (const int32_t dim : content->dims) {
+    seed = mix(seed ^ static_cast<uint64_t>(dim));
+  }
+  return hash_bytes(content->data, content->nbytes, seed);
+}
+
+TensorPtr EncoderCache::lookup(uint64_t key, const MultimodalInput& input) {
+  auto it = index_.find(key);
+  const auto content = input_content(input);
+  // Different inputs can share a hash, so compare the contents too.
+  if (it == index_.end() || !content ||
+      it->second->input_tag != content->tag ||
+      it->second->input_dims != content->dims ||
+      !std::equal(
+          it->second->input_data.begin(),
+          it->second->input_data.end(),
+          content->data,
+          content->data + content->nbytes)) {
+    ++num_misses_;
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  const Entry& entry = *it->second;
+  ++num_hits_;
+  time_saved_ms_ += entry.encode_time_ms;
+  auto data = entry.data;
+  void* ptr = data->data();
+  return from_blob(
+      ptr, entry.sizes, entry.dtype, [data = std::move(data)](void*) {});
+}
+
+void EncoderCache::insert(
+    uint64_t key,
+    const MultimodalInput& input,
+    const ::executorch::aten::Tensor& output,
+    long encode_time_ms) {
+  const auto content = input_content(input);
+  if (!content) {
+    return;
+  }
+  const size_t output_nbytes = output.nbytes();
+  const size_t nbytes = output_nbytes + content->nbytes;
+  if (nbytes > max_bytes_) {
+    return;
+  }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    size_bytes_ -= it->second->nbytes;
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  evict_to(max_bytes_ - nbytes);
+
+  const auto* bytes = output.const_data_ptr<uint8_t>();
+  entries_.push_front(
+      {key,
+       content->tag,
+       content->dims,
+       std::vector<uint8_t>(content->data, content->data + content->nbytes),
+       std::vector<::executorch::aten::SizesType>(
+           output.sizes().begin(), output.sizes().end()),
+       output.scalar_type(),
+       encode_time_ms,
+       std::make_shared<std::vector<uint8_t>>(bytes, bytes + output_nbytes),
+       nbytes});
+  index_[key] = entries_.begin();
+  size_bytes_ += nbytes;
+}
+
+void EncoderCache::clear() {
+  entries_.clear();
+  index_.clear();
+  size_bytes_ = 0;
+}
+
+void EncoderCache::set_max_bytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  evict_to(max_bytes);
+}
+
+void EncoderCache::evict_to(size_t max_bytes) {
+  while (size_bytes_ > max_bytes && !entries_.empty()) {
+    const Entry& entry = entries_.back();
+    size_bytes_ -= entry.nbytes;
+    index_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// An LRU cache of multimodal encoder outputs, keyed by the content of the
+// encoded image or audio.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/extension/llm/runner/multimodal_input.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * Keeps copies of encoder outputs so that an image or audio clip that is seen
+ * again, e.g. the same product photo in several prompts, is not encoded again.
+ *
+ * Entries are keyed by a 64-bit hash of the input's type, shape, dtype and
+ * data, and keep a copy of the input, which a hit must match exactly. They
+ * are evicted least recently used first once the total size of the outputs
+ * and inputs exceeds the memory budget. Not thread safe.
+ */
+class ET_EXPERIMENTAL EncoderCache {
+ public:
+  /**
+   * @param max_bytes The memory budget for the cached outputs and inputs.
+   * Entries larger than it are never cached.
+   */
+  explicit EncoderCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /**
+   * The cache key of an image or audio input, or std::nullopt for the other
+   * input types, which are cheap to encode.
+   */
+  static std::optional<uint64_t> key(const MultimodalInput& input);
+
+  /// 64-bit hash of `size` bytes at `data`, for content keys.
+  static uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0);
+
+  /**
+   * Returns the cached output of `input`, whose key() is `key`, and marks it
+   * as most recently used. The returned tensor keeps the cached data alive
+   * even if the entry is evicted meanwhile. Returns nullptr on a miss,
+   * including when another input with the same key is cached.
+   */
+  TensorPtr lookup(uint64_t key, const MultimodalInput& input);
+
+  /**
+   * Copies `output` and `input`, whose key() is `key`, into the cache,
+   * evicting the least recently used entries as needed.
+   * @param encode_time_ms How long computing `output` took, accumulated in
+   * time_saved_ms() by every later hit.
+   */
+  void insert(
+      uint64_t key,
+      const MultimodalInput& input,
+      const ::executorch::aten::Tensor& output,
+      long encode_time_ms = 0);
+
+  void clear();
+
+  /// Changes the memory budget, evicting entries that no longer fit.
+  void set_max_bytes(size_t max_bytes);
+
+  size_t max_bytes() const {
+    return max_bytes_;
+  }
+  size_t size_bytes() const {
+    return size_bytes_;
+  }
+  size_t num_entries() const {
+    return entries_.size();
+  }
+  int64_t num_hits() const {
+    return num_hits_;
+  }
+  int64_t num_misses() const {
+    return num_misses_;
+  }
+  /// The encoding time saved by hits, based on each entry's encode time.
+  long time_saved_ms() const {
+    return time_saved_ms_;
+  }
+
+ private:
+  struct Entry {
+    uint64_t key;
+    // The encoded input: its type and dtype, dimensions and bytes.
+    uint64_t input_tag;
+    std::array<int32_t, 3> input_dims;
+    std::vector<uint8_t> input_data;
+    std::vector<::executorch::aten::SizesType> sizes;
+    ::executorch::aten::ScalarType dtype;
+    long encode_time_ms;
+    // Shared with the tensors handed out by lookup().
+    std::shared_ptr<std::vector<uint8_t>> data;
+    // Size of the output and input data.
+    size_t nbytes;
+  };
+
+  void evict_to(size_t max_bytes);
+
+  size_t max_bytes_;
+  size_t size_bytes_ = 0;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  int64_t num_hits_ = 0;
+  int64_t num_misses_ = 0;
+  long time_saved_ms_ = 0;
+};
+
+} // namespace executorch::extension::llm
@@ -49,10 +49,52 @@ struct GenerationConfig {
   // Temperature for sampling (higher = more random)
   float temperature = 0.8f;
 
+  // Nucleus sampling threshold, disabled when <= 0 or >= 1
+  float top_p = 0.9f;
+
+  // Sample only from the top_k most likely tokens, disabled when <= 0
+  int32_t top_k = 0;
+
+  // Penalties for tokens that already occurred in the prompt or output.
+  // repetition_penalty divides positive logits and multiplies negative ones,
+  // frequency_penalty is subtracted once per occurrence and presence_penalty
+  // once per token.
+  float repetition_penalty = 1.0f;
+  float frequency_penalty = 0.0f;
+  float presence_penalty = 0.0f;
+
+  // Seed of the sampling RNG for this request, so that sampling at a nonzero
+  // temperature is reproducible. -1 continues the runner's RNG stream.
+  int64_t seed = -1;
+
   // Number of eos and bos to add to the prompt
   int32_t num_bos = 0;
   int32_t num_eos = 0;
 
+  // Whether to skip prefilling the longest prefix of the prompt whose KV cache
+  // entries are still resident from an earlier generate() call, e.g. a system
+  // prompt shared by conversations that are separated by reset(). Only valid
+  // for models whose KV cache keeps every position up to max_context_len,
+  // i.e. not for ring buffer (sliding window) caches.
+  bool reuse_prompt_prefix = false;
+
+  // Number of prompt tokens prefilled per model execution by models exported
+  // with a dynamic sequence length and a KV cache, clamped to max_seq_len.
+  // 0 uses max_seq_len. -1 times a few chunk sizes on the first prompt longer
+  // than max_seq_len and keeps the fastest one for later prompts.
+  int32_t prefill_chunk_size = 0;
+
+  // Prompt lookup decoding: draft up to this many tokens per decode step by
+  // looking up the last generated tokens in the prompt and output so far, and
+  // verify them in a single model execution. Speeds up outputs that copy from
+  // the prompt, e.g. summaries and code edits, without a draft model.
+  // Requires a model exported with a KV cache, dynamic shapes and full logits
+  // (generate_full_logits). 0 disables it.
+  int32_t num_lookup_draft_tokens = 0;
+  // The longest n-gram of the last generated tokens that is looked up to draft
+  // tokens.
+  int32_t lookup_ngram_size = 3;
+
   /**
    * Resolve the maximum number of new tokens to generate based on constraints.
    *
@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace executorch::extension::llm {
+
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::extension::Module;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'T', 'K', 'V'};
+constexpr uint32_t kVersion = 1;
+
+constexpr const char* kCacheNames[] = {
+    "k_cache",
+    "v_cache",
+    "k_cache_scales",
+    "v_cache_scales",
+    "k_cache_zero_points",
+    "v_cache_zero_points",
+};
+
+bool is_quantizable(ScalarType dtype) {
+  return dtype == ScalarType::Float || dtype == ScalarType::Half ||
+      dtype == ScalarType::BFloat16;
+}
+
+// Views a buffer as {outer, max_context_len, inner} around its position dim.
+struct BlockShape {
+  int64_t outer = 1;
+  int64_t seq_len = 0;
+  int64_t inner = 1;
+};
+
+BlockShape block_shape(const std::vector<int64_t>& sizes, int64_t seq_dim) {
+  BlockShape shape;
+  for (int64_t d = 0; d < static_cast<int64_t>(sizes.size()); ++d) {
+    if (d < seq_dim) {
+      shape.outer *= sizes[d];
+    } else if (d > seq_dim) {
+      shape.inner *= sizes[d];
+    }
+  }
+  shape.seq_len = sizes[seq_dim];
+  return shape;
+}
+
+std::vector<int64_t> sizes_of(const Tensor& tensor) {
+  return std::vector<int64_t>(tensor.sizes().begin(), tensor.sizes().end());
+}
+
+// Symmetric per-row quantization; rows of all zeros get a scale of 1.
+template <typename T>
+void quantize_rows(
+    const T* src,
+    int64_t num_rows,
+    int64_t row_size,
+    float* scales,
+    int8_t* dst) {
+  for (int64_t r = 0; r < num_rows; ++r) {
+    const T* row = src + r * row_size;
+    float absmax = 0.0f;
+    for (int64_t i = 0; i < row_size; ++i) {
+      absmax = std::max(absmax, std::fabs(static_cast<float>(row[i])));
+    }
+    const float scale = absmax == 0.0f ? 1.0f : absmax / 127.0f;
+    const float inv_scale = 1.0f / scale;
+    int8_t* out = dst + r * row_size;
+    for (int64_t i = 0; i < row_size; ++i) {
+      const float q = std::nearbyint(static_cast<float>(row[i]) * inv_scale);
+      out[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, q)));
+    }
+    scales[r] = scale;
+  }
+}
+
+template <typename T>
+void dequantize_rows(
+    const int8_t* src,
+    const float* scales,
+    int64_t num_rows,
+    int64_t row_size,
+    T* dst) {
+  for (int64_t r = 0; r < num_rows; ++r) {
+    const float scale = scales[r];
+    const int8_t* row = src + r * row_size;
+    T* out = dst + r * row_size;
+    for (int64_t i = 0; i < row_size; ++i) {
+      out[i] = static_cast<T>(static_cast<float>(row[i]) * scale);
+    }
+  }
+}
+
+// Calls fn with a null pointer of the C type of a quantizable dtype.
+template <typename Fn>
+void switch_quantizable_type(ScalarType dtype, Fn&& fn) {
+  switch (dtype) {
+    case ScalarType::Float:
+      fn(static_cast<float*>(nullptr));
+      break;
+    case ScalarType::Half:
+      fn(static_cast<::executorch::aten::Half*>(nullptr));
+      break;
+    case ScalarType::BFloat16:
+      fn(static_cast<::executorch::aten::BFloat16*>(nullptr));
+      break;
+    default:
+      ET_CHECK_MSG(false, "Unsupported dtype %d", static_cast<int>(dtype));
+  }
+}
+
+template <typename T>
+void write_pod(std::vector<uint8_t>& out, const T& value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void write_bytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+// Bounds checked reads from a serialized snapshot.
+class Reader {
+ public:
+  Reader(const void* data, size_t size)
+      : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+  bool read_bytes(void* dst, size_t size) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    if (size > 0) {
+      std::memcpy(dst, data_ + offset_, size);
+    }
+    offset_ += size;
+    return true;
+  }
+
+  template <typename T>
+  bool read_pod(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return read_bytes(&value, sizeof(T));
+  }
+
+  size_t remaining() const {
+    return size_ - offset_;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+} // namespace
+
+Result<std::vector<KVCacheBuffer>> find_kv_cache_buffers(
+    Module& module,
+    const std::string& method_name,
+    int64_t max_context_len) {
+  std::vector<KVCacheBuffer> buffers;
+  for (int64_t layer = 0;; ++layer) {
+    const size_t num_buffers = buffers.size();
+    for (const char* cache_name : kCacheNames) {
+      std::string name = "layers." + std::to_string(layer) +
+          ".attention.kv_cache." + cache_name;
+      auto tensor = module.get_attribute(method_name, name);
+      if (tensor.error() == Error::NotFound) {
+        continue;
+      }
+      ET_CHECK_OK_OR_RETURN_ERROR(tensor.error());
+      int64_t seq_dim = -1;
+      for (int64_t d = 1; d < tensor->dim(); ++d) {
+        if (tensor->size(d) == max_context_len) {
+          seq_dim = d;
+          break;
+        }
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          seq_dim >= 0,
+          InvalidArgument,
+          "KV cache buffer %s has no dim of size max_context_len %" PRId64,
+          name.c_str(),
+          max_context_len);
+      buffers.push_back({std::move(name), *tensor, seq_dim});
+    }
+    if (buffers.size() == num_buffers) {
+      break;
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      !buffers.empty(),
+      NotFound,
+      "No KV cache buffers found; export the model with "
+      "emit_mutable_buffer_names=True");
+  return buffers;
+}
+
+Result<KVCacheSnapshot> KVCacheSnapshot::capture(
+    const std::vector<KVCacheBuffer>& buffers,
+    int64_t num_positions,
+    std::vector<uint64_t> tokens,
+    bool quantize_int8) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_positions >= 0,
+      InvalidArgument,
+      "num_positions %" PRId64 " must be non-negative",
+      num_positions);
+  ET_CHECK_OR_RETURN_ERROR(
+      tokens.empty() || static_cast<int64_t>(tokens.size()) == num_positions,
+      InvalidArgument,
+      "Got %zu tokens for %" PRId64 " positions",
+      tokens.size(),
+      num_positions);
+
+  KVCacheSnapshot snapshot;
+  snapshot.num_positions_ = num_positions;
+  snapshot.tokens_ = std::move(tokens);
+  snapshot.entries_.reserve(buffers.size());
+
+  for (const auto& buffer : buffers) {
+    const Tensor& tensor = buffer.tensor;
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer.seq_dim >= 0 && buffer.seq_dim < tensor.dim() &&
+            num_positions <= tensor.size(buffer.seq_dim),
+        InvalidArgument,
+        "Can't capture %" PRId64 " positions of %s",
+        num_positions,
+        buffer.name.c_str());
+
+    Entry entry;
+    entry.name = buffer.name;
+    entry.dtype = tensor.scalar_type();
+    entry.seq_dim = buffer.seq_dim;
+    entry.sizes = sizes_of(tensor);
+
+    const BlockShape shape = block_shape(entry.sizes, entry.seq_dim);
+    const size_t element_size = tensor.element_size();
+    const int64_t block_numel = num_positions * shape.inner;
+    const char* src = tensor.const_data_ptr<char>();
+
+    if (quantize_int8 && is_quantizable(entry.dtype)) {
+      // Positions [0, num_positions) are contiguous within every outer block.
+      const int64_t rows_per_block = num_positions;
+      entry.scales.resize(shape.outer * rows_per_block);
+      entry.data.resize(shape.outer * block_numel);
+      switch_quantizable_type(entry.dtype, [&](auto* type_tag) {
+        using CTYPE = std::remove_pointer_t<decltype(type_tag)>;
+        for (int64_t o = 0; o < shape.outer; ++o) {
+          quantize_rows(
+              reinterpret_cast<const CTYPE*>(src) +
+                  o * shape.seq_len * shape.inner,
+              rows_per_block,
+              shape.inner,
+              entry.scales.data() + o * rows_per_block,
+              reinterpret_cast<int8_t*>(entry.data.data()) + o * block_numel);
+        }
+      });
+    } else {
+      const size_t block_nbytes = block_numel * element_size;
+      entry.data.resize(shape.outer * block_nbytes);
+      for (int64_t o = 0; o < shape.outer; ++o) {
+        std::memcpy(
+            entry.data.data() + o * block_nbytes,
+            src + o * shape.seq_len * shape.inner * element_size,
+            block_nbytes);
+      }
+    }
+    snapshot.entries_.push_back(std::move(entry));
+  }
+  return snapshot;
+}
+
+Error KVCacheSnapshot::restore(const std::vector<KVCacheBuffer>& buffers) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      buffers.size() == entries_.size(),
+      InvalidArgument,
+      "Snapshot has %zu buffers, got %zu",
+      entries_.size(),
+      buffers.size());
+
+  // Validate everything up front so that a mismatch leaves the cache intact.
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    const KVCacheBuffer& buffer = buffers[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer.name == entry.name && buffer.seq_dim == entry.seq_dim &&
+            buffer.tensor.scalar_type() == entry.dtype &&
+            sizes_of(buffer.tensor) == entry.sizes,
+        InvalidArgument,
+        "Buffer %s doesn't match snapshot buffer %s",
+        buffer.name.c_str(),
+        entry.name.c_str());
+  }
+
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    Tensor tensor = buffers[i].tensor;
+    const BlockShape shape = block_shape(entry.sizes, entry.seq_dim);
+    const size_t element_size = tensor.element_size();
+    const int64_t block_numel = num_positions_ * shape.inner;
+    char* dst = tensor.mutable_data_ptr<char>();
+
+    if (!entry.scales.empty()) {
+      switch_quantizable_type(entry.dtype, [&](auto* type_tag) {
+        using CTYPE = std::remove_pointer_t<decltype(type_tag)>;
+        for (int64_t o = 0; o < shape.outer; ++o) {
+          dequantize_rows(
+              reinterpret_cast<const int8_t*>(entry.data.data()) +
+                  o * block_numel,
+              entry.scales.data() + o * num_positions_,
+              num_positions_,
+              shape.inner,
+              reinterpret_cast<CTYPE*>(dst) + o * shape.seq_len * shape.inner);
+        }
+      });
+    } else {
+      const size_t block_nbytes = block_numel * element_size;
+      for (int64_t o = 0; o < shape.outer; ++o) {
+        std::memcpy(
+            dst + o * shape.seq_len * shape.inner * element_size,
+            entry.data.data() + o * block_nbytes,
+            block_nbytes);
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+size_t KVCacheSnapshot::nbytes() const {
+  size_t total = 0;
+  for (const auto& entry : entries_) {
+    total += entry.data.size() + entry.scales.size() * sizeof(float);
+  }
+  return total;
+}
+
+// Layout, in host byte order:
+//   magic[4] version:u32 num_positions:i64 num_tokens:u64 tokens:u64[]
+//   num_entries:u32, then per entry:
+//     name_len:u32 name[] dtype:i8 seq_dim:i64 ndim:u32 sizes:i64[]
+//     num_scales:u64 scales:f32[] data_nbytes:u64 data[]
+std::vector<uint8_t> KVCacheSnapshot::serialize() const {
+  std::vector<uint8_t> out;
+  out.reserve(nbytes() + 256);
+  write_bytes(out, kMagic, sizeof(kMagic));
+  write_pod(out, kVersion);
+  write_pod(out, num_positions_);
+  write_pod(out, static_cast<uint64_t>(tokens_.size()));
+  write_bytes(out, tokens_.data(), tokens_.size() * sizeof(uint64_t));
+  write_pod(out, static_cast<uint32_t>(entries_.size()));
+  for (const auto& entry : entries_) {
+    write_pod(out, static_cast<uint32_t>(entry.name.size()));
+    write_bytes(out, entry.name.data(), entry.name.size());
+    write_pod(out, static_cast<int8_t>(entry.dtype));
+    write_pod(out, entry.seq_dim);
+    write_pod(out, static_cast<uint32_t>(entry.sizes.size()));
+    write_bytes(out, entry.sizes.data(), entry.sizes.size() * sizeof(int64_t));
+    write_pod(out, static_cast<uint64_t>(entry.scales.size()));
+    write_bytes(out, entry.scales.data(), entry.scales.size() * sizeof(float));
+    write_pod(out, static_cast<uint64_t>(entry.data.size()));
+    write_bytes(out, entry.data.data(), entry.data.size());
+  }
+  return out;
+}
+
+Result<KVCacheSnapshot> KVCacheSnapshot::deserialize(
+    const void* data,
+    size_t size) {
+  Reader reader(data, size);
+  char magic[sizeof(kMagic)];
+  uint32_t version = 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read_bytes(magic, sizeof(magic)) &&
+          std::memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+          reader.read_pod(version) && version == kVersion,
+      InvalidProgram,
+      "Not a KV cache snapshot, or an unsupported version");
+
+  KVCacheSnapshot snapshot;
+  uint64_t num_tokens = 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read_pod(snapshot.num_positions_) &&
+          snapshot.num_positions_ >= 0 && reader.read_pod(num_tokens) &&
+          num_tokens <= reader.remaining() / sizeof(uint64_t),
+      InvalidProgram,
+      "Truncated KV cache snapshot header");
+  snapshot.tokens_.resize(num_tokens);
+  reader.read_bytes(snapshot.tokens_.data(), num_tokens * sizeof(uint64_t));
+
+  uint32_t num_entries = 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read_pod(num_entries),
+      InvalidProgram,
+      "Truncated KV cache snapshot header");
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    Entry entry;
+    uint32_t name_len = 0;
+    int8_t dtype = 0;
+    uint32_t ndim = 0;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_pod(name_len) && name_len <= reader.remaining(),
+        InvalidProgram,
+        "Truncated KV cache snapshot entry %" PRIu32,
+        i);
+    entry.name.resize(name_len);
+    reader.read_bytes(entry.name.data(), name_len);
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_pod(dtype) && reader.read_pod(entry.seq_dim) &&
+            reader.read_pod(ndim) && entry.seq_dim >= 0 &&
+            entry.seq_dim < static_cast<int64_t>(ndim) &&
+            ndim <= reader.remaining() / sizeof(int64_t),
+        InvalidProgram,
+        "Truncated KV cache snapshot entry %" PRIu32,
+        i);
+    entry.dtype = static_cast<ScalarType>(dtype);
+    entry.sizes.resize(ndim);
+    reader.read_bytes(entry.sizes.data(), ndim * sizeof(int64_t));
+
+    uint64_t num_scales = 0;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_pod(num_scales) &&
+            num_scales <= reader.remaining() / sizeof(float),
+        InvalidProgram,
+        "Truncated KV cache snapshot entry %" PRIu32,
+        i);
+    entry.scales.resize(num_scales);
+    reader.read_bytes(entry.scales.data(), num_scales * sizeof(float));
+
+    uint64_t data_nbytes = 0;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_pod(data_nbytes) && data_nbytes <= reader.remaining(),
+        InvalidProgram,
+        "Truncated KV cache snapshot entry %" PRIu32,
+        i);
+    entry.data.resize(data_nbytes);
+    reader.read_bytes(entry.data.data(), data_nbytes);
+
+    // Make sure restore() never reads or writes out of bounds.
+    ET_CHECK_OR_RETURN_ERROR(
+        ::executorch::runtime::isValid(entry.dtype),
+        InvalidProgram,
+        "Invalid dtype %d in KV cache snapshot",
+        static_cast<int>(dtype));
+    const BlockShape shape = block_shape(entry.sizes, entry.seq_dim);
+    const uint64_t numel =
+        shape.outer * snapshot.num_positions_ * shape.inner;
+    const bool quantized = num_scales > 0;
+    ET_CHECK_OR_RETURN_ERROR(
+        snapshot.num_positions_ <= shape.seq_len &&
+            (!quantized || is_quantizable(entry.dtype)) &&
+            (!quantized ||
+             num_scales == static_cast<uint64_t>(
+                               shape.outer * snapshot.num_positions_)) &&
+            data_nbytes ==
+                numel *
+                    (quantized
+                         ? 1
+                         : ::executorch::runtime::elementSize(entry.dtype)),
+        InvalidProgram,
+        "Inconsistent KV cache snapshot entry %s",
+        entry.name.c_str());
+    snapshot.entries_.push_back(std::move(entry));
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      snapshot.tokens_.empty() ||
+          static_cast<int64_t>(snapshot.tokens_.size()) ==
+              snapshot.num_positions_,
+      InvalidProgram,
+      "KV cache snapshot has %zu tokens for %" PRId64 " positions",
+      snapshot.tokens_.size(),
+      snapshot.num_positions_);
+  return snapshot;
+}
+
+Error KVCacheSnapshot::save(const std::string& path) const {
+  const std::vector<uint8_t> blob = serialize();
+  std::unique_ptr<FILE, decltype(&fclose)> file(
+      fopen(path.c_str(), "wb"), &fclose);
+  ET_CHECK_OR_RETURN_ERROR(
+      file != nullptr, AccessFailed, "Failed to open %s", path.c_str());
+  ET_CHECK_OR_RETURN_ERROR(
+      fwrite(blob.data(), 1, blob.size(), file.get()) == blob.size(),
+      AccessFailed,
+      "Failed to write %s",
+      path.c_str());
+  return Error::Ok;
+}
+
+Result<KVCacheSnapshot> KVCacheSnapshot::load(const std::string& path) {
+  std::unique_ptr<FILE, decltype(&fclose)> file(
+      fopen(path.c_str(), "rb"), &fclose);
+  ET_CHECK_OR_RETURN_ERROR(
+      file != nullptr, AccessFailed, "Failed to open %s", path.c_str());
+  ET_CHECK_OR_RETURN_ERROR(
+      fseek(file.get(), 0, SEEK_END) == 0,
+      AccessFailed,
+      "Failed to seek %s",
+      path.c_str());
+  const long size = ftell(file.get());
+  ET_CHECK_OR_RETURN_ERROR(
+      size >= 0 && fseek(file.get(), 0, SEEK_SET) == 0,
+      AccessFailed,
+      "Failed to seek %s",
+      path.c_str());
+  std::vector<uint8_t> blob(size);
+  ET_CHECK_OR_RETURN_ERROR(
+      fread(blob.data(), 1, blob.size(), file.get()) == blob.size(),
+      AccessFailed,
+      "Failed to read %s",
+      path.c_str());
+  return deserialize(blob.data(), blob.size());
+}
+
+} // namespace executorch::extension::llm
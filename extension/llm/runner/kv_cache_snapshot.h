@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Snapshots of the KV cache mutable buffers of a loaded Method, so that a
+// session can be evicted and later resumed without prefilling it again.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * A KV cache buffer of a loaded method and the dim of it that is indexed by
+ * the cache position.
+ */
+struct ET_EXPERIMENTAL KVCacheBuffer {
+  std::string name;
+  ::executorch::aten::Tensor tensor;
+  int64_t seq_dim;
+};
+
+/**
+ * Finds the KV cache buffers of the method `method_name` of `module`, i.e. the
+ * mutable buffers named
+ * "layers.{i}.attention.kv_cache.{k,v}_cache" (plus the "_scales" and
+ * "_zero_points" buffers of a quantized cache) that update_cache writes. The
+ * model must have been exported with
+ * ExecutorchBackendConfig(emit_mutable_buffer_names=True).
+ *
+ * The position dim of each buffer is the first dim after the batch dim whose
+ * size is `max_context_len`.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Result<std::vector<KVCacheBuffer>>
+find_kv_cache_buffers(
+    Module& module,
+    const std::string& method_name,
+    int64_t max_context_len);
+
+/**
+ * A copy of positions [0, num_positions) of a set of KV cache buffers.
+ *
+ * Floating point buffers can optionally be stored as int8 with one float
+ * scale per position of every row, which quarters the size of a float cache.
+ * Buffers of any other dtype, e.g. an already quantized cache, are always
+ * stored as is.
+ *
+ * The cache is assumed to be written linearly, i.e. the entry for position p
+ * lives at index p of the position dim. Ring buffer caches are not supported.
+ */
+class ET_EXPERIMENTAL KVCacheSnapshot {
+ public:
+  KVCacheSnapshot() = default;
+
+  /**
+   * Copies positions [0, num_positions) of every buffer.
+   *
+   * @param buffers The buffers to copy, e.g. from find_kv_cache_buffers().
+   * @param num_positions The number of filled cache positions.
+   * @param tokens The tokens that the cache entries were computed for, if
+   * known. Stored alongside the cache for the caller's bookkeeping.
+   * @param quantize_int8 Whether to store floating point buffers as int8.
+   */
+  static ::executorch::runtime::Result<KVCacheSnapshot> capture(
+      const std::vector<KVCacheBuffer>& buffers,
+      int64_t num_positions,
+      std::vector<uint64_t> tokens = {},
+      bool quantize_int8 = false);
+
+  /**
+   * Writes the snapshot back into positions [0, num_positions()) of
+   * `buffers`, which must have the same names, dtypes and shapes as the
+   * buffers it was captured from. Entries at later positions are left
+   * untouched.
+   */
+  ::executorch::runtime::Error restore(
+      const std::vector<KVCacheBuffer>& buffers) const;
+
+  /// Serializes the snapshot into a self-describing byte blob.
+  std::vector<uint8_t> serialize() const;
+
+  /// Parses a blob produced by serialize().
+  static ::executorch::runtime::Result<KVCacheSnapshot> deserialize(
+      const void* data,
+      size_t size);
+
+  /// Serializes the snapshot into the file at `path`.
+  ::executorch::runtime::Error save(const std::string& path) const;
+
+  /// Loads a snapshot saved with save().
+  static ::executorch::runtime::Result<KVCacheSnapshot> load(
+      const std::string& path);
+
+  int64_t num_positions() const {
+    return num_positions_;
+  }
+
+  const std::vector<uint64_t>& tokens() const {
+    return tokens_;
+  }
+
+  /// The number of bytes of cache data held, excluding metadata.
+  size_t nbytes() const;
+
+ private:
+  struct Entry {
+    std::string name;
+    ::executorch::aten::ScalarType dtype;
+    int64_t seq_dim;
+    std::vector<int64_t> sizes;
+    // One scale per row of trailing elements when quantized, else empty.
+    std::vector<float> scales;
+    std::vector<uint8_t> data;
+  };
+
+  int64_t num_positions_ = 0;
+  std::vector<uint64_t> tokens_;
+  std::vector<Entry> entries_;
+};
+
+} // namespace executorch::extension::llm
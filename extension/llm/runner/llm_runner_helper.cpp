@@ -218,15 +218,17 @@ std::unique_ptr<TextLLMRunner> create_text_llm_runner(
   auto text_decoder_runner =
       std::make_unique<TextDecoderRunner>(module.get(), io_manager.get());
 
-  // Create text_prefiller
+  auto stats = std::make_unique<Stats>();
+
+  // Create text_prefiller with stats
   auto text_prefiller = std::make_unique<TextPrefiller>(
       text_decoder_runner.get(),
       metadata.at(kUseKVCache),
       metadata.at(kEnableDynamicShape),
-      metadata.at(kMaxSeqLen));
+      metadata.at(kMaxSeqLen),
+      stats.get());
 
   // Create text_token_generator with stats
-  auto stats = std::make_unique<Stats>();
   auto text_token_generator = std::make_unique<TextTokenGenerator>(
       tokenizer.get(),
       text_decoder_runner.get(),
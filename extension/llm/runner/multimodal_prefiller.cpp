@@ -14,6 +14,7 @@
 #include <executorch/extension/llm/runner/multimodal_prefiller.h>
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace executorch::extension::llm {
 
@@ -37,10 +38,72 @@ MultimodalPrefiller::MultimodalPrefiller(
 Result<uint64_t> MultimodalPrefiller::prefill(
     const MultimodalInput& input,
     int64_t& start_pos) {
-  // 1. Run encoder model.
+  std::optional<uint64_t> cache_key;
+  if (encoder_cache_) {
+    cache_key = EncoderCache::key(input);
+  }
+  return prefill_input(input, cache_key, start_pos);
+}
+
+Result<uint64_t> MultimodalPrefiller::prefill(
+    const std::vector<MultimodalInput>& inputs,
+    int64_t& start_pos) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !inputs.empty(), InvalidArgument, "No multimodal inputs to prefill");
+  std::vector<std::optional<uint64_t>> cache_keys(inputs.size());
+  if (encoder_cache_) {
+    // Hashing a large image is a pass over all of its pixels, so spread the
+    // inputs over the threadpool. The encoders themselves run one at a time,
+    // as they share the Module and already use the threadpool internally.
+    ::executorch::extension::parallel_for(
+        0, inputs.size(), 1, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            cache_keys[i] = EncoderCache::key(inputs[i]);
+          }
+        });
+  }
+  uint64_t next_token = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    ET_LOG(
+        Info,
+        "Prefilling input %zu/%zu, type: %s",
+        i,
+        inputs.size(),
+        inputs[i].type_name());
+    next_token = ET_UNWRAP(prefill_input(inputs[i], cache_keys[i], start_pos));
+  }
+  return next_token;
+}
+
+void MultimodalPrefiller::set_encoder_cache_budget(size_t max_bytes) {
+  if (max_bytes == 0) {
+    encoder_cache_.reset();
+  } else if (encoder_cache_) {
+    encoder_cache_->set_max_bytes(max_bytes);
+  } else {
+    encoder_cache_ = std::make_unique<EncoderCache>(max_bytes);
+  }
+}
+
+Result<uint64_t> MultimodalPrefiller::prefill_input(
+    const MultimodalInput& input,
+    const std::optional<uint64_t>& cache_key,
+    int64_t& start_pos) {
+  // 1. Run encoder model, unless its output for the same input is cached.
   ::executorch::runtime::EValue encoder_output;
-  if (input.is_image()) {
-    Image image = input.get_image();
+  TensorPtr cached_output;
+  if (cache_key) {
+    cached_output = encoder_cache_->lookup(*cache_key, input);
+  }
+  const long encode_start_ms = time_in_ms();
+  if (cached_output) {
+    ET_LOG(
+        Info,
+        "Reusing the cached encoder output of the %s input",
+        input.type_name());
+    encoder_output = *cached_output;
+  } else if (input.is_image()) {
+    const Image& image = input.get_image();
 
     auto method_meta = ET_UNWRAP(
         module_->method_meta(kVisionEncoderMethod),
@@ -91,7 +154,7 @@ Result<uint64_t> MultimodalPrefiller::prefill(
 
     encoder_output = image_encoder_outputs[0];
   } else if (input.is_audio()) {
-    Audio audio = input.get_audio();
+    const Audio& audio = input.get_audio();
 
     // Use Audio::toTensor() for tensor creation
     auto audio_tensor =
@@ -135,6 +198,16 @@ Result<uint64_t> MultimodalPrefiller::prefill(
     return ::executorch::runtime::Error::NotSupported;
   }
 
+  if (cache_key && !cached_output) {
+    // Copy the output now, as the next execution of the encoder reuses its
+    // memory.
+    encoder_cache_->insert(
+        *cache_key,
+        input,
+        encoder_output.toTensor(),
+        time_in_ms() - encode_start_ms);
+  }
+
   // 2. Run decoder model for prefill.
 
   // Get expected shape of cache position tensor, which should be the second
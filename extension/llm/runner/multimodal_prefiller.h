@@ -11,6 +11,11 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <executorch/extension/llm/runner/encoder_cache.h>
 #include <executorch/extension/llm/runner/multimodal_decoder_runner.h>
 #include <executorch/extension/llm/runner/multimodal_input.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
@@ -46,6 +51,30 @@ class ET_EXPERIMENTAL MultimodalPrefiller {
       const MultimodalInput& input,
       int64_t& start_pos);
 
+  /**
+   * Prefill an LLM Module with the given multimodal inputs, in order. With an
+   * encoder cache, the cache keys of all inputs are hashed in parallel first.
+   * @param inputs The multimodal inputs to the multimodal LLM.
+   * @param start_pos The starting position in KV cache of the first input.
+   * It's passed as reference and will be updated inside this function.
+   * @return The next token of the LLM Module after prefilling the last input.
+   */
+  virtual Result<uint64_t> prefill(
+      const std::vector<MultimodalInput>& inputs,
+      int64_t& start_pos);
+
+  /**
+   * Cache up to `max_bytes` of image and audio encoder outputs and their
+   * inputs, so that inputs seen before skip their encoder. 0, the default,
+   * disables the cache.
+   */
+  void set_encoder_cache_budget(size_t max_bytes);
+
+  /// The encoder output cache, or nullptr if it is disabled.
+  const EncoderCache* encoder_cache() const {
+    return encoder_cache_.get();
+  }
+
   virtual Error load();
   virtual bool is_method_loaded();
 
@@ -56,6 +85,13 @@ class ET_EXPERIMENTAL MultimodalPrefiller {
   MultimodalDecoderRunner* text_decoder_runner_;
   Tokenizer* tokenizer_;
   IOManager* io_manager_;
+  std::unique_ptr<EncoderCache> encoder_cache_;
+
+ private:
+  Result<uint64_t> prefill_input(
+      const MultimodalInput& input,
+      const std::optional<uint64_t>& cache_key,
+      int64_t& start_pos);
 };
 
 } // namespace executorch::extension::llm
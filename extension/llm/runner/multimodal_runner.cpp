@@ -71,8 +71,8 @@ Error MultimodalRunner::prefill(const std::vector<MultimodalInput>& inputs) {
   if (!is_loaded()) {
     ET_CHECK_OK_OR_RETURN_ERROR(load());
   }
-  for (auto& input : inputs) {
-    ET_UNWRAP(multimodal_prefiller_->prefill(input, pos_));
+  if (!inputs.empty()) {
+    ET_UNWRAP(multimodal_prefiller_->prefill(inputs, pos_));
   }
   return Error::Ok;
 }
@@ -127,20 +127,22 @@ Error MultimodalRunner::generate(
   // Reset internal state and start inference
   stats_->inference_start_ms = time_in_ms();
 
-  uint64_t prefill_next_token = 0;
+  if (config.echo && inputs.back().is_text()) {
+    wrapped_callback(inputs.back().get_text());
+  }
   // Process multimodal inputs in order
-  for (size_t i = 0; i < inputs.size(); ++i) {
-    const MultimodalInput& input = inputs[i];
-    ET_LOG(
-        Info,
-        "Prefilling input %zu/%zu, type: %s",
-        i,
-        inputs.size(),
-        input.type_name());
-    if (config.echo && i == inputs.size() - 1 && input.is_text()) {
-      wrapped_callback(input.get_text());
-    }
-    prefill_next_token = ET_UNWRAP(multimodal_prefiller_->prefill(input, pos_));
+  uint64_t prefill_next_token =
+      ET_UNWRAP(multimodal_prefiller_->prefill(inputs, pos_));
+  if (const EncoderCache* cache = multimodal_prefiller_->encoder_cache()) {
+    RUNNER_ET_LOG(
+        config.warming,
+        "Encoder cache: %" PRId64 " hits, %" PRId64
+        " misses, %ld ms of encoding saved, %zu entries using %zu bytes",
+        cache->num_hits(),
+        cache->num_misses(),
+        cache->time_saved_ms(),
+        cache->num_entries(),
+        cache->size_bytes());
   }
 
   stats_->first_token_ms = time_in_ms();
@@ -152,6 +152,23 @@ class ET_EXPERIMENTAL MultimodalRunner {
   virtual ::executorch::runtime::Error prefill(
       std::vector<MultimodalInput>&& inputs);
 
+  /**
+   * Cache up to `max_bytes` of image and audio encoder outputs, along with
+   * their inputs, across generate() and prefill() calls, so that images or
+   * audio clips seen before are not encoded again. 0 disables the cache.
+   */
+  void set_encoder_cache_budget(size_t max_bytes) {
+    multimodal_prefiller_->set_encoder_cache_budget(max_bytes);
+  }
+
+  /**
+   * Decode the generated tokens and call the token callback on a separate
+   * output thread, see TextTokenGenerator::set_async_output().
+   */
+  void set_async_output(bool async_output) {
+    text_token_generator_->set_async_output(async_output);
+  }
+
   inline void stop() {
     text_token_generator_->stop();
   }
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/prompt_lookup.h>
+
+#include <algorithm>
+
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch::extension::llm {
+
+PromptLookupDrafter::PromptLookupDrafter(
+    int32_t max_ngram_size,
+    int32_t min_ngram_size)
+    : max_ngram_size_(max_ngram_size), min_ngram_size_(min_ngram_size) {
+  ET_CHECK_MSG(
+      min_ngram_size >= 1 && max_ngram_size >= min_ngram_size,
+      "Invalid n-gram sizes [%d, %d]",
+      min_ngram_size,
+      max_ngram_size);
+  indices_.resize(max_ngram_size - min_ngram_size + 1);
+}
+
+uint64_t PromptLookupDrafter::hash(size_t end, int32_t n) const {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (size_t i = end - n; i < end; ++i) {
+    h = (h ^ history_[i]) * 0x100000001b3ull;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+void PromptLookupDrafter::reset(const std::vector<uint64_t>& tokens) {
+  history_.clear();
+  history_.reserve(tokens.size());
+  for (auto& index : indices_) {
+    index.clear();
+  }
+  for (const uint64_t token : tokens) {
+    append(token);
+  }
+}
+
+void PromptLookupDrafter::append(uint64_t token) {
+  // The n-grams that end with the current last token are now followed by
+  // `token`.
+  const size_t end = history_.size();
+  for (int32_t n = min_ngram_size_;
+       n <= max_ngram_size_ && static_cast<size_t>(n) <= end;
+       ++n) {
+    indices_[n - min_ngram_size_][hash(end, n)] = end;
+  }
+  history_.push_back(token);
+}
+
+void PromptLookupDrafter::draft(
+    int32_t max_tokens,
+    std::vector<uint64_t>& draft) const {
+  draft.clear();
+  if (max_tokens <= 0) {
+    return;
+  }
+  const size_t end = history_.size();
+  for (int32_t n = std::min<int64_t>(max_ngram_size_, end);
+       n >= min_ngram_size_;
+       --n) {
+    const auto& index = indices_[n - min_ngram_size_];
+    auto it = index.find(hash(end, n));
+    if (it == index.end()) {
+      continue;
+    }
+    const size_t next = it->second;
+    // Rule out hash collisions.
+    if (!std::equal(
+            history_.begin() + (next - n),
+            history_.begin() + next,
+            history_.begin() + (end - n))) {
+      continue;
+    }
+    const size_t count = std::min<size_t>(max_tokens, end - next);
+    draft.assign(history_.begin() + next, history_.begin() + next + count);
+    return;
+  }
+}
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Draft tokens for prompt lookup decoding, a draft model free form of
+// speculative decoding.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * Proposes the tokens that are likely to come next by looking up the last
+ * tokens generated in the prompt and the output so far: if they occurred
+ * before, the tokens that followed them then are proposed. This works well
+ * when the output copies from the prompt, as in summarization, code editing
+ * or retrieval augmented answers.
+ *
+ * The latest occurrence of every n-gram of 1 to max_ngram_size tokens is
+ * indexed as tokens are appended, so drafting costs a few hash lookups and
+ * doesn't scan the history.
+ */
+class ET_EXPERIMENTAL PromptLookupDrafter {
+ public:
+  /**
+   * @param max_ngram_size The longest suffix of the history that is looked
+   * up. Longer matches are tried first.
+   * @param min_ngram_size The shortest suffix that is looked up.
+   */
+  explicit PromptLookupDrafter(
+      int32_t max_ngram_size = 3,
+      int32_t min_ngram_size = 1);
+
+  /// Replaces the history with `tokens`, e.g. the prompt.
+  void reset(const std::vector<uint64_t>& tokens);
+
+  /// Appends a token to the history.
+  void append(uint64_t token);
+
+  /**
+   * Replaces `draft` with up to `max_tokens` tokens that followed the longest
+   * earlier occurrence of a suffix of the history, latest occurrence first.
+   * Leaves it empty if no suffix occurred before.
+   */
+  void draft(int32_t max_tokens, std::vector<uint64_t>& draft) const;
+
+  const std::vector<uint64_t>& history() const {
+    return history_;
+  }
+
+ private:
+  // Hash of the n tokens ending before history_[end].
+  uint64_t hash(size_t end, int32_t n) const;
+
+  int32_t max_ngram_size_;
+  int32_t min_ngram_size_;
+  std::vector<uint64_t> history_;
+  // indices_[n - min_ngram_size_] maps the hash of an n-gram to the position
+  // in history_ of the token that followed its latest occurrence.
+  std::vector<std::unordered_map<uint64_t, size_t>> indices_;
+};
+
+} // namespace executorch::extension::llm
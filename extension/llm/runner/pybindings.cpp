@@ -132,6 +132,13 @@ class PyMultimodalRunner {
     }
   }
 
+  void set_encoder_cache_budget(size_t max_bytes) {
+    if (!runner_) {
+      throw std::runtime_error("Runner not initialized");
+    }
+    runner_->set_encoder_cache_budget(max_bytes);
+  }
+
   void prefill(std::vector<MultimodalInput> inputs) {
     if (!runner_) {
       throw std::runtime_error("Runner not initialized");
@@ -172,7 +179,17 @@ PYBIND11_MODULE(_llm_runner, m) {
                       int32_t seq_len,
                       float temperature,
                       int32_t num_bos,
-                      int32_t num_eos) {
+                      int32_t num_eos,
+                      bool reuse_prompt_prefix,
+                      int32_t prefill_chunk_size,
+                      int32_t num_lookup_draft_tokens,
+                      int32_t lookup_ngram_size,
+                      float top_p,
+                      int32_t top_k,
+                      float repetition_penalty,
+                      float frequency_penalty,
+                      float presence_penalty,
+                      int64_t seed) {
             GenerationConfig cfg;
             cfg.echo = echo;
             cfg.max_new_tokens = max_new_tokens;
@@ -181,6 +198,16 @@ PYBIND11_MODULE(_llm_runner, m) {
             cfg.temperature = temperature;
             cfg.num_bos = num_bos;
             cfg.num_eos = num_eos;
+            cfg.reuse_prompt_prefix = reuse_prompt_prefix;
+            cfg.prefill_chunk_size = prefill_chunk_size;
+            cfg.num_lookup_draft_tokens = num_lookup_draft_tokens;
+            cfg.lookup_ngram_size = lookup_ngram_size;
+            cfg.top_p = top_p;
+            cfg.top_k = top_k;
+            cfg.repetition_penalty = repetition_penalty;
+            cfg.frequency_penalty = frequency_penalty;
+            cfg.presence_penalty = presence_penalty;
+            cfg.seed = seed;
             return cfg;
           }),
           py::arg("echo") = true,
@@ -189,7 +216,17 @@ PYBIND11_MODULE(_llm_runner, m) {
           py::arg("seq_len") = -1,
           py::arg("temperature") = 0.8f,
           py::arg("num_bos") = 0,
-          py::arg("num_eos") = 0)
+          py::arg("num_eos") = 0,
+          py::arg("reuse_prompt_prefix") = false,
+          py::arg("prefill_chunk_size") = 0,
+          py::arg("num_lookup_draft_tokens") = 0,
+          py::arg("lookup_ngram_size") = 3,
+          py::arg("top_p") = 0.9f,
+          py::arg("top_k") = 0,
+          py::arg("repetition_penalty") = 1.0f,
+          py::arg("frequency_penalty") = 0.0f,
+          py::arg("presence_penalty") = 0.0f,
+          py::arg("seed") = -1)
       .def_readwrite("echo", &GenerationConfig::echo)
       .def_readwrite("max_new_tokens", &GenerationConfig::max_new_tokens)
       .def_readwrite("warming", &GenerationConfig::warming)
@@ -197,6 +234,21 @@ PYBIND11_MODULE(_llm_runner, m) {
       .def_readwrite("temperature", &GenerationConfig::temperature)
       .def_readwrite("num_bos", &GenerationConfig::num_bos)
       .def_readwrite("num_eos", &GenerationConfig::num_eos)
+      .def_readwrite(
+          "reuse_prompt_prefix", &GenerationConfig::reuse_prompt_prefix)
+      .def_readwrite(
+          "prefill_chunk_size", &GenerationConfig::prefill_chunk_size)
+      .def_readwrite(
+          "num_lookup_draft_tokens",
+          &GenerationConfig::num_lookup_draft_tokens)
+      .def_readwrite("lookup_ngram_size", &GenerationConfig::lookup_ngram_size)
+      .def_readwrite("top_p", &GenerationConfig::top_p)
+      .def_readwrite("top_k", &GenerationConfig::top_k)
+      .def_readwrite(
+          "repetition_penalty", &GenerationConfig::repetition_penalty)
+      .def_readwrite("frequency_penalty", &GenerationConfig::frequency_penalty)
+      .def_readwrite("presence_penalty", &GenerationConfig::presence_penalty)
+      .def_readwrite("seed", &GenerationConfig::seed)
       .def(
           "resolve_max_new_tokens",
           &GenerationConfig::resolve_max_new_tokens,
@@ -212,6 +264,19 @@ PYBIND11_MODULE(_llm_runner, m) {
             " warming=" + (config.warming ? "True" : "False") + ">";
       });
 
+  // Bind PrefillChunkStats
+  py::class_<PrefillChunkStats>(m, "PrefillChunkStats")
+      .def_readonly("start_pos", &PrefillChunkStats::start_pos)
+      .def_readonly("num_tokens", &PrefillChunkStats::num_tokens)
+      .def_readonly("start_ms", &PrefillChunkStats::start_ms)
+      .def_readonly("end_ms", &PrefillChunkStats::end_ms)
+      .def("__repr__", [](const PrefillChunkStats& chunk) {
+        return "<PrefillChunkStats start_pos=" +
+            std::to_string(chunk.start_pos) +
+            " num_tokens=" + std::to_string(chunk.num_tokens) +
+            " time_ms=" + std::to_string(chunk.end_ms - chunk.start_ms) + ">";
+      });
+
   // Bind Stats
   py::class_<Stats>(m, "Stats")
       .def_readonly(
@@ -230,7 +295,14 @@ PYBIND11_MODULE(_llm_runner, m) {
       .def_readonly(
           "aggregate_sampling_time_ms", &Stats::aggregate_sampling_time_ms)
       .def_readonly("num_prompt_tokens", &Stats::num_prompt_tokens)
+      .def_readonly(
+          "num_cached_prompt_tokens", &Stats::num_cached_prompt_tokens)
       .def_readonly("num_generated_tokens", &Stats::num_generated_tokens)
+      .def_readonly("num_decode_steps", &Stats::num_decode_steps)
+      .def_readonly("num_draft_tokens", &Stats::num_draft_tokens)
+      .def_readonly(
+          "num_accepted_draft_tokens", &Stats::num_accepted_draft_tokens)
+      .def_readonly("prefill_chunks", &Stats::prefill_chunks)
       .def("on_sampling_begin", &Stats::on_sampling_begin)
       .def("on_sampling_end", &Stats::on_sampling_end)
       .def(
@@ -637,6 +709,12 @@ PYBIND11_MODULE(_llm_runner, m) {
           "reset",
           &PyMultimodalRunner::reset,
           "Reset the runner state and KV cache")
+      .def(
+          "set_encoder_cache_budget",
+          &PyMultimodalRunner::set_encoder_cache_budget,
+          py::arg("max_bytes"),
+          "Cache up to max_bytes of image and audio encoder outputs so that "
+          "repeated inputs skip their encoder; 0 disables the cache")
       .def(
           "get_vocab_size",
           &PyMultimodalRunner::get_vocab_size,
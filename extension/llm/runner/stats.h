@@ -10,14 +10,27 @@
 #pragma once
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/log.h>
+#include <algorithm>
 #include <cinttypes>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace executorch {
 namespace extension {
 namespace llm {
 
+// Timing of one chunk of a prompt prefilled by TextPrefiller.
+struct ET_EXPERIMENTAL PrefillChunkStats {
+  // Position in the KV cache of the first token of the chunk.
+  int64_t start_pos;
+  // Number of prompt tokens in the chunk.
+  int64_t num_tokens;
+  // Start and end of the model execution for the chunk.
+  long start_ms;
+  long end_ms;
+};
+
 struct ET_EXPERIMENTAL Stats {
   // Scaling factor for timestamps - in this case, we use ms.
   const long SCALING_FACTOR_UNITS_PER_SECOND = 1000;
@@ -47,8 +60,20 @@ struct ET_EXPERIMENTAL Stats {
   long aggregate_sampling_time_ms;
   // Token count from prompt
   int64_t num_prompt_tokens;
+  // Number of prompt tokens whose KV cache entries were reused instead of
+  // prefilled, see GenerationConfig::reuse_prompt_prefix.
+  int64_t num_cached_prompt_tokens = 0;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // Number of model executions to generate num_generated_tokens. One per
+  // token, unless prompt lookup decoding emits several per execution.
+  int64_t num_decode_steps = 0;
+  // Tokens proposed by prompt lookup decoding, and how many of them matched
+  // the model's own samples and were kept.
+  int64_t num_draft_tokens = 0;
+  int64_t num_accepted_draft_tokens = 0;
+  // One entry per chunk the prompt was prefilled in, in order.
+  std::vector<PrefillChunkStats> prefill_chunks;
   inline void on_sampling_begin() {
     aggregate_sampling_timer_start_timestamp = time_in_ms();
   }
@@ -74,7 +99,12 @@ struct ET_EXPERIMENTAL Stats {
     inference_end_ms = 0;
     aggregate_sampling_time_ms = 0;
     num_prompt_tokens = 0;
+    num_cached_prompt_tokens = 0;
     num_generated_tokens = 0;
+    num_decode_steps = 0;
+    num_draft_tokens = 0;
+    num_accepted_draft_tokens = 0;
+    prefill_chunks.clear();
     aggregate_sampling_timer_start_timestamp = 0;
   }
 
@@ -85,7 +115,11 @@ struct ET_EXPERIMENTAL Stats {
 inline std::string stats_to_json_string(const Stats& stats) {
   std::stringstream ss;
   ss << "{\"prompt_tokens\":" << stats.num_prompt_tokens << ","
+     << "\"cached_prompt_tokens\":" << stats.num_cached_prompt_tokens << ","
      << "\"generated_tokens\":" << stats.num_generated_tokens << ","
+     << "\"decode_steps\":" << stats.num_decode_steps << ","
+     << "\"draft_tokens\":" << stats.num_draft_tokens << ","
+     << "\"accepted_draft_tokens\":" << stats.num_accepted_draft_tokens << ","
      << "\"model_load_start_ms\":" << stats.model_load_start_ms << ","
      << "\"model_load_end_ms\":" << stats.model_load_end_ms << ","
      << "\"inference_start_ms\":" << stats.inference_start_ms << ","
@@ -93,7 +127,15 @@ inline std::string stats_to_json_string(const Stats& stats) {
      << "\"prompt_eval_end_ms\":" << stats.prompt_eval_end_ms << ","
      << "\"first_token_ms\":" << stats.first_token_ms << ","
      << "\"aggregate_sampling_time_ms\":" << stats.aggregate_sampling_time_ms
-     << "," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
+     << "," << "\"prefill_chunks\":[";
+  for (size_t i = 0; i < stats.prefill_chunks.size(); ++i) {
+    const PrefillChunkStats& chunk = stats.prefill_chunks[i];
+    ss << (i == 0 ? "" : ",") << "{\"start_pos\":" << chunk.start_pos << ","
+       << "\"num_tokens\":" << chunk.num_tokens << ","
+       << "\"start_ms\":" << chunk.start_ms << ","
+       << "\"end_ms\":" << chunk.end_ms << "}";
+  }
+  ss << "]," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
      << stats.SCALING_FACTOR_UNITS_PER_SECOND << "}";
   return ss.str();
 }
@@ -107,6 +149,13 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens,
       stats.num_generated_tokens);
 
+  if (stats.num_cached_prompt_tokens > 0) {
+    ET_LOG(
+        Info,
+        "\tPrompt tokens reused from the KV cache: %" PRIu64,
+        stats.num_cached_prompt_tokens);
+  }
+
   ET_LOG(
       Info,
       "\tModel Load Time:\t\t%f (seconds)",
@@ -131,6 +180,21 @@ inline void print_report(const Stats& stats) {
       (stats.num_prompt_tokens) / prompt_eval_time *
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
 
+  if (stats.prefill_chunks.size() > 1) {
+    for (const PrefillChunkStats& chunk : stats.prefill_chunks) {
+      const double chunk_time = (double)(chunk.end_ms - chunk.start_ms);
+      ET_LOG(
+          Info,
+          "\t\t\tPrefill chunk at %" PRId64 ", %" PRId64
+          " tokens:\t%f (seconds)\t\t Rate: \t%f (tokens/second)",
+          chunk.start_pos,
+          chunk.num_tokens,
+          chunk_time / stats.SCALING_FACTOR_UNITS_PER_SECOND,
+          chunk.num_tokens / chunk_time *
+              stats.SCALING_FACTOR_UNITS_PER_SECOND);
+    }
+  }
+
   double eval_time =
       (double)(stats.inference_end_ms - stats.prompt_eval_end_ms);
   ET_LOG(
@@ -142,6 +206,18 @@ inline void print_report(const Stats& stats) {
       stats.num_generated_tokens / eval_time *
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
 
+  if (stats.num_draft_tokens > 0) {
+    ET_LOG(
+        Info,
+        "\tPrompt lookup accepted %" PRId64 " of %" PRId64
+        " draft tokens (%f%%), %f tokens per decode step",
+        stats.num_accepted_draft_tokens,
+        stats.num_draft_tokens,
+        100.0 * stats.num_accepted_draft_tokens / stats.num_draft_tokens,
+        (double)stats.num_generated_tokens /
+            std::max<int64_t>(stats.num_decode_steps, 1));
+  }
+
   // Time to first token is measured from the start of inference, excluding
   // model load time.
   ET_LOG(
@@ -21,6 +21,31 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "token_streamer",
+        exported_headers = ["token_streamer.h"],
+        srcs = ["token_streamer.cpp"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+            "//pytorch/tokenizers:headers",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "prompt_lookup",
+        exported_headers = ["prompt_lookup.h"],
+        srcs = ["prompt_lookup.cpp"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     for aten in get_aten_mode_options():
         aten_suffix = "_aten" if aten else ""
 
@@ -40,6 +65,20 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "token_constraint" + aten_suffix,
+            exported_headers = ["token_constraint.h"],
+            srcs = ["token_constraint.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/llm/sampler:sampler" + aten_suffix,
+                "//executorch/runtime/core:core",
+                "//pytorch/tokenizers:headers",
+            ],
+        )
+
         runtime.cxx_library(
             name = "text_decoder_runner" + aten_suffix,
             exported_headers = ["text_decoder_runner.h"],
@@ -49,6 +88,7 @@ def define_common_targets():
             ],
             exported_deps = [
                 ":stats" + aten_suffix,
+                ":token_constraint" + aten_suffix,
                 "//executorch/kernels/portable/cpu/util:arange_util" + aten_suffix,
                 "//executorch/extension/llm/sampler:sampler" + aten_suffix,
                 "//executorch/extension/llm/runner/io_manager:io_manager" + aten_suffix,
@@ -79,6 +119,8 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":prompt_lookup",
+                ":token_streamer",
                 ":text_decoder_runner" + aten_suffix,
                 "//pytorch/tokenizers:headers",
                 "//executorch/extension/module:module" + aten_suffix,
@@ -104,6 +146,7 @@ def define_common_targets():
             name = "multimodal_runner_lib" + aten_suffix,
             exported_headers = [
                 "audio.h",
+                "encoder_cache.h",
                 "image.h",
                 "multimodal_input.h",
                 "multimodal_runner.h",
@@ -111,6 +154,7 @@ def define_common_targets():
                 "multimodal_decoder_runner.h",
             ],
             srcs = [
+                "encoder_cache.cpp",
                 "multimodal_prefiller.cpp",
             ],
             exported_deps = [
@@ -118,6 +162,7 @@ def define_common_targets():
                 ":text_prefiller" + aten_suffix,
                 ":image_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
+                "//executorch/runtime/kernel:thread_parallel_interface",
             ],
         )
 
@@ -125,11 +170,13 @@ def define_common_targets():
             name = "runner_lib" + aten_suffix,
             exported_headers = [
                 "text_llm_runner.h",
+                "kv_cache_snapshot.h",
                 "llm_runner_helper.h",
                 "constants.h",
             ],
             srcs = [
                 "text_llm_runner.cpp",
+                "kv_cache_snapshot.cpp",
                 "llm_runner_helper.cpp",
                 "multimodal_runner.cpp",
             ],
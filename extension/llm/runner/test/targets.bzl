@@ -37,6 +37,47 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "test_kv_cache_snapshot",
+        srcs = ["test_kv_cache_snapshot.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:runner_lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_token_constraint",
+        srcs = ["test_token_constraint.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:runner_lib",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_encoder_cache",
+        srcs = ["test_encoder_cache.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:multimodal_runner_lib",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_prompt_lookup",
+        srcs = ["test_prompt_lookup.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:runner_lib",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_token_streamer",
+        srcs = ["test_token_streamer.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:runner_lib",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_multimodal_input",
         srcs = ["test_multimodal_input.cpp"],
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <vector>
+
+#include <executorch/extension/llm/runner/encoder_cache.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::extension::make_tensor_ptr;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::Audio;
+using executorch::extension::llm::EncoderCache;
+using executorch::extension::llm::Image;
+using executorch::extension::llm::make_audio_input;
+using executorch::extension::llm::make_image_input;
+using executorch::extension::llm::make_text_input;
+using executorch::extension::llm::MultimodalInput;
+
+namespace {
+
+class EncoderCacheTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // A [1, 4, 8] float encoder output, 128 bytes, filled with `value`.
+  TensorPtr make_output(float value) {
+    return make_tensor_ptr({1, 4, 8}, std::vector<float>(32, value));
+  }
+
+  // A 4x4 grayscale image, 16 bytes, filled with `value`.
+  MultimodalInput make_input(uint8_t value) {
+    return make_image_input(Image(std::vector<uint8_t>(16, value), 4, 4, 1));
+  }
+
+  // Inserts the output for make_input(value), keyed by `key`.
+  void insert(EncoderCache& cache, uint64_t key, uint8_t value) {
+    cache.insert(key, make_input(value), *make_output(value));
+  }
+
+  TensorPtr lookup(EncoderCache& cache, uint64_t key, uint8_t value) {
+    return cache.lookup(key, make_input(value));
+  }
+};
+
+TEST_F(EncoderCacheTest, KeysDependOnContentAndShape) {
+  std::vector<uint8_t> pixels(3 * 16 * 16, 7);
+  const auto key = EncoderCache::key(
+      make_image_input(Image(std::vector<uint8_t>(pixels), 16, 16, 3)));
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(
+      key,
+      EncoderCache::key(
+          make_image_input(Image(std::vector<uint8_t>(pixels), 16, 16, 3))));
+
+  // Same bytes, different shape.
+  EXPECT_NE(
+      key,
+      EncoderCache::key(
+          make_image_input(Image(std::vector<uint8_t>(pixels), 8, 32, 3))));
+  // One pixel differs, in the tail that isn't a multiple of the block size.
+  pixels.back() = 8;
+  EXPECT_NE(
+      key,
+      EncoderCache::key(
+          make_image_input(Image(std::vector<uint8_t>(pixels), 16, 16, 3))));
+
+  // Audio with the same bytes as an image gets another key.
+  const auto audio_key = EncoderCache::key(make_audio_input(
+      Audio(std::vector<uint8_t>(3 * 16 * 16, 7), 3, 16, 16)));
+  ASSERT_TRUE(audio_key.has_value());
+  EXPECT_NE(key, audio_key);
+
+  EXPECT_FALSE(EncoderCache::key(make_text_input("hello")).has_value());
+}
+
+TEST_F(EncoderCacheTest, LookupReturnsCopyOfInsertedOutput) {
+  EncoderCache cache(1024);
+  const auto input = make_input(1);
+  EXPECT_EQ(cache.lookup(1, input), nullptr);
+
+  auto output = make_output(1.5f);
+  cache.insert(1, input, *output, /*encode_time_ms=*/40);
+  // Overwriting the original must not change the cached copy.
+  output->mutable_data_ptr<float>()[0] = 0.0f;
+
+  auto cached = cache.lookup(1, input);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_EQ(cached->scalar_type(), ScalarType::Float);
+  ASSERT_EQ(cached->dim(), 3);
+  EXPECT_EQ(cached->size(1), 4);
+  EXPECT_EQ(cached->size(2), 8);
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_EQ(cached->const_data_ptr<float>()[i], 1.5f);
+  }
+  cache.lookup(1, input);
+
+  EXPECT_EQ(cache.num_hits(), 2);
+  EXPECT_EQ(cache.num_misses(), 1);
+  EXPECT_EQ(cache.time_saved_ms(), 80);
+  // The output and a copy of the input.
+  EXPECT_EQ(cache.size_bytes(), 128u + 16u);
+}
+
+TEST_F(EncoderCacheTest, LookupComparesInputs) {
+  EncoderCache cache(1024);
+  insert(cache, 1, 1);
+
+  // Inputs that share the key of a cached one don't hit it.
+  EXPECT_EQ(lookup(cache, 1, 2), nullptr);
+  EXPECT_EQ(
+      cache.lookup(
+          1, make_image_input(Image(std::vector<uint8_t>(16, 1), 2, 8, 1))),
+      nullptr);
+  EXPECT_EQ(
+      cache.lookup(
+          1, make_audio_input(Audio(std::vector<uint8_t>(16, 1), 1, 4, 4))),
+      nullptr);
+  EXPECT_EQ(
+      cache.lookup(
+          1, make_image_input(Image(std::vector<float>(4, 1.0f), 2, 2, 1))),
+      nullptr);
+  EXPECT_EQ(cache.lookup(1, make_text_input("hello")), nullptr);
+  EXPECT_EQ(cache.num_misses(), 5);
+
+  EXPECT_NE(lookup(cache, 1, 1), nullptr);
+  EXPECT_EQ(cache.num_hits(), 1);
+
+  // Other inputs aren't cached.
+  cache.insert(2, make_text_input("hello"), *make_output(1.0f));
+  EXPECT_EQ(cache.num_entries(), 1u);
+}
+
+TEST_F(EncoderCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+  // Room for three entries of 144 bytes.
+  EncoderCache cache(3 * 144 + 64);
+  insert(cache, 1, 1);
+  insert(cache, 2, 2);
+  insert(cache, 3, 3);
+  // Entry 1 becomes the most recently used, so 2 is evicted next.
+  auto held = lookup(cache, 1, 1);
+  insert(cache, 4, 4);
+
+  EXPECT_EQ(cache.num_entries(), 3u);
+  EXPECT_EQ(cache.size_bytes(), 3 * 144u);
+  EXPECT_EQ(lookup(cache, 2, 2), nullptr);
+  EXPECT_NE(lookup(cache, 3, 3), nullptr);
+  EXPECT_NE(lookup(cache, 4, 4), nullptr);
+
+  // Shrinking the budget evicts 1, but the tensor handed out still holds it.
+  cache.set_max_bytes(2 * 144);
+  EXPECT_EQ(lookup(cache, 1, 1), nullptr);
+  EXPECT_EQ(held->const_data_ptr<float>()[31], 1.0f);
+
+  // Entries larger than the budget are not cached.
+  cache.insert(
+      5, make_input(5), *make_tensor_ptr({1, 100}, std::vector<float>(100)));
+  EXPECT_EQ(lookup(cache, 5, 5), nullptr);
+  EXPECT_EQ(cache.num_entries(), 2u);
+
+  // Inserting an existing key replaces it.
+  cache.insert(3, make_input(3), *make_output(5.0f));
+  EXPECT_EQ(cache.num_entries(), 2u);
+  EXPECT_EQ(lookup(cache, 3, 3)->const_data_ptr<float>()[0], 5.0f);
+
+  cache.clear();
+  EXPECT_EQ(cache.num_entries(), 0u);
+  EXPECT_EQ(cache.size_bytes(), 0u);
+}
+
+} // namespace
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::KVCacheBuffer;
+using executorch::extension::llm::KVCacheSnapshot;
+using executorch::runtime::Error;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int32_t kMaxContextLen = 8;
+
+class KVCacheSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // A (1, 2, kMaxContextLen, 3) KVCache style buffer and a
+  // (1, kMaxContextLen, 2, 3) CustomKVCache style buffer.
+  std::vector<KVCacheBuffer> make_buffers(float offset) {
+    std::vector<float> data(2 * kMaxContextLen * 3);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = offset + 0.25f * static_cast<float>(i) - 3.0f;
+    }
+    return {
+        {"layers.0.attention.kv_cache.k_cache",
+         tf_.make({1, 2, kMaxContextLen, 3}, data),
+         2},
+        {"layers.0.attention.kv_cache.v_cache",
+         tf_.make({1, kMaxContextLen, 2, 3}, data),
+         1},
+    };
+  }
+
+  // Element i of position p along seq_dim, for comparing positions.
+  static float at(const KVCacheBuffer& buffer, int64_t p, int64_t i) {
+    const float* data = buffer.tensor.const_data_ptr<float>();
+    if (buffer.seq_dim == 2) {
+      // (1, 2, S, 3)
+      return data[(i / 3) * kMaxContextLen * 3 + p * 3 + i % 3];
+    }
+    // (1, S, 2, 3)
+    return data[p * 6 + i];
+  }
+
+  TensorFactory<ScalarType::Float> tf_;
+};
+
+TEST_F(KVCacheSnapshotTest, RoundTripThroughBlob) {
+  auto source = make_buffers(0.0f);
+  auto snapshot = KVCacheSnapshot::capture(source, 5, {1, 2, 3, 4, 5});
+  ASSERT_TRUE(snapshot.ok());
+  EXPECT_EQ(snapshot->nbytes(), 2 * 5 * 6 * sizeof(float));
+
+  const std::vector<uint8_t> blob = snapshot->serialize();
+  auto restored = KVCacheSnapshot::deserialize(blob.data(), blob.size());
+  ASSERT_TRUE(restored.ok());
+  EXPECT_EQ(restored->num_positions(), 5);
+  EXPECT_EQ(restored->tokens(), (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+
+  auto target = make_buffers(100.0f);
+  ASSERT_EQ(restored->restore(target), Error::Ok);
+  for (size_t b = 0; b < source.size(); ++b) {
+    for (int64_t p = 0; p < kMaxContextLen; ++p) {
+      for (int64_t i = 0; i < 6; ++i) {
+        // Positions past the snapshot are left untouched.
+        const float expected =
+            p < 5 ? at(source[b], p, i) : at(source[b], p, i) + 100.0f;
+        EXPECT_EQ(at(target[b], p, i), expected);
+      }
+    }
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, RoundTripThroughFile) {
+  auto source = make_buffers(1.0f);
+  auto snapshot = KVCacheSnapshot::capture(source, kMaxContextLen);
+  ASSERT_TRUE(snapshot.ok());
+
+  const std::string path = ::testing::TempDir() + "kv_cache_snapshot.bin";
+  ASSERT_EQ(snapshot->save(path), Error::Ok);
+  auto loaded = KVCacheSnapshot::load(path);
+  std::remove(path.c_str());
+  ASSERT_TRUE(loaded.ok());
+  EXPECT_TRUE(loaded->tokens().empty());
+
+  auto target = make_buffers(-50.0f);
+  ASSERT_EQ(loaded->restore(target), Error::Ok);
+  for (size_t b = 0; b < source.size(); ++b) {
+    for (int64_t p = 0; p < kMaxContextLen; ++p) {
+      for (int64_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(at(target[b], p, i), at(source[b], p, i));
+      }
+    }
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, Int8RoundTripIsClose) {
+  auto source = make_buffers(0.5f);
+  auto snapshot = KVCacheSnapshot::capture(source, 6, {}, true);
+  ASSERT_TRUE(snapshot.ok());
+  // One int8 per element plus one float scale per row of trailing elements:
+  // 2 * 6 rows of 3 for the KVCache layout, 6 rows of 6 for the other.
+  EXPECT_EQ(snapshot->nbytes(), 2 * 6 * 6 + (12 + 6) * sizeof(float));
+
+  const std::vector<uint8_t> blob = snapshot->serialize();
+  auto restored = KVCacheSnapshot::deserialize(blob.data(), blob.size());
+  ASSERT_TRUE(restored.ok());
+
+  auto target = make_buffers(0.0f);
+  ASSERT_EQ(restored->restore(target), Error::Ok);
+  for (size_t b = 0; b < source.size(); ++b) {
+    for (int64_t p = 0; p < 6; ++p) {
+      for (int64_t i = 0; i < 6; ++i) {
+        const float expected = at(source[b], p, i);
+        // Half a quantization step of the row's absmax.
+        EXPECT_NEAR(at(target[b], p, i), expected, 10.0f / 254.0f);
+      }
+    }
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, RestoreRejectsMismatchedBuffers) {
+  auto source = make_buffers(0.0f);
+  auto snapshot = KVCacheSnapshot::capture(source, 3);
+  ASSERT_TRUE(snapshot.ok());
+
+  auto target = make_buffers(0.0f);
+  target.pop_back();
+  EXPECT_EQ(snapshot->restore(target), Error::InvalidArgument);
+
+  TensorFactory<ScalarType::Half> tf_half;
+  target = make_buffers(0.0f);
+  target[1].tensor = tf_half.zeros({1, kMaxContextLen, 2, 3});
+  EXPECT_EQ(snapshot->restore(target), Error::InvalidArgument);
+}
+
+TEST_F(KVCacheSnapshotTest, CaptureRejectsTooManyPositions) {
+  auto source = make_buffers(0.0f);
+  EXPECT_EQ(
+      KVCacheSnapshot::capture(source, kMaxContextLen + 1).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      KVCacheSnapshot::capture(source, 2, {1, 2, 3}).error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(KVCacheSnapshotTest, DeserializeRejectsCorruptBlobs) {
+  auto source = make_buffers(0.0f);
+  auto snapshot = KVCacheSnapshot::capture(source, 4, {}, true);
+  ASSERT_TRUE(snapshot.ok());
+  std::vector<uint8_t> blob = snapshot->serialize();
+
+  for (size_t size : {size_t(0), size_t(3), blob.size() / 2, blob.size() - 1}) {
+    EXPECT_FALSE(KVCacheSnapshot::deserialize(blob.data(), size).ok());
+  }
+  blob[0] = 'X';
+  EXPECT_FALSE(KVCacheSnapshot::deserialize(blob.data(), blob.size()).ok());
+}
+
+} // namespace
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <vector>
+
+#include <executorch/extension/llm/runner/prompt_lookup.h>
+#include <executorch/extension/llm/runner/text_token_generator.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::make_tensor_ptr;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::PromptLookupDrafter;
+using executorch::extension::llm::Stats;
+using executorch::extension::llm::TextDecoderRunner;
+using executorch::extension::llm::TextTokenGenerator;
+using executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 16;
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+// A model that predicts the token after t to be (3 * t + 1) % kVocabSize,
+// returning the logits of every input token or only of the last one.
+class FakeDecoderRunner : public TextDecoderRunner {
+ public:
+  explicit FakeDecoderRunner(bool full_logits)
+      : TextDecoderRunner(nullptr, nullptr), full_logits_(full_logits) {}
+
+  Result<executorch::aten::Tensor> step(TensorPtr& tokens, int64_t start_pos)
+      override {
+    step_positions_.push_back(start_pos);
+    const int64_t num_tokens = tokens->numel();
+    const int64_t first = full_logits_ ? 0 : num_tokens - 1;
+    const int32_t num_rows = num_tokens - first;
+    std::vector<float> logits(num_rows * kVocabSize, 0.0f);
+    for (int64_t i = first; i < num_tokens; ++i) {
+      const int64_t token = tokens->const_data_ptr<int64_t>()[i];
+      logits[(i - first) * kVocabSize + (3 * token + 1) % kVocabSize] = 1.0f;
+    }
+    last_logits_ =
+        make_tensor_ptr({1, num_rows, kVocabSize}, std::move(logits));
+    return *last_logits_;
+  }
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  std::vector<int64_t> step_positions_;
+
+ private:
+  bool full_logits_;
+  TensorPtr last_logits_;
+};
+
+class PromptLookupTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    ON_CALL(tokenizer_, decode).WillByDefault([](uint64_t, uint64_t) {
+      return ::tokenizers::Result<std::string>("t");
+    });
+  }
+
+  // Generates greedily after `prompt`, returning the generated tokens.
+  std::vector<uint64_t> generate(
+      const std::vector<uint64_t>& prompt,
+      int32_t max_new_tokens,
+      int32_t num_draft_tokens,
+      FakeDecoderRunner& runner) {
+    TextTokenGenerator generator(
+        &tokenizer_,
+        &runner,
+        /*use_kv_cache=*/true,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{kVocabSize}),
+        &stats_);
+    generator.set_lookup_decoding(num_draft_tokens, /*max_ngram_size=*/2);
+    std::vector<uint64_t> generated;
+    auto num_generated = generator.generate(
+        prompt,
+        prompt.size(),
+        max_new_tokens,
+        0.0f,
+        [](const std::string&) {},
+        &generated);
+    EXPECT_TRUE(num_generated.ok());
+    EXPECT_EQ(num_generated.get(), static_cast<int64_t>(generated.size()));
+    return generated;
+  }
+
+  NiceMock<MockTokenizer> tokenizer_;
+  Stats stats_;
+};
+
+TEST_F(PromptLookupTest, DraftsContinuationOfLongestMatch) {
+  PromptLookupDrafter drafter(/*max_ngram_size=*/3);
+  std::vector<uint64_t> draft = {99};
+  drafter.reset({});
+  drafter.draft(4, draft);
+  EXPECT_TRUE(draft.empty());
+
+  drafter.reset({5, 1, 2, 3, 4, 7, 2, 3, 8, 9});
+  // Nothing followed 9 before.
+  drafter.draft(4, draft);
+  EXPECT_TRUE(draft.empty());
+
+  // "2 3" occurred twice; the latest occurrence wins.
+  drafter.append(2);
+  drafter.append(3);
+  drafter.draft(4, draft);
+  EXPECT_THAT(draft, ElementsAre(8, 9, 2, 3));
+
+  // "5 1 2" has no match, but "1 2" does.
+  drafter.reset({1, 2, 3, 4, 7, 2, 5, 1, 2});
+  drafter.draft(2, draft);
+  EXPECT_THAT(draft, ElementsAre(3, 4));
+
+  // The draft can run up to the end of the history.
+  drafter.reset({6, 6, 6});
+  drafter.draft(8, draft);
+  EXPECT_THAT(draft, ElementsAre(6));
+  drafter.draft(0, draft);
+  EXPECT_TRUE(draft.empty());
+}
+
+TEST_F(PromptLookupTest, MatchesTokenByTokenDecoding) {
+  // The prompt follows the fake model's rule from 1 on, but not from 9.
+  const std::vector<uint64_t> prompt = {1, 4, 13, 8, 9, 0, 1, 4, 13, 8, 9};
+
+  FakeDecoderRunner reference_runner(/*full_logits=*/true);
+  const auto expected = generate(prompt, 20, 0, reference_runner);
+  EXPECT_EQ(stats_.num_draft_tokens, 0);
+  EXPECT_EQ(stats_.num_decode_steps, 20);
+  EXPECT_EQ(reference_runner.step_positions_.size(), 20u);
+
+  FakeDecoderRunner runner(/*full_logits=*/true);
+  const auto generated = generate(prompt, 20, 4, runner);
+  EXPECT_EQ(generated, expected);
+  EXPECT_GT(stats_.num_accepted_draft_tokens, 0);
+  EXPECT_LE(stats_.num_accepted_draft_tokens, stats_.num_draft_tokens);
+  // Every step emits its accepted drafts plus one sampled token.
+  EXPECT_EQ(
+      stats_.num_decode_steps + stats_.num_accepted_draft_tokens,
+      static_cast<int64_t>(generated.size()));
+  EXPECT_EQ(runner.step_positions_.size(), stats_.num_decode_steps);
+  EXPECT_LT(stats_.num_decode_steps, 20);
+}
+
+TEST_F(PromptLookupTest, StopsAtMaxNewTokensWithinDraft) {
+  // The fake model cycles 1, 4, 13, 8, 9, 12, 5, 0, 1, ...
+  const std::vector<uint64_t> prompt = {1, 4, 13, 8, 9, 12, 5, 0, 1};
+  FakeDecoderRunner runner(/*full_logits=*/true);
+  const auto generated = generate(prompt, 6, 8, runner);
+  EXPECT_THAT(generated, ElementsAre(4, 13, 8, 9, 12, 5));
+  EXPECT_EQ(stats_.num_draft_tokens, 5);
+  EXPECT_EQ(stats_.num_accepted_draft_tokens, 5);
+  EXPECT_EQ(stats_.num_decode_steps, 1);
+}
+
+TEST_F(PromptLookupTest, FallsBackWithoutFullLogits) {
+  const std::vector<uint64_t> prompt = {1, 4, 13, 8, 9, 12, 5, 0, 1};
+  FakeDecoderRunner reference_runner(/*full_logits=*/true);
+  const auto expected = generate(prompt, 10, 0, reference_runner);
+
+  FakeDecoderRunner runner(/*full_logits=*/false);
+  const auto generated = generate(prompt, 10, 4, runner);
+  EXPECT_EQ(generated, expected);
+  EXPECT_EQ(stats_.num_draft_tokens, 0);
+  // One step is wasted finding out that drafts can't be verified, and the
+  // position it was fed at is fed again.
+  EXPECT_EQ(stats_.num_decode_steps, 11);
+  ASSERT_GE(runner.step_positions_.size(), 2u);
+  EXPECT_EQ(runner.step_positions_[0], prompt.size());
+  EXPECT_EQ(runner.step_positions_[1], prompt.size());
+}
+
+} // namespace
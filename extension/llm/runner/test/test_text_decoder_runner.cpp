@@ -15,6 +15,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <cstdlib>
+#include <set>
+#include <vector>
 
 using namespace ::testing;
 using executorch::extension::Module;
@@ -120,6 +122,43 @@ TEST_F(TextDecoderRunnerTest, LogitsToTokenWithTemperature) {
   EXPECT_LT(token, 4);
 }
 
+// The runner keeps one sampler, so a seed makes a sequence of draws
+// reproducible.
+TEST_F(TextDecoderRunnerTest, LogitsToTokenIsReproducibleWithSeed) {
+  TensorFactory<executorch::aten::ScalarType::Float> tf_float;
+  const std::vector<float> data = {
+      0.1f, 0.2f, 0.8f, 0.4f, 0.3f, 0.7f, 0.5f, 0.6f};
+  auto sample_tokens = [&]() {
+    std::vector<int32_t> tokens;
+    for (int i = 0; i < 32; ++i) {
+      // Sampling works on the logits in place.
+      auto logits = tf_float.make({1, 8}, data);
+      tokens.push_back(runner_->logits_to_token(logits, 1.0f));
+    }
+    return tokens;
+  };
+
+  runner_->set_rng_seed(42);
+  const std::vector<int32_t> first = sample_tokens();
+  runner_->set_rng_seed(42);
+  EXPECT_EQ(sample_tokens(), first);
+  // The draws come from one RNG stream rather than a fresh sampler per token.
+  EXPECT_GT(std::set<int32_t>(first.begin(), first.end()).size(), 1);
+}
+
+// Test that logits_to_token() applies the sampler config to the seen tokens
+TEST_F(TextDecoderRunnerTest, LogitsToTokenAppliesSamplerConfig) {
+  TensorFactory<executorch::aten::ScalarType::Float> tf_float;
+  executorch::extension::llm::SamplerConfig config;
+  config.repetition_penalty = 2.0f;
+  runner_->set_sampler_config(config);
+
+  auto logits = tf_float.make({1, 4}, {1.0f, 0.9f, 0.1f, -1.0f});
+  EXPECT_EQ(runner_->logits_to_token(logits, 0.0f, {0}), 1);
+  logits = tf_float.make({1, 4}, {1.0f, 0.9f, 0.1f, -1.0f});
+  EXPECT_EQ(runner_->logits_to_token(logits, 0.0f), 0);
+}
+
 // Test step() method with all available PTE models
 TEST_F(TextDecoderRunnerTest, StepWithAllModels) {
   // List of all environment variables for PTE models
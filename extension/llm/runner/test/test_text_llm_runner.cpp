@@ -62,6 +62,11 @@ class MockModule : public ::executorch::extension::Module {
       execute,
       (const std::string&, const std::vector<executorch::runtime::EValue>&),
       (override));
+  MOCK_METHOD(
+      Result<executorch::aten::Tensor>,
+      get_attribute,
+      (const std::string&, const std::string&),
+      (override));
 };
 
 class MockTextDecoderRunner : public TextDecoderRunner {
@@ -346,4 +351,239 @@ TEST_F(RunnerTest, IsLoadedReturnsTrueWhenComponentsInitialized) {
   EXPECT_TRUE(runner.is_loaded());
 }
 
+// Test that a prompt prefix whose KV cache is still resident after reset() is
+// not prefilled again when reuse_prompt_prefix is set.
+TEST_F(RunnerTest, GenerateReusesResidentPromptPrefix) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  std::vector<uint64_t> prompt_tokens;
+  ON_CALL(*tokenizer, encode(_, _, _))
+      .WillByDefault([&](const std::string&, int8_t, int8_t) {
+        return ::tokenizers::Result<std::vector<uint64_t>>(prompt_tokens);
+      });
+
+  // Record what gets prefilled, advancing the position like TextPrefiller.
+  std::vector<uint64_t> prefilled_tokens;
+  int64_t prefill_start_pos = -1;
+  ON_CALL(*text_prefiller, prefill(_, _))
+      .WillByDefault([&](std::vector<uint64_t>& tokens, int64_t& start_pos) {
+        prefilled_tokens = tokens;
+        prefill_start_pos = start_pos;
+        start_pos += tokens.size();
+        return Result<uint64_t>(4);
+      });
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  auto module = std::make_unique<MockModule>();
+  auto io_manager =
+      std::make_unique<executorch::extension::llm::IOManager>(*module);
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::move(module),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::move(io_manager),
+      std::move(text_token_generator),
+      std::move(stats));
+  runner.load();
+
+  GenerationConfig config;
+  config.max_new_tokens = 3;
+  config.echo = false;
+  config.reuse_prompt_prefix = true;
+  int64_t num_cached_prompt_tokens = -1;
+  auto stats_callback = [&](const Stats& s) {
+    num_cached_prompt_tokens = s.num_cached_prompt_tokens;
+  };
+
+  // Nothing is resident yet, so the whole prompt is prefilled.
+  prompt_tokens = {1, 5, 6, 7, 8};
+  EXPECT_EQ(runner.generate("first", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(prefilled_tokens, prompt_tokens);
+  EXPECT_EQ(prefill_start_pos, 0);
+  EXPECT_EQ(num_cached_prompt_tokens, 0);
+
+  // Only the part after the shared prefix {1, 5, 6} is prefilled.
+  runner.reset();
+  prompt_tokens = {1, 5, 6, 9, 10};
+  EXPECT_EQ(runner.generate("second", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(prefilled_tokens, (std::vector<uint64_t>{9, 10}));
+  EXPECT_EQ(prefill_start_pos, 3);
+  EXPECT_EQ(num_cached_prompt_tokens, 3);
+
+  // The last prompt token is prefilled even if the whole prompt is resident.
+  runner.reset();
+  EXPECT_EQ(runner.generate("second", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(prefilled_tokens, (std::vector<uint64_t>{10}));
+  EXPECT_EQ(prefill_start_pos, 4);
+  EXPECT_EQ(num_cached_prompt_tokens, 4);
+
+  // Without reuse_prompt_prefix, everything is prefilled again.
+  runner.reset();
+  config.reuse_prompt_prefix = false;
+  EXPECT_EQ(runner.generate("second", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(prefilled_tokens, prompt_tokens);
+  EXPECT_EQ(prefill_start_pos, 0);
+  EXPECT_EQ(num_cached_prompt_tokens, 0);
+}
+
+// Test that generate() passes the prefill chunk size to the prefiller
+TEST_F(RunnerTest, GenerateSetsPrefillChunkSize) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+  TextPrefiller* prefiller = text_prefiller.get();
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  auto module = std::make_unique<MockModule>();
+  auto io_manager =
+      std::make_unique<executorch::extension::llm::IOManager>(*module);
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::move(module),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::move(io_manager),
+      std::move(text_token_generator),
+      std::move(stats));
+  runner.load();
+
+  GenerationConfig config;
+  config.max_new_tokens = 2;
+  config.echo = false;
+  EXPECT_EQ(runner.generate("prompt", config), Error::Ok);
+  EXPECT_EQ(prefiller->chunk_size(), 128);
+
+  config.prefill_chunk_size = 16;
+  runner.reset();
+  EXPECT_EQ(runner.generate("prompt", config), Error::Ok);
+  EXPECT_EQ(prefiller->chunk_size(), 16);
+
+  // The adaptive chunk size needs parallel prefill, which this prefiller
+  // doesn't use, so it falls back to max_seq_len.
+  config.prefill_chunk_size = -1;
+  runner.reset();
+  EXPECT_EQ(runner.generate("prompt", config), Error::Ok);
+  EXPECT_EQ(prefiller->chunk_size(), 128);
+}
+
+// Test that restoring a KV cache snapshot makes generation continue exactly
+// as it did right after the snapshot was taken.
+TEST_F(RunnerTest, RestoredKVCacheSnapshotReproducesGeneration) {
+  constexpr int32_t kVocabSize = 16;
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  std::vector<uint64_t> prompt_tokens;
+  ON_CALL(*tokenizer, encode(_, _, _))
+      .WillByDefault([&](const std::string&, int8_t, int8_t) {
+        return ::tokenizers::Result<std::vector<uint64_t>>(prompt_tokens);
+      });
+  ON_CALL(*tokenizer, decode).WillByDefault([](uint64_t, uint64_t token) {
+    return ::tokenizers::Result<std::string>(std::to_string(token) + " ");
+  });
+
+  // A one-layer model whose cache holds the token at each position, and
+  // whose next token depends on the whole cache up to the current position.
+  executorch::aten::Tensor k_cache = tf.zeros({1, 128, 1});
+  float* const cache = k_cache.mutable_data_ptr<float>();
+  const auto next_token = [&](int64_t pos) {
+    int64_t sum = 0;
+    for (int64_t p = 0; p <= pos; ++p) {
+      sum += static_cast<int64_t>(cache[p]) * (p + 1);
+    }
+    return static_cast<uint64_t>(3 + sum % (kVocabSize - 3));
+  };
+  ON_CALL(*text_prefiller, prefill(_, _))
+      .WillByDefault([&](std::vector<uint64_t>& tokens, int64_t& start_pos) {
+        for (const auto token : tokens) {
+          cache[start_pos++] = static_cast<float>(token);
+        }
+        return Result<uint64_t>(next_token(start_pos - 1));
+      });
+  executorch::aten::Tensor logits = tf.zeros({1, kVocabSize});
+  ON_CALL(*text_decoder_runner, step)
+      .WillByDefault(
+          [&](executorch::extension::TensorPtr& tokens, int64_t start_pos) {
+            cache[start_pos] =
+                static_cast<float>(tokens->const_data_ptr<int64_t>()[0]);
+            float* const data = logits.mutable_data_ptr<float>();
+            std::fill(data, data + kVocabSize, 0.0f);
+            data[next_token(start_pos)] = 1.0f;
+            return Result<executorch::aten::Tensor>(logits);
+          });
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  auto module = std::make_unique<MockModule>();
+  ON_CALL(*module, get_attribute(_, _))
+      .WillByDefault([&](const std::string& method_name,
+                         const std::string& attribute_name) {
+        EXPECT_EQ(method_name, "forward");
+        if (attribute_name == "layers.0.attention.kv_cache.k_cache") {
+          return Result<executorch::aten::Tensor>(k_cache);
+        }
+        return Result<executorch::aten::Tensor>(Error::NotFound);
+      });
+  auto io_manager =
+      std::make_unique<executorch::extension::llm::IOManager>(*module);
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::move(module),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::move(io_manager),
+      std::move(text_token_generator),
+      std::move(stats));
+  runner.load();
+
+  GenerationConfig config;
+  config.max_new_tokens = 5;
+  config.echo = false;
+  config.temperature = 0.0f;
+  const auto generate = [&](std::vector<uint64_t> tokens) {
+    prompt_tokens = std::move(tokens);
+    std::string text;
+    EXPECT_EQ(
+        runner.generate(
+            "prompt",
+            config,
+            [&](const std::string& piece) { text += piece; }),
+        Error::Ok);
+    return text;
+  };
+
+  generate({1, 5, 6, 7});
+  auto snapshot = runner.snapshot_kv_cache();
+  ASSERT_EQ(snapshot.error(), Error::Ok);
+  const std::string continuation = generate({8, 9});
+
+  // Another session overwrites the cache before the snapshot is restored.
+  runner.reset();
+  generate({4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4});
+
+  ASSERT_EQ(runner.restore_kv_cache(*snapshot), Error::Ok);
+  EXPECT_EQ(generate({8, 9}), continuation);
+}
+
 } // namespace
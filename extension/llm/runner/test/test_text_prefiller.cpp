@@ -14,7 +14,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+
 using namespace ::testing;
+using executorch::extension::llm::Stats;
 using executorch::extension::llm::TextDecoderRunner;
 using executorch::extension::llm::TextPrefiller;
 using executorch::runtime::Error;
@@ -54,12 +58,14 @@ class TextPrefillerTest : public Test {
   std::unique_ptr<TextPrefiller> createTextPrefiller(
       int64_t max_seq_len,
       bool use_kv_cache = true,
-      bool enable_parallel_prefill = false) {
+      bool enable_parallel_prefill = false,
+      Stats* stats = nullptr) {
     return std::make_unique<TextPrefiller>(
         &text_decoder_runner_,
         use_kv_cache,
         enable_parallel_prefill,
-        max_seq_len);
+        max_seq_len,
+        stats);
   }
 
   // Create a mock TextPrefiller that allows us to mock prefill_chunk calls
@@ -305,4 +311,116 @@ TEST_F(TextPrefillerTest, PrefillChunkWorksWithParallelPrefill) {
   // Verify that start_pos has been updated correctly
   EXPECT_EQ(start_pos, prompt_tokens.size());
 }
+
+// Test that chunked prefill advances the position once per chunk and records
+// the timing of every chunk
+TEST_F(TextPrefillerTest, ChunkedPrefillRecordsChunkStats) {
+  Stats stats;
+  stats.reset();
+  auto prefiller = createTextPrefiller(3, true, true, &stats);
+
+  std::vector<int64_t> step_positions;
+  EXPECT_CALL(text_decoder_runner_, step(_, _))
+      .Times(3)
+      .WillRepeatedly([&](executorch::extension::TensorPtr&, int64_t pos) {
+        step_positions.push_back(pos);
+        return Result<executorch::aten::Tensor>(tensor);
+      });
+
+  std::vector<uint64_t> prompt_tokens = {1, 2, 3, 4, 5, 6, 7, 8};
+  int64_t start_pos = 2;
+  auto result = prefiller->prefill(prompt_tokens, start_pos);
+
+  EXPECT_EQ(result.error(), Error::Ok);
+  EXPECT_EQ(start_pos, 10);
+  EXPECT_EQ(step_positions, (std::vector<int64_t>{2, 5, 8}));
+  ASSERT_EQ(stats.prefill_chunks.size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(stats.prefill_chunks[i].start_pos, 2 + 3 * i);
+    EXPECT_EQ(stats.prefill_chunks[i].num_tokens, i < 2 ? 3 : 2);
+    EXPECT_LE(
+        stats.prefill_chunks[i].start_ms, stats.prefill_chunks[i].end_ms);
+  }
+}
+
+// Test that set_chunk_size() splits prompts that fit in max_seq_len
+TEST_F(TextPrefillerTest, SetChunkSizeSplitsPrompt) {
+  auto prefiller = createMockTextPrefiller(10);
+  prefiller->set_chunk_size(4);
+  EXPECT_EQ(prefiller->chunk_size(), 4);
+
+  std::vector<size_t> chunk_sizes;
+  EXPECT_CALL(*prefiller, prefill_chunk(_, _))
+      .Times(3)
+      .WillRepeatedly([&](std::vector<uint64_t>& tokens, int64_t&) {
+        chunk_sizes.push_back(tokens.size());
+        return Result<uint64_t>(tokens.back());
+      });
+
+  std::vector<uint64_t> prompt_tokens = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  int64_t start_pos = 0;
+  auto result = prefiller->prefill(prompt_tokens, start_pos);
+
+  EXPECT_EQ(result.error(), Error::Ok);
+  EXPECT_EQ(result.get(), 9);
+  EXPECT_EQ(start_pos, 9);
+  EXPECT_EQ(chunk_sizes, (std::vector<size_t>{4, 4, 1}));
+
+  // Chunks larger than max_seq_len are clamped.
+  prefiller->set_chunk_size(100);
+  EXPECT_EQ(prefiller->chunk_size(), 10);
+}
+
+// Test that the adaptive chunk size probes halving chunk sizes and keeps the
+// one with the best throughput
+TEST_F(TextPrefillerTest, AdaptiveChunkSizePicksFastestChunkSize) {
+  Stats stats;
+  stats.reset();
+  auto prefiller = createTextPrefiller(128, true, true, &stats);
+  prefiller->set_adaptive_chunk_size(true);
+
+  // Chunks of 64 tokens are the fastest per token.
+  ON_CALL(text_decoder_runner_, step(_, _))
+      .WillByDefault([&](executorch::extension::TensorPtr& tokens, int64_t) {
+        const auto num_tokens = tokens->size(1);
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(num_tokens == 64 ? 2 : 40));
+        return Result<executorch::aten::Tensor>(tensor);
+      });
+
+  std::vector<uint64_t> prompt_tokens(300, 1);
+  int64_t start_pos = 0;
+  auto result = prefiller->prefill(prompt_tokens, start_pos);
+
+  EXPECT_EQ(result.error(), Error::Ok);
+  EXPECT_EQ(start_pos, 300);
+  std::vector<int64_t> chunk_sizes;
+  std::vector<int64_t> chunk_positions;
+  for (const auto& chunk : stats.prefill_chunks) {
+    chunk_sizes.push_back(chunk.num_tokens);
+    chunk_positions.push_back(chunk.start_pos);
+  }
+  // Probes of 128, 64 and 32 tokens at the same position, then chunks of 64
+  // after the last probe.
+  EXPECT_EQ(
+      chunk_sizes, (std::vector<int64_t>{128, 64, 32, 64, 64, 64, 64, 12}));
+  EXPECT_EQ(
+      chunk_positions,
+      (std::vector<int64_t>{0, 0, 0, 32, 96, 160, 224, 288}));
+  EXPECT_EQ(prefiller->chunk_size(), 64);
+}
+
+// Test that the adaptive chunk size is ignored for sequential prefill
+TEST_F(TextPrefillerTest, AdaptiveChunkSizeNeedsParallelPrefill) {
+  auto prefiller = createTextPrefiller(128, true, false);
+  prefiller->set_adaptive_chunk_size(true);
+  EXPECT_EQ(prefiller->chunk_size(), 128);
+
+  EXPECT_CALL(text_decoder_runner_, step(_, _)).Times(200);
+  std::vector<uint64_t> prompt_tokens(200, 1);
+  int64_t start_pos = 0;
+  auto result = prefiller->prefill(prompt_tokens, start_pos);
+  EXPECT_EQ(result.error(), Error::Ok);
+  EXPECT_EQ(start_pos, 200);
+}
 } // namespace
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/token_constraint.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::extension::llm::RegexTokenConstraint;
+using executorch::extension::llm::TextDecoderRunner;
+using executorch::runtime::Error;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+class TokenConstraintTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // Samples greedily under `constraint` until it is complete, returning the
+  // generated text without the end of sequence token.
+  std::string generate_greedily(
+      RegexTokenConstraint& constraint,
+      const std::vector<std::string>& vocab,
+      uint64_t eos,
+      unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> dist;
+    std::string text;
+    std::vector<float> logits(vocab.size());
+    for (int step = 0; step < 100 && !constraint.is_complete(); ++step) {
+      for (float& logit : logits) {
+        logit = dist(gen);
+      }
+      constraint.process(logits.data(), logits.size(), {});
+      const auto token =
+          std::max_element(logits.begin(), logits.end()) - logits.begin();
+      EXPECT_TRUE(std::isfinite(logits[token]));
+      EXPECT_TRUE(constraint.advance(token));
+      if (static_cast<uint64_t>(token) != eos) {
+        text += vocab[token];
+      }
+    }
+    EXPECT_TRUE(constraint.is_complete());
+    return text;
+  }
+};
+
+TEST_F(TokenConstraintTest, MasksTokensThatCannotMatch) {
+  const std::vector<std::string> vocab = {"a", "1", "12", "3x", "</s>", "9"};
+  auto constraint = RegexTokenConstraint::create("[0-9]+", vocab, {4});
+  ASSERT_TRUE(constraint.ok());
+  auto& c = *constraint.get();
+
+  std::vector<float> logits = {5, 1, 2, 6, 7, 3};
+  c.process(logits.data(), logits.size(), {});
+  EXPECT_TRUE(std::isinf(logits[0]));
+  EXPECT_EQ(logits[1], 1);
+  EXPECT_EQ(logits[2], 2);
+  EXPECT_TRUE(std::isinf(logits[3]));
+  // Nothing matched yet, so the text can't end.
+  EXPECT_TRUE(std::isinf(logits[4]));
+  EXPECT_EQ(logits[5], 3);
+
+  EXPECT_FALSE(c.advance(0));
+  EXPECT_FALSE(c.advance(4));
+  EXPECT_TRUE(c.advance(2));
+  EXPECT_TRUE(c.is_allowed(4));
+  EXPECT_FALSE(c.is_complete());
+  EXPECT_TRUE(c.advance(4));
+  EXPECT_TRUE(c.is_complete());
+
+  c.reset();
+  EXPECT_FALSE(c.is_allowed(4));
+  EXPECT_FALSE(c.is_complete());
+}
+
+TEST_F(TokenConstraintTest, CompletesWhenNothingCanFollow) {
+  const std::vector<std::string> vocab = {"a", "b", "ab", "c"};
+  auto constraint = RegexTokenConstraint::create("ab?", vocab, {});
+  ASSERT_TRUE(constraint.ok());
+  auto& c = *constraint.get();
+
+  EXPECT_TRUE(c.advance(0));
+  // "a" matches, but "b" can still follow.
+  EXPECT_FALSE(c.is_complete());
+  EXPECT_TRUE(c.advance(1));
+  EXPECT_TRUE(c.is_complete());
+
+  c.reset();
+  EXPECT_TRUE(c.advance(2));
+  EXPECT_TRUE(c.is_complete());
+  EXPECT_FALSE(c.is_allowed(3));
+}
+
+TEST_F(TokenConstraintTest, GeneratesTextMatchingJsonPattern) {
+  std::vector<std::string> vocab;
+  for (int b = 32; b < 127; ++b) {
+    vocab.emplace_back(1, static_cast<char>(b));
+  }
+  for (const char* piece :
+       {"{\"", "\":", " \"", "\",", "name", "age", "ab", "12", "}", "\n"}) {
+    vocab.emplace_back(piece);
+  }
+  const uint64_t eos = vocab.size();
+  vocab.emplace_back("</s>");
+
+  const std::string pattern =
+      R"(\{"name": "[a-z]{1,8}", "age": (0|[1-9]\d{0,2})\})";
+  auto constraint = RegexTokenConstraint::create(pattern, vocab, {eos});
+  ASSERT_TRUE(constraint.ok());
+
+  for (unsigned seed = 0; seed < 20; ++seed) {
+    constraint.get()->reset();
+    const std::string text =
+        generate_greedily(*constraint.get(), vocab, eos, seed);
+    ASSERT_EQ(text.rfind("{\"name\": \"", 0), 0u) << text;
+    const size_t name_end = text.find('"', 10);
+    ASSERT_NE(name_end, std::string::npos) << text;
+    const std::string name = text.substr(10, name_end - 10);
+    EXPECT_GE(name.size(), 1u);
+    EXPECT_LE(name.size(), 8u);
+    for (const char ch : name) {
+      EXPECT_TRUE(ch >= 'a' && ch <= 'z') << text;
+    }
+    const std::string rest = text.substr(name_end);
+    ASSERT_EQ(rest.rfind("\", \"age\": ", 0), 0u) << text;
+    const std::string age = rest.substr(10, rest.size() - 11);
+    EXPECT_EQ(rest.back(), '}');
+    EXPECT_GE(age.size(), 1u);
+    EXPECT_LE(age.size(), 3u);
+    EXPECT_TRUE(age == "0" || age[0] != '0') << text;
+  }
+}
+
+TEST_F(TokenConstraintTest, NegatedClassAcceptsMultiByteCharacters) {
+  // "h\u00e9" and the two halves of "\u20ac".
+  const std::vector<std::string> vocab = {
+      "\"", "h\xc3\xa9", "\xe2\x82", "\xac"};
+  auto constraint = RegexTokenConstraint::create(R"("[^"]*")", vocab, {});
+  ASSERT_TRUE(constraint.ok());
+  auto& c = *constraint.get();
+  for (const uint64_t token : {0, 1, 2, 3, 0}) {
+    EXPECT_TRUE(c.advance(token));
+  }
+  EXPECT_TRUE(c.is_complete());
+}
+
+TEST_F(TokenConstraintTest, RejectsInvalidPatterns) {
+  const std::vector<std::string> vocab = {"a", "b"};
+  for (const char* pattern :
+       {"(a", "a)", "a{3,1}", "[a-", "\\q", "*a", "a{2}{3}", "[b-a]", "a{2"}) {
+    auto constraint = RegexTokenConstraint::create(pattern, vocab, {});
+    EXPECT_EQ(constraint.error(), Error::InvalidArgument) << pattern;
+  }
+  // Patterns that can't match anything are rejected too.
+  EXPECT_EQ(
+      RegexTokenConstraint::create("[^\\x00-\\xff]", vocab, {}).error(),
+      Error::InvalidArgument);
+  EXPECT_TRUE(RegexTokenConstraint::create("(a|b){2,}", vocab, {}).ok());
+}
+
+TEST_F(TokenConstraintTest, CompilesAgainstTokenizerVocab) {
+  MockTokenizer tokenizer;
+  const std::vector<std::string> pieces = {"<s>", "</s>", " yes", " no", "x"};
+  EXPECT_CALL(tokenizer, is_loaded()).WillRepeatedly(Return(true));
+  EXPECT_CALL(tokenizer, vocab_size()).WillRepeatedly(Return(pieces.size()));
+  EXPECT_CALL(tokenizer, bos_tok()).WillRepeatedly(Return(0));
+  EXPECT_CALL(tokenizer, decode(_, _))
+      .WillRepeatedly([&](uint64_t, uint64_t token) {
+        return ::tokenizers::Result<std::string>(pieces[token]);
+      });
+
+  auto constraint =
+      RegexTokenConstraint::create(" (yes|no)", tokenizer, {1});
+  ASSERT_TRUE(constraint.ok());
+  auto& c = *constraint.get();
+  EXPECT_FALSE(c.is_allowed(0));
+  EXPECT_FALSE(c.is_allowed(1));
+  EXPECT_TRUE(c.is_allowed(2));
+  EXPECT_TRUE(c.is_allowed(3));
+  EXPECT_FALSE(c.is_allowed(4));
+  EXPECT_TRUE(c.advance(3));
+  EXPECT_TRUE(c.is_allowed(1));
+}
+
+TEST_F(TokenConstraintTest, DecoderRunnerSamplesAllowedTokens) {
+  const std::vector<std::string> vocab = {"x", "a", "b", "</s>"};
+  auto constraint = RegexTokenConstraint::create("ab", vocab, {3});
+  ASSERT_TRUE(constraint.ok());
+  std::shared_ptr<RegexTokenConstraint> c = std::move(constraint.get());
+
+  TextDecoderRunner runner(nullptr, nullptr);
+  runner.set_token_constraint(c);
+  TensorFactory<ScalarType::Float> tf;
+  // "x" and the end of sequence token have the largest logits.
+  auto logits = tf.make({1, 4}, {9.0f, 1.0f, 2.0f, 8.0f});
+  EXPECT_EQ(runner.logits_to_token(logits), 1);
+  logits = tf.make({1, 4}, {9.0f, 1.0f, 2.0f, 8.0f});
+  EXPECT_EQ(runner.logits_to_token(logits), 2);
+  logits = tf.make({1, 4}, {9.0f, 1.0f, 2.0f, 8.0f});
+  EXPECT_EQ(runner.logits_to_token(logits), 3);
+  EXPECT_TRUE(c->is_complete());
+
+  // Without the constraint the runner samples freely again.
+  runner.set_token_constraint(nullptr);
+  logits = tf.make({1, 4}, {9.0f, 1.0f, 2.0f, 8.0f});
+  EXPECT_EQ(runner.logits_to_token(logits), 0);
+}
+
+} // namespace
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <executorch/extension/llm/runner/text_token_generator.h>
+#include <executorch/extension/llm/runner/token_streamer.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::Stats;
+using executorch::extension::llm::TextDecoderRunner;
+using executorch::extension::llm::TextTokenGenerator;
+using executorch::extension::llm::TokenStreamer;
+using executorch::extension::llm::utf8_complete_prefix_length;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+// Samples the tokens 1, 2, 3, ... in order, taking 1 ms per step.
+class CountingDecoderRunner : public TextDecoderRunner {
+ public:
+  CountingDecoderRunner() : TextDecoderRunner(nullptr, nullptr) {}
+
+  Result<executorch::aten::Tensor> step(TensorPtr&, int64_t start_pos)
+      override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::vector<float> logits(kVocabSize, 0.0f);
+    logits[(start_pos + 1) % kVocabSize] = 1.0f;
+    logits_ = tf_.make({1, kVocabSize}, logits);
+    return logits_;
+  }
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  static constexpr int32_t kVocabSize = 64;
+
+ private:
+  TensorFactory<executorch::aten::ScalarType::Float> tf_;
+  executorch::aten::Tensor logits_ = tf_.zeros({1, kVocabSize});
+};
+
+class TokenStreamerTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    // Token i decodes to pieces_[i], spelling "h\u00e9llo \u20ac!" with both
+    // non-ASCII characters split across tokens.
+    pieces_ = {"", "h", "\xc3", "\xa9l", "lo ", "\xe2", "\x82", "\xac!"};
+    ON_CALL(tokenizer_, decode).WillByDefault([this](uint64_t, uint64_t token) {
+      if (token >= pieces_.size()) {
+        return ::tokenizers::Result<std::string>(
+            ::tokenizers::Error::DecodeFailure);
+      }
+      return ::tokenizers::Result<std::string>(pieces_[token]);
+    });
+  }
+
+  std::unique_ptr<TextTokenGenerator> make_generator(uint64_t eos) {
+    return std::make_unique<TextTokenGenerator>(
+        &tokenizer_,
+        &decoder_runner_,
+        /*use_kv_cache=*/true,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{eos}),
+        &stats_);
+  }
+
+  std::vector<std::string> pieces_;
+  NiceMock<MockTokenizer> tokenizer_;
+  CountingDecoderRunner decoder_runner_;
+  Stats stats_;
+};
+
+TEST_F(TokenStreamerTest, CompletePrefixExcludesPartialCharacter) {
+  EXPECT_EQ(utf8_complete_prefix_length(""), 0u);
+  EXPECT_EQ(utf8_complete_prefix_length("abc"), 3u);
+  EXPECT_EQ(utf8_complete_prefix_length("a\xc3"), 1u);
+  EXPECT_EQ(utf8_complete_prefix_length("a\xc3\xa9"), 3u);
+  EXPECT_EQ(utf8_complete_prefix_length("\xe2\x82"), 0u);
+  EXPECT_EQ(utf8_complete_prefix_length("ab\xf0\x9f\x98"), 2u);
+  EXPECT_EQ(utf8_complete_prefix_length("ab\xf0\x9f\x98\x80"), 6u);
+  // Invalid sequences are passed through.
+  EXPECT_EQ(utf8_complete_prefix_length("\xa9\xa9"), 2u);
+  EXPECT_EQ(utf8_complete_prefix_length("a\xc3\xa9\xa9"), 4u);
+  EXPECT_EQ(utf8_complete_prefix_length("a\xff"), 2u);
+}
+
+TEST_F(TokenStreamerTest, DeliversWholeCharactersInOrder) {
+  TokenStreamer streamer(&tokenizer_, /*capacity=*/2);
+  std::vector<std::string> outputs;
+  const auto caller = std::this_thread::get_id();
+  bool called_on_caller = false;
+  streamer.start(0, [&](const std::string& text) {
+    called_on_caller |= std::this_thread::get_id() == caller;
+    outputs.push_back(text);
+  });
+  for (uint64_t token = 1; token < pieces_.size(); ++token) {
+    streamer.push(token);
+  }
+  EXPECT_EQ(streamer.finish(), Error::Ok);
+  EXPECT_FALSE(called_on_caller);
+  EXPECT_THAT(outputs, ElementsAre("h", "\xc3\xa9l", "lo ", "\xe2\x82\xac!"));
+
+  // The streamer can be restarted, and delivers a trailing partial character
+  // when finishing.
+  outputs.clear();
+  streamer.start(0, [&](const std::string& text) { outputs.push_back(text); });
+  streamer.push(1);
+  streamer.push(5);
+  EXPECT_EQ(streamer.finish(), Error::Ok);
+  EXPECT_THAT(outputs, ElementsAre("h", "\xe2"));
+}
+
+TEST_F(TokenStreamerTest, ReportsDecodeFailure) {
+  TokenStreamer streamer(&tokenizer_);
+  std::string text;
+  streamer.start(0, [&](const std::string& piece) { text += piece; });
+  streamer.push(1);
+  streamer.push(100);
+  streamer.push(4);
+  EXPECT_EQ(streamer.finish(), Error::InvalidArgument);
+  EXPECT_EQ(text, "h");
+}
+
+TEST_F(TokenStreamerTest, GeneratorOutputsAsynchronously) {
+  auto generator = make_generator(/*eos=*/7);
+  generator->set_async_output(true);
+  std::string text;
+  int num_calls = 0;
+  auto result = generator->generate(
+      {0}, 0, 20, 0.0f, [&](const std::string& piece) {
+        // A slow consumer.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        text += piece;
+        ++num_calls;
+      });
+  ASSERT_TRUE(result.ok());
+  // Stopped at the end of sequence token, after every piece was delivered.
+  EXPECT_EQ(result.get(), 7);
+  EXPECT_EQ(text, "h\xc3\xa9llo \xe2\x82\xac!");
+  EXPECT_EQ(num_calls, 4);
+
+  // Without the output thread, every token is delivered as is.
+  generator->set_async_output(false);
+  std::vector<std::string> outputs;
+  auto sync_result = generator->generate(
+      {0}, 0, 20, 0.0f, [&](const std::string& piece) {
+        outputs.push_back(piece);
+      });
+  ASSERT_TRUE(sync_result.ok());
+  EXPECT_EQ(outputs.size(), 7u);
+}
+
+TEST_F(TokenStreamerTest, GeneratorFailsOnDecodeError) {
+  // Nothing stops generation before token 8, which fails to decode.
+  auto generator = make_generator(/*eos=*/63);
+  generator->set_async_output(true);
+  auto result =
+      generator->generate({0}, 0, 40, 0.0f, [](const std::string&) {});
+  EXPECT_EQ(result.error(), Error::InvalidArgument);
+
+  // Stopping from the callback stops generation soon after.
+  pieces_.resize(64, "x");
+  auto stopped = generator->generate(
+      {0}, 0, 60, 0.0f, [&](const std::string&) { generator->stop(); });
+  ASSERT_TRUE(stopped.ok());
+  EXPECT_LT(stopped.get(), 60);
+}
+
+} // namespace
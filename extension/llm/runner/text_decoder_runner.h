@@ -10,7 +10,13 @@
 
 #pragma once
 
+#include <cinttypes>
+#include <ctime>
+#include <memory>
+#include <vector>
+
 #include <executorch/extension/llm/runner/io_manager/io_manager.h>
+#include <executorch/extension/llm/runner/token_constraint.h>
 #include <executorch/extension/llm/sampler/sampler.h>
 
 namespace executorch {
@@ -54,16 +60,101 @@ class ET_EXPERIMENTAL TextDecoderRunner {
     should_stop_ = true;
   }
 
+  /**
+   * Sets the sampling parameters used by logits_to_token() from now on. The
+   * temperature is still passed to every logits_to_token() call.
+   */
+  void set_sampler_config(const SamplerConfig& config) {
+    sampler_config_ = config;
+    if (sampler_) {
+      sampler_->set_config(config);
+    }
+  }
+
+  const SamplerConfig& sampler_config() const {
+    return sampler_config_;
+  }
+
+  /**
+   * Restarts the RNG stream of the sampler, so that the tokens sampled from
+   * here on are reproducible.
+   */
+  void set_rng_seed(unsigned long long rng_seed) {
+    rng_seed_ = rng_seed;
+    if (sampler_) {
+      sampler_->set_rng_seed(rng_seed);
+    }
+  }
+
+  /**
+   * Appends a step, e.g. a grammar mask, to the logits processing pipeline of
+   * the sampler.
+   */
+  void add_logits_processor(std::unique_ptr<LogitsProcessor> processor) {
+    logits_processors_.push_back(std::move(processor));
+    if (sampler_) {
+      install_logits_processors(*sampler_);
+    }
+  }
+
+  /**
+   * Restricts every token sampled by logits_to_token() to the ones allowed by
+   * `constraint`, which is advanced with each sampled token. Its mask is
+   * applied after every other logits processor. Pass nullptr to remove it.
+   */
+  void set_token_constraint(std::shared_ptr<TokenConstraint> constraint) {
+    token_constraint_ = std::move(constraint);
+    if (sampler_) {
+      install_logits_processors(*sampler_);
+    }
+  }
+
+  const std::shared_ptr<TokenConstraint>& token_constraint() const {
+    return token_constraint_;
+  }
+
   /**
    * Sample the next token from the logits tensor.
    * @param logits_tensor The logits tensor.
    * @param temperature The temperature parameter used to control randomness in
    * sampling.
+   * @param tokens The tokens seen so far, for the repetition penalties of the
+   * sampler config.
    * @return The next token.
    */
   inline int32_t logits_to_token(
       const executorch::aten::Tensor& logits_tensor,
-      const float temperature = 0.0f) {
+      const float temperature = 0.0f,
+      const std::vector<uint64_t>& tokens = {}) {
+    // If the logit_tensor rank is 3, the shape is [batch, seq_length,
+    // vocab_size], sample from the last logits. Else the model outputs the
+    // last logits only.
+    const int64_t row =
+        logits_tensor.dim() == 3 ? logits_tensor.size(1) - 1 : 0;
+    return logits_to_token_at(logits_tensor, row, temperature, tokens);
+  }
+
+  /**
+   * Sample a token from the logits of the row-th input token, for models that
+   * output the logits of every input token, e.g. to verify draft tokens.
+   * @param logits_tensor The [batch, seq_length, vocab_size] logits tensor.
+   * @param row The index of the input token whose logits to sample from.
+   * @param temperature The temperature parameter used to control randomness in
+   * sampling.
+   * @param tokens The tokens seen so far, for the repetition penalties of the
+   * sampler config.
+   * @return The token following the row-th input token.
+   */
+  inline int32_t logits_to_token_at(
+      const executorch::aten::Tensor& logits_tensor,
+      const int64_t row,
+      const float temperature = 0.0f,
+      const std::vector<uint64_t>& tokens = {}) {
+    ET_CHECK_MSG(
+        row == 0 ||
+            (logits_tensor.dim() == 3 && row < logits_tensor.size(1)),
+        "Logits row %" PRId64 " out of range",
+        row);
     int32_t result = 0;
 
     // Create a minimal context for error handling in ET_SWITCH
@@ -80,26 +171,50 @@ class ET_EXPERIMENTAL TextDecoderRunner {
         UInt16,
         logits_tensor.scalar_type(),
         ctx,
-        "logits_to_token",
+        "logits_to_token_at",
         CTYPE,
         [&]() {
-          // If the logit_tensor rank is 3, the shape is [batch, seq_length,
-          // vocab_size], get the last logits, sample and return. Else the model
-          // outputs the last logit, directly sample and return.
           auto* logits = logits_tensor.mutable_data_ptr<CTYPE>();
           ssize_t vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
-          if (logits_tensor.dim() == 3) {
-            auto num_tokens = logits_tensor.size(1);
-            logits += (num_tokens - 1) * vocab_size;
-          }
-          // @lint-ignore CLANGTIDY facebook-hte-Deprecated
-          Sampler sampler(vocab_size, temperature);
-          result = sampler.sample(logits);
+          logits += row * vocab_size;
+          Sampler& sampler = get_sampler(static_cast<int32_t>(vocab_size));
+          sampler.set_temperature(temperature);
+          result = sampler.sample(logits, tokens);
         });
+    if (token_constraint_ && !token_constraint_->advance(result)) {
+      ET_LOG(
+          Error, "Sampled token %d is not allowed by the constraint", result);
+    }
     return result;
   }
 
  protected:
+  /**
+   * Returns the long lived sampler, creating it on first use or when the
+   * vocab size changes. It keeps its RNG state and scratch buffers across
+   * tokens.
+   */
+  Sampler& get_sampler(int32_t vocab_size) {
+    if (!sampler_ || sampler_->vocab_size() != vocab_size) {
+      sampler_ =
+          std::make_unique<Sampler>(vocab_size, sampler_config_, rng_seed_);
+      install_logits_processors(*sampler_);
+    }
+    return *sampler_;
+  }
+
+  void install_logits_processors(Sampler& sampler) {
+    sampler.clear_logits_processors();
+    for (auto& processor : logits_processors_) {
+      sampler.add_logits_processor(
+          std::make_unique<SharedLogitsProcessor>(processor.get()));
+    }
+    if (token_constraint_) {
+      sampler.add_logits_processor(
+          std::make_unique<SharedLogitsProcessor>(token_constraint_.get()));
+    }
+  }
+
   /**
    * Note: TextDecoderRunner does not own the Module or IOManager instance. It
    * is expected that the outer class (likely Runner) manages the lifecycle of
@@ -110,6 +225,30 @@ class ET_EXPERIMENTAL TextDecoderRunner {
   Module* module_;
   IOManager* io_manager_;
   bool should_stop_{false};
+
+ private:
+  // Forwards to a processor owned by the runner, so that recreating the
+  // sampler for another vocab size keeps the pipeline.
+  class SharedLogitsProcessor : public LogitsProcessor {
+   public:
+    explicit SharedLogitsProcessor(LogitsProcessor* processor)
+        : processor_(processor) {}
+    void process(
+        float* logits,
+        int32_t vocab_size,
+        const std::vector<uint64_t>& tokens) override {
+      processor_->process(logits, vocab_size, tokens);
+    }
+
+   private:
+    LogitsProcessor* processor_;
+  };
+
+  SamplerConfig sampler_config_;
+  unsigned long long rng_seed_ = std::time(nullptr);
+  std::vector<std::unique_ptr<LogitsProcessor>> logits_processors_;
+  std::shared_ptr<TokenConstraint> token_constraint_;
+  std::unique_ptr<Sampler> sampler_;
 };
 
 } // namespace llm
@@ -10,6 +10,9 @@
 // A simple llama2 runner that includes preprocessing and post processing logic.
 // The module takes in a string as input and emits a string as output.
 
+#include <algorithm>
+#include <limits>
+
 #include <executorch/extension/llm/runner/io_manager/io_manager.h>
 #include <executorch/extension/llm/runner/text_llm_runner.h>
 #include <executorch/extension/llm/runner/util.h>
@@ -25,6 +28,14 @@ using ::executorch::extension::Module;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::Result;
 
+namespace {
+
+// Marks KV cache positions whose token is not known, e.g. after a failed
+// prefill. It never matches a prompt token.
+constexpr uint64_t kUnknownToken = std::numeric_limits<uint64_t>::max();
+
+} // namespace
+
 TextLLMRunner::TextLLMRunner(
     std::unordered_map<std::string, int64_t> metadata,
     std::unique_ptr<::tokenizers::Tokenizer> tokenizer,
@@ -163,8 +174,42 @@ Error TextLLMRunner::generate(
   if (config.echo) {
     wrapped_callback(prompt);
   }
+
+  // Skip the part of the prompt whose KV cache entries are already resident.
+  int64_t num_cached_prompt_tokens = 0;
+  if (config.reuse_prompt_prefix && metadata_.at(kUseKVCache)) {
+    num_cached_prompt_tokens = num_resident_prefix_tokens(prompt_tokens);
+  }
+  if (num_cached_prompt_tokens > 0) {
+    RUNNER_ET_LOG(
+        config.warming,
+        "Reusing the KV cache of %" PRId64 " prompt tokens",
+        num_cached_prompt_tokens);
+    pos_ += num_cached_prompt_tokens;
+    prompt_tokens.erase(
+        prompt_tokens.begin(),
+        prompt_tokens.begin() + num_cached_prompt_tokens);
+  }
+  // Everything from pos_ on is about to be overwritten.
+  kv_tokens_.resize(pos_, kUnknownToken);
+
+  // Keep the measurements of the adaptive chunk size across calls.
+  if (config.prefill_chunk_size != prefill_chunk_size_) {
+    prefill_chunk_size_ = config.prefill_chunk_size;
+    if (prefill_chunk_size_ < 0) {
+      text_prefiller_->set_adaptive_chunk_size(true);
+    } else {
+      text_prefiller_->set_chunk_size(prefill_chunk_size_);
+    }
+  }
+  stats_->prefill_chunks.clear();
+  if (const auto& constraint = text_token_generator_->constraint()) {
+    constraint->reset();
+  }
   auto prefill_res = text_prefiller_->prefill(prompt_tokens, pos_);
   ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
+  kv_tokens_.insert(
+      kv_tokens_.end(), prompt_tokens.begin(), prompt_tokens.end());
   uint64_t cur_token = prefill_res.get();
   stats_->first_token_ms = time_in_ms();
   stats_->prompt_eval_end_ms = time_in_ms();
@@ -180,13 +225,54 @@ Error TextLLMRunner::generate(
   // start the main loop
   prompt_tokens.push_back(cur_token);
 
+  // The sampler outlives this call; only its per-request parameters change.
+  SamplerConfig sampler_config = text_decoder_runner_->sampler_config();
+  sampler_config.topp = config.top_p;
+  sampler_config.topk = config.top_k;
+  sampler_config.repetition_penalty = config.repetition_penalty;
+  sampler_config.frequency_penalty = config.frequency_penalty;
+  sampler_config.presence_penalty = config.presence_penalty;
+  text_decoder_runner_->set_sampler_config(sampler_config);
+  if (config.seed >= 0) {
+    text_decoder_runner_->set_rng_seed(
+        static_cast<unsigned long long>(config.seed));
+  }
+
+  int32_t num_lookup_draft_tokens = config.num_lookup_draft_tokens;
+  if (num_lookup_draft_tokens > 0 &&
+      !(metadata_.at(kUseKVCache) && metadata_.at(kEnableDynamicShape))) {
+    ET_LOG(
+        Info,
+        "Prompt lookup decoding needs a KV cache and dynamic shapes, "
+        "disabling it");
+    num_lookup_draft_tokens = 0;
+  }
+  // The drafts are fed to the model along with the last token.
+  num_lookup_draft_tokens = std::min<int64_t>(
+      num_lookup_draft_tokens, metadata_.at(kMaxSeqLen) - 1);
+  text_token_generator_->set_lookup_decoding(
+      num_lookup_draft_tokens, config.lookup_ngram_size);
+
   // Generate max_new_tokens - 1 because prefill already generated 1 token.
+  std::vector<uint64_t> generated_tokens;
   int64_t num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
       prompt_tokens,
-      num_prompt_tokens,
+      pos_,
       max_new_tokens - 1,
       temperature_ == -1.0f ? config.temperature : temperature_,
-      wrapped_callback));
+      wrapped_callback,
+      &generated_tokens));
+
+  // Every decode step writes the KV cache entries of the token it was fed:
+  // the token from prefill, then all generated tokens but the last one.
+  if (num_generated_tokens > 0) {
+    kv_tokens_.push_back(cur_token);
+    kv_tokens_.insert(
+        kv_tokens_.end(),
+        generated_tokens.begin(),
+        generated_tokens.begin() + (num_generated_tokens - 1));
+  }
+  pos_ += num_generated_tokens;
 
   stats_->inference_end_ms = time_in_ms();
   if (!config.warming) {
@@ -202,6 +288,7 @@ Error TextLLMRunner::generate(
   }
 
   stats_->num_prompt_tokens = num_prompt_tokens;
+  stats_->num_cached_prompt_tokens = num_cached_prompt_tokens;
   stats_->num_generated_tokens = num_generated_tokens;
 
   if (config.warming) {
@@ -238,9 +325,55 @@ void TextLLMRunner::stop() {
   }
 }
 
+Error TextLLMRunner::load_kv_cache_buffers() {
+  if (!kv_cache_buffers_.empty()) {
+    return Error::Ok;
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  auto buffers = find_kv_cache_buffers(
+      *module_, "forward", metadata_.at(kMaxContextLen));
+  ET_CHECK_OK_OR_RETURN_ERROR(buffers.error());
+  kv_cache_buffers_ = std::move(*buffers);
+  return Error::Ok;
+}
+
+Result<KVCacheSnapshot> TextLLMRunner::snapshot_kv_cache(bool quantize_int8) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_kv_cache_buffers());
+  std::vector<uint64_t> tokens(kv_tokens_.begin(), kv_tokens_.end());
+  tokens.resize(pos_, kUnknownToken);
+  return KVCacheSnapshot::capture(
+      kv_cache_buffers_, pos_, std::move(tokens), quantize_int8);
+}
+
+Error TextLLMRunner::restore_kv_cache(const KVCacheSnapshot& snapshot) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_kv_cache_buffers());
+  ET_CHECK_OK_OR_RETURN_ERROR(snapshot.restore(kv_cache_buffers_));
+  pos_ = snapshot.num_positions();
+  kv_tokens_ = snapshot.tokens();
+  kv_tokens_.resize(pos_, kUnknownToken);
+  stats_->reset();
+  return Error::Ok;
+}
+
 void TextLLMRunner::reset() {
   stats_->reset();
   pos_ = 0;
 }
 
+int64_t TextLLMRunner::num_resident_prefix_tokens(
+    const std::vector<uint64_t>& prompt_tokens) const {
+  if (kv_tokens_.size() <= static_cast<size_t>(pos_)) {
+    return 0;
+  }
+  // The last prompt token is always prefilled to get the logits of the first
+  // generated token.
+  const size_t max_len =
+      std::min(kv_tokens_.size() - pos_, prompt_tokens.size() - 1);
+  size_t len = 0;
+  while (len < max_len && kv_tokens_[pos_ + len] == prompt_tokens[len]) {
+    ++len;
+  }
+  return len;
+}
+
 } // namespace executorch::extension::llm
@@ -16,8 +16,10 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -119,10 +121,68 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
    * @brief Remove prefilled tokens and reset start position, and stats.
    *
    * This method removes the prefilled tokens from the KV cache and resets the
-   * start position to 0. It also clears the stats for previous runs.
+   * start position to 0. It also clears the stats for previous runs. The KV
+   * cache entries themselves are left in place, so a following generate()
+   * with GenerationConfig::reuse_prompt_prefix can reuse a shared prefix.
    */
   void reset() override;
 
+  /**
+   * @brief Snapshots the KV cache of the current session
+   *
+   * Copies the KV cache entries of positions [0, pos_) along with their
+   * tokens, so that the session can be dropped and later resumed with
+   * restore_kv_cache() without prefilling it again. The snapshot can be
+   * persisted with KVCacheSnapshot::serialize() or KVCacheSnapshot::save().
+   * Requires a model exported with
+   * ExecutorchBackendConfig(emit_mutable_buffer_names=True).
+   *
+   * @param quantize_int8 Whether to store floating point cache entries as
+   * int8 with per-row scales, which is lossy
+   * @return The snapshot, or an error if the KV cache buffers can't be found
+   */
+  ::executorch::runtime::Result<KVCacheSnapshot> snapshot_kv_cache(
+      bool quantize_int8 = false);
+
+  /**
+   * @brief Restores a KV cache snapshot taken from a runner of the same model
+   *
+   * Writes the snapshot into the KV cache and sets the start position to the
+   * end of it, so that the next generate() continues the snapshotted session.
+   *
+   * @param snapshot The snapshot to restore
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error restore_kv_cache(
+      const KVCacheSnapshot& snapshot);
+
+  /**
+   * @brief Constrains the generated text, e.g. with a RegexTokenConstraint
+   *
+   * The constraint is reset at the start of every generate() and applied to
+   * every sampled token, including the first one from prefill. Generation
+   * stops once the constraint is complete.
+   *
+   * @param constraint The constraint, or nullptr to generate freely
+   */
+  void set_token_constraint(std::shared_ptr<TokenConstraint> constraint) {
+    text_token_generator_->set_constraint(std::move(constraint));
+  }
+
+  /**
+   * @brief Delivers the generated text on a separate output thread
+   *
+   * Tokens are decoded and passed to the token callback off the generation
+   * loop, so that a slow callback doesn't delay the model. The callback
+   * receives whole UTF-8 characters, possibly merging several tokens, and
+   * every call completes before generate() returns.
+   *
+   * @param async_output Whether to use the output thread
+   */
+  void set_async_output(bool async_output) {
+    text_token_generator_->set_async_output(async_output);
+  }
+
   /**
    * @brief Stops the ongoing text generation process
    *
@@ -157,6 +217,24 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
 
   // The position in KV cache of the input, starting from 0.
   int64_t pos_ = 0;
+
+  // The GenerationConfig::prefill_chunk_size given to text_prefiller_.
+  int32_t prefill_chunk_size_ = 0;
+
+  // The tokens whose KV cache entries are resident, by position. Entries at
+  // and after pos_ are left over from before the last reset() and are only
+  // valid until they are overwritten.
+  std::vector<uint64_t> kv_tokens_;
+
+  // The KV cache buffers of the forward method, found on first use.
+  std::vector<KVCacheBuffer> kv_cache_buffers_;
+
+  ::executorch::runtime::Error load_kv_cache_buffers();
+
+  // Returns how many leading tokens of `prompt_tokens` match the resident KV
+  // cache entries starting at pos_, leaving at least one token to prefill.
+  int64_t num_resident_prefix_tokens(
+      const std::vector<uint64_t>& prompt_tokens) const;
 };
 
 } // namespace executorch::extension::llm
@@ -11,6 +11,9 @@
 
 #include <executorch/extension/llm/runner/text_prefiller.h>
 #include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <limits>
 
 namespace executorch {
 namespace extension {
@@ -20,11 +23,105 @@ TextPrefiller::TextPrefiller(
     TextDecoderRunner* text_decoder_runner,
     bool use_kv_cache,
     bool enable_parallel_prefill,
-    int64_t max_seq_len)
+    int64_t max_seq_len,
+    Stats* stats)
     : text_decoder_runner_(text_decoder_runner),
       use_kv_cache_(use_kv_cache),
       enable_parallel_prefill_(enable_parallel_prefill),
-      max_seq_len_(max_seq_len > 0 ? max_seq_len : 128) {}
+      max_seq_len_(max_seq_len > 0 ? max_seq_len : 128),
+      stats_(stats) {}
+
+void TextPrefiller::set_chunk_size(int64_t chunk_size) {
+  chunk_size_ = std::min(std::max<int64_t>(chunk_size, 0), max_seq_len_);
+  probe_chunk_sizes_.clear();
+}
+
+void TextPrefiller::set_adaptive_chunk_size(bool enabled) {
+  chunk_size_ = 0;
+  probe_chunk_sizes_.clear();
+  if (!enabled || !use_kv_cache_ || !enable_parallel_prefill_) {
+    return;
+  }
+  for (int64_t size = max_seq_len_;
+       size >= kMinAdaptiveChunkSize || size == max_seq_len_;
+       size /= 2) {
+    probe_chunk_sizes_.insert(probe_chunk_sizes_.begin(), size);
+  }
+}
+
+::executorch::runtime::Result<uint64_t> TextPrefiller::prefill_range(
+    std::vector<uint64_t>& prompt_tokens,
+    int64_t offset,
+    int64_t num_tokens,
+    int64_t start_pos,
+    bool sample,
+    double& seconds) {
+  // A prompt that fits in one chunk is prefilled in place.
+  std::vector<uint64_t>* chunk_tokens = &prompt_tokens;
+  if (num_tokens < static_cast<int64_t>(prompt_tokens.size())) {
+    chunk_tokens_.assign(
+        prompt_tokens.begin() + offset,
+        prompt_tokens.begin() + offset + num_tokens);
+    chunk_tokens = &chunk_tokens_;
+  }
+
+  const long start_ms = time_in_ms();
+  const auto start = std::chrono::steady_clock::now();
+  sample_chunk_ = sample;
+  // prefill_chunk() may or may not advance its copy of start_pos.
+  int64_t chunk_start_pos = start_pos;
+  auto chunk_result = prefill_chunk(*chunk_tokens, chunk_start_pos);
+  sample_chunk_ = true;
+  ET_CHECK_OK_OR_RETURN_ERROR(chunk_result.error());
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  seconds = elapsed.count();
+  if (stats_ != nullptr) {
+    stats_->prefill_chunks.push_back(
+        {start_pos, num_tokens, start_ms, time_in_ms()});
+  }
+  return chunk_result.get();
+}
+
+::executorch::runtime::Result<int64_t> TextPrefiller::probe_chunk_sizes(
+    std::vector<uint64_t>& prompt_tokens,
+    int64_t offset,
+    int64_t start_pos) {
+  // The attention gets slower as the KV cache fills up, so every size is
+  // timed at the same depth. Each probe rewrites the cache entries of the
+  // previous ones with the same values, and the prompt continues after the
+  // last, smallest one.
+  int64_t best_chunk_size = 0;
+  double best_tokens_per_second = 0.0;
+  int64_t probe_size = 0;
+  while (!probe_chunk_sizes_.empty()) {
+    probe_size = probe_chunk_sizes_.back();
+    probe_chunk_sizes_.pop_back();
+    double seconds = 0.0;
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        prefill_range(
+            prompt_tokens,
+            offset,
+            probe_size,
+            start_pos,
+            /*sample=*/false,
+            seconds)
+            .error());
+    const double tokens_per_second =
+        probe_size / std::max(seconds, std::numeric_limits<double>::min());
+    if (tokens_per_second > best_tokens_per_second) {
+      best_tokens_per_second = tokens_per_second;
+      best_chunk_size = probe_size;
+    }
+  }
+  ET_LOG(
+      Info,
+      "Adaptive prefill chunk size: %" PRId64 " (%f tokens/second)",
+      best_chunk_size,
+      best_tokens_per_second);
+  chunk_size_ = best_chunk_size;
+  return probe_size;
+}
 
 ::executorch::runtime::Result<uint64_t> TextPrefiller::prefill(
     std::vector<uint64_t>& prompt_tokens,
@@ -34,40 +131,42 @@ TextPrefiller::TextPrefiller(
     ET_CHECK_OK_OR_RETURN_ERROR(text_decoder_runner_->load());
   }
 
-  // Check if we need to chunk the prompt tokens
-  int32_t num_prompt_tokens = prompt_tokens.size();
-
-  // If prompt tokens exceed max_seq_len_, we need to chunk them
-  if (num_prompt_tokens > max_seq_len_) {
-    uint64_t cur_token = 0;
-    int num_tokens_to_process = 0;
-
-    while (num_tokens_to_process < num_prompt_tokens) {
-      auto num_tokens_to_prefill_with = std::min<int>(
-          num_prompt_tokens - num_tokens_to_process, max_seq_len_);
-
-      std::vector<uint64_t> prompt_tokens_to_process(
-          num_tokens_to_prefill_with);
-      std::copy(
-          prompt_tokens.begin() + num_tokens_to_process,
-          prompt_tokens.begin() + num_tokens_to_process +
-              num_tokens_to_prefill_with,
-          prompt_tokens_to_process.begin());
-
-      // Process this chunk
-      auto chunk_result = prefill_chunk(prompt_tokens_to_process, start_pos);
-      ET_CHECK_OK_OR_RETURN_ERROR(chunk_result.error());
-      cur_token = chunk_result.get();
-
-      start_pos += num_tokens_to_prefill_with;
-      num_tokens_to_process += num_tokens_to_prefill_with;
+  const int64_t num_prompt_tokens = prompt_tokens.size();
+  uint64_t cur_token = 0;
+  int64_t num_processed_tokens = 0;
+
+  while (num_processed_tokens < num_prompt_tokens) {
+    const int64_t num_remaining_tokens =
+        num_prompt_tokens - num_processed_tokens;
+    // Only probe with full chunks that leave tokens for a later chunk, so
+    // that the short tail of a prompt is never taken for the best size.
+    if (!probe_chunk_sizes_.empty() &&
+        probe_chunk_sizes_.back() < num_remaining_tokens) {
+      auto probed =
+          probe_chunk_sizes(prompt_tokens, num_processed_tokens, start_pos);
+      ET_CHECK_OK_OR_RETURN_ERROR(probed.error());
+      start_pos += probed.get();
+      num_processed_tokens += probed.get();
+      continue;
     }
 
-    return cur_token;
-  } else {
-    // If prompt tokens don't exceed max_seq_len_, process them directly
-    return prefill_chunk(prompt_tokens, start_pos);
+    const int64_t chunk_size =
+        std::min(this->chunk_size(), num_remaining_tokens);
+    const bool is_last_chunk = chunk_size == num_remaining_tokens;
+    double seconds = 0.0;
+    auto chunk_result = prefill_range(
+        prompt_tokens,
+        num_processed_tokens,
+        chunk_size,
+        start_pos,
+        is_last_chunk,
+        seconds);
+    ET_CHECK_OK_OR_RETURN_ERROR(chunk_result.error());
+    cur_token = chunk_result.get();
+    start_pos += chunk_size;
+    num_processed_tokens += chunk_size;
   }
+  return cur_token;
 }
 
 ::executorch::runtime::Result<uint64_t> TextPrefiller::prefill_chunk(
@@ -93,7 +192,9 @@ TextPrefiller::TextPrefiller(
         Info, "Prefill token result numel(): %zu", outputs_res.get().numel());
 
     start_pos += num_prompt_tokens;
-    cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
+    cur_token = sample_chunk_
+        ? text_decoder_runner_->logits_to_token(outputs_res.get())
+        : 0;
   } else { // sequential prefill
     int64_t pos = 0; // position in the sequence
     // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
@@ -122,7 +223,9 @@ TextPrefiller::TextPrefiller(
       start_pos++;
     }
 
-    cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
+    cur_token = sample_chunk_
+        ? text_decoder_runner_->logits_to_token(logits_tensor)
+        : 0;
   }
   return cur_token;
 }
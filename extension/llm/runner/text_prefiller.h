@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 
 namespace executorch {
@@ -23,11 +24,17 @@ class ET_EXPERIMENTAL TextPrefiller {
       TextDecoderRunner* text_decoder_runner,
       bool use_kv_cache,
       bool enable_parallel_prefill,
-      int64_t max_seq_len = 128);
+      int64_t max_seq_len = 128,
+      Stats* stats = nullptr);
 
   virtual ~TextPrefiller() = default;
   /**
    * Prefill an LLM Module with the given text input.
+   *
+   * Prompts longer than the chunk size are prefilled in consecutive chunks.
+   * Only the logits of the last chunk are sampled. If a Stats object was
+   * given, the timing of every chunk is appended to Stats::prefill_chunks.
+   *
    * @param prompt_tokens The text prompt tokens to the LLM Module. Encoded by
    * tokenizer.
    * @param start_pos The starting position in KV cache of the input in the LLM
@@ -49,6 +56,33 @@ class ET_EXPERIMENTAL TextPrefiller {
       std::vector<uint64_t>& prompt_tokens,
       int64_t& start_pos);
 
+  /**
+   * Sets the number of tokens prefilled per chunk, clamped to max_seq_len.
+   * 0, the default, uses max_seq_len. Disables the adaptive chunk size.
+   */
+  void set_chunk_size(int64_t chunk_size);
+
+  /**
+   * Lets the prefiller pick the chunk size with the best throughput.
+   *
+   * The first prompt that needs chunking starts with chunks of max_seq_len,
+   * max_seq_len / 2, max_seq_len / 4, ... (down to kMinAdaptiveChunkSize),
+   * all at the same position, and the size with the most tokens per second
+   * is used for the rest of it and all later prompts. Smaller chunks can be
+   * faster when the attention over a large input does not fit in cache or
+   * when few threads are available. Only applies to models exported with a
+   * dynamic sequence length and a KV cache, the others are prefilled token by
+   * token anyway.
+   */
+  void set_adaptive_chunk_size(bool enabled);
+
+  /// The chunk size used for the next chunk that is not a probe.
+  int64_t chunk_size() const {
+    return chunk_size_ > 0 ? chunk_size_ : max_seq_len_;
+  }
+
+  static constexpr int64_t kMinAdaptiveChunkSize = 32;
+
   /**
    * Load the necessary resources for the TextPrefiller.
    * This method should be called before using the prefill methods.
@@ -77,6 +111,33 @@ class ET_EXPERIMENTAL TextPrefiller {
   bool use_kv_cache_;
   bool enable_parallel_prefill_;
   int64_t max_seq_len_;
+  Stats* stats_;
+
+  // Fixed chunk size, 0 for max_seq_len_.
+  int64_t chunk_size_ = 0;
+  // Chunk sizes still to be measured by the adaptive chunk size, largest last.
+  std::vector<int64_t> probe_chunk_sizes_;
+  // Whether prefill_chunk() should sample the logits of the chunk. Cleared
+  // while prefill() runs all but the last chunk of a prompt.
+  bool sample_chunk_ = true;
+  // Reused across chunks and calls to avoid reallocating per chunk.
+  std::vector<uint64_t> chunk_tokens_;
+
+  // Prefills prompt_tokens[offset, offset + num_tokens) at start_pos through
+  // prefill_chunk(), and records the time it took.
+  ::executorch::runtime::Result<uint64_t> prefill_range(
+      std::vector<uint64_t>& prompt_tokens,
+      int64_t offset,
+      int64_t num_tokens,
+      int64_t start_pos,
+      bool sample,
+      double& seconds);
+  // Times every size of the adaptive chunk size, prefilling from token
+  // `offset` at start_pos, and returns the number of tokens prefilled.
+  ::executorch::runtime::Result<int64_t> probe_chunk_sizes(
+      std::vector<uint64_t>& prompt_tokens,
+      int64_t offset,
+      int64_t start_pos);
 };
 
 } // namespace llm
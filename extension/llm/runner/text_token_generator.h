@@ -9,8 +9,10 @@
 // Generate tokens in a loop.
 #pragma once
 
+#include <executorch/extension/llm/runner/prompt_lookup.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/token_streamer.h>
 #include <executorch/extension/tensor/tensor.h>
 #include <pytorch/tokenizers/tokenizer.h>
 
@@ -34,6 +36,63 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
   virtual ~TextTokenGenerator() = default;
 
+  /**
+   * Constrains the generated tokens, e.g. to a RegexTokenConstraint. The
+   * constraint is applied by the TextDecoderRunner, so it also covers the
+   * token sampled at the end of prefill, and generation stops once it is
+   * complete. The caller resets it before each prompt. Pass nullptr to
+   * generate freely again.
+   */
+  void set_constraint(std::shared_ptr<TokenConstraint> constraint) {
+    constraint_ = constraint;
+    text_decoder_runner_->set_token_constraint(std::move(constraint));
+  }
+
+  const std::shared_ptr<TokenConstraint>& constraint() const {
+    return constraint_;
+  }
+
+  /**
+   * Enables prompt lookup decoding: each step feeds the model the last token
+   * plus up to `num_draft_tokens` tokens proposed by a PromptLookupDrafter
+   * over the prompt and output so far. The model samples a token after each
+   * of them; the drafts are kept for as long as they match, followed by the
+   * sample after the last match. The output follows the same distribution as
+   * decoding one token per step, but takes fewer model executions when the
+   * output repeats the prompt. Requires a model with a KV cache and dynamic
+   * shapes that outputs the logits of every input token; it is disabled at
+   * the first step otherwise. 0 disables it.
+   * @param max_ngram_size The longest n-gram looked up to draft tokens.
+   */
+  void set_lookup_decoding(int32_t num_draft_tokens, int32_t max_ngram_size) {
+    num_draft_tokens_ = std::max(0, num_draft_tokens);
+    max_ngram_size_ = std::max(1, max_ngram_size);
+  }
+
+  int32_t num_draft_tokens() const {
+    return num_draft_tokens_;
+  }
+
+  /**
+   * Decodes the generated tokens and calls the token callback on a separate
+   * output thread fed through a lock-free queue (see TokenStreamer), so that
+   * a slow callback doesn't hold up the model. The callback then receives
+   * whole UTF-8 characters, which may span several tokens, and all of its
+   * calls complete before generate() returns. A stop() from the callback
+   * takes effect a few tokens late, as generation runs ahead of it.
+   */
+  void set_async_output(bool async_output) {
+    if (!async_output) {
+      streamer_.reset();
+    } else if (!streamer_) {
+      streamer_ = std::make_unique<TokenStreamer>(tokenizer_);
+    }
+  }
+
+  bool async_output() const {
+    return streamer_ != nullptr;
+  }
+
   /**
    * Token generation loop.
    * @param tokens The first token generated by prefill, if using kv cache. Else
@@ -46,6 +105,8 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * random predictions, while a lower temperature results in more deterministic
    * predictions.
    * @param token_callback what to do after a token is generated.
+   * @param generated_tokens If not null, every generated token is appended to
+   * it.
    * @return how many tokens are generated.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
@@ -53,9 +114,78 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       int64_t start_pos,
       int32_t max_new_tokens,
       float temperature = 0.0f,
-      const std::function<void(const std::string&)>& token_callback = {}) {
+      const std::function<void(const std::string&)>& token_callback = {},
+      std::vector<uint64_t>* generated_tokens = nullptr) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
+    stats_->num_decode_steps = 0;
+    stats_->num_draft_tokens = 0;
+    stats_->num_accepted_draft_tokens = 0;
+    should_stop_ = false;
+    reached_eos_ = false;
+    if (streamer_) {
+      streamer_->start(tokens.back(), token_callback);
+    }
+    auto result = use_kv_cache_ && num_draft_tokens_ > 0
+        ? generate_with_lookup(
+              std::move(tokens),
+              start_pos,
+              max_new_tokens,
+              temperature,
+              token_callback,
+              generated_tokens)
+        : generate_sequential(
+              std::move(tokens),
+              start_pos,
+              max_new_tokens,
+              temperature,
+              token_callback,
+              generated_tokens);
+    if (streamer_) {
+      const auto error = streamer_->finish();
+      if (result.ok()) {
+        ET_CHECK_OK_OR_RETURN_ERROR(error);
+      }
+    }
+    if (reached_eos_) {
+      printf("\n");
+    }
+    return result;
+  }
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  /**
+   * Load the necessary resources for TextTokenGenerator.
+   * This method should be called before using the generate() method.
+   */
+  ::executorch::runtime::Error load() {
+    return text_decoder_runner_->load();
+  }
+
+  /**
+   * Check if the TextTokenGenerator has been successfully loaded.
+   * @return True if the resources are loaded, false otherwise.
+   */
+  bool inline is_loaded() const {
+    // Implementation to check if resources are loaded
+    return tokenizer_->is_loaded() && text_decoder_runner_->is_method_loaded();
+  }
+
+ private:
+  // The generation loop that samples one token per step.
+  ::executorch::runtime::Result<int64_t> generate_sequential(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t max_new_tokens,
+      float temperature,
+      const std::function<void(const std::string&)>& token_callback,
+      std::vector<uint64_t>* generated_tokens) {
     int64_t pos = start_pos; // position in the sequence
 
     std::vector<uint64_t> token_data; // allocate space for the tokens
@@ -79,8 +209,6 @@ class ET_EXPERIMENTAL TextTokenGenerator {
     auto tokens_managed = from_blob(
         token_data.data(), token_shape, executorch::aten::ScalarType::Long);
 
-    should_stop_ = false;
-
     // Generate our tokens
     while (pos < start_pos + max_new_tokens) {
       // Run the model
@@ -88,13 +216,20 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
       ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
       executorch::aten::Tensor& logits_tensor = logits_res.get();
+      stats_->num_decode_steps++;
 
       prev_token = cur_token;
 
       stats_->on_sampling_begin();
-      cur_token =
-          text_decoder_runner_->logits_to_token(logits_tensor, temperature);
+      // tokens holds every token seen so far, for the sampler's penalties.
+      cur_token = text_decoder_runner_->logits_to_token(
+          logits_tensor, temperature, tokens);
       stats_->on_sampling_end();
+      tokens.push_back(cur_token);
+
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
 
       pos++;
 
@@ -110,16 +245,21 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       }
 
       // print the token as string, decode it with the Tokenizer object
-      token_callback(
-          ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          output_token(prev_token, cur_token, token_callback));
 
       if (should_stop_) {
         break;
       }
 
+      if (constraint_ && constraint_->is_complete()) {
+        ET_LOG(Info, "\nReached the end of the constrained output");
+        break;
+      }
+
       // data-dependent terminating condition: we have n_eos_ number of EOS
       if (eos_ids_->find(cur_token) != eos_ids_->end()) {
-        printf("\n");
+        reached_eos_ = true;
         ET_LOG(Info, "\nReached to the end of generation");
         break;
       }
@@ -127,31 +267,110 @@ class ET_EXPERIMENTAL TextTokenGenerator {
     return pos - start_pos;
   }
 
-  /**
-   * Stop the generation loop.
-   */
-  inline void stop() {
-    should_stop_ = true;
-  }
+  // The generation loop of prompt lookup decoding, see set_lookup_decoding().
+  ::executorch::runtime::Result<int64_t> generate_with_lookup(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t max_new_tokens,
+      float temperature,
+      const std::function<void(const std::string&)>& token_callback,
+      std::vector<uint64_t>* generated_tokens) {
+    const int64_t end_pos = start_pos + max_new_tokens;
+    int64_t pos = start_pos;
+    uint64_t cur_token = tokens.back();
+    int32_t num_draft_tokens = num_draft_tokens_;
+    PromptLookupDrafter drafter(max_ngram_size_);
+    drafter.reset(tokens);
+    std::vector<uint64_t> draft;
+    std::vector<uint64_t> step_tokens;
 
-  /**
-   * Load the necessary resources for TextTokenGenerator.
-   * This method should be called before using the generate() method.
-   */
-  ::executorch::runtime::Error load() {
-    return text_decoder_runner_->load();
+    while (pos < end_pos) {
+      // Don't draft past the last token to generate, so that the KV cache
+      // entries written for the drafts stay within the context.
+      drafter.draft(
+          std::min<int64_t>(num_draft_tokens, end_pos - pos - 1), draft);
+      step_tokens.assign(1, cur_token);
+      step_tokens.insert(step_tokens.end(), draft.begin(), draft.end());
+      auto step_input = from_blob(
+          step_tokens.data(),
+          {1, static_cast<executorch::aten::SizesType>(step_tokens.size())},
+          executorch::aten::ScalarType::Long);
+
+      auto logits_res = text_decoder_runner_->step(step_input, pos);
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      executorch::aten::Tensor& logits_tensor = logits_res.get();
+      stats_->num_decode_steps++;
+
+      if (!draft.empty() &&
+          (logits_tensor.dim() != 3 ||
+           logits_tensor.size(1) != static_cast<int64_t>(step_tokens.size()))) {
+        // Only the logits after the last draft token came back, so the drafts
+        // can't be verified. Redo the step with the last token alone; its KV
+        // cache entry is rewritten and the ones of the drafts are ignored.
+        ET_LOG(
+            Info,
+            "The model doesn't output the logits of every input token, "
+            "disabling prompt lookup decoding");
+        num_draft_tokens = 0;
+        continue;
+      }
+      stats_->num_draft_tokens += draft.size();
+
+      // Sample after every fed token, for as long as the drafts agree.
+      for (size_t i = 0; i < step_tokens.size(); ++i) {
+        const uint64_t prev_token = cur_token;
+        stats_->on_sampling_begin();
+        cur_token = text_decoder_runner_->logits_to_token_at(
+            logits_tensor, i, temperature, tokens);
+        stats_->on_sampling_end();
+        tokens.push_back(cur_token);
+        drafter.append(cur_token);
+        if (generated_tokens != nullptr) {
+          generated_tokens->push_back(cur_token);
+        }
+        pos++;
+
+        ET_CHECK_OK_OR_RETURN_ERROR(
+            output_token(prev_token, cur_token, token_callback));
+
+        if (should_stop_) {
+          return pos - start_pos;
+        }
+        if (constraint_ && constraint_->is_complete()) {
+          ET_LOG(Info, "\nReached the end of the constrained output");
+          return pos - start_pos;
+        }
+        if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+          reached_eos_ = true;
+          ET_LOG(Info, "\nReached to the end of generation");
+          return pos - start_pos;
+        }
+        if (i == draft.size() || cur_token != draft[i]) {
+          break;
+        }
+        stats_->num_accepted_draft_tokens++;
+      }
+    }
+    return pos - start_pos;
   }
 
-  /**
-   * Check if the TextTokenGenerator has been successfully loaded.
-   * @return True if the resources are loaded, false otherwise.
-   */
-  bool inline is_loaded() const {
-    // Implementation to check if resources are loaded
-    return tokenizer_->is_loaded() && text_decoder_runner_->is_method_loaded();
+  // Hands a generated token to the output thread, or decodes it and calls
+  // the callback right away without one.
+  ::executorch::runtime::Error output_token(
+      uint64_t prev_token,
+      uint64_t cur_token,
+      const std::function<void(const std::string&)>& token_callback) {
+    if (streamer_) {
+      ET_CHECK_OR_RETURN_ERROR(
+          !streamer_->failed(), InvalidArgument, "Failed to decode a token");
+      streamer_->push(cur_token);
+      return ::executorch::runtime::Error::Ok;
+    }
+    token_callback(
+        ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+    return ::executorch::runtime::Error::Ok;
   }
 
- private:
   /**
    * Note: TextTokenGenerator does not own the tokenizer_ and
    * text_decoder_runner_. The lifecycle of these objects should be managed
@@ -162,9 +381,15 @@ class ET_EXPERIMENTAL TextTokenGenerator {
   TextDecoderRunner* text_decoder_runner_;
   std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
   bool use_kv_cache_;
+  std::shared_ptr<TokenConstraint> constraint_;
+  int32_t num_draft_tokens_ = 0;
+  int32_t max_ngram_size_ = 3;
+  std::unique_ptr<TokenStreamer> streamer_;
 
   // state machine
-  bool should_stop_ = false;
+  // Atomic, as stop() may be called from the output thread's callback.
+  std::atomic<bool> should_stop_{false};
+  bool reached_eos_ = false;
 
   // stats
   Stats* stats_;
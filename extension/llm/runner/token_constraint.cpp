@@ -0,0 +1,852 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/token_constraint.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <numeric>
+
+#include <executorch/runtime/platform/log.h>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch::extension::llm {
+namespace {
+
+constexpr int32_t kDeadState = -1;
+constexpr size_t kMaxNfaStates = 1 << 16;
+constexpr int kMaxRepeat = 1000;
+
+using ByteSet = std::bitset<256>;
+
+// Thompson NFA over bytes. A state either consumes a byte of `bytes` and
+// moves to `next`, or has up to two epsilon edges.
+struct Nfa {
+  struct State {
+    ByteSet bytes;
+    int32_t next = -1;
+    int32_t eps0 = -1;
+    int32_t eps1 = -1;
+  };
+  std::vector<State> states;
+};
+
+// A sub-automaton from `start` to `end`, where `end` has no edges yet.
+struct Fragment {
+  int32_t start;
+  int32_t end;
+};
+
+class RegexParser {
+ public:
+  RegexParser(const std::string& pattern, Nfa& nfa)
+      : pattern_(pattern), nfa_(nfa) {}
+
+  Result<Fragment> parse() {
+    auto fragment = parse_alternation();
+    if (!fragment.ok()) {
+      return fragment.error();
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        pos_ == pattern_.size(),
+        InvalidArgument,
+        "Unexpected '%c' at offset %zu of the regex",
+        pattern_[pos_],
+        pos_);
+    return fragment;
+  }
+
+ private:
+  Result<int32_t> add_state() {
+    ET_CHECK_OR_RETURN_ERROR(
+        nfa_.states.size() < kMaxNfaStates,
+        InvalidArgument,
+        "Regex is too large");
+    nfa_.states.emplace_back();
+    return static_cast<int32_t>(nfa_.states.size() - 1);
+  }
+
+  // Adds an epsilon edge from `from`, which must have a free one.
+  void link(int32_t from, int32_t to) {
+    Nfa::State& state = nfa_.states[from];
+    (state.eps0 < 0 ? state.eps0 : state.eps1) = to;
+  }
+
+  bool at_end() const {
+    return pos_ >= pattern_.size();
+  }
+
+  char peek() const {
+    return pattern_[pos_];
+  }
+
+  Result<Fragment> parse_alternation() {
+    auto left = parse_concatenation();
+    if (!left.ok()) {
+      return left.error();
+    }
+    Fragment fragment = left.get();
+    while (!at_end() && peek() == '|') {
+      ++pos_;
+      auto right = parse_concatenation();
+      if (!right.ok()) {
+        return right.error();
+      }
+      auto start = add_state();
+      auto end = add_state();
+      if (!start.ok() || !end.ok()) {
+        return Error::InvalidArgument;
+      }
+      link(start.get(), fragment.start);
+      link(start.get(), right->start);
+      link(fragment.end, end.get());
+      link(right->end, end.get());
+      fragment = {start.get(), end.get()};
+    }
+    return fragment;
+  }
+
+  Result<Fragment> parse_concatenation() {
+    auto empty = add_state();
+    if (!empty.ok()) {
+      return empty.error();
+    }
+    Fragment fragment = {empty.get(), empty.get()};
+    while (!at_end() && peek() != '|' && peek() != ')') {
+      auto next = parse_repetition();
+      if (!next.ok()) {
+        return next.error();
+      }
+      link(fragment.end, next->start);
+      fragment.end = next->end;
+    }
+    return fragment;
+  }
+
+  Result<int> parse_number() {
+    ET_CHECK_OR_RETURN_ERROR(
+        !at_end() && std::isdigit(static_cast<unsigned char>(peek())),
+        InvalidArgument,
+        "Expected a number at offset %zu of the regex",
+        pos_);
+    int value = 0;
+    while (!at_end() && std::isdigit(static_cast<unsigned char>(peek()))) {
+      value = value * 10 + (peek() - '0');
+      ET_CHECK_OR_RETURN_ERROR(
+          value <= kMaxRepeat,
+          InvalidArgument,
+          "Repetition count above %d in the regex",
+          kMaxRepeat);
+      ++pos_;
+    }
+    return value;
+  }
+
+  // Wraps `fragment` into `fragment*`, or `fragment?` if !repeat.
+  Result<Fragment> make_optional(Fragment fragment, bool repeat) {
+    auto start = add_state();
+    auto end = add_state();
+    if (!start.ok() || !end.ok()) {
+      return Error::InvalidArgument;
+    }
+    link(start.get(), fragment.start);
+    link(start.get(), end.get());
+    if (repeat) {
+      link(fragment.end, fragment.start);
+    }
+    link(fragment.end, end.get());
+    return Fragment{start.get(), end.get()};
+  }
+
+  Result<Fragment> parse_repetition() {
+    const size_t atom_pos = pos_;
+    auto atom = parse_atom();
+    if (!atom.ok()) {
+      return atom.error();
+    }
+    Fragment fragment = atom.get();
+    bool quantified = false;
+    while (!at_end()) {
+      const char c = peek();
+      // {} copies the atom by parsing it again, which would drop an earlier
+      // quantifier.
+      ET_CHECK_OR_RETURN_ERROR(
+          c != '{' || !quantified,
+          InvalidArgument,
+          "Group a quantified atom before {} at offset %zu of the regex",
+          pos_);
+      if (c == '*' || c == '?' || c == '+' || c == '{') {
+        quantified = true;
+      }
+      if (c == '*' || c == '?') {
+        ++pos_;
+        auto optional = make_optional(fragment, c == '*');
+        if (!optional.ok()) {
+          return optional.error();
+        }
+        fragment = optional.get();
+      } else if (c == '+') {
+        ++pos_;
+        auto end = add_state();
+        if (!end.ok()) {
+          return end.error();
+        }
+        link(fragment.end, fragment.start);
+        link(fragment.end, end.get());
+        fragment.end = end.get();
+      } else if (c == '{') {
+        ++pos_;
+        auto min_count = parse_number();
+        if (!min_count.ok()) {
+          return min_count.error();
+        }
+        int max_count = min_count.get();
+        if (!at_end() && peek() == ',') {
+          ++pos_;
+          if (!at_end() && peek() == '}') {
+            max_count = -1;
+          } else {
+            auto count = parse_number();
+            if (!count.ok()) {
+              return count.error();
+            }
+            max_count = count.get();
+          }
+        }
+        ET_CHECK_OR_RETURN_ERROR(
+            !at_end() && peek() == '}',
+            InvalidArgument,
+            "Unterminated {} quantifier in the regex");
+        ++pos_;
+        ET_CHECK_OR_RETURN_ERROR(
+            max_count < 0 || max_count >= min_count.get(),
+            InvalidArgument,
+            "Invalid {%d,%d} quantifier in the regex",
+            min_count.get(),
+            max_count);
+        auto repeated =
+            repeat(fragment, atom_pos, min_count.get(), max_count);
+        if (!repeated.ok()) {
+          return repeated.error();
+        }
+        fragment = repeated.get();
+      } else {
+        break;
+      }
+    }
+    return fragment;
+  }
+
+  // Expands `atom{min_count,max_count}`, with max_count < 0 for no bound. The
+  // atom is parsed again from `atom_pos` for every copy after the first.
+  Result<Fragment> repeat(
+      Fragment atom,
+      size_t atom_pos,
+      int min_count,
+      int max_count) {
+    const size_t end_pos = pos_;
+    auto copy = [&]() -> Result<Fragment> {
+      pos_ = atom_pos;
+      auto fragment = parse_atom();
+      pos_ = end_pos;
+      return fragment;
+    };
+    auto empty = add_state();
+    if (!empty.ok()) {
+      return empty.error();
+    }
+    Fragment fragment = {empty.get(), empty.get()};
+    bool atom_used = false;
+    auto next_copy = [&]() -> Result<Fragment> {
+      if (!atom_used) {
+        atom_used = true;
+        return atom;
+      }
+      return copy();
+    };
+    for (int i = 0; i < min_count; ++i) {
+      auto next = next_copy();
+      if (!next.ok()) {
+        return next.error();
+      }
+      link(fragment.end, next->start);
+      fragment.end = next->end;
+    }
+    const int num_optional = max_count < 0 ? 1 : max_count - min_count;
+    for (int i = 0; i < num_optional; ++i) {
+      auto next = next_copy();
+      if (!next.ok()) {
+        return next.error();
+      }
+      auto optional = make_optional(next.get(), max_count < 0);
+      if (!optional.ok()) {
+        return optional.error();
+      }
+      link(fragment.end, optional->start);
+      fragment.end = optional->end;
+    }
+    return fragment;
+  }
+
+  Result<Fragment> make_byte_set(const ByteSet& bytes) {
+    auto start = add_state();
+    auto end = add_state();
+    if (!start.ok() || !end.ok()) {
+      return Error::InvalidArgument;
+    }
+    nfa_.states[start.get()].bytes = bytes;
+    nfa_.states[start.get()].next = end.get();
+    return Fragment{start.get(), end.get()};
+  }
+
+  static ByteSet range(unsigned char first, unsigned char last) {
+    ByteSet bytes;
+    for (int b = first; b <= last; ++b) {
+      bytes.set(b);
+    }
+    return bytes;
+  }
+
+  // Parses the escape sequence after a backslash into a set of bytes.
+  Result<ByteSet> parse_escape() {
+    ET_CHECK_OR_RETURN_ERROR(
+        !at_end(), InvalidArgument, "Trailing backslash in the regex");
+    const char c = pattern_[pos_++];
+    ByteSet bytes;
+    switch (c) {
+      case 'd':
+      case 'D':
+        bytes = range('0', '9');
+        break;
+      case 'w':
+      case 'W':
+        bytes = range('a', 'z') | range('A', 'Z') | range('0', '9');
+        bytes.set('_');
+        break;
+      case 's':
+      case 'S':
+        for (const char space : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+          bytes.set(static_cast<unsigned char>(space));
+        }
+        break;
+      case 'n':
+        bytes.set('\n');
+        break;
+      case 't':
+        bytes.set('\t');
+        break;
+      case 'r':
+        bytes.set('\r');
+        break;
+      case 'f':
+        bytes.set('\f');
+        break;
+      case 'v':
+        bytes.set('\v');
+        break;
+      case 'x': {
+        ET_CHECK_OR_RETURN_ERROR(
+            pos_ + 2 <= pattern_.size() &&
+                std::isxdigit(static_cast<unsigned char>(pattern_[pos_])) &&
+                std::isxdigit(static_cast<unsigned char>(pattern_[pos_ + 1])),
+            InvalidArgument,
+            "Invalid \\x escape in the regex");
+        bytes.set(std::stoi(pattern_.substr(pos_, 2), nullptr, 16));
+        pos_ += 2;
+        break;
+      }
+      default:
+        ET_CHECK_OR_RETURN_ERROR(
+            !std::isalnum(static_cast<unsigned char>(c)),
+            InvalidArgument,
+            "Unsupported escape \\%c in the regex",
+            c);
+        bytes.set(static_cast<unsigned char>(c));
+        break;
+    }
+    if (c == 'D' || c == 'W' || c == 'S') {
+      bytes.flip();
+    }
+    return bytes;
+  }
+
+  Result<ByteSet> parse_class() {
+    // The opening '[' is consumed.
+    bool negate = false;
+    if (!at_end() && peek() == '^') {
+      negate = true;
+      ++pos_;
+    }
+    ByteSet bytes;
+    bool first = true;
+    while (!at_end() && (peek() != ']' || first)) {
+      first = false;
+      ByteSet item;
+      unsigned char low = 0;
+      bool is_single = false;
+      if (peek() == '\\') {
+        ++pos_;
+        auto escape = parse_escape();
+        if (!escape.ok()) {
+          return escape.error();
+        }
+        item = escape.get();
+        if (item.count() == 1) {
+          is_single = true;
+          for (int b = 0; b < 256; ++b) {
+            if (item.test(b)) {
+              low = static_cast<unsigned char>(b);
+            }
+          }
+        }
+      } else {
+        low = static_cast<unsigned char>(pattern_[pos_++]);
+        item.set(low);
+        is_single = true;
+      }
+      if (is_single && pos_ + 1 < pattern_.size() && peek() == '-' &&
+          pattern_[pos_ + 1] != ']') {
+        ++pos_;
+        unsigned char high = 0;
+        if (peek() == '\\') {
+          ++pos_;
+          auto escape = parse_escape();
+          if (!escape.ok()) {
+            return escape.error();
+          }
+          ET_CHECK_OR_RETURN_ERROR(
+              escape->count() == 1,
+              InvalidArgument,
+              "Invalid range in a regex character class");
+          for (int b = 0; b < 256; ++b) {
+            if (escape->test(b)) {
+              high = static_cast<unsigned char>(b);
+            }
+          }
+        } else {
+          high = static_cast<unsigned char>(pattern_[pos_++]);
+        }
+        ET_CHECK_OR_RETURN_ERROR(
+            low <= high,
+            InvalidArgument,
+            "Invalid range in a regex character class");
+        item = range(low, high);
+      }
+      bytes |= item;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        !at_end(), InvalidArgument, "Unterminated [] class in the regex");
+    ++pos_;
+    if (negate) {
+      bytes.flip();
+    }
+    return bytes;
+  }
+
+  Result<Fragment> parse_atom() {
+    ET_CHECK_OR_RETURN_ERROR(
+        !at_end(), InvalidArgument, "Unexpected end of the regex");
+    const char c = pattern_[pos_++];
+    switch (c) {
+      case '(': {
+        if (pattern_.compare(pos_, 2, "?:") == 0) {
+          pos_ += 2;
+        }
+        auto group = parse_alternation();
+        if (!group.ok()) {
+          return group.error();
+        }
+        ET_CHECK_OR_RETURN_ERROR(
+            !at_end() && peek() == ')',
+            InvalidArgument,
+            "Unbalanced parenthesis in the regex");
+        ++pos_;
+        return group;
+      }
+      case '[': {
+        auto bytes = parse_class();
+        if (!bytes.ok()) {
+          return bytes.error();
+        }
+        return make_byte_set(bytes.get());
+      }
+      case '.': {
+        ByteSet bytes;
+        bytes.set();
+        bytes.reset('\n');
+        return make_byte_set(bytes);
+      }
+      case '\\': {
+        auto bytes = parse_escape();
+        if (!bytes.ok()) {
+          return bytes.error();
+        }
+        return make_byte_set(bytes.get());
+      }
+      case ')':
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+      case '|':
+        ET_LOG(
+            Error,
+            "Unexpected '%c' at offset %zu of the regex",
+            c,
+            pos_ - 1);
+        return Error::InvalidArgument;
+      default: {
+        ByteSet bytes;
+        bytes.set(static_cast<unsigned char>(c));
+        return make_byte_set(bytes);
+      }
+    }
+  }
+
+  const std::string& pattern_;
+  Nfa& nfa_;
+  size_t pos_ = 0;
+};
+
+// Adds the epsilon closure of `states` to `states`, sorted and deduplicated.
+void epsilon_closure(const Nfa& nfa, std::vector<int32_t>& states) {
+  std::vector<bool> seen(nfa.states.size());
+  std::vector<int32_t> stack(states.begin(), states.end());
+  states.clear();
+  while (!stack.empty()) {
+    const int32_t s = stack.back();
+    stack.pop_back();
+    if (s < 0 || seen[s]) {
+      continue;
+    }
+    seen[s] = true;
+    states.push_back(s);
+    stack.push_back(nfa.states[s].eps0);
+    stack.push_back(nfa.states[s].eps1);
+  }
+  std::sort(states.begin(), states.end());
+}
+
+struct Dfa {
+  // Row-major [num_states, 256], kDeadState for no transition.
+  std::vector<int32_t> transitions;
+  std::vector<bool> accepting;
+};
+
+// Subset construction, then pruning of the states that cannot reach an
+// accepting state so that they are all folded into kDeadState.
+Result<Dfa> build_dfa(const Nfa& nfa, Fragment fragment) {
+  Dfa dfa;
+  std::map<std::vector<int32_t>, int32_t> ids;
+  std::vector<std::vector<int32_t>> sets;
+
+  std::vector<int32_t> start = {fragment.start};
+  epsilon_closure(nfa, start);
+  ids.emplace(start, 0);
+  sets.push_back(std::move(start));
+
+  for (size_t id = 0; id < sets.size(); ++id) {
+    dfa.accepting.push_back(std::binary_search(
+        sets[id].begin(), sets[id].end(), fragment.end));
+    dfa.transitions.resize((id + 1) * 256, kDeadState);
+    for (int b = 0; b < 256; ++b) {
+      std::vector<int32_t> next;
+      for (const int32_t s : sets[id]) {
+        if (nfa.states[s].bytes.test(b)) {
+          next.push_back(nfa.states[s].next);
+        }
+      }
+      if (next.empty()) {
+        continue;
+      }
+      epsilon_closure(nfa, next);
+      auto it = ids.find(next);
+      if (it == ids.end()) {
+        ET_CHECK_OR_RETURN_ERROR(
+            sets.size() < RegexTokenConstraint::kMaxDfaStates,
+            InvalidArgument,
+            "Regex needs more than %zu DFA states",
+            RegexTokenConstraint::kMaxDfaStates);
+        it = ids.emplace(next, static_cast<int32_t>(sets.size())).first;
+        sets.push_back(std::move(next));
+      }
+      dfa.transitions[id * 256 + b] = it->second;
+    }
+  }
+
+  // Live states can reach an accepting state.
+  const size_t num_states = sets.size();
+  std::vector<bool> live = dfa.accepting;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t s = 0; s < num_states; ++s) {
+      if (live[s]) {
+        continue;
+      }
+      for (int b = 0; b < 256; ++b) {
+        const int32_t next = dfa.transitions[s * 256 + b];
+        if (next != kDeadState && live[next]) {
+          live[s] = true;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      live[0], InvalidArgument, "Regex does not match any text");
+
+  std::vector<int32_t> renumbered(num_states, kDeadState);
+  int32_t num_live = 0;
+  for (size_t s = 0; s < num_states; ++s) {
+    if (live[s]) {
+      renumbered[s] = num_live++;
+    }
+  }
+  Dfa pruned;
+  pruned.transitions.resize(static_cast<size_t>(num_live) * 256);
+  for (size_t s = 0; s < num_states; ++s) {
+    if (!live[s]) {
+      continue;
+    }
+    pruned.accepting.push_back(dfa.accepting[s]);
+    for (int b = 0; b < 256; ++b) {
+      const int32_t next = dfa.transitions[s * 256 + b];
+      pruned.transitions[renumbered[s] * 256 + b] =
+          next == kDeadState ? kDeadState : renumbered[next];
+    }
+  }
+  return pruned;
+}
+
+} // namespace
+
+Result<std::unique_ptr<RegexTokenConstraint>> RegexTokenConstraint::create(
+    const std::string& pattern,
+    const ::tokenizers::Tokenizer& tokenizer,
+    const std::unordered_set<uint64_t>& eos_ids) {
+  ET_CHECK_OR_RETURN_ERROR(
+      tokenizer.is_loaded(), InvalidState, "Tokenizer is not loaded");
+  const uint64_t vocab_size = tokenizer.vocab_size();
+  std::vector<std::string> vocab(vocab_size);
+  for (uint64_t token = 0; token < vocab_size; ++token) {
+    if (token == tokenizer.bos_tok() || eos_ids.count(token) > 0) {
+      continue;
+    }
+    // Decode each token on its own, i.e. not as the first token after BOS,
+    // which some tokenizers strip a leading space from.
+    auto piece = tokenizer.decode(token, token);
+    if (piece.ok()) {
+      vocab[token] = std::move(piece.get());
+    }
+  }
+  return create(pattern, vocab, eos_ids);
+}
+
+Result<std::unique_ptr<RegexTokenConstraint>> RegexTokenConstraint::create(
+    const std::string& pattern,
+    const std::vector<std::string>& vocab,
+    const std::unordered_set<uint64_t>& eos_ids) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !vocab.empty() &&
+          vocab.size() <=
+              static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+      InvalidArgument,
+      "Invalid vocab size %zu",
+      vocab.size());
+
+  Nfa nfa;
+  auto fragment = RegexParser(pattern, nfa).parse();
+  if (!fragment.ok()) {
+    return fragment.error();
+  }
+  auto dfa = build_dfa(nfa, fragment.get());
+  if (!dfa.ok()) {
+    return dfa.error();
+  }
+
+  std::unique_ptr<RegexTokenConstraint> constraint(new RegexTokenConstraint());
+  RegexTokenConstraint& c = *constraint;
+  c.vocab_size_ = static_cast<int32_t>(vocab.size());
+  c.num_mask_words_ = (vocab.size() + 31) / 32;
+  c.transitions_ = std::move(dfa->transitions);
+  c.accepting_ = std::move(dfa->accepting);
+  c.eos_ids_ = eos_ids;
+  c.vocab_ = vocab;
+  for (const uint64_t eos : eos_ids) {
+    if (eos < vocab.size()) {
+      c.vocab_[eos].clear();
+    }
+  }
+
+  // Walk the tokens in byte order so that each one only runs the DFA over the
+  // bytes it does not share with the previous one, and a dead prefix rules
+  // out every token that starts with it.
+  std::vector<int32_t> order;
+  size_t max_length = 0;
+  for (size_t token = 0; token < c.vocab_.size(); ++token) {
+    if (!c.vocab_[token].empty()) {
+      order.push_back(static_cast<int32_t>(token));
+      max_length = std::max(max_length, c.vocab_[token].size());
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+    return c.vocab_[a] < c.vocab_[b];
+  });
+  std::vector<size_t> common_prefix(order.size(), 0);
+  for (size_t i = 1; i < order.size(); ++i) {
+    const std::string& a = c.vocab_[order[i - 1]];
+    const std::string& b = c.vocab_[order[i]];
+    const auto mismatch = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+    common_prefix[i] = mismatch.first - a.begin();
+  }
+
+  const size_t num_states = c.accepting_.size();
+  c.has_continuation_.assign(num_states, false);
+  c.masks_.assign((num_states + 1) * c.num_mask_words_, 0);
+  std::vector<int32_t> path(max_length + 1);
+  for (size_t state = 0; state < num_states; ++state) {
+    uint32_t* mask = c.masks_.data() + state * c.num_mask_words_;
+    path[0] = static_cast<int32_t>(state);
+    // path[i] is the DFA state after i bytes of the current token, valid for
+    // i <= depth.
+    size_t depth = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+      const std::string& piece = c.vocab_[order[i]];
+      size_t d = std::min(common_prefix[i], depth);
+      while (path[d] != kDeadState && d < piece.size()) {
+        const unsigned char byte = piece[d];
+        path[d + 1] = c.transitions_[path[d] * 256 + byte];
+        ++d;
+      }
+      depth = d;
+      if (path[d] != kDeadState) {
+        mask[order[i] / 32] |= 1u << (order[i] % 32);
+        c.has_continuation_[state] = true;
+      }
+    }
+    if (c.accepting_[state]) {
+      for (const uint64_t eos : eos_ids) {
+        if (eos < vocab.size()) {
+          mask[eos / 32] |= 1u << (eos % 32);
+        }
+      }
+    }
+  }
+  uint32_t* eos_mask = c.masks_.data() + num_states * c.num_mask_words_;
+  for (const uint64_t eos : eos_ids) {
+    if (eos < vocab.size()) {
+      eos_mask[eos / 32] |= 1u << (eos % 32);
+    }
+  }
+  ET_LOG(
+      Info,
+      "Compiled regex constraint: %zu DFA states over %zu tokens",
+      num_states,
+      vocab.size());
+  return constraint;
+}
+
+void RegexTokenConstraint::process(
+    float* logits,
+    int32_t vocab_size,
+    const std::vector<uint64_t>& /* tokens */) {
+  constexpr float kMasked = -std::numeric_limits<float>::infinity();
+  uint32_t masked_bits;
+  std::memcpy(&masked_bits, &kMasked, sizeof(masked_bits));
+  // All-ones lanes for the set bits of every byte, so that a byte of the mask
+  // selects 8 logits with plain AND/OR, which vectorizes without variable
+  // shifts.
+  static const auto byte_lanes = []() {
+    std::array<std::array<uint32_t, 8>, 256> lanes{};
+    for (int byte = 0; byte < 256; ++byte) {
+      for (int bit = 0; bit < 8; ++bit) {
+        lanes[byte][bit] = (byte >> bit) & 1 ? ~0u : 0u;
+      }
+    }
+    return lanes;
+  }();
+
+  const uint32_t* allowed =
+      mask(done_ ? static_cast<int32_t>(num_states()) : state_);
+  const int32_t n = std::min(vocab_size, vocab_size_);
+  const int32_t num_full_words = n / 32;
+  for (int32_t word = 0; word < num_full_words; ++word) {
+    const uint32_t bits = allowed[word];
+    float* x = logits + word * 32;
+    // Most words are all allowed or all masked.
+    if (bits == ~0u) {
+      continue;
+    }
+    if (bits == 0) {
+      std::fill(x, x + 32, kMasked);
+      continue;
+    }
+    uint32_t values[32];
+    std::memcpy(values, x, sizeof(values));
+    for (int byte = 0; byte < 4; ++byte) {
+      const auto& keep = byte_lanes[(bits >> (8 * byte)) & 0xff];
+      uint32_t* v = values + 8 * byte;
+      for (int i = 0; i < 8; ++i) {
+        v[i] = (v[i] & keep[i]) | (masked_bits & ~keep[i]);
+      }
+    }
+    std::memcpy(x, values, sizeof(values));
+  }
+  for (int32_t i = num_full_words * 32; i < n; ++i) {
+    if (!((allowed[i / 32] >> (i % 32)) & 1u)) {
+      logits[i] = kMasked;
+    }
+  }
+  // Tokens the model has but the tokenizer does not are never allowed.
+  if (vocab_size > n) {
+    std::fill(logits + n, logits + vocab_size, kMasked);
+  }
+}
+
+void RegexTokenConstraint::reset() {
+  state_ = 0;
+  done_ = false;
+}
+
+bool RegexTokenConstraint::is_allowed(uint64_t token) const {
+  if (token >= static_cast<uint64_t>(vocab_size_)) {
+    return false;
+  }
+  const uint32_t* allowed =
+      mask(done_ ? static_cast<int32_t>(num_states()) : state_);
+  return (allowed[token / 32] >> (token % 32)) & 1u;
+}
+
+bool RegexTokenConstraint::advance(uint64_t token) {
+  if (!is_allowed(token)) {
+    return false;
+  }
+  if (eos_ids_.count(token) > 0) {
+    done_ = true;
+    return true;
+  }
+  for (const char byte : vocab_[token]) {
+    state_ = transitions_[state_ * 256 + static_cast<unsigned char>(byte)];
+  }
+  return true;
+}
+
+bool RegexTokenConstraint::is_complete() const {
+  return done_ || (accepting_[state_] && !has_continuation_[state_]);
+}
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Constrained decoding: restrict the tokens an LLM can sample to the ones that
+// keep the generated text matching a pattern.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/sampler/sampler.h>
+#include <executorch/runtime/core/result.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * A stateful LogitsProcessor that masks out the logits of every token that is
+ * not allowed in its current state. The runner advances it with every token
+ * it samples.
+ */
+class ET_EXPERIMENTAL TokenConstraint : public LogitsProcessor {
+ public:
+  /// Goes back to the initial state, before any token was generated.
+  virtual void reset() = 0;
+
+  /**
+   * Moves to the state after `token`.
+   * @return false, leaving the state unchanged, if `token` is not allowed.
+   */
+  virtual bool advance(uint64_t token) = 0;
+
+  /**
+   * Whether the generated text is complete, i.e. an end of sequence token was
+   * accepted or nothing but one can follow.
+   */
+  virtual bool is_complete() const = 0;
+};
+
+/**
+ * Constrains the generated text to fully match a regular expression.
+ *
+ * The pattern is compiled to a DFA over bytes and, for every DFA state, to a
+ * bitmask of the vocab tokens whose bytes keep the DFA alive. All masks are
+ * built up front, so constraining a token costs a single pass over the logits
+ * with the mask of the current state. End of sequence tokens are only allowed
+ * once the text matches.
+ *
+ * Supported syntax: literals, `.` (any byte but a newline), `[...]` and
+ * `[^...]` classes with ranges, `\d \w \s \D \W \S`, `\n \t \r \f \v`,
+ * `\xHH`, escaped metacharacters, `(...)`, `(?:...)`, `|` and the `* + ?
+ * {m} {m,} {m,n}` quantifiers. Matching is byte-wise, so a negated class
+ * also accepts every multi-byte UTF-8 character. JSON schemas can be used
+ * by first converting them to a regex.
+ */
+class ET_EXPERIMENTAL RegexTokenConstraint : public TokenConstraint {
+ public:
+  /// Upper bound on the number of DFA states, which each hold a vocab mask.
+  static constexpr size_t kMaxDfaStates = 4096;
+
+  /**
+   * Compiles `pattern` against the vocab of `tokenizer`.
+   * @param eos_ids The end of sequence tokens, allowed once the text matches.
+   */
+  static ::executorch::runtime::Result<std::unique_ptr<RegexTokenConstraint>>
+  create(
+      const std::string& pattern,
+      const ::tokenizers::Tokenizer& tokenizer,
+      const std::unordered_set<uint64_t>& eos_ids);
+
+  /**
+   * Compiles `pattern` against an explicit vocab: `vocab[i]` holds the bytes
+   * that token i decodes to. Empty entries are never allowed.
+   */
+  static ::executorch::runtime::Result<std::unique_ptr<RegexTokenConstraint>>
+  create(
+      const std::string& pattern,
+      const std::vector<std::string>& vocab,
+      const std::unordered_set<uint64_t>& eos_ids);
+
+  void process(
+      float* logits,
+      int32_t vocab_size,
+      const std::vector<uint64_t>& tokens) override;
+
+  void reset() override;
+  bool advance(uint64_t token) override;
+  bool is_complete() const override;
+
+  /// Whether `token` is allowed in the current state.
+  bool is_allowed(uint64_t token) const;
+
+  size_t num_states() const {
+    return accepting_.size();
+  }
+
+ private:
+  RegexTokenConstraint() = default;
+
+  const uint32_t* mask(int32_t state) const {
+    return masks_.data() + static_cast<size_t>(state) * num_mask_words_;
+  }
+
+  int32_t vocab_size_ = 0;
+  size_t num_mask_words_ = 0;
+  // Row-major [num_states, 256] DFA transitions, -1 for the dead state.
+  std::vector<int32_t> transitions_;
+  std::vector<bool> accepting_;
+  // Whether any token other than an end of sequence one is allowed.
+  std::vector<bool> has_continuation_;
+  // Row-major [num_states + 1, num_mask_words_] token masks. The last row
+  // allows only the end of sequence tokens, for after one was accepted.
+  std::vector<uint32_t> masks_;
+  std::vector<std::string> vocab_;
+  std::unordered_set<uint64_t> eos_ids_;
+  int32_t state_ = 0;
+  bool done_ = false;
+};
+
+} // namespace executorch::extension::llm
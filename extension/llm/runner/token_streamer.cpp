@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/token_streamer.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch::extension::llm {
+
+size_t utf8_complete_prefix_length(const std::string& text) {
+  const size_t size = text.size();
+  // Step back over the continuation bytes of the last character.
+  size_t start = size;
+  size_t num_continuation = 0;
+  while (start > 0 && num_continuation < 3 &&
+         (static_cast<uint8_t>(text[start - 1]) & 0xC0) == 0x80) {
+    --start;
+    ++num_continuation;
+  }
+  if (start == 0) {
+    return size;
+  }
+  const uint8_t lead = static_cast<uint8_t>(text[start - 1]);
+  size_t length = 1;
+  if (lead >= 0xF0 && lead <= 0xF7) {
+    length = 4;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+  } else if (lead >= 0xC0 && lead <= 0xDF) {
+    length = 2;
+  }
+  return length > num_continuation + 1 ? start - 1 : size;
+}
+
+TokenStreamer::TokenStreamer(
+    const ::tokenizers::Tokenizer* tokenizer,
+    size_t capacity)
+    : tokenizer_(tokenizer) {
+  size_t size = 1;
+  while (size < std::max<size_t>(capacity, 2)) {
+    size <<= 1;
+  }
+  ring_.resize(size);
+  mask_ = size - 1;
+}
+
+TokenStreamer::~TokenStreamer() {
+  if (thread_.joinable()) {
+    finish();
+  }
+}
+
+void TokenStreamer::start(
+    uint64_t prev_token,
+    std::function<void(const std::string&)> callback) {
+  ET_CHECK_MSG(!thread_.joinable(), "TokenStreamer is already started");
+  head_.store(0);
+  tail_.store(0);
+  done_.store(false);
+  failed_.store(false);
+  prev_token_ = prev_token;
+  pending_.clear();
+  callback_ = std::move(callback);
+  max_queue_depth_ = 0;
+  thread_ = std::thread([this]() { run(); });
+}
+
+void TokenStreamer::push(uint64_t token) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  // Back pressure: wait for the consumer to free a slot.
+  while (tail - head_.load(std::memory_order_acquire) > mask_) {
+    std::this_thread::yield();
+  }
+  ring_[tail & mask_] = token;
+  tail_.store(tail + 1, std::memory_order_seq_cst);
+  max_queue_depth_ = std::max(
+      max_queue_depth_, tail + 1 - head_.load(std::memory_order_relaxed));
+  // Only take the lock when the consumer may be asleep. Paired with the
+  // seq_cst store above, the consumer either sees the token before it sleeps
+  // or we see it waiting here.
+  if (consumer_waiting_.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+}
+
+bool TokenStreamer::try_pop(uint64_t& token) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  token = ring_[head & mask_];
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+::executorch::runtime::Error TokenStreamer::finish() {
+  if (!thread_.joinable()) {
+    return ::executorch::runtime::Error::Ok;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_.store(true, std::memory_order_seq_cst);
+  }
+  cv_.notify_one();
+  thread_.join();
+  return failed_.load() ? ::executorch::runtime::Error::InvalidArgument
+                        : ::executorch::runtime::Error::Ok;
+}
+
+void TokenStreamer::deliver(const std::string& text) {
+  if (callback_) {
+    callback_(text);
+  }
+}
+
+void TokenStreamer::run() {
+  uint64_t token;
+  while (true) {
+    if (try_pop(token)) {
+      if (failed_.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      auto piece = tokenizer_->decode(prev_token_, token);
+      prev_token_ = token;
+      if (!piece.ok()) {
+        ET_LOG(
+            Error,
+            "Tokenizers error code %d",
+            static_cast<uint32_t>(piece.error()));
+        failed_.store(true, std::memory_order_relaxed);
+        continue;
+      }
+      pending_ += *piece;
+      const size_t length = utf8_complete_prefix_length(pending_);
+      if (length == pending_.size()) {
+        deliver(pending_);
+        pending_.clear();
+      } else if (length > 0) {
+        deliver(pending_.substr(0, length));
+        pending_.erase(0, length);
+      }
+      continue;
+    }
+    // finish() is only called after the last push(), so once done_ is set
+    // the queue only needs to be drained.
+    if (done_.load(std::memory_order_seq_cst)) {
+      if (head_.load(std::memory_order_relaxed) ==
+          tail_.load(std::memory_order_seq_cst)) {
+        break;
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    consumer_waiting_.store(true, std::memory_order_seq_cst);
+    // The timeout only guards against a missed wake up.
+    cv_.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+      return head_.load(std::memory_order_relaxed) !=
+          tail_.load(std::memory_order_seq_cst) ||
+          done_.load(std::memory_order_seq_cst);
+    });
+    consumer_waiting_.store(false, std::memory_order_relaxed);
+  }
+  if (!pending_.empty() && !failed_.load()) {
+    // The output ended inside a character; deliver the bytes anyway.
+    deliver(pending_);
+    pending_.clear();
+  }
+}
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Decodes generated tokens and delivers the text to a callback on a separate
+// thread, so that the generation loop doesn't wait on the consumer.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * Returns the length of the longest prefix of `text` that doesn't end inside
+ * a multi-byte UTF-8 character, i.e. that excludes a trailing lead byte that
+ * isn't followed by all of its continuation bytes yet. Invalid sequences are
+ * not held back.
+ */
+ET_EXPERIMENTAL size_t utf8_complete_prefix_length(const std::string& text);
+
+/**
+ * The output stage of token generation. The generation loop push()es every
+ * sampled token into a lock-free single producer, single consumer ring
+ * buffer; an output thread decodes them and calls the callback. The text of
+ * a token that ends inside a multi-byte UTF-8 character, as byte-level BPE
+ * tokens may, is held back until the following tokens complete it, so the
+ * callback only sees whole characters and may be called less often than once
+ * per token.
+ *
+ * push() only blocks when the consumer is a whole ring buffer behind.
+ */
+class ET_EXPERIMENTAL TokenStreamer {
+ public:
+  /**
+   * @param tokenizer Decodes the tokens, on the output thread. Must outlive
+   * the streamer and not be used by anything else between start() and
+   * finish().
+   * @param capacity Number of tokens the ring buffer holds, rounded up to a
+   * power of two.
+   */
+  explicit TokenStreamer(
+      const ::tokenizers::Tokenizer* tokenizer,
+      size_t capacity = 1024);
+
+  ~TokenStreamer();
+
+  TokenStreamer(const TokenStreamer&) = delete;
+  TokenStreamer& operator=(const TokenStreamer&) = delete;
+
+  /**
+   * Starts the output thread.
+   * @param prev_token The token before the first pushed one, for decoding.
+   * @param callback Called with the decoded text, on the output thread.
+   */
+  void start(
+      uint64_t prev_token,
+      std::function<void(const std::string&)> callback);
+
+  /// Queues `token` for decoding. Only call it from one thread.
+  void push(uint64_t token);
+
+  /**
+   * Waits for all pushed tokens to be delivered, delivers any incomplete
+   * UTF-8 character that is still held back, and stops the output thread.
+   * @return Error::InvalidArgument if a token failed to decode, in which case
+   * the tokens after it were dropped.
+   */
+  ::executorch::runtime::Error finish();
+
+  /// Whether decoding failed, so that the producer can stop early.
+  bool failed() const {
+    return failed_.load(std::memory_order_relaxed);
+  }
+
+  /// The largest number of tokens that were queued at once since start().
+  size_t max_queue_depth() const {
+    return max_queue_depth_;
+  }
+
+ private:
+  bool try_pop(uint64_t& token);
+  void deliver(const std::string& text);
+  void run();
+
+  const ::tokenizers::Tokenizer* tokenizer_;
+  std::vector<uint64_t> ring_;
+  size_t mask_;
+  // Written by the consumer and producer respectively, on separate cache
+  // lines. Both only ever increase; the slot is the index & mask_.
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<bool> consumer_waiting_{false};
+  std::atomic<bool> done_{false};
+  std::atomic<bool> failed_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+
+  // Owned by the output thread while it runs.
+  uint64_t prev_token_ = 0;
+  std::string pending_;
+  std::function<void(const std::string&)> callback_;
+
+  // Owned by the producer.
+  size_t max_queue_depth_ = 0;
+};
+
+} // namespace executorch::extension::llm
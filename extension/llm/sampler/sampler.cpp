@@ -35,6 +35,8 @@
 #include <executorch/extension/llm/sampler/sampler.h>
 #include <algorithm>
 #include <ctime>
+#include <limits>
+#include <type_traits>
 
 namespace executorch {
 namespace extension {
@@ -80,8 +82,7 @@ int32_t Sampler::sample_topp(T* probabilities, float coin) {
   // quicksort indices in descending order of probabilities
   // values smaller than (1 - topp) / (n - 1) cannot be part of the result
   // so for efficiency we crop these out as candidates before sorting
-  std::unique_ptr<ProbIndex<T>[]> probindex =
-      std::make_unique<ProbIndex<T>[]>(vocab_size_);
+  ProbIndex<T>* probindex = probindex_scratch<T>();
 
   const float cutoff = (1.0f - topp_) / (n - 1);
   for (int i = 0; i < n; i++) {
@@ -95,7 +96,7 @@ int32_t Sampler::sample_topp(T* probabilities, float coin) {
   auto compare = [](const ProbIndex<T>& a, const ProbIndex<T>& b) {
     return a.prob > b.prob;
   };
-  std::sort(probindex.get(), probindex.get() + n0, compare);
+  std::sort(probindex, probindex + n0, compare);
 
   // truncate the list where cumulative probability exceeds topp
   T cumulative_prob = 0;
@@ -120,6 +121,15 @@ int32_t Sampler::sample_topp(T* probabilities, float coin) {
   return probindex[last_idx].index; // in case of rounding errors
 }
 
+template <typename T>
+ProbIndex<T>* Sampler::probindex_scratch() {
+  const size_t size = static_cast<size_t>(vocab_size_) * sizeof(ProbIndex<T>);
+  if (probindex_scratch_.size() < size) {
+    probindex_scratch_.resize(size);
+  }
+  return reinterpret_cast<ProbIndex<T>*>(probindex_scratch_.data());
+}
+
 Sampler::Sampler(
     int vocab_size,
     float temperature,
@@ -128,13 +138,110 @@ Sampler::Sampler(
     : vocab_size_(vocab_size),
       inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
       topp_(topp),
-      rng_state_(rng_seed) {}
+      rng_state_(rng_seed),
+      probindex_scratch_(
+          static_cast<size_t>(vocab_size) * sizeof(ProbIndex<float>)) {
+  config_.temperature = temperature;
+  config_.topp = topp;
+}
 
 Sampler::Sampler(int vocab_size, float temperature)
-    : vocab_size_(vocab_size),
-      inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
-      topp_(kTopp),
-      rng_state_(std::time(nullptr)) {}
+    : Sampler(vocab_size, temperature, kTopp, std::time(nullptr)) {}
+
+Sampler::Sampler(
+    int32_t vocab_size,
+    const SamplerConfig& config,
+    unsigned long long rng_seed)
+    : Sampler(vocab_size, config.temperature, config.topp, rng_seed) {
+  config_ = config;
+}
+
+void Sampler::set_config(const SamplerConfig& config) {
+  config_ = config;
+  topp_ = config.topp;
+  set_temperature(config.temperature);
+}
+
+void Sampler::set_temperature(float temperature) {
+  config_.temperature = temperature;
+  inv_temperature_ = static_cast<bool>(temperature) ? 1.0f / temperature : 0;
+}
+
+bool Sampler::needs_processing() const {
+  return config_.topk > 0 || config_.repetition_penalty != 1.0f ||
+      config_.frequency_penalty != 0.0f || config_.presence_penalty != 0.0f ||
+      !config_.logit_bias.empty() || !logits_processors_.empty();
+}
+
+void Sampler::apply_penalties(
+    float* logits,
+    const std::vector<uint64_t>& tokens) {
+  if (tokens.empty() ||
+      (config_.repetition_penalty == 1.0f &&
+       config_.frequency_penalty == 0.0f &&
+       config_.presence_penalty == 0.0f)) {
+    return;
+  }
+  // Count the occurrences of every seen token by sorting them, which only
+  // touches the seen tokens instead of the whole vocab.
+  tokens_scratch_.clear();
+  for (const uint64_t token : tokens) {
+    if (token < static_cast<uint64_t>(vocab_size_)) {
+      tokens_scratch_.push_back(static_cast<int32_t>(token));
+    }
+  }
+  std::sort(tokens_scratch_.begin(), tokens_scratch_.end());
+  for (size_t i = 0; i < tokens_scratch_.size();) {
+    const int32_t token = tokens_scratch_[i];
+    size_t count = 0;
+    while (i < tokens_scratch_.size() && tokens_scratch_[i] == token) {
+      ++i;
+      ++count;
+    }
+    float& logit = logits[token];
+    if (config_.repetition_penalty != 1.0f) {
+      logit = logit > 0 ? logit / config_.repetition_penalty
+                        : logit * config_.repetition_penalty;
+    }
+    logit -= config_.frequency_penalty * static_cast<float>(count) +
+        config_.presence_penalty;
+  }
+}
+
+int32_t Sampler::sample_candidates(
+    ProbIndex<float>* candidates,
+    int32_t num_candidates,
+    float sum,
+    float coin) {
+  // candidates hold unnormalized probabilities that add up to sum.
+  const bool use_topp = topp_ > 0 && topp_ < 1;
+  if (use_topp) {
+    std::sort(
+        candidates,
+        candidates + num_candidates,
+        [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
+          return a.prob > b.prob;
+        });
+  }
+  float cumulative_prob = 0;
+  int32_t last_idx = num_candidates - 1;
+  for (int32_t i = 0; i < num_candidates; i++) {
+    cumulative_prob += candidates[i].prob;
+    if (use_topp && cumulative_prob > topp_ * sum) {
+      last_idx = i;
+      break;
+    }
+  }
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
+  for (int32_t i = 0; i <= last_idx; i++) {
+    cdf += candidates[i].prob;
+    if (r < cdf) {
+      return candidates[i].index;
+    }
+  }
+  return candidates[last_idx].index; // in case of rounding errors
+}
 
 template <typename T>
 static void softmax(T* x, int size) {
@@ -169,8 +276,111 @@ static float random_f32(unsigned long long* state) { // random float32 in [0,1)
   return (random_u32(state) >> 8) / 16777216.0f;
 }
 
+template <typename T>
+int32_t Sampler::sample_processed(
+    T* logits,
+    const std::vector<uint64_t>& tokens) {
+  // Everything runs on float logits, in place for float models.
+  float* x = nullptr;
+  if constexpr (std::is_same_v<T, float>) {
+    x = logits;
+  } else {
+    logits_scratch_.resize(vocab_size_);
+    x = logits_scratch_.data();
+    for (int i = 0; i < vocab_size_; i++) {
+      x[i] = static_cast<float>(logits[i]);
+    }
+  }
+
+  // Penalties and biases only touch the tokens they apply to.
+  apply_penalties(x, tokens);
+  for (const auto& [token, bias] : config_.logit_bias) {
+    if (token >= 0 && token < vocab_size_) {
+      x[token] += bias;
+    }
+  }
+  for (const auto& processor : logits_processors_) {
+    processor->process(x, vocab_size_, tokens);
+  }
+
+  if (inv_temperature_ == 0.0f) {
+    return sample_argmax(x);
+  }
+
+  // Apply the temperature and find the max in a single pass.
+  float max_val = -std::numeric_limits<float>::infinity();
+  for (int i = 0; i < vocab_size_; i++) {
+    x[i] *= inv_temperature_;
+    max_val = std::max(max_val, x[i]);
+  }
+  if (max_val == -std::numeric_limits<float>::infinity()) {
+    // Every token is masked out.
+    return sample_argmax(x);
+  }
+
+  const float coin = random_f32(&rng_state_);
+  ProbIndex<float>* candidates = probindex_scratch<float>();
+  int32_t num_candidates = 0;
+  float sum = 0;
+  if (config_.topk > 0 && config_.topk < vocab_size_) {
+    // Select the top k logits, then exponentiate only those.
+    for (int i = 0; i < vocab_size_; i++) {
+      candidates[i].prob = x[i];
+      candidates[i].index = i;
+    }
+    num_candidates = config_.topk;
+    std::nth_element(
+        candidates,
+        candidates + num_candidates - 1,
+        candidates + vocab_size_,
+        [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
+          return a.prob > b.prob;
+        });
+    for (int32_t i = 0; i < num_candidates; i++) {
+      candidates[i].prob = expf(candidates[i].prob - max_val);
+      sum += candidates[i].prob;
+    }
+  } else {
+    // Exponentiate and sum in one pass, leaving the probabilities
+    // unnormalized.
+    for (int i = 0; i < vocab_size_; i++) {
+      x[i] = expf(x[i] - max_val);
+      sum += x[i];
+    }
+    if (topp_ <= 0 || topp_ >= 1) {
+      const float r = coin * sum;
+      float cdf = 0;
+      for (int i = 0; i < vocab_size_; i++) {
+        cdf += x[i];
+        if (r < cdf) {
+          return i;
+        }
+      }
+      return vocab_size_ - 1; // in case of rounding errors
+    }
+    // Same cutoff as sample_topp, scaled by the unnormalized sum.
+    const float cutoff = (1.0f - topp_) / (vocab_size_ - 1) * sum;
+    for (int i = 0; i < vocab_size_; i++) {
+      if (x[i] >= cutoff) {
+        candidates[num_candidates].prob = x[i];
+        candidates[num_candidates].index = i;
+        num_candidates++;
+      }
+    }
+  }
+  return sample_candidates(candidates, num_candidates, sum, coin);
+}
+
 template <typename T>
 int32_t Sampler::sample(T* logits) {
+  return sample(logits, {});
+}
+
+template <typename T>
+int32_t Sampler::sample(T* logits, const std::vector<uint64_t>& tokens) {
+  if (needs_processing()) {
+    return sample_processed(logits, tokens);
+  }
   // sample the token given the logits and some hyperparameters
   int next;
   if (inv_temperature_ == 0.0f) {
@@ -203,6 +413,18 @@ template int32_t Sampler::sample<executorch::aten::Half>(
     executorch::aten::Half* logits);
 template int32_t Sampler::sample<executorch::aten::BFloat16>(
     executorch::aten::BFloat16* logits);
+template int32_t Sampler::sample<float>(
+    float* logits,
+    const std::vector<uint64_t>& tokens);
+template int32_t Sampler::sample<uint16_t>(
+    uint16_t* logits,
+    const std::vector<uint64_t>& tokens);
+template int32_t Sampler::sample<executorch::aten::Half>(
+    executorch::aten::Half* logits,
+    const std::vector<uint64_t>& tokens);
+template int32_t Sampler::sample<executorch::aten::BFloat16>(
+    executorch::aten::BFloat16* logits,
+    const std::vector<uint64_t>& tokens);
 
 } // namespace llm
 } // namespace extension
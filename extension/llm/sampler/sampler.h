@@ -14,6 +14,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <utility>
+#include <vector>
 #ifdef USE_ATEN_LIB
 #include <torch/torch.h>
 #endif
@@ -34,6 +36,54 @@ struct ET_EXPERIMENTAL ProbIndex {
   int32_t index;
 }; // struct used when sorting probabilities during top-p sampling
 
+/**
+ * A step of the logits processing pipeline that runs before sampling, e.g. a
+ * grammar mask that sets the logits of disallowed tokens to -inf.
+ */
+class ET_EXPERIMENTAL LogitsProcessor {
+ public:
+  virtual ~LogitsProcessor() = default;
+
+  /**
+   * Modifies the float logits of the next token in place.
+   * @param logits The vocab_size logits of the next token.
+   * @param vocab_size The number of logits.
+   * @param tokens The tokens seen so far, i.e. the prompt and the tokens
+   * generated before this one, as far as the caller tracks them.
+   */
+  virtual void process(
+      float* logits,
+      int32_t vocab_size,
+      const std::vector<uint64_t>& tokens) = 0;
+};
+
+struct ET_EXPERIMENTAL SamplerConfig {
+  // 0 for greedy argmax sampling.
+  float temperature = 0.0f;
+  // Nucleus sampling threshold, disabled when <= 0 or >= 1.
+  float topp = kTopp;
+  // Sample only from the topk most likely tokens, disabled when <= 0.
+  int32_t topk = 0;
+  // Positive logits of seen tokens are divided by it and negative ones
+  // multiplied by it, disabled when 1.
+  float repetition_penalty = 1.0f;
+  // Subtracted from the logit of a seen token once per occurrence.
+  float frequency_penalty = 0.0f;
+  // Subtracted from the logit of every seen token.
+  float presence_penalty = 0.0f;
+  // (token, bias) pairs added to the logits.
+  std::vector<std::pair<int32_t, float>> logit_bias;
+};
+
+/**
+ * Samples the next token from logits. A Sampler is meant to be long lived: it
+ * keeps its RNG state across calls and reuses scratch buffers sized to the
+ * vocab, so that sampling a token doesn't allocate.
+ *
+ * Penalties, logit biases, top-k and LogitsProcessors are applied on float
+ * logits in as few passes over the vocab as possible. Without any of them,
+ * sample() behaves exactly like the original llama2.c sampler.
+ */
 class ET_EXPERIMENTAL Sampler {
  public:
   Sampler(
@@ -44,9 +94,47 @@ class ET_EXPERIMENTAL Sampler {
 
   Sampler(int32_t vocab_size, float temperature);
 
+  Sampler(
+      int32_t vocab_size,
+      const SamplerConfig& config,
+      unsigned long long rng_seed);
+
   template <typename T>
   int32_t sample(T* logits);
 
+  /**
+   * Samples the next token.
+   * @param logits The vocab_size logits of the next token, which may be
+   * modified in place.
+   * @param tokens The tokens seen so far, for the repetition, frequency and
+   * presence penalties and the LogitsProcessors.
+   */
+  template <typename T>
+  int32_t sample(T* logits, const std::vector<uint64_t>& tokens);
+
+  int32_t vocab_size() const {
+    return vocab_size_;
+  }
+
+  /// Updates the sampling parameters, keeping the RNG state.
+  void set_config(const SamplerConfig& config);
+
+  void set_temperature(float temperature);
+
+  /// Restarts the RNG stream, e.g. to make a request reproducible.
+  void set_rng_seed(unsigned long long rng_seed) {
+    rng_state_ = rng_seed;
+  }
+
+  /// Appends a step to the logits processing pipeline.
+  void add_logits_processor(std::unique_ptr<LogitsProcessor> processor) {
+    logits_processors_.push_back(std::move(processor));
+  }
+
+  void clear_logits_processors() {
+    logits_processors_.clear();
+  }
+
  private:
   template <typename T>
   int32_t sample_topp(T* probabilities, float coin);
@@ -55,12 +143,31 @@ class ET_EXPERIMENTAL Sampler {
   template <typename T>
   int32_t sample_argmax(T* probabilities);
 
+  bool needs_processing() const;
+  template <typename T>
+  int32_t sample_processed(T* logits, const std::vector<uint64_t>& tokens);
+  void apply_penalties(float* logits, const std::vector<uint64_t>& tokens);
+  int32_t sample_candidates(
+      ProbIndex<float>* candidates,
+      int32_t num_candidates,
+      float sum,
+      float coin);
+  template <typename T>
+  ProbIndex<T>* probindex_scratch();
+
  private:
   int32_t vocab_size_;
   // reciprocal of temperature, or 0 if temperature == 0.
   float inv_temperature_;
   float topp_;
   unsigned long long rng_state_;
+  SamplerConfig config_;
+  std::vector<std::unique_ptr<LogitsProcessor>> logits_processors_;
+  // Scratch reused across calls: float logits for other dtypes, ProbIndex
+  // candidates, and sorted tokens for the penalties.
+  std::vector<float> logits_scratch_;
+  std::vector<uint8_t> probindex_scratch_;
+  std::vector<int32_t> tokens_scratch_;
 };
 
 } // namespace llm
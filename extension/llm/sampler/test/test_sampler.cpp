@@ -11,8 +11,15 @@
 #include <gtest/gtest.h>
 #include <torch/torch.h>
 
+#include <cmath>
+#include <limits>
+#include <set>
+#include <vector>
+
 using namespace ::testing;
+using ::executorch::extension::llm::LogitsProcessor;
 using ::executorch::extension::llm::Sampler;
+using ::executorch::extension::llm::SamplerConfig;
 
 TEST(SamplerTest, TestArgMax) {
   Sampler sampler{
@@ -39,3 +46,116 @@ TEST(SamplerTest, TestArgMaxWithFP16) {
   input[0][0][396] = 1.0f;
   EXPECT_EQ(sampler.sample(input.data_ptr<c10::Half>()), 396);
 }
+
+TEST(SamplerTest, TopKSamplesOnlyTheTopKTokens) {
+  SamplerConfig config;
+  config.temperature = 1.0f;
+  config.topp = 1.0f;
+  config.topk = 2;
+  Sampler sampler(8, config, /*rng_seed=*/7);
+  std::set<int32_t> sampled;
+  for (int i = 0; i < 200; ++i) {
+    std::vector<float> logits = {0.5f, 0.1f, 0.2f, 2.0f, 0.3f, 1.9f, 0.4f, 0};
+    sampled.insert(sampler.sample(logits.data()));
+  }
+  EXPECT_EQ(sampled, (std::set<int32_t>{3, 5}));
+}
+
+TEST(SamplerTest, SeedMakesSamplingReproducible) {
+  Sampler a(16, /*temperature=*/1.0f, /*topp=*/0.9f, /*rng_seed=*/1234);
+  Sampler b(16, /*temperature=*/1.0f, /*topp=*/0.9f, /*rng_seed=*/1234);
+  std::vector<int32_t> first;
+  for (int i = 0; i < 50; ++i) {
+    std::vector<float> logits_a(16);
+    for (int j = 0; j < 16; ++j) {
+      logits_a[j] = 0.1f * j;
+    }
+    std::vector<float> logits_b = logits_a;
+    first.push_back(a.sample(logits_a.data()));
+    EXPECT_EQ(first.back(), b.sample(logits_b.data()));
+  }
+  // Restarting the stream replays the same tokens.
+  a.set_rng_seed(1234);
+  for (int i = 0; i < 50; ++i) {
+    std::vector<float> logits(16);
+    for (int j = 0; j < 16; ++j) {
+      logits[j] = 0.1f * j;
+    }
+    EXPECT_EQ(a.sample(logits.data()), first[i]);
+  }
+}
+
+TEST(SamplerTest, ProcessedPathMatchesOriginalSampling) {
+  // A zero logit bias takes the fused float path without changing the
+  // distribution, so it must sample the same tokens as the original path.
+  SamplerConfig config;
+  config.temperature = 0.7f;
+  config.topp = 0.9f;
+  config.logit_bias = {{0, 0.0f}};
+  Sampler processed(32, config, /*rng_seed=*/99);
+  Sampler original(32, 0.7f, 0.9f, /*rng_seed=*/99);
+  for (int i = 0; i < 100; ++i) {
+    std::vector<float> logits(32);
+    for (int j = 0; j < 32; ++j) {
+      logits[j] = std::sin(0.37f * j + i);
+    }
+    std::vector<float> copy = logits;
+    EXPECT_EQ(processed.sample(logits.data()), original.sample(copy.data()));
+  }
+}
+
+TEST(SamplerTest, PenaltiesAndBiasApplyToSeenTokens) {
+  SamplerConfig config;
+  config.repetition_penalty = 2.0f;
+  Sampler sampler(4, config, /*rng_seed=*/0);
+  std::vector<float> logits = {1.0f, 0.9f, 0.1f, -1.0f};
+  // Token 0 drops to 0.5, below token 1.
+  EXPECT_EQ(sampler.sample(logits.data(), {0}), 1);
+
+  config.repetition_penalty = 1.0f;
+  config.frequency_penalty = 0.3f;
+  config.presence_penalty = 0.1f;
+  sampler.set_config(config);
+  logits = {1.0f, 0.9f, 0.1f, -1.0f};
+  // Token 0 seen twice: 1.0 - 0.6 - 0.1 = 0.3. Token 1 once: 0.9 - 0.4.
+  EXPECT_EQ(sampler.sample(logits.data(), {0, 1, 0}), 1);
+
+  config.frequency_penalty = 0.0f;
+  config.presence_penalty = 0.0f;
+  config.logit_bias = {{3, 5.0f}};
+  sampler.set_config(config);
+  logits = {1.0f, 0.9f, 0.1f, -1.0f};
+  EXPECT_EQ(sampler.sample(logits.data()), 3);
+}
+
+namespace {
+// Only allows even tokens.
+class EvenTokensProcessor : public LogitsProcessor {
+ public:
+  void process(
+      float* logits,
+      int32_t vocab_size,
+      const std::vector<uint64_t>& /*tokens*/) override {
+    for (int32_t i = 1; i < vocab_size; i += 2) {
+      logits[i] = -std::numeric_limits<float>::infinity();
+    }
+  }
+};
+} // namespace
+
+TEST(SamplerTest, LogitsProcessorMasksTokens) {
+  Sampler sampler(10, /*temperature=*/1.0f, /*topp=*/0.95f, /*rng_seed=*/3);
+  sampler.add_logits_processor(std::make_unique<EvenTokensProcessor>());
+  for (int i = 0; i < 100; ++i) {
+    std::vector<float> logits(10, 0.0f);
+    logits[1] = 10.0f;
+    EXPECT_EQ(sampler.sample(logits.data()) % 2, 0);
+  }
+
+  // Half logits are processed in float scratch.
+  std::vector<executorch::aten::Half> half_logits(10, 0.0f);
+  half_logits[1] = 10.0f;
+  half_logits[4] = 5.0f;
+  sampler.set_temperature(0.0f);
+  EXPECT_EQ(sampler.sample(half_logits.data()), 4);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Dynamically allocates memory by bumping a pointer through chunks obtained
+ * from malloc(). reset() rewinds to the first chunk but keeps every chunk, so
+ * a workload that repeats the same allocation pattern between resets, like
+ * the temporary allocations made by the kernels of a Method, stops calling
+ * malloc() once it has warmed up.
+ *
+ * When a reset finds that more than one chunk was needed, the chunks are
+ * replaced by a single chunk of their combined size, so the steady state is
+ * one contiguous buffer.
+ *
+ * The allocator also records the high watermark: the number of bytes a
+ * contiguous, fixed-size MemoryAllocator would need to satisfy the requests
+ * made between two resets. Since Method resets its temp allocator after every
+ * instruction, last_high_watermark() read after each Method::step() is the
+ * scratch memory used by that instruction, and high_watermark() is the size
+ * of the fixed temp buffer needed to run the whole Method.
+ */
+class ArenaMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// Size of the first chunk when none is given at construction time.
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  /**
+   * Construct a new arena memory allocator.
+   *
+   * @param[in] chunk_size The size of the first chunk to allocate. Later
+   * chunks are at least as large as all the previous chunks combined.
+   */
+  explicit ArenaMemoryAllocator(size_t chunk_size = kDefaultChunkSize)
+      : MemoryAllocator(0, nullptr),
+        chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+  ArenaMemoryAllocator(const ArenaMemoryAllocator&) = delete;
+  ArenaMemoryAllocator& operator=(const ArenaMemoryAllocator&) = delete;
+
+  ~ArenaMemoryAllocator() override {
+    release();
+  }
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    // Account for the request as if it was served from a single buffer.
+    watermark_ = align_offset(watermark_, alignment) + size;
+    segment_high_watermark_ = std::max(segment_high_watermark_, watermark_);
+
+    // Use the current chunk, or any retained chunk after it.
+    while (current_ < chunks_.size()) {
+      void* ptr = allocate_in_chunk(chunks_[current_], size, alignment);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+      ++current_;
+      offset_ = 0;
+    }
+
+    // Out of retained chunks: grow. Doubling the capacity keeps the number of
+    // chunks logarithmic in the peak usage.
+    size_t new_chunk_size = std::max(chunk_size_, capacity_);
+    if (size + alignment > new_chunk_size) {
+      new_chunk_size = size + alignment;
+    }
+    if (!add_chunk(new_chunk_size)) {
+      ET_LOG(
+          Error, "Failed to allocate a %zu byte arena chunk", new_chunk_size);
+      return nullptr;
+    }
+    current_ = chunks_.size() - 1;
+    offset_ = 0;
+    return allocate_in_chunk(chunks_[current_], size, alignment);
+  }
+
+  /**
+   * Rewinds to the start of the arena. The memory is kept for reuse; if more
+   * than one chunk is held, they are merged into a single chunk.
+   */
+  void reset() override {
+    high_watermark_ = std::max(high_watermark_, segment_high_watermark_);
+    last_segment_high_watermark_ = segment_high_watermark_;
+    segment_high_watermark_ = 0;
+    watermark_ = 0;
+    current_ = 0;
+    offset_ = 0;
+
+    if (chunks_.size() > 1) {
+      const size_t merged_size = capacity_;
+      release();
+      if (!add_chunk(merged_size)) {
+        ET_LOG(
+            Error, "Failed to merge arena chunks of %zu bytes", merged_size);
+      }
+    }
+  }
+
+  /**
+   * Frees all the memory held by the arena. Pointers returned by allocate()
+   * must not be used afterwards.
+   */
+  void release() {
+    for (auto& chunk : chunks_) {
+      std::free(chunk.data);
+    }
+    chunks_.clear();
+    capacity_ = 0;
+    current_ = 0;
+    offset_ = 0;
+  }
+
+  /**
+   * Returns the largest number of bytes requested between two resets over the
+   * lifetime of the allocator, including alignment padding. A fixed
+   * MemoryAllocator of this size can serve the same workload.
+   */
+  size_t high_watermark() const {
+    return std::max(high_watermark_, segment_high_watermark_);
+  }
+
+  /**
+   * Returns the number of bytes requested between the two most recent resets,
+   * including alignment padding.
+   */
+  size_t last_high_watermark() const {
+    return last_segment_high_watermark_;
+  }
+
+  /// Returns the number of bytes currently held by the arena.
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /// Returns the number of times the arena called malloc().
+  size_t num_chunk_allocations() const {
+    return num_chunk_allocations_;
+  }
+
+ private:
+  struct Chunk {
+    uint8_t* data;
+    size_t size;
+  };
+
+  static size_t align_offset(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+  }
+
+  void* allocate_in_chunk(const Chunk& chunk, size_t size, size_t alignment) {
+    uint8_t* start = alignPointer(chunk.data + offset_, alignment);
+    const size_t start_offset = static_cast<size_t>(start - chunk.data);
+    if (start_offset > chunk.size || size > chunk.size - start_offset) {
+      return nullptr;
+    }
+    offset_ = start_offset + size;
+    return start;
+  }
+
+  bool add_chunk(size_t size) {
+    void* data = std::malloc(size);
+    if (data == nullptr) {
+      return false;
+    }
+    chunks_.push_back({static_cast<uint8_t*>(data), size});
+    capacity_ += size;
+    ++num_chunk_allocations_;
+    return true;
+  }
+
+  const size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  size_t capacity_ = 0;
+  size_t current_ = 0;
+  size_t offset_ = 0;
+
+  size_t watermark_ = 0;
+  size_t segment_high_watermark_ = 0;
+  size_t last_segment_high_watermark_ = 0;
+  size_t high_watermark_ = 0;
+  size_t num_chunk_allocations_ = 0;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/arena_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::ArenaMemoryAllocator;
+
+constexpr auto kDefaultAlignment = ArenaMemoryAllocator::kDefaultAlignment;
+
+class ArenaMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+#define EXPECT_ALIGNED(ptr, alignment)        \
+  EXPECT_TRUE(is_aligned((ptr), (alignment))) \
+      << "Pointer " << (ptr) << " is not aligned to " << (alignment)
+
+TEST_F(ArenaMemoryAllocatorTest, SimpleAllocateSucceeds) {
+  ArenaMemoryAllocator allocator;
+
+  auto p = allocator.allocate(16);
+  EXPECT_NE(p, nullptr);
+  EXPECT_ALIGNED(p, kDefaultAlignment);
+
+  auto p2 = allocator.allocate(16);
+  EXPECT_NE(p2, nullptr);
+  EXPECT_NE(p2, p);
+  EXPECT_ALIGNED(p2, kDefaultAlignment);
+
+  // Both allocations come from the same chunk.
+  EXPECT_EQ(allocator.num_chunk_allocations(), 1);
+  EXPECT_EQ(allocator.capacity(), ArenaMemoryAllocator::kDefaultChunkSize);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, AlignmentSmokeTest) {
+  ArenaMemoryAllocator allocator(256);
+
+  std::vector<size_t> alignments = {
+      kDefaultAlignment * 64,
+      kDefaultAlignment * 8,
+      kDefaultAlignment * 16,
+      kDefaultAlignment * 2,
+      kDefaultAlignment * 32,
+      kDefaultAlignment / 2,
+      kDefaultAlignment * 128,
+      kDefaultAlignment,
+      kDefaultAlignment * 4,
+  };
+
+  static constexpr int kNumPasses = 100;
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    for (size_t alignment : alignments) {
+      constexpr size_t kAllocationSize = 16;
+      auto p = allocator.allocate(kAllocationSize, alignment);
+      EXPECT_NE(p, nullptr);
+      EXPECT_ALIGNED(p, alignment);
+      // Write to the allocated memory. If it overruns, ASAN should catch it.
+      memset(p, 0x55, kAllocationSize);
+    }
+    if (pass % 10 == 0) {
+      allocator.reset();
+    }
+  }
+}
+
+TEST_F(ArenaMemoryAllocatorTest, BadAlignmentFails) {
+  ArenaMemoryAllocator allocator;
+
+  // Should fail because the requested alignment is not a power of 2.
+  std::vector<size_t> alignments = {0, 5, 6, 12, 34};
+  for (auto alignment : alignments) {
+    auto p = allocator.allocate(16, alignment);
+    EXPECT_EQ(p, nullptr);
+  }
+}
+
+TEST_F(ArenaMemoryAllocatorTest, LargeAllocationGrowsArena) {
+  ArenaMemoryAllocator allocator(64);
+
+  auto p = allocator.allocate(1024);
+  EXPECT_NE(p, nullptr);
+  memset(p, 0x55, 1024);
+  EXPECT_GE(allocator.capacity(), 1024);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, ResetMergesChunks) {
+  ArenaMemoryAllocator allocator(64);
+
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_NE(allocator.allocate(48), nullptr);
+  }
+  EXPECT_GT(allocator.num_chunk_allocations(), 1);
+  const size_t capacity = allocator.capacity();
+
+  allocator.reset();
+  EXPECT_EQ(allocator.capacity(), capacity);
+
+  // The same pattern is now served from the single merged chunk.
+  const size_t num_chunk_allocations = allocator.num_chunk_allocations();
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_NE(allocator.allocate(48), nullptr);
+  }
+  EXPECT_EQ(allocator.num_chunk_allocations(), num_chunk_allocations);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, NoChunkAllocationsAfterWarmup) {
+  ArenaMemoryAllocator allocator(128);
+
+  // Mimic a Method that resets the temp allocator after every instruction,
+  // with kernels requesting different amounts of scratch memory.
+  const std::vector<std::vector<size_t>> instructions = {
+      {64}, {}, {512, 32}, {4096}, {16, 16, 16}, {2048, 1024}};
+
+  size_t warm_num_chunk_allocations = 0;
+  for (int execution = 0; execution < 10; ++execution) {
+    for (const auto& sizes : instructions) {
+      for (size_t size : sizes) {
+        auto p = allocator.allocate(size);
+        EXPECT_NE(p, nullptr);
+        memset(p, 0x55, size);
+      }
+      allocator.reset();
+    }
+    if (execution == 1) {
+      warm_num_chunk_allocations = allocator.num_chunk_allocations();
+    }
+  }
+  EXPECT_EQ(allocator.num_chunk_allocations(), warm_num_chunk_allocations);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, HighWatermark) {
+  ArenaMemoryAllocator allocator;
+  EXPECT_EQ(allocator.high_watermark(), 0);
+
+  allocator.allocate(10, 1);
+  allocator.allocate(8, 8);
+  // 10 bytes, padded to 16 for the second allocation, plus 8.
+  EXPECT_EQ(allocator.high_watermark(), 24);
+  allocator.reset();
+  EXPECT_EQ(allocator.last_high_watermark(), 24);
+
+  allocator.allocate(4);
+  allocator.reset();
+  EXPECT_EQ(allocator.last_high_watermark(), 4);
+  EXPECT_EQ(allocator.high_watermark(), 24);
+
+  allocator.allocate(100);
+  EXPECT_EQ(allocator.high_watermark(), 100);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, ReleaseFreesMemory) {
+  ArenaMemoryAllocator allocator;
+
+  EXPECT_NE(allocator.allocate(16), nullptr);
+  EXPECT_GT(allocator.capacity(), 0);
+
+  allocator.release();
+  EXPECT_EQ(allocator.capacity(), 0);
+
+  // Continue to allocate successfully.
+  EXPECT_NE(allocator.allocate(16), nullptr);
+}
@@ -348,6 +348,13 @@ runtime::Result<runtime::EValue> Module::get_output(
   return method->get_output(output_index);
 }
 
+runtime::Result<executorch::aten::Tensor> Module::get_attribute(
+    const std::string& method_name,
+    const std::string& attribute_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).method->get_attribute(attribute_name);
+}
+
 } // namespace ET_MODULE_NAMESPACE
 } // namespace extension
 } // namespace executorch
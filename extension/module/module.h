@@ -101,7 +101,9 @@ class Module {
    * @param[in] data_loader A DataLoader used for loading program data.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data during kernel or delegate execution.
+   * temporary data during kernel or delegate execution. Defaults to a
+   * MallocMemoryAllocator; pass an ArenaMemoryAllocator to keep the temporary
+   * memory across executions instead of reallocating it.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -119,7 +121,8 @@ class Module {
    * the program uses is valid for the lifetime of the program.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data.
+   * temporary data. Defaults to a MallocMemoryAllocator; pass an
+   * ArenaMemoryAllocator to keep the temporary memory across executions.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -601,6 +604,22 @@ class Module {
     return get_output("forward", output_index);
   }
 
+  /**
+   * Retrieve a named attribute tensor of a specific method, e.g. a mutable
+   * buffer of a program exported with emit_mutable_buffer_names=True. Loads
+   * the program and method before retrieval if needed.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] attribute_name The fully qualified name of the attribute.
+   *
+   * @returns A Result containing the attribute tensor, which aliases the
+   * method's memory, or Error::NotFound if there is no such attribute.
+   */
+  ET_NODISCARD
+  virtual runtime::Result<executorch::aten::Tensor> get_attribute(
+      const std::string& method_name,
+      const std::string& attribute_name);
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
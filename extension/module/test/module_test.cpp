@@ -14,6 +14,7 @@
 #include <gtest/gtest.h>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/memory_allocator/arena_memory_allocator.h>
 #include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 
@@ -338,6 +339,26 @@ TEST_F(ModuleTest, TestProgramSharingAndDataLoaderManagement) {
   EXPECT_EQ(result3.error(), Error::Ok);
 }
 
+TEST_F(ModuleTest, TestArenaTempAllocator) {
+  auto loader = FileDataLoader::from(model_path_.c_str());
+  EXPECT_EQ(loader.error(), Error::Ok);
+  auto data_loader = std::make_unique<FileDataLoader>(std::move(loader.get()));
+
+  Module module(
+      std::move(data_loader),
+      /*memory_allocator=*/nullptr,
+      std::make_unique<ArenaMemoryAllocator>());
+
+  auto tensor = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+  const auto expected = make_tensor_ptr({2, 2}, {2.f, 4.f, 6.f, 8.f});
+
+  for (int i = 0; i < 3; ++i) {
+    const auto result = module.execute("forward", {tensor, tensor, 1.0});
+    ASSERT_EQ(result.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(result->at(0).toTensor(), *expected.get());
+  }
+}
+
 TEST_F(ModuleTest, TestProgramPersistenceAndReuseAfterModuleDestruction) {
   std::shared_ptr<Program> shared_program;
 
@@ -522,6 +543,16 @@ TEST_F(ModuleTest, TestGetOutputInvalidIndex) {
   EXPECT_NE(bad.error(), Error::Ok);
 }
 
+TEST_F(ModuleTest, TestGetAttributeNotFound) {
+  Module module(model_path_);
+
+  const auto attribute = module.get_attribute("forward", "no_such_buffer");
+  EXPECT_EQ(attribute.error(), Error::NotFound);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+
+  EXPECT_NE(module.get_attribute("backward", "state").error(), Error::Ok);
+}
+
 TEST_F(ModuleTest, TestPTD) {
   Module module(add_mul_path_, add_mul_data_path_);
 
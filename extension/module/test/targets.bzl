@@ -33,6 +33,7 @@ def define_common_targets(is_fbcode=False):
                 deps = [
                     "//executorch/kernels/portable:generated_lib" + aten_suffix,
                     "//executorch/extension/data_loader:file_data_loader",
+                    "//executorch/extension/memory_allocator:arena_memory_allocator",
                     "//executorch/extension/module:module" + aten_suffix,
                     "//executorch/extension/tensor:tensor" + aten_suffix,
                     "//executorch/runtime/core/exec_aten/testing_util:tensor_util" + aten_suffix,
@@ -15,12 +15,14 @@ def define_common_targets():
             srcs = [
                 "tensor_ptr.cpp",
                 "tensor_ptr_maker.cpp",
+                "tensor_storage_pool.cpp",
             ],
             exported_headers = [
                 "tensor.h",
                 "tensor_accessor.h",
                 "tensor_ptr.h",
                 "tensor_ptr_maker.h",
+                "tensor_storage_pool.h",
             ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
@@ -8,8 +8,10 @@
 
 #include <executorch/extension/tensor/tensor_ptr.h>
 
+#include <cstring>
 #include <numeric>
 
+#include <executorch/extension/tensor/tensor_storage_pool.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
 namespace executorch {
@@ -178,6 +180,22 @@ TensorPtr clone_tensor_ptr(const executorch::aten::Tensor& tensor) {
 #ifndef USE_ATEN_LIB
   dynamism = tensor.shape_dynamism();
 #endif // USE_ATEN_LIB
+  const size_t nbytes = tensor.nbytes();
+  if (tensor.const_data_ptr() && nbytes > 0 && tensor_storage_pool_enabled()) {
+    void* data = TensorStoragePool::global().allocate(nbytes);
+    ET_CHECK_MSG(data != nullptr, "Failed to allocate %zu bytes", nbytes);
+    std::memcpy(data, tensor.const_data_ptr(), nbytes);
+    return make_tensor_ptr(
+        std::move(sizes),
+        data,
+        std::move(dim_order),
+        std::move(strides),
+        tensor.scalar_type(),
+        dynamism,
+        [nbytes](void* ptr) {
+          TensorStoragePool::global().deallocate(ptr, nbytes);
+        });
+  }
   return tensor.const_data_ptr()
       ? make_tensor_ptr(
             std::move(sizes),
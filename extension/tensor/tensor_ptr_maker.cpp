@@ -10,6 +10,8 @@
 
 #include <random>
 
+#include <executorch/extension/tensor/tensor_storage_pool.h>
+
 namespace executorch {
 namespace extension {
 namespace {
@@ -111,9 +113,24 @@ TensorPtr empty_strided(
     std::vector<executorch::aten::StridesType> strides,
     executorch::aten::ScalarType type,
     executorch::aten::TensorShapeDynamism dynamism) {
-  std::vector<uint8_t> data(
+  const size_t nbytes =
       executorch::aten::compute_numel(sizes.data(), sizes.size()) *
-      executorch::aten::elementSize(type));
+      executorch::aten::elementSize(type);
+  if (nbytes > 0 && tensor_storage_pool_enabled()) {
+    void* data = TensorStoragePool::global().allocate(nbytes);
+    ET_CHECK_MSG(data != nullptr, "Failed to allocate %zu bytes", nbytes);
+    return make_tensor_ptr(
+        std::move(sizes),
+        data,
+        {},
+        std::move(strides),
+        type,
+        dynamism,
+        [nbytes](void* data) {
+          TensorStoragePool::global().deallocate(data, nbytes);
+        });
+  }
+  std::vector<uint8_t> data(nbytes);
   return make_tensor_ptr(
       std::move(sizes),
       std::move(data),
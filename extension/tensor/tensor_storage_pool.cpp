@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_storage_pool.h>
+
+#include <cstdlib>
+
+namespace executorch {
+namespace extension {
+namespace {
+
+std::atomic<bool> pool_enabled{false};
+
+// Returns the size class serving `nbytes`, or kNumSizeClasses if `nbytes` is
+// too large to be pooled.
+size_t size_class_of(size_t nbytes) {
+  size_t size_class = 0;
+  size_t block_size = TensorStoragePool::kMinBlockSize;
+  while (block_size < nbytes) {
+    if (block_size == TensorStoragePool::kMaxBlockSize) {
+      return TensorStoragePool::kNumSizeClasses;
+    }
+    block_size <<= 1;
+    ++size_class;
+  }
+  return size_class;
+}
+
+size_t block_size_of(size_t size_class) {
+  return TensorStoragePool::kMinBlockSize << size_class;
+}
+
+// Set once the calling thread's cache has been destroyed, so buffers freed
+// later during thread exit go straight to the global cache. Trivially
+// destructible, so it stays readable after the cache itself is gone.
+thread_local bool thread_cache_destroyed = false;
+
+} // namespace
+
+namespace internal {
+
+struct TensorStoragePoolThreadCache final {
+  std::array<std::vector<void*>, TensorStoragePool::kNumSizeClasses>
+      free_blocks;
+
+  TensorStoragePoolThreadCache() {
+    for (auto& blocks : free_blocks) {
+      blocks.reserve(TensorStoragePool::kMaxThreadCachedBlocks);
+    }
+  }
+
+  ~TensorStoragePoolThreadCache() {
+    auto& pool = TensorStoragePool::global();
+    for (size_t size_class = 0; size_class < free_blocks.size();
+         ++size_class) {
+      for (void* data : free_blocks[size_class]) {
+        if (!pool.push_global(size_class, data)) {
+          std::free(data);
+        }
+      }
+    }
+    thread_cache_destroyed = true;
+  }
+};
+
+} // namespace internal
+
+namespace {
+
+internal::TensorStoragePoolThreadCache* thread_cache() {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local internal::TensorStoragePoolThreadCache cache;
+  return &cache;
+}
+
+} // namespace
+
+TensorStoragePool& TensorStoragePool::global() {
+  // Intentionally leaked so that tensors destroyed during static destruction
+  // can still return their storage.
+  static auto* pool = new TensorStoragePool();
+  return *pool;
+}
+
+void* TensorStoragePool::allocate(size_t nbytes) {
+  const auto size_class = size_class_of(nbytes);
+  if (size_class == kNumSizeClasses) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(nbytes);
+  }
+  if (auto* cache = thread_cache()) {
+    auto& free_blocks = cache->free_blocks[size_class];
+    if (!free_blocks.empty()) {
+      void* data = free_blocks.back();
+      free_blocks.pop_back();
+      thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+      return data;
+    }
+  }
+  if (void* data = pop_global(size_class)) {
+    global_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    return data;
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(block_size_of(size_class));
+}
+
+void TensorStoragePool::deallocate(void* data, size_t nbytes) {
+  if (data == nullptr) {
+    return;
+  }
+  const auto size_class = size_class_of(nbytes);
+  if (size_class == kNumSizeClasses) {
+    std::free(data);
+    return;
+  }
+  if (auto* cache = thread_cache()) {
+    auto& free_blocks = cache->free_blocks[size_class];
+    if (free_blocks.size() < kMaxThreadCachedBlocks) {
+      free_blocks.push_back(data);
+      return;
+    }
+  }
+  if (!push_global(size_class, data)) {
+    std::free(data);
+  }
+}
+
+void TensorStoragePool::trim() {
+  if (auto* cache = thread_cache()) {
+    for (auto& free_blocks : cache->free_blocks) {
+      for (void* data : free_blocks) {
+        std::free(data);
+      }
+      free_blocks.clear();
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& free_blocks : free_blocks_) {
+    for (void* data : free_blocks) {
+      std::free(data);
+    }
+    free_blocks.clear();
+    free_blocks.shrink_to_fit();
+  }
+}
+
+TensorStoragePool::Stats TensorStoragePool::stats() const {
+  return {
+      thread_cache_hits_.load(std::memory_order_relaxed),
+      global_cache_hits_.load(std::memory_order_relaxed),
+      misses_.load(std::memory_order_relaxed),
+  };
+}
+
+void* TensorStoragePool::pop_global(size_t size_class) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& free_blocks = free_blocks_[size_class];
+  if (free_blocks.empty()) {
+    return nullptr;
+  }
+  void* data = free_blocks.back();
+  free_blocks.pop_back();
+  return data;
+}
+
+bool TensorStoragePool::push_global(size_t size_class, void* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& free_blocks = free_blocks_[size_class];
+  if (free_blocks.size() >= kMaxGlobalCachedBlocks) {
+    return false;
+  }
+  free_blocks.push_back(data);
+  return true;
+}
+
+void set_tensor_storage_pool_enabled(bool enabled) {
+  pool_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool tensor_storage_pool_enabled() {
+  return pool_enabled.load(std::memory_order_relaxed);
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace internal {
+struct TensorStoragePoolThreadCache;
+} // namespace internal
+
+/**
+ * A pool of tensor data buffers grouped into power-of-two size classes.
+ *
+ * Freed buffers are cached per thread first and spill over to a global cache
+ * shared by all threads, so pipelines that create and destroy many
+ * short-lived tensors of similar sizes reuse memory instead of going through
+ * malloc() and free() for every tensor. Buffers larger than the biggest size
+ * class are not cached.
+ *
+ * The pool is opt-in: TensorPtr makers that allocate their own storage, such
+ * as empty(), zeros(), ones(), full(), rand() and clone_tensor_ptr(), only use
+ * it after set_tensor_storage_pool_enabled(true) has been called.
+ */
+class TensorStoragePool final {
+ public:
+  /// Smallest size class, in bytes.
+  static constexpr size_t kMinBlockSize = 64;
+  /// Largest size class, in bytes. Larger buffers bypass the pool.
+  static constexpr size_t kMaxBlockSize = size_t(4) << 20;
+  /// Number of size classes between kMinBlockSize and kMaxBlockSize.
+  static constexpr size_t kNumSizeClasses = 17;
+  /// Maximum number of buffers each thread caches per size class.
+  static constexpr size_t kMaxThreadCachedBlocks = 8;
+  /// Maximum number of buffers the global cache holds per size class.
+  static constexpr size_t kMaxGlobalCachedBlocks = 64;
+
+  /// Counters describing how allocation requests were served.
+  struct Stats {
+    /// Requests served from the calling thread's cache.
+    size_t thread_cache_hits;
+    /// Requests served from the global cache.
+    size_t global_cache_hits;
+    /// Requests that had to call malloc().
+    size_t misses;
+  };
+
+  /**
+   * Returns the process-wide pool. It is never destroyed, so tensors may
+   * outlive static destruction safely.
+   */
+  static TensorStoragePool& global();
+
+  /**
+   * Allocates at least `nbytes` bytes.
+   *
+   * @param[in] nbytes The number of bytes to allocate.
+   *
+   * @returns The allocated buffer, or nullptr on failure. It must be returned
+   * with deallocate() passing the same `nbytes`.
+   */
+  void* allocate(size_t nbytes);
+
+  /**
+   * Returns a buffer obtained from allocate() to the pool.
+   *
+   * @param[in] data The buffer to return.
+   * @param[in] nbytes The size passed to allocate() for this buffer.
+   */
+  void deallocate(void* data, size_t nbytes);
+
+  /**
+   * Frees the buffers cached by the calling thread and by the global cache.
+   * Buffers cached by other threads are kept until those threads exit.
+   */
+  void trim();
+
+  /// Returns the allocation counters accumulated so far.
+  Stats stats() const;
+
+ private:
+  TensorStoragePool() = default;
+
+  void* pop_global(size_t size_class);
+  bool push_global(size_t size_class, void* data);
+
+  std::mutex mutex_;
+  std::array<std::vector<void*>, kNumSizeClasses> free_blocks_;
+  std::atomic<size_t> thread_cache_hits_{0};
+  std::atomic<size_t> global_cache_hits_{0};
+  std::atomic<size_t> misses_{0};
+
+  friend struct internal::TensorStoragePoolThreadCache;
+};
+
+/**
+ * Enables or disables allocating TensorPtr storage from
+ * TensorStoragePool::global(). Disabled by default. Tensors created while the
+ * pool was enabled still return their memory to it after it is disabled.
+ *
+ * @param[in] enabled Whether to use the pool.
+ */
+void set_tensor_storage_pool_enabled(bool enabled);
+
+/**
+ * Returns whether TensorPtr storage is allocated from
+ * TensorStoragePool::global().
+ */
+bool tensor_storage_pool_enabled();
+
+} // namespace extension
+} // namespace executorch
@@ -16,6 +16,7 @@ def define_common_targets():
                 "tensor_accessor_test.cpp",
                 "tensor_ptr_maker_test.cpp",
                 "tensor_ptr_test.cpp",
+                "tensor_storage_pool_test.cpp",
             ],
             deps = [
                 "//executorch/extension/tensor:tensor" + aten_suffix,
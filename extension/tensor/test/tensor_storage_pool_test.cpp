@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_storage_pool.h>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+
+class TensorStoragePoolTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    executorch::runtime::runtime_init();
+  }
+
+  void SetUp() override {
+    TensorStoragePool::global().trim();
+    set_tensor_storage_pool_enabled(true);
+  }
+
+  void TearDown() override {
+    set_tensor_storage_pool_enabled(false);
+    TensorStoragePool::global().trim();
+  }
+};
+
+TEST_F(TensorStoragePoolTest, ReusesFreedBlocks) {
+  auto& pool = TensorStoragePool::global();
+
+  void* data = pool.allocate(100);
+  EXPECT_NE(data, nullptr);
+  pool.deallocate(data, 100);
+
+  // Any size in the same size class gets the cached block back.
+  const auto before = pool.stats();
+  void* reused = pool.allocate(128);
+  EXPECT_EQ(reused, data);
+  EXPECT_EQ(pool.stats().thread_cache_hits, before.thread_cache_hits + 1);
+  pool.deallocate(reused, 128);
+}
+
+TEST_F(TensorStoragePoolTest, LargeBlocksBypassPool) {
+  auto& pool = TensorStoragePool::global();
+  const size_t nbytes = TensorStoragePool::kMaxBlockSize + 1;
+
+  void* data = pool.allocate(nbytes);
+  EXPECT_NE(data, nullptr);
+  pool.deallocate(data, nbytes);
+
+  const auto before = pool.stats();
+  data = pool.allocate(nbytes);
+  EXPECT_EQ(pool.stats().misses, before.misses + 1);
+  pool.deallocate(data, nbytes);
+}
+
+TEST_F(TensorStoragePoolTest, MakersUsePool) {
+  auto& pool = TensorStoragePool::global();
+
+  const void* data = nullptr;
+  {
+    auto tensor = zeros({4, 8});
+    data = tensor->const_data_ptr();
+    for (auto i = 0; i < tensor->numel(); ++i) {
+      EXPECT_EQ(tensor->const_data_ptr<float>()[i], 0);
+    }
+  }
+  const auto before = pool.stats();
+  auto tensor = ones({8, 4});
+  EXPECT_EQ(tensor->const_data_ptr(), data);
+  EXPECT_EQ(pool.stats().thread_cache_hits, before.thread_cache_hits + 1);
+  for (auto i = 0; i < tensor->numel(); ++i) {
+    EXPECT_EQ(tensor->const_data_ptr<float>()[i], 1);
+  }
+}
+
+TEST_F(TensorStoragePoolTest, CloneUsesPool) {
+  auto tensor = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+
+  const auto before = TensorStoragePool::global().stats();
+  auto clone = clone_tensor_ptr(tensor);
+  const auto after = TensorStoragePool::global().stats();
+  EXPECT_EQ(
+      after.thread_cache_hits + after.global_cache_hits + after.misses,
+      before.thread_cache_hits + before.global_cache_hits + before.misses + 1);
+
+  EXPECT_NE(clone->const_data_ptr(), tensor->const_data_ptr());
+  for (auto i = 0; i < tensor->numel(); ++i) {
+    EXPECT_EQ(
+        clone->const_data_ptr<float>()[i], tensor->const_data_ptr<float>()[i]);
+  }
+}
+
+TEST_F(TensorStoragePoolTest, DisabledPoolIsNotUsed) {
+  set_tensor_storage_pool_enabled(false);
+
+  const auto before = TensorStoragePool::global().stats();
+  auto tensor = zeros({16});
+  const auto after = TensorStoragePool::global().stats();
+  EXPECT_EQ(after.misses, before.misses);
+  EXPECT_EQ(after.thread_cache_hits, before.thread_cache_hits);
+  EXPECT_EQ(after.global_cache_hits, before.global_cache_hits);
+}
+
+TEST_F(TensorStoragePoolTest, TensorFreedOnAnotherThread) {
+  auto tensor = rand({64});
+  std::thread([tensor = std::move(tensor)]() mutable {
+    tensor.reset();
+  }).join();
+
+  // The exiting thread flushed its cache to the global one.
+  const auto before = TensorStoragePool::global().stats();
+  auto reused = rand({64});
+  EXPECT_EQ(
+      TensorStoragePool::global().stats().global_cache_hits,
+      before.global_cache_hits + 1);
+}
@@ -75,6 +75,12 @@ DEFINE_double(
     0.001,
     "Learning rate for SGD optimizer."); // Learning rate
 
+DEFINE_int32(
+    accumulation_steps,
+    1,
+    "Number of batches to accumulate gradients over before each optimizer "
+    "step."); // Gradient accumulation steps
+
 DEFINE_double(momentum, 0.9,
               "Momentum for SGD optimizer."); // Momentum
 
@@ -168,9 +174,15 @@ void train_model(
       // Start timing model training
       auto train_start = std::chrono::high_resolution_clock::now();
 
-      // Execute forward and backward pass on the batch
-      const auto& results = mod.execute_forward_backward(
-          "forward", {*batch_image_tensor, *batch_label_tensor});
+      // Execute forward and backward pass on the batch, accumulating the
+      // gradients when training with an effective batch of several batches.
+      const auto& results = FLAGS_accumulation_steps > 1
+          ? mod.execute_forward_backward_accumulate(
+                "forward",
+                {*batch_image_tensor, *batch_label_tensor},
+                1.0 / FLAGS_accumulation_steps)
+          : mod.execute_forward_backward(
+                "forward", {*batch_image_tensor, *batch_label_tensor});
       if (results.error() != Error::Ok) {
         ET_LOG(
             Error,
@@ -195,12 +207,25 @@ void train_model(
       total_samples += FLAGS_batch_size;
 
       // Get gradients and update parameters
-      auto grads = mod.named_gradients("forward");
-      if (grads.error() != Error::Ok) {
-        ET_LOG(Error, "Failed to get named gradients");
-        return;
+      if (FLAGS_accumulation_steps > 1) {
+        if (mod.num_accumulated_steps("forward") ==
+            static_cast<size_t>(FLAGS_accumulation_steps)) {
+          auto grads = mod.named_accumulated_gradients("forward");
+          if (grads.error() != Error::Ok) {
+            ET_LOG(Error, "Failed to get accumulated gradients");
+            return;
+          }
+          optimizer.step(grads.get());
+          mod.zero_accumulated_gradients("forward");
+        }
+      } else {
+        auto grads = mod.named_gradients("forward");
+        if (grads.error() != Error::Ok) {
+          ET_LOG(Error, "Failed to get named gradients");
+          return;
+        }
+        optimizer.step(grads.get());
       }
-      optimizer.step(grads.get());
 
       // End timing model training
       auto train_end = std::chrono::high_resolution_clock::now();
@@ -228,6 +253,24 @@ void train_model(
     auto epoch_end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> epoch_time = epoch_end - epoch_start;
 
+    // Report the extra memory held for gradient accumulation
+    if (FLAGS_accumulation_steps > 1) {
+      size_t accumulation_bytes = 0;
+      auto grads = mod.named_accumulated_gradients("forward");
+      if (grads.ok()) {
+        for (const auto& grad : grads.get()) {
+          accumulation_bytes += grad.second.nbytes();
+        }
+      }
+      ET_LOG(
+          Info,
+          "Accumulating %d batches per step (effective batch size %d), "
+          "accumulation buffer: %zu bytes",
+          FLAGS_accumulation_steps,
+          FLAGS_accumulation_steps * FLAGS_batch_size,
+          accumulation_bytes);
+    }
+
     // Log epoch summary
     float avg_loss = epoch_loss / num_batches;
     float accuracy = 100.0f * correct_predictions / total_samples;
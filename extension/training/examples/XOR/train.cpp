@@ -12,6 +12,8 @@
 #include <executorch/extension/training/module/training_module.h>
 #include <executorch/extension/training/optimizer/sgd.h>
 #include <gflags/gflags.h>
+#include <algorithm>
+#include <chrono>
 #include <random>
 
 #pragma clang diagnostic ignored \
@@ -24,6 +26,10 @@ using executorch::runtime::Error;
 using executorch::runtime::Result;
 DEFINE_string(model_path, "xor.pte", "Model serialized in flatbuffer format.");
 DEFINE_string(ptd_path, "", "Model weights serialized in flatbuffer format.");
+DEFINE_int32(
+    accumulation_steps,
+    1,
+    "Number of micro-batches to accumulate gradients over per optimizer step.");
 
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -106,12 +112,19 @@ int main(int argc, char** argv) {
       0, static_cast<int>(data_set.size()) - 1};
 
   // Train the model.
+  const size_t accumulation_steps =
+      static_cast<size_t>(std::max(FLAGS_accumulation_steps, 1));
+  const double grad_scale = 1.0 / accumulation_steps;
+  double total_step_ms = 0;
   size_t num_epochs = 5000;
   for (int i = 0; i < num_epochs; i++) {
     int index = dist(URBG);
     auto& data = data_set[index];
-    const auto& results =
-        mod.execute_forward_backward("forward", {*data.first, *data.second});
+    auto step_start = std::chrono::steady_clock::now();
+    const auto& results = accumulation_steps > 1
+        ? mod.execute_forward_backward_accumulate(
+              "forward", {*data.first, *data.second}, grad_scale)
+        : mod.execute_forward_backward("forward", {*data.first, *data.second});
     if (results.error() != Error::Ok) {
       ET_LOG(Error, "Failed to execute forward_backward");
       return 1;
@@ -127,8 +140,33 @@ int main(int argc, char** argv) {
           results.get()[1].toTensor().const_data_ptr<int64_t>()[0],
           data.second->const_data_ptr<int64_t>()[0]);
     }
-    optimizer.step(mod.named_gradients("forward").get());
+    if (accumulation_steps > 1) {
+      if (mod.num_accumulated_steps("forward") == accumulation_steps) {
+        optimizer.step(mod.named_accumulated_gradients("forward").get());
+        mod.zero_accumulated_gradients("forward");
+      }
+    } else {
+      optimizer.step(mod.named_gradients("forward").get());
+    }
+    total_step_ms += std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - step_start)
+                         .count();
   }
+
+  size_t accumulation_bytes = 0;
+  if (accumulation_steps > 1) {
+    for (const auto& grad : mod.named_accumulated_gradients("forward").get()) {
+      accumulation_bytes += grad.second.nbytes();
+    }
+  }
+  ET_LOG(
+      Info,
+      "Accumulation steps %zu, avg micro-batch time %.4f ms, "
+      "accumulation buffer %zu bytes",
+      accumulation_steps,
+      total_step_ms / num_epochs,
+      accumulation_bytes);
+
   std::map<std::string, exec_aten::Tensor> param_map;
   for (auto& param : param_res.get()) {
     param_map.insert(std::pair<std::string, exec_aten::Tensor>{
@@ -41,6 +41,7 @@ def define_common_targets():
             ],
             exported_deps = [
                 "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
                 "//executorch/runtime/core:evalue" + aten_suffix,
             ],
         )
@@ -254,3 +254,65 @@ TEST_F(TrainingModuleTest, UnloadMethodTest) {
       0.1528,
       0.0001);
 }
+
+TEST_F(TrainingModuleTest, GradientAccumulationTest) {
+  const char* path = std::getenv("ET_MODULE_SIMPLE_TRAIN_PATH");
+  executorch::runtime::Result<torch::executor::util::FileDataLoader>
+      loader_res = torch::executor::util::FileDataLoader::from(path);
+  ASSERT_EQ(loader_res.error(), Error::Ok);
+  auto loader = std::make_unique<torch::executor::util::FileDataLoader>(
+      std::move(loader_res.get()));
+
+  auto mod = executorch::extension::training::TrainingModule(std::move(loader));
+
+  // Nothing has been accumulated yet.
+  ASSERT_EQ(
+      mod.named_accumulated_gradients("forward").error(),
+      Error::InvalidArgument);
+  ASSERT_EQ(mod.num_accumulated_steps("forward"), 0);
+
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({3}, {1.0, 1.0, 1.0});
+  Tensor label = tf.make({3}, {1.0, 0.0, 0.0});
+
+  std::vector<executorch::runtime::EValue> inputs;
+  inputs.push_back(input);
+  inputs.push_back(label);
+
+  // Accumulate the same micro-batch twice, averaging over both.
+  for (int i = 0; i < 2; ++i) {
+    auto res = mod.execute_forward_backward_accumulate("forward", inputs, 0.5);
+    ASSERT_EQ(res.error(), Error::Ok);
+    ASSERT_EQ(res.get().size(), 1);
+  }
+  ASSERT_EQ(mod.num_accumulated_steps("forward"), 2);
+
+  auto grad_res = mod.named_gradients("forward");
+  ASSERT_EQ(grad_res.error(), Error::Ok);
+  auto accum_res = mod.named_accumulated_gradients("forward");
+  ASSERT_EQ(accum_res.error(), Error::Ok);
+  auto& grad = grad_res.get();
+  auto& accum = accum_res.get();
+  ASSERT_EQ(accum.size(), grad.size());
+
+  // The accumulated buffers are separate from the method's gradient outputs.
+  for (const auto& [fqn, gradient] : grad) {
+    const auto& accumulated = accum.at(fqn);
+    ASSERT_NE(accumulated.const_data_ptr(), gradient.const_data_ptr());
+    ASSERT_EQ(accumulated.numel(), gradient.numel());
+    for (size_t i = 0; i < gradient.numel(); ++i) {
+      EXPECT_NEAR(
+          accumulated.const_data_ptr<float>()[i],
+          gradient.const_data_ptr<float>()[i],
+          1e-6);
+    }
+  }
+
+  ASSERT_EQ(mod.zero_accumulated_gradients("forward"), Error::Ok);
+  ASSERT_EQ(mod.num_accumulated_steps("forward"), 0);
+  for (const auto& [fqn, accumulated] : accum) {
+    for (size_t i = 0; i < accumulated.numel(); ++i) {
+      EXPECT_EQ(accumulated.const_data_ptr<float>()[i], 0.0f);
+    }
+  }
+}
@@ -8,6 +8,10 @@
 
 #include <executorch/extension/training/module/training_module.h>
 
+#include <cstring>
+
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
 namespace executorch {
 namespace extension {
 namespace training {
@@ -26,6 +30,42 @@ std::string make_fqn_method_name(const std::string& method_name) {
   return "__et_training_fqn_" + method_name;
 }
 
+runtime::Error accumulate_gradient(
+    executorch::aten::Tensor& accumulator,
+    const executorch::aten::Tensor& gradient,
+    double scale) {
+  ET_CHECK_OR_RETURN_ERROR(
+      accumulator.scalar_type() == gradient.scalar_type() &&
+          accumulator.numel() == gradient.numel(),
+      InvalidArgument,
+      "Gradient does not match its accumulation buffer");
+
+  struct {
+    void fail(runtime::Error error) {
+      this->error = error;
+    }
+    runtime::Error error = runtime::Error::Ok;
+  } ctx;
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      gradient.scalar_type(), ctx, "accumulate_gradient", CTYPE, [&] {
+        const CTYPE* src = gradient.const_data_ptr<CTYPE>();
+        CTYPE* dst = accumulator.mutable_data_ptr<CTYPE>();
+        const size_t numel = gradient.numel();
+        if (scale == 1.0) {
+          for (size_t i = 0; i < numel; ++i) {
+            dst[i] = dst[i] + src[i];
+          }
+        } else {
+          const CTYPE s = static_cast<CTYPE>(scale);
+          for (size_t i = 0; i < numel; ++i) {
+            dst[i] = dst[i] + src[i] * s;
+          }
+        }
+      });
+  return ctx.error;
+}
+
 } // namespace
 
 runtime::Result<std::vector<runtime::EValue>>
@@ -97,6 +137,78 @@ TrainingModule::execute_forward_backward(
   return user_outputs;
 }
 
+runtime::Result<std::vector<runtime::EValue>>
+TrainingModule::execute_forward_backward_accumulate(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input,
+    double scale) {
+  auto outputs = execute_forward_backward(method_name, input);
+  if (!outputs.ok()) {
+    return outputs.error();
+  }
+  const auto& gradients_map = method_named_gradients_.at(method_name);
+  auto& accumulator = method_gradient_accumulators_[method_name];
+
+  // Allocate the buffer once; later micro-batches only add into it.
+  if (accumulator.buffers.empty()) {
+    accumulator.buffers.reserve(gradients_map.size());
+    for (const auto& [fqn, gradient] : gradients_map) {
+      auto buffer = full_strided(
+          {gradient.sizes().begin(), gradient.sizes().end()},
+          {gradient.strides().begin(), gradient.strides().end()},
+          0,
+          gradient.scalar_type(),
+          executorch::aten::TensorShapeDynamism::STATIC);
+      accumulator.named_gradients.insert({fqn, *buffer});
+      accumulator.buffers.push_back(std::move(buffer));
+    }
+  }
+
+  for (const auto& [fqn, gradient] : gradients_map) {
+    auto error = accumulate_gradient(
+        accumulator.named_gradients.at(fqn), gradient, scale);
+    if (error != runtime::Error::Ok) {
+      return error;
+    }
+  }
+  ++accumulator.num_steps;
+
+  return outputs;
+}
+
+runtime::Result<const std::map<std::string_view, executorch::aten::Tensor>>
+TrainingModule::named_accumulated_gradients(const std::string& method_name) {
+  auto it = method_gradient_accumulators_.find(method_name);
+  if (it == method_gradient_accumulators_.end()) {
+    ET_LOG(
+        Error,
+        "No accumulated gradients found for method %s",
+        method_name.c_str());
+    return executorch::runtime::Error::InvalidArgument;
+  }
+  return it->second.named_gradients;
+}
+
+runtime::Error TrainingModule::zero_accumulated_gradients(
+    const std::string& method_name) {
+  auto it = method_gradient_accumulators_.find(method_name);
+  if (it == method_gradient_accumulators_.end()) {
+    // Nothing has been accumulated yet, so there is nothing to zero.
+    return runtime::Error::Ok;
+  }
+  for (auto& buffer : it->second.buffers) {
+    std::memset(buffer->mutable_data_ptr(), 0, buffer->nbytes());
+  }
+  it->second.num_steps = 0;
+  return runtime::Error::Ok;
+}
+
+size_t TrainingModule::num_accumulated_steps(
+    const std::string& method_name) const {
+  auto it = method_gradient_accumulators_.find(method_name);
+  return it == method_gradient_accumulators_.end() ? 0 : it->second.num_steps;
+}
+
 runtime::Result<const std::map<std::string_view, executorch::aten::Tensor>>
 TrainingModule::named_parameters(const std::string& method_name) {
   // If we haven't seen this method before, populate the dict.
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/executor/program.h>
 
@@ -54,6 +55,7 @@ class ET_EXPERIMENTAL TrainingModule final
     method_named_gradients_.erase(method_name);
     method_named_parameters_.erase(method_name);
     method_named_attributes_.erase(method_name);
+    method_gradient_accumulators_.erase(method_name);
 
     return methods_.erase(method_name);
   }
@@ -74,6 +76,67 @@ class ET_EXPERIMENTAL TrainingModule final
       const std::string& method_name,
       const std::vector<runtime::EValue>& input);
 
+  /**
+   * Execute a joint graph method like execute_forward_backward() and add the
+   * resulting gradients, multiplied by `scale`, in place into a per-method
+   * accumulation buffer. The buffer is allocated on the first call and reused
+   * by every later call, so accumulating over N micro-batches costs a single
+   * extra copy of the gradients regardless of N. Feed
+   * named_accumulated_gradients() to the optimizer once the effective batch is
+   * complete, then call zero_accumulated_gradients() before the next one.
+   *
+   * @param[in] method_name The name of the joint graph method to execute.
+   * @param[in] input A vector of input values to be passed to the method.
+   * @param[in] scale The factor applied to this micro-batch's gradients before
+   * they are added to the buffer, e.g. 1/N to average over N micro-batches.
+   *
+   * @returns A Result object containing the output values from the method or an
+   * error to indicate failure.
+   */
+  ET_EXPERIMENTAL runtime::Result<std::vector<runtime::EValue>>
+  execute_forward_backward_accumulate(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input,
+      double scale = 1.0);
+
+  /**
+   * Retrieve the accumulated gradients for a joint graph method.
+   *
+   * @param[in] method_name The name of the joint graph method to get the
+   * accumulated gradients for.
+   *
+   * @returns A Result object containing a map of the fully qualified name to
+   * the accumulated gradient tensor associated with that parameter, or an error
+   * if execute_forward_backward_accumulate() has not been called for the
+   * method.
+   */
+  ET_EXPERIMENTAL
+  runtime::Result<const std::map<std::string_view, executorch::aten::Tensor>>
+  named_accumulated_gradients(const std::string& method_name);
+
+  /**
+   * Reset the accumulated gradients of a joint graph method to zero without
+   * releasing the accumulation buffer.
+   *
+   * @param[in] method_name The name of the joint graph method.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL runtime::Error zero_accumulated_gradients(
+      const std::string& method_name);
+
+  /**
+   * Retrieve the number of micro-batches accumulated since the buffer of a
+   * joint graph method was last zeroed.
+   *
+   * @param[in] method_name The name of the joint graph method.
+   *
+   * @returns The number of accumulated micro-batches, or 0 if nothing was
+   * accumulated for the method.
+   */
+  ET_EXPERIMENTAL size_t num_accumulated_steps(
+      const std::string& method_name) const;
+
   /**
    * Retrieve the trainable parameters for a joint graph method.
    *
@@ -116,6 +179,13 @@ class ET_EXPERIMENTAL TrainingModule final
   named_attributes(const std::string& method_name);
 
  private:
+  struct GradientAccumulator {
+    // Owns the memory backing named_gradients.
+    std::vector<TensorPtr> buffers;
+    std::map<std::string_view, executorch::aten::Tensor> named_gradients;
+    size_t num_steps = 0;
+  };
+
   std::unordered_map<
       std::string,
       std::map<std::string_view, executorch::aten::Tensor>>
@@ -130,6 +200,9 @@ class ET_EXPERIMENTAL TrainingModule final
       std::string,
       std::map<std::string_view, executorch::aten::Tensor>>
       method_named_attributes_;
+
+  std::unordered_map<std::string, GradientAccumulator>
+      method_gradient_accumulators_;
 };
 
 } // namespace training
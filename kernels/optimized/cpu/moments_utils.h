@@ -15,8 +15,11 @@
 #include <ATen/cpu/vec/vec.h>
 
 #include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <array>
+#include <type_traits>
+#include <vector>
 
 namespace torch {
 namespace executor {
@@ -186,6 +189,32 @@ RowwiseMoments(const T* X, int64_t N, int64_t ddof = 0) {
   }
 }
 
+// Type in which normalization statistics are computed: float for Half and
+// BFloat16, acc_t<T> otherwise.
+template <typename T>
+using moments_opmath_t = std::
+    conditional_t<c10::is_reduced_floating_point_v<T>, float, acc_t<T>>;
+
+// RowwiseMoments() computed in moments_opmath_t<T>. Half and BFloat16 rows
+// are first converted to float in `scratch`, which callers can reuse across
+// rows.
+template <typename T>
+std::pair<moments_opmath_t<T>, moments_opmath_t<T>> RowwiseMomentsOpmath(
+    const T* X,
+    int64_t N,
+    std::vector<float>& scratch) {
+  if constexpr (c10::is_reduced_floating_point_v<T>) {
+    scratch.resize(N);
+    for (int64_t i = 0; i < N; ++i) {
+      scratch[i] = static_cast<float>(X[i]);
+    }
+    return RowwiseMoments(scratch.data(), N);
+  } else {
+    (void)scratch;
+    return RowwiseMoments(X, N);
+  }
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <ATen/cpu/vec/vec.h>
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/cpu/pool2d_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+// Half and BFloat16 windows are summed in float.
+template <typename CTYPE>
+using acc_t =
+    std::conditional_t<c10::is_reduced_floating_point_v<CTYPE>, float, CTYPE>;
+
+// acc[i] += src[i * src_stride], vectorized for contiguous sources that need
+// no conversion.
+template <typename CTYPE, typename ACC_T>
+void accumulate(
+    ACC_T* acc,
+    const CTYPE* src,
+    const int64_t src_stride,
+    const int64_t size) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, ACC_T>) {
+    if (src_stride == 1) {
+      using Vec = at::vec::Vectorized<ACC_T>;
+      for (; i + Vec::size() <= size; i += Vec::size()) {
+        const Vec sum = Vec::loadu(acc + i) + Vec::loadu(src + i);
+        sum.store(acc + i);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    acc[i] += src[i * src_stride];
+  }
+}
+
+template <typename CTYPE>
+CTYPE average(
+    const acc_t<CTYPE> sum,
+    const int64_t count,
+    const std::optional<int64_t>& divisor_override) {
+  using ACC_T = acc_t<CTYPE>;
+  // If divisor_override is specified, then we don't need to use `count`.
+  const int64_t divisor =
+      divisor_override.has_value() ? divisor_override.value() : count;
+  return static_cast<CTYPE>(sum / static_cast<ACC_T>(divisor));
+}
+
+template <typename CTYPE>
+void avg_pool2d_nchw(
+    const Tensor& in,
+    const Pool2dParams& p,
+    const bool count_include_pad,
+    const std::optional<int64_t>& divisor_override,
+    Tensor& out) {
+  using ACC_T = acc_t<CTYPE>;
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t num_planes = p.batch * p.channels;
+  const int64_t in_plane_size = p.in_h * p.in_w;
+  const int64_t out_plane_size = p.out_h * p.out_w;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_planes,
+      pool2d_grain_size(out_plane_size * p.kernel_h * p.kernel_w),
+      [&](const auto begin, const auto end) {
+        // Sums for one output row. Each kernel tap adds a strided run of an
+        // input row into it, which is contiguous when stride_w is 1.
+        std::vector<ACC_T> row_sum(p.out_w);
+
+        for (const auto plane : c10::irange(begin, end)) {
+          const CTYPE* const in_plane = in_data + plane * in_plane_size;
+          CTYPE* const out_plane = out_data + plane * out_plane_size;
+
+          for (const auto oh : c10::irange(p.out_h)) {
+            const PoolWindow win_h =
+                pool_window(oh, p.kernel_h, p.stride_h, p.pad_h, p.in_h);
+
+            std::fill(row_sum.begin(), row_sum.end(), ACC_T(0));
+            for (int64_t ih = win_h.start; ih < win_h.end; ++ih) {
+              const CTYPE* const in_row = in_plane + ih * p.in_w;
+              for (const auto kw : c10::irange(p.kernel_w)) {
+                const int64_t offset = kw - p.pad_w;
+                const auto range = pool_valid_output_range(
+                    offset, p.stride_w, p.in_w, p.out_w);
+                if (range.first >= range.second) {
+                  continue;
+                }
+                accumulate(
+                    row_sum.data() + range.first,
+                    in_row + range.first * p.stride_w + offset,
+                    p.stride_w,
+                    range.second - range.first);
+              }
+            }
+
+            CTYPE* const out_row = out_plane + oh * p.out_w;
+            for (const auto ow : c10::irange(p.out_w)) {
+              const PoolWindow win_w =
+                  pool_window(ow, p.kernel_w, p.stride_w, p.pad_w, p.in_w);
+              if (win_h.start >= win_h.end || win_w.start >= win_w.end) {
+                continue;
+              }
+              const int64_t count = count_include_pad
+                  ? win_h.padded_size * win_w.padded_size
+                  : (win_h.end - win_h.start) * (win_w.end - win_w.start);
+              out_row[ow] =
+                  average<CTYPE>(row_sum[ow], count, divisor_override);
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void avg_pool2d_nhwc(
+    const Tensor& in,
+    const Pool2dParams& p,
+    const bool count_include_pad,
+    const std::optional<int64_t>& divisor_override,
+    Tensor& out) {
+  using ACC_T = acc_t<CTYPE>;
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t num_rows = p.batch * p.out_h;
+  const int64_t channels = p.channels;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_rows,
+      pool2d_grain_size(p.out_w * channels * p.kernel_h * p.kernel_w),
+      [&](const auto begin, const auto end) {
+        // Channels are innermost, so every input pixel in the window adds a
+        // contiguous vector of channels.
+        std::vector<ACC_T> pixel_sum(channels);
+
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t n = row / p.out_h;
+          const int64_t oh = row % p.out_h;
+          const CTYPE* const in_image =
+              in_data + n * p.in_h * p.in_w * channels;
+          CTYPE* const out_row = out_data + row * p.out_w * channels;
+
+          const PoolWindow win_h =
+              pool_window(oh, p.kernel_h, p.stride_h, p.pad_h, p.in_h);
+          for (const auto ow : c10::irange(p.out_w)) {
+            const PoolWindow win_w =
+                pool_window(ow, p.kernel_w, p.stride_w, p.pad_w, p.in_w);
+            if (win_h.start >= win_h.end || win_w.start >= win_w.end) {
+              continue;
+            }
+
+            std::fill(pixel_sum.begin(), pixel_sum.end(), ACC_T(0));
+            for (int64_t ih = win_h.start; ih < win_h.end; ++ih) {
+              for (int64_t iw = win_w.start; iw < win_w.end; ++iw) {
+                accumulate(
+                    pixel_sum.data(),
+                    in_image + (ih * p.in_w + iw) * channels,
+                    1,
+                    channels);
+              }
+            }
+
+            const int64_t count = count_include_pad
+                ? win_h.padded_size * win_w.padded_size
+                : (win_h.end - win_h.start) * (win_w.end - win_w.start);
+            CTYPE* const out_pixel = out_row + ow * channels;
+            for (const auto c : c10::irange(channels)) {
+              out_pixel[c] =
+                  average<CTYPE>(pixel_sum[c], count, divisor_override);
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_avg_pool2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    std::optional<int64_t> divisor_override,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_avg_pool2d_args(
+          in,
+          kernel_size,
+          stride,
+          padding,
+          ceil_mode,
+          count_include_pad,
+          divisor_override,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_avg_pool2d_out_target_size(
+      in, kernel_size, stride, padding, ceil_mode, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const Pool2dParams params =
+      make_pool2d_params(in, out, kernel_size, stride, padding, {});
+  const bool channels_last = pool2d_is_channels_last(in);
+
+  ScalarType in_type = in.scalar_type();
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "avg_pool2d.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES_AND(Long, in_type, ctx, op_name, CTYPE, [&]() {
+    if (channels_last) {
+      avg_pool2d_nhwc<CTYPE>(
+          in, params, count_include_pad, divisor_override, out);
+    } else {
+      avg_pool2d_nchw<CTYPE>(
+          in, params, count_include_pad, divisor_override, out);
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cinttypes>
+
+#include <executorch/kernels/portable/cpu/util/gather_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+template <typename CTYPE>
+void embedding_kernel(
+    KernelRuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  const CTYPE* const indices_ptr = indices.const_data_ptr<CTYPE>();
+  const ssize_t weight_height = weight.size(0);
+  const auto indices_numel = indices.numel();
+
+  // Validate every index up front so that the rows can be gathered in
+  // parallel without bounds checks.
+  for (int64_t i = 0; i < indices_numel; i++) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        indices_ptr[i] < weight_height,
+        InvalidArgument,
+        ,
+        "indices_ptr[%" PRId64 "] %ld >= weight.size(0) %zd",
+        i,
+        static_cast<long>(indices_ptr[i]),
+        weight_height);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        indices_ptr[i] >= 0,
+        InvalidArgument,
+        ,
+        "indices_ptr[%" PRId64 "] %ld < 0",
+        i,
+        static_cast<long>(indices_ptr[i]));
+  }
+
+  const char* const w_data = weight.const_data_ptr<char>();
+  if (w_data == nullptr) {
+    return;
+  }
+  gather_rows(
+      out.mutable_data_ptr<char>(),
+      /*dst_block_nbytes=*/0,
+      w_data,
+      /*src_block_nbytes=*/0,
+      indices_ptr,
+      indices_numel,
+      weight.size(1) * weight.element_size());
+}
+
+} // namespace
+
+// embedding.out(Tensor weight, Tensor indices, int padding_idx=-1, bool
+// scale_grad_by_freq=False, bool sparse=False, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_embedding_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    int64_t padding_idx,
+    bool scale_grad_by_freq,
+    bool sparse,
+    Tensor& out) {
+  (void)padding_idx;
+  (void)scale_grad_by_freq;
+  (void)sparse;
+
+  ET_KERNEL_CHECK(
+      ctx, check_embedding_args(weight, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_embedding_output(weight, indices, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.size(out.dim() - 1) == weight.size(1),
+      InvalidArgument,
+      out,
+      "out.size(%zd) %zd != weight.size(1) %zd",
+      out.dim() - 1,
+      out.size(1),
+      weight.size(1));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(weight, indices, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_default_dim_order(weight), InvalidArgument, out);
+
+  ScalarType ix_type = indices.scalar_type();
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      ix_type == ScalarType::Long || ix_type == ScalarType::Int,
+      InvalidArgument,
+      out,
+      "Expected indices tensor to have Long or Int scalar types");
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "embedding.out";
+
+  ET_SWITCH_TWO_TYPES(Long, Int, ix_type, ctx, op_name, CTYPE, [&]() {
+    embedding_kernel<CTYPE>(ctx, weight, indices, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
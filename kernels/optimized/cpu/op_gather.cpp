@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+// True when in, index and out are contiguous and index only differs from in
+// along `dim`. Every index value then addresses a row of `in` that lines up
+// with its position in `index`, so out can be filled with flat offsets.
+bool can_use_fast_path(
+    const Tensor& in,
+    const Tensor& index,
+    const Tensor& out,
+    const int64_t dim) {
+  if (in.dim() == 0 || in.dim() != index.dim()) {
+    return false;
+  }
+  if (!tensor_is_default_dim_order(in) ||
+      !tensor_is_default_dim_order(index) ||
+      !tensor_is_default_dim_order(out)) {
+    return false;
+  }
+  for (const auto d : c10::irange(in.dim())) {
+    if (d != dim && index.size(d) != in.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename CTYPE>
+void gather_fast_path(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    const int64_t dim) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  // View index/out as {outer, index_dim, inner} and in as
+  // {outer, in_dim, inner}.
+  const int64_t inner = getTrailingDims(in, dim);
+  const int64_t in_dim = in.size(dim);
+  const int64_t index_dim = index.size(dim);
+  const int64_t num_rows = getLeadingDims(index, dim) * index_dim;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_rows,
+      std::max<int64_t>(
+          1,
+          ::executorch::extension::internal::GRAIN_SIZE /
+              std::max<int64_t>(1, inner)),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const CTYPE* const in_block =
+              in_data + (row / index_dim) * in_dim * inner;
+          const int64_t* const index_row = index_data + row * inner;
+          CTYPE* const out_row = out_data + row * inner;
+          if (inner == 1) {
+            // Gathering along the last dim.
+            out_row[0] = in_block[index_row[0]];
+            continue;
+          }
+          for (const auto i : c10::irange(inner)) {
+            out_row[i] = in_block[index_row[i] * inner + i];
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void gather_helper(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (index.dim() == 0) {
+    out_data[0] = in_data[index_data[0]];
+    return;
+  }
+
+  if (can_use_fast_path(in, index, out, dim)) {
+    gather_fast_path<CTYPE>(in, index, out, dim);
+    return;
+  }
+
+  for (const auto ix : c10::irange(index.numel())) {
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    size_t in_coord[kTensorDimensionLimit];
+    for (const auto i : c10::irange(out.dim())) {
+      if (i == dim) {
+        in_coord[i] = index_data[ix];
+      } else {
+        in_coord[i] = ix_coord[i];
+      }
+    }
+
+    size_t in_ix = coordinateToIndex(in, in_coord);
+    size_t out_ix = coordinateToIndex(out, ix_coord);
+
+    out_data[out_ix] = in_data[in_ix];
+  }
+}
+
+} // namespace
+
+Tensor& opt_gather_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out) {
+  // Also validates that every index value is in range.
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gather_args(in, dim, index, sparse_grad, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, index.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "gather.out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    gather_helper<CTYPE>(in, index, out, dim);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/cpu/pool2d_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+// Folds one kernel tap into the running maxima. An index of -1 marks an
+// output whose window has not seen an in-bounds element yet; like the
+// portable kernel, the first element seen initializes the maximum and later
+// elements only replace it when strictly greater.
+template <typename CTYPE>
+inline void update_max(
+    CTYPE& max_val,
+    int64_t& max_idx,
+    const CTYPE val,
+    const int64_t idx) {
+  if (max_idx < 0 || val > max_val) {
+    max_val = val;
+    max_idx = idx;
+  }
+}
+
+// Windows with no in-bounds element produce (0, 0), matching the portable
+// kernel; windows that lie entirely in the padding are not written.
+template <typename CTYPE>
+inline void store_max(
+    const CTYPE max_val,
+    const int64_t max_idx,
+    CTYPE* out,
+    int64_t* indices) {
+  *out = max_idx < 0 ? CTYPE(0) : max_val;
+  *indices = max_idx < 0 ? 0 : max_idx;
+}
+
+template <typename CTYPE>
+void max_pool2d_nchw(
+    const Tensor& in,
+    const Pool2dParams& p,
+    Tensor& out,
+    Tensor& indices) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+
+  const int64_t num_planes = p.batch * p.channels;
+  const int64_t in_plane_size = p.in_h * p.in_w;
+  const int64_t out_plane_size = p.out_h * p.out_w;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_planes,
+      pool2d_grain_size(out_plane_size * p.kernel_h * p.kernel_w),
+      [&](const auto begin, const auto end) {
+        // Running maxima for one output row. Each kernel tap is folded in as
+        // a strided run of one input row, which is contiguous when stride_w
+        // is 1.
+        std::vector<CTYPE> row_max(p.out_w);
+        std::vector<int64_t> row_idx(p.out_w);
+
+        for (const auto plane : c10::irange(begin, end)) {
+          const CTYPE* const in_plane = in_data + plane * in_plane_size;
+          CTYPE* const out_plane = out_data + plane * out_plane_size;
+          int64_t* const indices_plane = indices_data + plane * out_plane_size;
+
+          for (const auto oh : c10::irange(p.out_h)) {
+            std::fill(row_idx.begin(), row_idx.end(), -1);
+            for (const auto kh : c10::irange(p.kernel_h)) {
+              const int64_t ih = oh * p.stride_h + kh * p.dilation_h - p.pad_h;
+              if (ih < 0 || ih >= p.in_h) {
+                continue;
+              }
+              const CTYPE* const in_row = in_plane + ih * p.in_w;
+              for (const auto kw : c10::irange(p.kernel_w)) {
+                const int64_t offset = kw * p.dilation_w - p.pad_w;
+                const auto range = pool_valid_output_range(
+                    offset, p.stride_w, p.in_w, p.out_w);
+                for (int64_t ow = range.first; ow < range.second; ++ow) {
+                  const int64_t iw = ow * p.stride_w + offset;
+                  update_max(
+                      row_max[ow], row_idx[ow], in_row[iw], ih * p.in_w + iw);
+                }
+              }
+            }
+
+            const PoolWindow win_h =
+                pool_window(oh, p.kernel_h, p.stride_h, p.pad_h, p.in_h);
+            for (const auto ow : c10::irange(p.out_w)) {
+              const PoolWindow win_w =
+                  pool_window(ow, p.kernel_w, p.stride_w, p.pad_w, p.in_w);
+              if (win_h.start >= win_h.end || win_w.start >= win_w.end) {
+                continue;
+              }
+              const int64_t out_offset = oh * p.out_w + ow;
+              store_max(
+                  row_max[ow],
+                  row_idx[ow],
+                  out_plane + out_offset,
+                  indices_plane + out_offset);
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void max_pool2d_nhwc(
+    const Tensor& in,
+    const Pool2dParams& p,
+    Tensor& out,
+    Tensor& indices) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+
+  const int64_t num_rows = p.batch * p.out_h;
+  const int64_t channels = p.channels;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_rows,
+      pool2d_grain_size(p.out_w * channels * p.kernel_h * p.kernel_w),
+      [&](const auto begin, const auto end) {
+        // Channels are innermost, so every input pixel in the window is
+        // folded in as a contiguous vector of channels.
+        std::vector<CTYPE> pixel_max(channels);
+        std::vector<int64_t> pixel_idx(channels);
+
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t n = row / p.out_h;
+          const int64_t oh = row % p.out_h;
+          const CTYPE* const in_image =
+              in_data + n * p.in_h * p.in_w * channels;
+          const int64_t out_row_offset = row * p.out_w * channels;
+
+          const PoolWindow win_h =
+              pool_window(oh, p.kernel_h, p.stride_h, p.pad_h, p.in_h);
+          for (const auto ow : c10::irange(p.out_w)) {
+            const PoolWindow win_w =
+                pool_window(ow, p.kernel_w, p.stride_w, p.pad_w, p.in_w);
+            if (win_h.start >= win_h.end || win_w.start >= win_w.end) {
+              continue;
+            }
+
+            std::fill(pixel_idx.begin(), pixel_idx.end(), -1);
+            for (const auto kh : c10::irange(p.kernel_h)) {
+              const int64_t ih = oh * p.stride_h + kh * p.dilation_h - p.pad_h;
+              if (ih < 0 || ih >= p.in_h) {
+                continue;
+              }
+              for (const auto kw : c10::irange(p.kernel_w)) {
+                const int64_t iw =
+                    ow * p.stride_w + kw * p.dilation_w - p.pad_w;
+                if (iw < 0 || iw >= p.in_w) {
+                  continue;
+                }
+                const CTYPE* const in_pixel =
+                    in_image + (ih * p.in_w + iw) * channels;
+                const int64_t idx = ih * p.in_w + iw;
+                for (const auto c : c10::irange(channels)) {
+                  update_max(pixel_max[c], pixel_idx[c], in_pixel[c], idx);
+                }
+              }
+            }
+
+            const int64_t out_offset = out_row_offset + ow * channels;
+            for (const auto c : c10::irange(channels)) {
+              store_max(
+                  pixel_max[c],
+                  pixel_idx[c],
+                  out_data + out_offset + c,
+                  indices_data + out_offset + c);
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_max_pool2d_with_indices_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices) {
+  std::tuple<Tensor&, Tensor&> ret_val(out, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_with_indices_args(
+          in, kernel_size, stride, padding, dilation, ceil_mode, out, indices),
+      InvalidArgument,
+      ret_val);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      in,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  const Pool2dParams params =
+      make_pool2d_params(in, out, kernel_size, stride, padding, dilation);
+  // The fast paths address all three tensors with the same layout. Mixed dim
+  // orders are rare and go through the generic strided implementation.
+  const bool same_dim_order = tensors_have_same_dim_order(in, out) &&
+      tensors_have_same_dim_order(in, indices);
+  const bool channels_last = pool2d_is_channels_last(in);
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_REALHBF16_TYPES(
+      in_type, ctx, "max_pool2d_with_indices.out", CTYPE, [&]() {
+        if (!same_dim_order) {
+          apply_kernel_2d_reduce_then_map_fn<CTYPE>(
+              [](const CTYPE in_val,
+                 const int64_t in_idx,
+                 const CTYPE accum,
+                 const int64_t accum_idx) {
+                if (in_val > accum) {
+                  return std::tuple<CTYPE, int64_t>(in_val, in_idx);
+                }
+                return std::tuple<CTYPE, int64_t>(accum, accum_idx);
+              },
+              // Max pooling does not need to post-process the accumulated
+              // output
+              [](const int64_t /*count*/, const CTYPE accum) { return accum; },
+              /*include_pad=*/false,
+              in,
+              kernel_size,
+              stride,
+              padding,
+              dilation,
+              out,
+              {indices});
+        } else if (channels_last) {
+          max_pool2d_nhwc<CTYPE>(in, params, out, indices);
+        } else {
+          max_pool2d_nchw<CTYPE>(in, params, out, indices);
+        }
+      });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/cpu/moments_utils.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using SizesType = executorch::aten::SizesType;
+
+namespace {
+
+int64_t batch_norm_grain_size(const int64_t work_per_unit) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, work_per_unit));
+}
+
+/**
+ * Applies out = in * scale[c] + shift[c] to a contiguous {outer, C, inner}
+ * input, where the per-channel scale and shift already fold in the mean,
+ * invstd, weight and bias. Rows of `inner` elements are independent and
+ * normalized in parallel; Half and BFloat16 are computed in float.
+ */
+template <typename CTYPE>
+void apply_batch_norm(
+    const CTYPE* in_data,
+    const std::vector<moments_opmath_t<CTYPE>>& scale,
+    const std::vector<moments_opmath_t<CTYPE>>& shift,
+    const int64_t outer,
+    const int64_t C,
+    const int64_t inner,
+    CTYPE* out_data) {
+  ::executorch::extension::parallel_for(
+      0,
+      outer * C,
+      batch_norm_grain_size(inner),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t c = row % C;
+          const auto s = scale[c];
+          const auto b = shift[c];
+          at::vec::map<CTYPE>(
+              [s, b](auto x) {
+                using Vec = decltype(x);
+                return x * Vec(s) + Vec(b);
+              },
+              out_data + row * inner,
+              in_data + row * inner,
+              inner);
+        }
+      });
+}
+
+/**
+ * Computes the per-channel scale and shift that apply_batch_norm() uses to
+ * normalize with the given mean and invstd.
+ */
+template <typename CTYPE, typename INVSTD_FN>
+void compute_scale_and_shift(
+    const optional<Tensor>& weight,
+    const optional<Tensor>& bias,
+    const CTYPE* mean_data,
+    const INVSTD_FN& invstd_of,
+    const int64_t C,
+    std::vector<moments_opmath_t<CTYPE>>& scale,
+    std::vector<moments_opmath_t<CTYPE>>& shift) {
+  using ACC_T = moments_opmath_t<CTYPE>;
+
+  const CTYPE* const weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+  scale.resize(C);
+  shift.resize(C);
+  for (const auto c : c10::irange(C)) {
+    const ACC_T invstd = static_cast<ACC_T>(invstd_of(c));
+    const ACC_T weight_val =
+        weight_data == nullptr ? ACC_T(1) : static_cast<ACC_T>(weight_data[c]);
+    const ACC_T bias_val =
+        bias_data == nullptr ? ACC_T(0) : static_cast<ACC_T>(bias_data[c]);
+    scale[c] = invstd * weight_val;
+    shift[c] = bias_val - static_cast<ACC_T>(mean_data[c]) * scale[c];
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&, Tensor&>
+opt_native_batch_norm_legit_no_training_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, invstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(mean_out, {0}) == Error::Ok, InvalidArgument, ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(invstd_out, {0}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_batch_norm_args(
+          in,
+          weight,
+          bias,
+          running_mean,
+          running_var,
+          momentum,
+          eps,
+          out,
+          mean_out,
+          invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  // For now, only support the contiguous dim order
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  if (weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(in, weight.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (bias.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(in, bias.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  const size_t C_dim = in.dim() >= 1 ? 1 : 0;
+  const int64_t C = in.size(C_dim);
+  const int64_t outer = getLeadingDims(in, C_dim);
+  const int64_t inner = getTrailingDims(in, C_dim);
+
+  constexpr auto name = "native_batch_norm_legit_no_training.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&] {
+    const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
+    const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
+
+    std::vector<moments_opmath_t<CTYPE>> scale;
+    std::vector<moments_opmath_t<CTYPE>> shift;
+    compute_scale_and_shift<CTYPE>(
+        weight,
+        bias,
+        mean_data,
+        [&](const int64_t c) {
+          return 1.0 / std::sqrt(static_cast<double>(var_data[c]) + eps);
+        },
+        C,
+        scale,
+        shift);
+
+    apply_batch_norm<CTYPE>(
+        in.const_data_ptr<CTYPE>(),
+        scale,
+        shift,
+        outer,
+        C,
+        inner,
+        out.mutable_data_ptr<CTYPE>());
+  });
+
+  return ret_val;
+}
+
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_batch_norm_legit_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    Tensor& running_mean,
+    Tensor& running_var,
+    bool training,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, invstd_out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      training == false,
+      InvalidArgument,
+      ret_val,
+      "Optimized kernels only support inference mode!");
+
+  return opt_native_batch_norm_legit_no_training_out(
+      ctx,
+      in,
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      momentum,
+      eps,
+      out,
+      mean_out,
+      invstd_out);
+}
+
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_batch_norm_legit_no_stats_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    bool training,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out) {
+  (void)training;
+
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, invstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_batch_norm_args(
+          in,
+          weight,
+          bias,
+          std::optional<Tensor>(),
+          std::optional<Tensor>(),
+          momentum,
+          eps,
+          out,
+          mean_out,
+          invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  if (weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(in, weight.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (bias.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(in, bias.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  ET_KERNEL_CHECK(ctx, in.dim() >= 2, InvalidArgument, ret_val);
+
+  const int64_t N = in.size(0);
+  const int64_t C = in.size(1);
+  const int64_t inner = getTrailingDims(in, 1);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(mean_out, {static_cast<SizesType>(C)}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(invstd_out, {static_cast<SizesType>(C)}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  constexpr auto name = "_native_batch_norm_legit.no_stats_out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&] {
+    using ACC_T = moments_opmath_t<CTYPE>;
+
+    const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+    CTYPE* const mean_data = mean_out.mutable_data_ptr<CTYPE>();
+    CTYPE* const invstd_data = invstd_out.mutable_data_ptr<CTYPE>();
+
+    // The statistics of a channel combine the Welford moments of its row in
+    // every batch, which is more stable than E[x^2] - E[x]^2. Channels are
+    // independent, so they are reduced in parallel.
+    ::executorch::extension::parallel_for(
+        0,
+        C,
+        batch_norm_grain_size(N * inner),
+        [&](const auto begin, const auto end) {
+          std::vector<float> scratch;
+          for (const auto c : c10::irange(begin, end)) {
+            int64_t m0 = 0;
+            ACC_T m1 = 0;
+            ACC_T m2 = 0;
+            for (int64_t b = 0; b < N && inner > 0; ++b) {
+              const auto moments = RowwiseMomentsOpmath(
+                  in_data + (b * C + c) * inner, inner, scratch);
+              AddMoments(
+                  inner,
+                  moments.first,
+                  moments.second * static_cast<ACC_T>(inner),
+                  m0,
+                  m1,
+                  m2);
+            }
+            // Like the portable kernel, channels without elements get NaN
+            // statistics.
+            const ACC_T mean = m0 == 0 ? static_cast<ACC_T>(NAN) : m1;
+            const ACC_T var =
+                m0 == 0 ? static_cast<ACC_T>(NAN) : m2 / static_cast<ACC_T>(m0);
+            mean_data[c] = static_cast<CTYPE>(mean);
+            invstd_data[c] = static_cast<CTYPE>(1.0 / std::sqrt(var + eps));
+          }
+        });
+
+    std::vector<moments_opmath_t<CTYPE>> scale;
+    std::vector<moments_opmath_t<CTYPE>> shift;
+    compute_scale_and_shift<CTYPE>(
+        weight,
+        bias,
+        mean_data,
+        [&](const int64_t c) { return invstd_data[c]; },
+        C,
+        scale,
+        shift);
+
+    apply_batch_norm<CTYPE>(
+        in_data, scale, shift, N, C, inner, out.mutable_data_ptr<CTYPE>());
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
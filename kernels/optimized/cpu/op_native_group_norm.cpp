@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/cpu/moments_utils.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// y = x * scale + shift over a contiguous run of n elements. Half and
+// BFloat16 are computed in float.
+template <typename CTYPE, typename ACC_T>
+void scale_and_shift(
+    CTYPE* dst,
+    const CTYPE* src,
+    const ACC_T scale,
+    const ACC_T shift,
+    const int64_t n) {
+  at::vec::map<CTYPE>(
+      [scale, shift](auto x) {
+        using Vec = decltype(x);
+        return x * Vec(scale) + Vec(shift);
+      },
+      dst,
+      src,
+      n);
+}
+
+template <typename CTYPE>
+void group_norm(
+    const Tensor& input,
+    const optional<Tensor>& weight,
+    const optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& out,
+    Tensor& mean,
+    Tensor& rstd) {
+  using ACC_T = moments_opmath_t<CTYPE>;
+
+  const int64_t G = group;
+  const int64_t leading = N * G;
+  const int64_t D = C / G;
+  const int64_t inner_size = D * HxW;
+
+  if (leading == 0) {
+    return;
+  }
+
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  CTYPE* mean_data = mean.mutable_data_ptr<CTYPE>();
+  CTYPE* rstd_data = rstd.mutable_data_ptr<CTYPE>();
+
+  if (inner_size == 0) {
+    for (const auto i : c10::irange(leading)) {
+      mean_data[i] = static_cast<CTYPE>(0);
+      rstd_data[i] = static_cast<CTYPE>(NAN);
+    }
+    return;
+  }
+
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+  // Every (batch, group) pair is an independent contiguous block of
+  // D * HxW elements.
+  ::executorch::extension::parallel_for(
+      0,
+      leading,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / inner_size),
+      [&](const auto begin, const auto end) {
+        std::vector<float> scratch;
+        for (const auto i : c10::irange(begin, end)) {
+          const CTYPE* x = input_data + i * inner_size;
+          CTYPE* y = out_data + i * inner_size;
+
+          ACC_T mean_val;
+          ACC_T rstd_val;
+          std::tie(mean_val, rstd_val) =
+              RowwiseMomentsOpmath(x, inner_size, scratch);
+          rstd_val = ACC_T(1) / std::sqrt(rstd_val + static_cast<ACC_T>(eps));
+
+          if (weight_data == nullptr && bias_data == nullptr) {
+            scale_and_shift(y, x, rstd_val, -rstd_val * mean_val, inner_size);
+          } else {
+            // Fold the per-channel affine transform into the normalization.
+            const int64_t g = i % G;
+            for (const auto j : c10::irange(D)) {
+              const int64_t ch = g * D + j;
+              const ACC_T weight_val = weight_data == nullptr
+                  ? ACC_T(1)
+                  : static_cast<ACC_T>(weight_data[ch]);
+              const ACC_T bias_val = bias_data == nullptr
+                  ? ACC_T(0)
+                  : static_cast<ACC_T>(bias_data[ch]);
+              const ACC_T scale = rstd_val * weight_val;
+              const ACC_T shift = bias_val - scale * mean_val;
+              scale_and_shift(y + j * HxW, x + j * HxW, scale, shift, HxW);
+            }
+          }
+
+          mean_data[i] = static_cast<CTYPE>(mean_val);
+          rstd_data[i] = static_cast<CTYPE>(rstd_val);
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_group_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, rstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_group_norm_args(
+          input, weight, bias, N, C, HxW, group, out, mean_out, rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  Tensor::SizesType mean_rstd_sizes[kTensorDimensionLimit];
+  mean_rstd_sizes[0] = N;
+  mean_rstd_sizes[1] = group;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(mean_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(rstd_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_default_dim_order(input), InvalidArgument, ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(input, out, mean_out, rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  if (weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(input, weight.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (bias.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(input, bias.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  constexpr auto name = "native_group_norm.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    group_norm<CTYPE>(
+        input, weight, bias, N, C, HxW, group, eps, out, mean_out, rstd_out);
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
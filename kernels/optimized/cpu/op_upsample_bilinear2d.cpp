@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ATen/cpu/vec/vec.h>
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+// Source indices and weights for every output row or column. They only
+// depend on the sizes, so they are computed once per call instead of once per
+// output pixel.
+struct InterpolationTable {
+  std::vector<int64_t> index0;
+  std::vector<int64_t> index1;
+  std::vector<float> lambda0;
+  std::vector<float> lambda1;
+
+  InterpolationTable(
+      const float scale,
+      const int64_t in_size,
+      const int64_t out_size,
+      const bool align_corners)
+      : index0(out_size),
+        index1(out_size),
+        lambda0(out_size),
+        lambda1(out_size) {
+    for (const auto i : c10::irange(out_size)) {
+      compute_source_index_and_lambda(
+          index0[i],
+          index1[i],
+          lambda0[i],
+          lambda1[i],
+          scale,
+          i,
+          in_size,
+          out_size,
+          align_corners);
+    }
+  }
+};
+
+// Bilinear interpolation is computed in float, except for double which keeps
+// its precision. This matches the promotion of CTYPE * float in the portable
+// kernel.
+template <typename CTYPE>
+using opmath_t =
+    std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+
+// out[i] = a[i] * wa + b[i] * wb, vectorized when no conversion is needed.
+template <typename CTYPE, typename MATH_T>
+void blend(
+    const MATH_T* a,
+    const MATH_T* b,
+    const MATH_T wa,
+    const MATH_T wb,
+    CTYPE* out,
+    const int64_t size) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, MATH_T>) {
+    using Vec = at::vec::Vectorized<MATH_T>;
+    const Vec wa_vec(wa);
+    const Vec wb_vec(wb);
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      const Vec result =
+          Vec::loadu(a + i) * wa_vec + Vec::loadu(b + i) * wb_vec;
+      result.store(out + i);
+    }
+  }
+  for (; i < size; ++i) {
+    out[i] = static_cast<CTYPE>(a[i] * wa + b[i] * wb);
+  }
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_kernel_impl_nchw(
+    const Tensor& in,
+    const InterpolationTable& table_h,
+    const InterpolationTable& table_w,
+    Tensor& out) {
+  using MATH_T = opmath_t<CTYPE>;
+
+  const auto in_data = in.const_data_ptr<CTYPE>();
+  const auto out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t num_planes = out.size(0) * out.size(1);
+
+  const int64_t plane_size = out_h * out_w;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, plane_size));
+
+  ::executorch::extension::parallel_for(
+      0, num_planes, grain_size, [&](const auto begin, const auto end) {
+        // The interpolation is separable: each output row blends two input
+        // rows that were first interpolated along the width. Consecutive
+        // output rows usually share their input rows, so the horizontally
+        // interpolated rows are cached and only recomputed when the source
+        // rows change.
+        std::vector<MATH_T> row_buffer(2 * out_w);
+        MATH_T* row0 = row_buffer.data();
+        MATH_T* row1 = row0 + out_w;
+
+        const auto interpolate_row = [&](const CTYPE* in_row, MATH_T* dst) {
+          for (const auto w : c10::irange(out_w)) {
+            dst[w] =
+                in_row[table_w.index0[w]] * table_w.lambda0[w] +
+                in_row[table_w.index1[w]] * table_w.lambda1[w];
+          }
+        };
+
+        for (const auto plane : c10::irange(begin, end)) {
+          const CTYPE* const in_plane = in_data + plane * in_h * in_w;
+          CTYPE* const out_plane = out_data + plane * plane_size;
+
+          int64_t cached0 = -1;
+          int64_t cached1 = -1;
+          for (const auto h : c10::irange(out_h)) {
+            const int64_t src0 = table_h.index0[h];
+            const int64_t src1 = table_h.index1[h];
+            if (src0 == cached1 && src0 != cached0) {
+              std::swap(row0, row1);
+              std::swap(cached0, cached1);
+            }
+            if (src0 != cached0) {
+              interpolate_row(in_plane + src0 * in_w, row0);
+              cached0 = src0;
+            }
+            if (src1 != cached1) {
+              interpolate_row(in_plane + src1 * in_w, row1);
+              cached1 = src1;
+            }
+
+            blend<CTYPE, MATH_T>(
+                row0,
+                row1,
+                table_h.lambda0[h],
+                table_h.lambda1[h],
+                out_plane + h * out_w,
+                out_w);
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_kernel_impl_nhwc(
+    const Tensor& in,
+    const InterpolationTable& table_h,
+    const InterpolationTable& table_w,
+    Tensor& out) {
+  using MATH_T = opmath_t<CTYPE>;
+
+  const auto in_data = in.const_data_ptr<CTYPE>();
+  const auto out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t channels = out.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t num_rows = out.size(0) * out_h;
+
+  const int64_t row_size = out_w * channels;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, row_size));
+
+  ::executorch::extension::parallel_for(
+      0, num_rows, grain_size, [&](const auto begin, const auto end) {
+        // Channels are innermost, so each output pixel blends four
+        // contiguous input pixels and the blend is vectorized over channels.
+        std::vector<MATH_T> pixel_buffer(2 * channels);
+        MATH_T* const top = pixel_buffer.data();
+        MATH_T* const bottom = top + channels;
+
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t n = row / out_h;
+          const int64_t h = row % out_h;
+          const CTYPE* const in_image = in_data + n * in_h * in_w * channels;
+          const CTYPE* const in_row0 =
+              in_image + table_h.index0[h] * in_w * channels;
+          const CTYPE* const in_row1 =
+              in_image + table_h.index1[h] * in_w * channels;
+          CTYPE* const out_row = out_data + row * row_size;
+
+          for (const auto w : c10::irange(out_w)) {
+            const int64_t offset0 = table_w.index0[w] * channels;
+            const int64_t offset1 = table_w.index1[w] * channels;
+            const MATH_T lambda0 = table_w.lambda0[w];
+            const MATH_T lambda1 = table_w.lambda1[w];
+            for (const auto c : c10::irange(channels)) {
+              top[c] = in_row0[offset0 + c] * lambda0 +
+                  in_row0[offset1 + c] * lambda1;
+              bottom[c] = in_row1[offset0 + c] * lambda0 +
+                  in_row1[offset1 + c] * lambda1;
+            }
+            blend<CTYPE, MATH_T>(
+                top,
+                bottom,
+                table_h.lambda0[h],
+                table_h.lambda1[h],
+                out_row + w * channels,
+                channels);
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_kernel_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    bool align_corners,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const InterpolationTable table_h(
+      scale_h, in.size(2), out.size(2), align_corners);
+  const InterpolationTable table_w(
+      scale_w, in.size(3), out.size(3), align_corners);
+
+  if (is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size())) {
+    upsample_bilinear2d_kernel_impl_nchw<CTYPE>(in, table_h, table_w, out);
+  } else if (is_channels_last_dim_order(
+                 in.dim_order().data(), in.dim_order().size())) {
+    upsample_bilinear2d_kernel_impl_nhwc<CTYPE>(in, table_h, table_w, out);
+  } else {
+    // Shouldn't be reachable because of args checks, but just in case.
+    ET_LOG(Error, "Unsupported dim order");
+    ctx.fail(Error::InvalidArgument);
+  }
+}
+} // namespace
+
+// Signatures are auto-generated, so disable pass-by-value lint.
+// NOLINTBEGIN(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+Tensor& opt_upsample_bilinear2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  // Preconditions (checked in check_..._args):
+  //  In and out tensors have same dtype.
+  //  In and out tensors are rank 4 and have same dim[0] and dim[1].
+  //  In and out tensors are NHWC or NCHW dim order.
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_bilinear2d_args(
+          in, output_size, align_corners, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const auto kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], align_corners, scale_h);
+  const auto kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], align_corners, scale_w);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.out", CTYPE, [&]() {
+        upsample_bilinear2d_kernel_impl<CTYPE>(
+            ctx, in, align_corners, kernel_scale_h, kernel_scale_w, out);
+      });
+
+  return out;
+}
+// NOLINTEND(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+// Source row/column for every output row/column. These only depend on the
+// sizes, so they are computed once per call instead of once per pixel.
+std::vector<int64_t> compute_source_indices(
+    const float scale,
+    const int64_t in_size,
+    const int64_t out_size) {
+  std::vector<int64_t> indices(out_size);
+  for (const auto i : c10::irange(out_size)) {
+    indices[i] = nearest_neighbor_compute_source_index(scale, i, in_size);
+  }
+  return indices;
+}
+
+template <typename CTYPE>
+void upsample_nearest2d_kernel_impl_nchw(
+    const Tensor& in,
+    const std::vector<int64_t>& in_h_idx,
+    const std::vector<int64_t>& in_w_idx,
+    Tensor& out) {
+  const auto in_data = in.const_data_ptr<CTYPE>();
+  const auto out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t num_planes = out.size(0) * out.size(1);
+
+  const int64_t plane_size = out_h * out_w;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, plane_size));
+
+  ::executorch::extension::parallel_for(
+      0, num_planes, grain_size, [&](const auto begin, const auto end) {
+        for (const auto plane : c10::irange(begin, end)) {
+          const CTYPE* const in_plane = in_data + plane * in_h * in_w;
+          CTYPE* const out_plane = out_data + plane * plane_size;
+          for (const auto h : c10::irange(out_h)) {
+            CTYPE* const out_row = out_plane + h * out_w;
+            // Integer upscales map consecutive output rows to the same input
+            // row; copy the row that was already gathered.
+            if (h > 0 && in_h_idx[h] == in_h_idx[h - 1]) {
+              std::memcpy(out_row, out_row - out_w, out_w * sizeof(CTYPE));
+              continue;
+            }
+            const CTYPE* const in_row = in_plane + in_h_idx[h] * in_w;
+            for (const auto w : c10::irange(out_w)) {
+              out_row[w] = in_row[in_w_idx[w]];
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_nearest2d_kernel_impl_nhwc(
+    const Tensor& in,
+    const std::vector<int64_t>& in_h_idx,
+    const std::vector<int64_t>& in_w_idx,
+    Tensor& out) {
+  const auto in_data = in.const_data_ptr<CTYPE>();
+  const auto out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t channels = out.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t num_rows = out.size(0) * out_h;
+
+  // Every output pixel is a contiguous run of `channels` elements copied from
+  // a single input pixel.
+  const int64_t row_size = out_w * channels;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, row_size));
+
+  ::executorch::extension::parallel_for(
+      0, num_rows, grain_size, [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t n = row / out_h;
+          const int64_t h = row % out_h;
+          CTYPE* const out_row = out_data + row * row_size;
+          if (row > begin && h > 0 && in_h_idx[h] == in_h_idx[h - 1]) {
+            std::memcpy(out_row, out_row - row_size, row_size * sizeof(CTYPE));
+            continue;
+          }
+          const CTYPE* const in_row =
+              in_data + (n * in_h + in_h_idx[h]) * in_w * channels;
+          for (const auto w : c10::irange(out_w)) {
+            std::memcpy(
+                out_row + w * channels,
+                in_row + in_w_idx[w] * channels,
+                channels * sizeof(CTYPE));
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_nearest2d_kernel_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const auto in_h_idx =
+      compute_source_indices(scale_h, in.size(2), out.size(2));
+  const auto in_w_idx =
+      compute_source_indices(scale_w, in.size(3), out.size(3));
+
+  if (is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size())) {
+    upsample_nearest2d_kernel_impl_nchw<CTYPE>(in, in_h_idx, in_w_idx, out);
+  } else if (is_channels_last_dim_order(
+                 in.dim_order().data(), in.dim_order().size())) {
+    upsample_nearest2d_kernel_impl_nhwc<CTYPE>(in, in_h_idx, in_w_idx, out);
+  } else {
+    // Shouldn't be reachable because of args checks, but just in case.
+    ET_LOG(Error, "Unsupported dim order");
+    ctx.fail(Error::InvalidArgument);
+  }
+}
+} // namespace
+
+Tensor& opt_upsample_nearest2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  // Preconditions (checked in check_..._args):
+  //  In and out tensors have same dtype.
+  //  In and out tensors are rank 4 and have same dim[0] and dim[1].
+  //  In and out tensors are NHWC or NCHW dim order.
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_nearest2d_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const auto kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], false, scale_h);
+  const auto kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], false, scale_w);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.out", CTYPE, [&]() {
+        upsample_nearest2d_kernel_impl<CTYPE>(
+            ctx, in, kernel_scale_h, kernel_scale_w, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Shared helpers for the optimized 2D pooling kernels. The kernels walk the
+// input one pooling window row/column at a time instead of recomputing a
+// linear index for every element, and use these helpers to find which output
+// columns a given window offset contributes to.
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+struct Pool2dParams {
+  int64_t batch;
+  int64_t channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+};
+
+/**
+ * Collects the sizes and window parameters of a 3-D {C, H, W} or 4-D
+ * {N, C, H, W} pooling op, using the same defaults as
+ * kernel_reduction_then_map_2d().
+ */
+inline Pool2dParams make_pool2d_params(
+    const executorch::aten::Tensor& in,
+    const executorch::aten::Tensor& out,
+    const executorch::aten::ArrayRef<int64_t> kernel_size,
+    const executorch::aten::ArrayRef<int64_t> stride,
+    const executorch::aten::ArrayRef<int64_t> padding,
+    const executorch::aten::ArrayRef<int64_t> dilation) {
+  const auto dim = in.dim();
+  Pool2dParams params{};
+  params.batch = dim == 4 ? in.size(0) : 1;
+  params.channels = in.size(dim - 3);
+  params.in_h = in.size(dim - 2);
+  params.in_w = in.size(dim - 1);
+  params.out_h = out.size(dim - 2);
+  params.out_w = out.size(dim - 1);
+  params.kernel_h = val_at(kernel_size, 0);
+  params.kernel_w = val_at(kernel_size, 1);
+  params.stride_h = val_at(stride, 0, /*default_value=*/params.kernel_h);
+  params.stride_w = val_at(stride, 1, /*default_value=*/params.kernel_w);
+  params.pad_h = val_at(padding, 0, /*default_value=*/0);
+  params.pad_w = val_at(padding, 1, /*default_value=*/0);
+  params.dilation_h = val_at(dilation, 0, /*default_value=*/1);
+  params.dilation_w = val_at(dilation, 1, /*default_value=*/1);
+  return params;
+}
+
+/**
+ * Returns true if the input is a 4-D channels last tensor. 3-D inputs are
+ * always treated as contiguous {C, H, W}.
+ */
+inline bool pool2d_is_channels_last(const executorch::aten::Tensor& in) {
+  return is_channels_last_dim_order(
+      in.dim_order().data(), in.dim_order().size());
+}
+
+/**
+ * Bounds of the undilated pooling window for output position `out_index`
+ * along one spatial dim. `padded_size` is the size of the window clipped to
+ * the padded input, which is the divisor used when padding is counted;
+ * [start, end) is the window clipped to the input itself.
+ */
+struct PoolWindow {
+  int64_t start;
+  int64_t end;
+  int64_t padded_size;
+};
+
+inline PoolWindow pool_window(
+    const int64_t out_index,
+    const int64_t kernel,
+    const int64_t stride,
+    const int64_t pad,
+    const int64_t in_size) {
+  int64_t start = out_index * stride - pad;
+  int64_t end = std::min(start + kernel, in_size + pad);
+  const int64_t padded_size = end - start;
+  start = std::max<int64_t>(start, 0);
+  end = std::min(end, in_size);
+  return {start, end, padded_size};
+}
+
+/**
+ * For a fixed kernel tap at input offset `offset` (i.e. input index
+ * out_index * stride + offset), returns the half-open range of output indices
+ * whose tap lands inside [0, in_size). Iterating over this range touches
+ * consecutive input elements when stride is 1, which lets the inner loops run
+ * over contiguous memory.
+ */
+inline std::pair<int64_t, int64_t> pool_valid_output_range(
+    const int64_t offset,
+    const int64_t stride,
+    const int64_t in_size,
+    const int64_t out_size) {
+  const int64_t begin = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+  const int64_t last_in = in_size - 1 - offset;
+  const int64_t end =
+      last_in < 0 ? 0 : std::min(out_size, last_in / stride + 1);
+  return {std::min(begin, end), end};
+}
+
+/**
+ * Grain size for parallel_for over pooling planes or rows, given the number
+ * of input elements read per unit of work.
+ */
+inline int64_t pool2d_grain_size(const int64_t work_per_unit) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, work_per_unit));
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -76,6 +76,19 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "pool2d_utils",
+        srcs = [],
+        exported_headers = ["pool2d_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS",],
+        exported_deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/extension/threadpool:threadpool",
+        ],
+    )
+
     # Used for dtype selective build. Collect source and header files.
     runtime.filegroup(
         name = "optimized_source_files",
@@ -14,7 +14,7 @@ namespace torch {
 namespace executor {
 namespace native {
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(acosh_out, std::acosh)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(acosh_out, "acosh.out", std::acosh)
 
 } // namespace native
 } // namespace executor
@@ -14,7 +14,7 @@ namespace torch {
 namespace executor {
 namespace native {
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(asinh_out, std::asinh)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(asinh_out, "asinh.out", std::asinh)
 
 } // namespace native
 } // namespace executor
@@ -14,7 +14,7 @@ namespace torch {
 namespace executor {
 namespace native {
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(atanh_out, std::atanh)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(atanh_out, "atanh.out", std::atanh)
 
 } // namespace native
 } // namespace executor
@@ -6,8 +6,6 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <cstring>
-
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -53,15 +51,13 @@ Tensor& cat_out(
 
   const size_t outer = getLeadingDims(out, dim);
   const size_t dim_stride = getTrailingDims(out, dim);
+  const size_t out_row = out.size(dim) * dim_stride;
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
   const bool out_is_complex =
       executorch::runtime::isComplexType(out.scalar_type());
 
-  // @lint-ignore CLANGTIDY facebook-hte-CArray
-  static constexpr const char op_name[] = "cat.out";
-
   if (out_is_complex) {
     // TODO: The current support for complex dtype enforces that input and
     // output tensors have the same dtype. Support mixed dtypes in the future.
@@ -69,47 +65,55 @@ Tensor& cat_out(
       const auto in_type = tensors[i].scalar_type();
       ET_KERNEL_CHECK(ctx, out_type == in_type, InvalidArgument, out);
     }
-    ET_SWITCH_COMPLEXH_TYPES(out_type, ctx, op_name, CTYPE, [&] {
-      CTYPE* out_ptr = out.mutable_data_ptr<CTYPE>();
-      for (size_t i = 0; i < outer; ++i) {
-        for (size_t j = 0; j < ninputs; ++j) {
-          if (tensors[j].numel() == 0) {
-            return;
-          }
-          size_t inner = tensors[j].size(dim) * dim_stride;
-          const CTYPE* const in_ptr =
-              tensors[j].const_data_ptr<CTYPE>() + i * inner;
-          memcpy(out_ptr, in_ptr, inner * sizeof(CTYPE));
-          out_ptr += inner;
-        }
-      }
-    });
-  } else {
-    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE_OUT, [&] {
-      CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
-      for (size_t i = 0; i < outer; ++i) {
-        for (size_t j = 0; j < ninputs; ++j) {
-          const auto in_type = tensors[j].scalar_type();
-          ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, op_name, CTYPE_IN, [&] {
-            if (tensors[j].numel() == 0) {
-              return;
-            }
-            size_t inner = tensors[j].size(dim) * dim_stride;
-            const CTYPE_IN* const in_ptr =
-                tensors[j].const_data_ptr<CTYPE_IN>() + i * inner;
+  }
 
-            if (sizeof(CTYPE_IN) == sizeof(CTYPE_OUT)) {
-              memcpy(out_ptr, in_ptr, inner * sizeof(CTYPE_IN));
-            } else {
-              for (size_t k = 0; k < inner; ++k) {
-                out_ptr[k] = static_cast<CTYPE_OUT>(in_ptr[k]);
-              }
-            }
-            out_ptr += inner;
-          });
-        }
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "cat.out";
+
+  // Each input is copied into a column of `outer` rows of the output.
+  const size_t out_element_size = out.element_size();
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+  size_t offset = 0;
+  for (size_t j = 0; j < ninputs; ++j) {
+    if (tensors[j].numel() == 0) {
+      continue;
+    }
+    const size_t inner = tensors[j].size(dim) * dim_stride;
+    const auto in_type = tensors[j].scalar_type();
+    if (in_type == out_type) {
+      // Same dtype: a byte copy, once the dtype is known to be supported.
+      const auto copy = [&] {
+        copy_rows(
+            out_data + offset * out_element_size,
+            out_row * out_element_size,
+            tensors[j].const_data_ptr(),
+            inner * out_element_size,
+            inner * out_element_size,
+            outer);
+      };
+      if (out_is_complex) {
+        ET_SWITCH_COMPLEXH_TYPES(
+            out_type, ctx, op_name, CTYPE, [&] { copy(); });
+      } else {
+        ET_SWITCH_REALHBBF16_TYPES(
+            out_type, ctx, op_name, CTYPE, [&] { copy(); });
       }
-    });
+    } else {
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE_OUT, [&] {
+        ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, op_name, CTYPE_IN, [&] {
+          const CTYPE_IN* const in_ptr = tensors[j].const_data_ptr<CTYPE_IN>();
+          CTYPE_OUT* const out_ptr =
+              out.mutable_data_ptr<CTYPE_OUT>() + offset;
+          for (size_t i = 0; i < outer; ++i) {
+            for (size_t k = 0; k < inner; ++k) {
+              out_ptr[i * out_row + k] =
+                  static_cast<CTYPE_OUT>(in_ptr[i * inner + k]);
+            }
+          }
+        });
+      });
+    }
+    offset += inner;
   }
 
   return out;
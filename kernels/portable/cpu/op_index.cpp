@@ -13,6 +13,7 @@
 
 #include <executorch/kernels/portable/cpu/util/advanced_index_util.h>
 #include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/gather_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -157,28 +158,25 @@ Tensor& fast_path(
     return out;
   }
 
-  size_t in_dim_length = in.size(dim);
-  size_t out_dim_length = out.size(dim);
-
-  size_t length_per_step = trailing_dims * in.element_size();
-
-  const char* in_data = in.const_data_ptr<char>();
-  char* out_data = out.mutable_data_ptr<char>();
+  const size_t in_dim_length = in.size(dim);
+  const size_t out_dim_length = out.size(dim);
+  const size_t length_per_step = trailing_dims * in.element_size();
 
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "index.Tensor_out";
 
+  // Same access pattern as index_select: the index values were validated by
+  // check_fast_path_args(), so the rows can be gathered in parallel.
   ET_SWITCH_TWO_TYPES(Long, Int, index_type, ctx, op_name, CTYPE, [&]() {
-    const CTYPE* const index_arr = index.const_data_ptr<CTYPE>();
-    for (const auto i : c10::irange(leading_dims)) {
-      const char* src = in_data + i * in_dim_length * length_per_step;
-      char* dest = out_data + i * out_dim_length * length_per_step;
-      for (const auto j : c10::irange(out_dim_length)) {
-        const char* copy_src = src + index_arr[j] * length_per_step;
-        char* copy_dest = dest + j * length_per_step;
-        memcpy(copy_dest, copy_src, length_per_step);
-      }
-    }
+    gather_rows(
+        out.mutable_data_ptr<char>(),
+        out_dim_length * length_per_step,
+        in.const_data_ptr<char>(),
+        in_dim_length * length_per_step,
+        index.const_data_ptr<CTYPE>(),
+        out_dim_length,
+        length_per_step,
+        leading_dims);
   });
 
   return out;
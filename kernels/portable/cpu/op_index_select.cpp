@@ -6,11 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <c10/util/irange.h>
-#include <cinttypes>
-#include <cstdint>
 #include <cstring>
 
+#include <executorch/kernels/portable/cpu/util/gather_util.h>
 #include <executorch/kernels/portable/cpu/util/index_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -26,6 +24,8 @@ Tensor& index_select_out(
     int64_t dim,
     const Tensor& index,
     Tensor& out) {
+  // Also validates that every index value is in range, which gather_rows()
+  // relies on.
   ET_KERNEL_CHECK(
       ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
 
@@ -54,35 +54,33 @@ Tensor& index_select_out(
     return out;
   }
 
-  size_t leading_dims = getLeadingDims(in, dim);
-  size_t trailing_dims = getTrailingDims(in, dim);
+  const size_t leading_dims = getLeadingDims(in, dim);
+  const size_t trailing_dims = getTrailingDims(in, dim);
 
   if (leading_dims == 0 || trailing_dims == 0) {
     return out;
   }
 
-  size_t out_dim_length = out.size(dim);
-  size_t in_dim_length = in.size(dim);
-
-  size_t length_per_step = trailing_dims * in.element_size();
-
-  const char* input_data = in.const_data_ptr<char>();
-  char* out_data = out.mutable_data_ptr<char>();
+  // Each leading index selects rows of `trailing_dims` contiguous elements
+  // from its own block of the input. Selecting along the outermost dim is a
+  // single block, i.e. an embedding lookup.
+  const size_t out_dim_length = out.size(dim);
+  const size_t in_dim_length = in.size(dim);
+  const size_t length_per_step = trailing_dims * in.element_size();
 
   ScalarType ix_type = index.scalar_type();
 
   ET_SWITCH_TWO_TYPES(
       Long, Int, ix_type, ctx, "index_select.out", CTYPE, [&]() {
-        const CTYPE* const index_arr = index.mutable_data_ptr<CTYPE>();
-        for (const auto i : c10::irange(leading_dims)) {
-          const char* src = input_data + i * in_dim_length * length_per_step;
-          char* dest = out_data + i * out_dim_length * length_per_step;
-          for (const auto j : c10::irange(out_dim_length)) {
-            const char* copy_src = src + index_arr[j] * length_per_step;
-            memcpy(dest, copy_src, length_per_step);
-            dest += length_per_step;
-          }
-        }
+        gather_rows(
+            out.mutable_data_ptr<char>(),
+            out_dim_length * length_per_step,
+            in.const_data_ptr<char>(),
+            in_dim_length * length_per_step,
+            index.const_data_ptr<CTYPE>(),
+            out_dim_length,
+            length_per_step,
+            leading_dims);
       });
 
   return out;
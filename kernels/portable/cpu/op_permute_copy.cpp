@@ -6,37 +6,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <c10/util/irange.h>
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/permute_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
 namespace executor {
 namespace native {
 
-using SizesType = executorch::aten::SizesType;
 using Tensor = executorch::aten::Tensor;
 using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
 
-namespace {
-
-void increment_coordinate_permuted(
-    const Tensor& tensor,
-    size_t* const coordinate,
-    IntArrayRef dims) {
-  for (int i = dims.size() - 1; i >= 0; i--) {
-    size_t d = dims[i] >= 0 ? dims[i] : dims[i] + tensor.dim();
-    coordinate[d]++;
-    if (static_cast<ssize_t>(coordinate[d]) == tensor.size(d)) {
-      coordinate[d] = 0;
-    } else {
-      return;
-    }
-  }
-}
-
-} // namespace
-
 Tensor& permute_copy_out(
     KernelRuntimeContext& ctx,
     const Tensor& in,
@@ -60,24 +40,11 @@ Tensor& permute_copy_out(
       InvalidArgument,
       out);
 
-  const auto in_type = out.scalar_type();
-
-  size_t in_coord[kTensorDimensionLimit] = {0};
-  size_t trailing_dims_memo[kTensorDimensionLimit];
-  executorch::runtime::memoizeTrailingDims(in, trailing_dims_memo);
-
   // in and out must be the same dtype
-  ET_SWITCH_ALL_TYPES(in_type, ctx, "permute_copy.out", CTYPE, [&] {
-    const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
-    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  ET_KERNEL_CHECK(
+      ctx, is_strided_copy_dtype(in.scalar_type()), InvalidArgument, out);
 
-    for (const auto i : c10::irange(out.numel())) {
-      out_data[i] =
-          in_data[executorch::runtime::coordinateToIndexWithTrailingDimsMemo(
-              in, in_coord, trailing_dims_memo)];
-      increment_coordinate_permuted(in, in_coord, dims);
-    }
-  });
+  permute_tensor_data(in, dims, out);
 
   return out;
 }
@@ -16,12 +16,15 @@ namespace {
 
 template <typename T>
 T reciprocal(T x) {
-  return 1.0 / x;
+  return T(1.0f) / x;
 }
 
 } // namespace
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(reciprocal_out, reciprocal)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(
+    reciprocal_out,
+    "reciprocal.out",
+    reciprocal)
 
 } // namespace native
 } // namespace executor
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/kernels/portable/cpu/util/vectorized_math.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -16,12 +17,12 @@ namespace {
 
 template <typename T>
 T rsqrt(T x) {
-  return 1.0 / std::sqrt(x);
+  return T(1.0f) / executorch::math::sqrt(x);
 }
 
 } // namespace
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(rsqrt_out, rsqrt)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(rsqrt_out, "rsqrt.out", rsqrt)
 
 } // namespace native
 } // namespace executor
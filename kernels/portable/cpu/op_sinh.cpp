@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/kernels/portable/cpu/util/vectorized_math.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <cmath>
 
@@ -14,7 +15,10 @@ namespace torch {
 namespace executor {
 namespace native {
 
-DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(sinh_out, std::sinh)
+DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(
+    sinh_out,
+    "sinh.out",
+    executorch::math::sinh)
 
 } // namespace native
 } // namespace executor
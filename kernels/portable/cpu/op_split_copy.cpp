@@ -68,14 +68,24 @@ void split_copy_Tensor_out(
                 if (out_step == 0) {
                   continue;
                 }
-                const CTYPE_IN* src = input_data;
                 CTYPE_OUT* dest = out[i].mutable_data_ptr<CTYPE_OUT>();
-                for (size_t j = 0; j < leading_dims; ++j) {
-                  for (size_t k = 0; k < out_step; ++k) {
-                    dest[k] = convert<CTYPE_OUT, CTYPE_IN>(src[k]);
+                if constexpr (std::is_same_v<CTYPE_IN, CTYPE_OUT>) {
+                  copy_rows(
+                      dest,
+                      out_step * sizeof(CTYPE_OUT),
+                      input_data,
+                      step * sizeof(CTYPE_IN),
+                      out_step * sizeof(CTYPE_IN),
+                      leading_dims);
+                } else {
+                  const CTYPE_IN* src = input_data;
+                  for (size_t j = 0; j < leading_dims; ++j) {
+                    for (size_t k = 0; k < out_step; ++k) {
+                      dest[k] = convert<CTYPE_OUT, CTYPE_IN>(src[k]);
+                    }
+                    src += step;
+                    dest += out_step;
                   }
-                  src += step;
-                  dest += out_step;
                 }
                 input_data += out_step;
               }
@@ -101,13 +101,23 @@ void split_with_sizes_copy_out(
 
         // Simpler logic if there's no broadcasting
         if (!is_broadcasted) {
-          const CTYPE_IN* src = in_data;
-          for ([[maybe_unused]] const auto j : c10::irange(leading_dims)) {
-            for (const auto k : c10::irange(chunk_step)) {
-              out_data[k] = convert<CTYPE_OUT, CTYPE_IN>(src[k]);
+          if constexpr (std::is_same_v<CTYPE_IN, CTYPE_OUT>) {
+            copy_rows(
+                out_data,
+                chunk_step * sizeof(CTYPE_OUT),
+                in_data,
+                step * sizeof(CTYPE_IN),
+                chunk_step * sizeof(CTYPE_IN),
+                leading_dims);
+          } else {
+            const CTYPE_IN* src = in_data;
+            for ([[maybe_unused]] const auto j : c10::irange(leading_dims)) {
+              for (const auto k : c10::irange(chunk_step)) {
+                out_data[k] = convert<CTYPE_OUT, CTYPE_IN>(src[k]);
+              }
+              src += step;
+              out_data += chunk_step;
             }
-            src += step;
-            out_data += chunk_step;
           }
         } else { // Otherwise, we need to do a copy with broadcasting
           // Compute target strides
@@ -63,9 +63,9 @@ Tensor& t_copy_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
       InvalidArgument,
       out);
 
-  ET_SWITCH_ALL_TYPES(in_type, ctx, __func__, CTYPE, [&] {
-    transpose_tensors<CTYPE>(in, 1, 0, out);
-  });
+  ET_KERNEL_CHECK(ctx, is_strided_copy_dtype(in_type), InvalidArgument, out);
+
+  transpose_tensors(in, 1, 0, out);
 
   return out;
 }
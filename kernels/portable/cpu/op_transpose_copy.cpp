@@ -60,9 +60,10 @@ Tensor& transpose_copy_int_out(
   ET_KERNEL_CHECK(
       ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
 
-  ET_SWITCH_ALL_TYPES(in.scalar_type(), ctx, __func__, CTYPE, [&] {
-    transpose_tensors<CTYPE>(in, dim0, dim1, out);
-  });
+  ET_KERNEL_CHECK(
+      ctx, is_strided_copy_dtype(in.scalar_type()), InvalidArgument, out);
+
+  transpose_tensors(in, dim0, dim1, out);
 
   return out;
 }
@@ -64,6 +64,16 @@ void unbind_copy_int_out(
               for (size_t i = 0, e = out.size(); i < e; ++i) {
                 size_t input_offset = i * trailing_dims;
                 CTYPE_OUT* const dest = out[i].mutable_data_ptr<CTYPE_OUT>();
+                if constexpr (std::is_same_v<CTYPE_IN, CTYPE_OUT>) {
+                  copy_rows(
+                      dest,
+                      trailing_dims * sizeof(CTYPE_OUT),
+                      input_data + input_offset,
+                      step * sizeof(CTYPE_IN),
+                      trailing_dims * sizeof(CTYPE_IN),
+                      leading_dims);
+                  continue;
+                }
                 size_t dest_offset = 0;
                 for ([[maybe_unused]] const auto j :
                      c10::irange(leading_dims)) {
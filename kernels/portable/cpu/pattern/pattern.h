@@ -46,6 +46,7 @@ question is a bit more specific, then add a descriptive sufix. */
 
 #pragma once
 
+#include <executorch/kernels/portable/cpu/util/elementwise_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -102,10 +103,67 @@ Tensor& unary_ufunc_realhbbf16_to_floathbf16(
     const Tensor& in,
     Tensor& out);
 
-#define DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(op_name, fn)              \
+/**
+ * Same as above, but fn is a generic callable that is applied to values of
+ * the compute type (float, or double for Double inputs). If fn can also be
+ * called with at::vec::Vectorized values of the compute type (see [NOTE:
+ * Generic lambdas] in elementwise_util.h), contiguous Float and Double inputs
+ * are processed a vector at a time. Large inputs are split across threads.
+ *
+ * op_name is the name of the operator, e.g. "exp.out", and is used for dtype
+ * selective build.
+ */
+template <const char* op_name, typename Op>
+Tensor& unary_ufunc_realhbbf16_to_floathbf16(
+    const Op& fn,
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    Tensor& out) {
+  ET_KERNEL_CHECK(ctx, tensor_is_floating_type(out), InvalidArgument, out);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // Half and BFloat16 are computed in float.
+  ScalarType compute_type =
+      executorch::runtime::isFloatingType(in.scalar_type()) ? in.scalar_type()
+                                                            : ScalarType::Float;
+  compute_type = utils::get_compute_type(compute_type);
+
+  ET_SWITCH_FLOAT_TYPES(compute_type, ctx, op_name, CTYPE_COMPUTE, [&]() {
+    utils::apply_unitensor_elementwise_fn<
+        CTYPE_COMPUTE,
+        op_name,
+        utils::SupportedTensorDtypes::FLOATHBF16>(
+        fn, ctx, in, utils::SupportedTensorDtypes::REALHBBF16, out);
+  });
+
+  return out;
+}
+
+/**
+ * Defines op_name using the templated pattern above. fn must name a function
+ * or function template that accepts float and double, such as std::exp or
+ * executorch::math::exp. Overloads of fn that accept at::vec::Vectorized
+ * (which executorch::math provides for most float math functions) enable the
+ * vectorized path; other functions are applied one element at a time.
+ */
+#define DEFINE_UNARY_UFUNC_REALHBBF16_TO_FLOATHBF16(op_name, op_name_str, fn) \
   Tensor& op_name(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) { \
-    return internal::unary_ufunc_realhbbf16_to_floathbf16(                    \
-        fn, fn, ctx, in, out);                                                \
+    static constexpr const char kOpName[] = op_name_str;                      \
+    return internal::unary_ufunc_realhbbf16_to_floathbf16<kOpName>(           \
+        [](const auto x) -> decltype(fn(x)) { return fn(x); },                \
+        ctx,                                                                  \
+        in,                                                                   \
+        out);                                                                 \
   }
 
 } // namespace internal
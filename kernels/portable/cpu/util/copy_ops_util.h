@@ -10,6 +10,7 @@
 #include <c10/util/irange.h>
 
 #include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/permute_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -83,21 +84,26 @@ void as_strided_copy(
  */
 template <typename SELF_CTYPE, typename OUT_CTYPE>
 void _to_dim_order_copy_impl(const Tensor& self, Tensor& out) {
-  auto self_data = self.mutable_data_ptr<SELF_CTYPE>();
-  auto out_data = out.mutable_data_ptr<OUT_CTYPE>();
-
-  // Here we make a slightly off-label use of
-  // BroadcastIndexesRange. It always assumes it doesn't have to care
-  // about different dim_order between input and output, but we can
-  // just force it to respect strides (and thus dim_order) for its
-  // inputs using support_noncontiguous_input_tensors=true, and then pretend
-  // the output is just another input.
-  for (const auto [unused_index, self_data_index, out_data_index] :
-       BroadcastIndexesRange<2, /*support_noncontiguous_input_tensors=*/true>(
-           /*dummy output*/ self, self, out)) {
-    (void)unused_index;
-    out_data[out_data_index] =
-        static_cast<OUT_CTYPE>(self_data[self_data_index]);
+  if constexpr (std::is_same_v<SELF_CTYPE, OUT_CTYPE>) {
+    // Without a dtype conversion this is a pure layout change.
+    copy_tensor_data_to_strides(self, out);
+  } else {
+    auto self_data = self.mutable_data_ptr<SELF_CTYPE>();
+    auto out_data = out.mutable_data_ptr<OUT_CTYPE>();
+
+    // Here we make a slightly off-label use of
+    // BroadcastIndexesRange. It always assumes it doesn't have to care
+    // about different dim_order between input and output, but we can
+    // just force it to respect strides (and thus dim_order) for its
+    // inputs using support_noncontiguous_input_tensors=true, and then pretend
+    // the output is just another input.
+    for (const auto [unused_index, self_data_index, out_data_index] :
+         BroadcastIndexesRange<2, /*support_noncontiguous_input_tensors=*/true>(
+             /*dummy output*/ self, self, out)) {
+      (void)unused_index;
+      out_data[out_data_index] =
+          static_cast<OUT_CTYPE>(self_data[self_data_index]);
+    }
   }
 }
 
@@ -22,6 +22,7 @@
 #include <ATen/cpu/vec/vec.h>
 #endif // ET_USE_PYTORCH_HEADERS
 
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -71,6 +72,141 @@ constexpr bool can_use_vectorized() {
 }
 #endif // ET_USE_PYTORCH_HEADERS
 
+/**
+ * A view of the output of an elementwise op as [num_rows, row_size] in which
+ * every input either advances with the output or is broadcast along each of
+ * the two dimensions. This covers the common broadcasts: scalars, rows (e.g. a
+ * bias of shape [C] added to [N, C]), columns (e.g. a per-channel scale of
+ * shape [C, 1] applied to [C, HW]) and broadcasts of all but the last dim.
+ */
+template <size_t kNumInputs>
+struct RowBroadcastPlan {
+  // Number of contiguous output elements per row.
+  ssize_t row_size = 0;
+  // Whether input i reads a different element for each row.
+  std::array<bool, kNumInputs> varies_across_rows{};
+  // Whether input i reads a different element for each column.
+  std::array<bool, kNumInputs> varies_within_row{};
+};
+
+/**
+ * Finds the RowBroadcastPlan with the longest rows for the given contiguous
+ * inputs, or returns false if some input needs a more general broadcast, e.g.
+ * [N, 1, C] to [N, M, C].
+ */
+template <size_t kNumInputs, typename... Args>
+bool plan_row_broadcast(
+    const Tensor& out,
+    RowBroadcastPlan<kNumInputs>& plan,
+    const Args&... inputs) {
+  static_assert(sizeof...(inputs) == kNumInputs);
+  const ssize_t ndim = out.dim();
+  if (out.numel() == 0 || !tensor_is_contiguous(out) ||
+      !((inputs.dim() <= ndim && tensor_is_contiguous(inputs)) && ...)) {
+    return false;
+  }
+  const std::array<const Tensor*, kNumInputs> input_ptrs = {&inputs...};
+  const auto out_sizes = out.sizes();
+  // Size of input i in dim d of the output, with broadcasting's implicit
+  // leading ones.
+  const auto input_size = [&](size_t i, ssize_t d) -> ssize_t {
+    const auto sizes = input_ptrs[i]->sizes();
+    const ssize_t num_leading_ones = ndim - sizes.size();
+    return d < num_leading_ones ? 1 : sizes[d - num_leading_ones];
+  };
+  // Whether input i matches the output in dims [begin, end).
+  const auto matches = [&](size_t i, ssize_t begin, ssize_t end) {
+    for (ssize_t d = begin; d < end; ++d) {
+      if (input_size(i, d) != out_sizes[d]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  // Whether input i is broadcast along all dims [begin, end).
+  const auto all_ones = [&](size_t i, ssize_t begin, ssize_t end) {
+    for (ssize_t d = begin; d < end; ++d) {
+      if (input_size(i, d) != 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (ssize_t split = 0; split <= ndim; ++split) {
+    bool ok = true;
+    for (size_t i = 0; ok && i < kNumInputs; ++i) {
+      const bool ones_in_row = all_ones(i, split, ndim);
+      const bool ones_across_rows = all_ones(i, 0, split);
+      ok = (ones_in_row || matches(i, split, ndim)) &&
+          (ones_across_rows || matches(i, 0, split));
+      plan.varies_within_row[i] = !ones_in_row;
+      plan.varies_across_rows[i] = !ones_across_rows;
+    }
+    if (ok) {
+      plan.row_size = 1;
+      for (ssize_t d = split; d < ndim; ++d) {
+        plan.row_size *= out_sizes[d];
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Applies compute_fun to one row of a RowBroadcastPlan. inputs_data_ptrs
+ * point at the first element of the row of each input.
+ */
+template <
+    typename CTYPE_COMPUTE,
+    typename CTYPE_OUT,
+    bool use_vectorized,
+    typename Op,
+    size_t kNumInputs>
+inline void apply_elementwise_fn_to_row(
+    const Op& compute_fun,
+    const std::array<const CTYPE_COMPUTE*, kNumInputs>& inputs_data_ptrs,
+    const std::array<bool, kNumInputs>& varies_within_row,
+    CTYPE_OUT* data_out,
+    ssize_t n) {
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (use_vectorized) {
+    using Vec = at::vec::Vectorized<CTYPE_COMPUTE>;
+    std::array<Vec, kNumInputs> loaded_vec_inputs{};
+    for (const auto input_idx : c10::irange(kNumInputs)) {
+      if (!varies_within_row[input_idx]) {
+        loaded_vec_inputs[input_idx] = Vec(inputs_data_ptrs[input_idx][0]);
+      }
+    }
+    for (ssize_t idx = 0; idx < n; idx += Vec::size()) {
+      const auto count = std::min<ssize_t>(Vec::size(), n - idx);
+      for (const auto input_idx : c10::irange(kNumInputs)) {
+        if (varies_within_row[input_idx]) {
+          loaded_vec_inputs[input_idx] =
+              Vec::loadu(&inputs_data_ptrs[input_idx][idx], count);
+        }
+      }
+      std::apply(compute_fun, loaded_vec_inputs).store(&data_out[idx], count);
+    }
+    return;
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+
+  std::array<ssize_t, kNumInputs> strides{};
+  for (const auto input_idx : c10::irange(kNumInputs)) {
+    strides[input_idx] = varies_within_row[input_idx] ? 1 : 0;
+  }
+  for (ssize_t idx = 0; idx < n; ++idx) {
+    std::array<CTYPE_COMPUTE, kNumInputs> loaded_inputs{};
+    for (const auto input_idx : c10::irange(kNumInputs)) {
+      loaded_inputs[input_idx] =
+          inputs_data_ptrs[input_idx][idx * strides[input_idx]];
+    }
+    data_out[idx] = std::apply(compute_fun, loaded_inputs);
+  }
+}
+
 template <
     typename CTYPE_COMPUTE,
     typename CTYPE_OUT,
@@ -167,6 +303,56 @@ inline void dtype_specialized_elementwise_fn_impl(
   }
 #endif // ET_USE_PYTORCH_HEADERS
 
+  // Common broadcasts run row by row over the contiguous inner dims, without
+  // computing input indexes for every element.
+  RowBroadcastPlan<kNumInputs> plan;
+  if (!support_noncontiguous_tensors &&
+      plan_row_broadcast(out, plan, (*inputs.first)...)) {
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+    constexpr bool use_vectorized =
+        can_use_vectorized<CTYPE_COMPUTE, Op, Args...>();
+#else // ET_USE_PYTORCH_HEADERS
+    constexpr bool use_vectorized = false;
+#endif // ET_USE_PYTORCH_HEADERS
+    ::executorch::extension::parallel_for(
+        0,
+        out.numel(),
+        ::executorch::extension::internal::GRAIN_SIZE,
+        [&](const auto begin, const auto end) {
+          std::array<const CTYPE_COMPUTE*, kNumInputs> inputs_data_ptrs = {
+              inputs.first->template const_data_ptr<CTYPE_COMPUTE>()...};
+
+          CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
+
+          const ssize_t row_size = plan.row_size;
+          ssize_t row = begin / row_size;
+          ssize_t col = begin % row_size;
+          for (ssize_t idx = begin; idx < end; ++row, col = 0) {
+            const ssize_t n = std::min<ssize_t>(row_size - col, end - idx);
+            std::array<const CTYPE_COMPUTE*, kNumInputs> row_data_ptrs{};
+            for (const auto input_idx : c10::irange(kNumInputs)) {
+              const bool varies_within_row = plan.varies_within_row[input_idx];
+              ssize_t offset = varies_within_row ? col : 0;
+              if (plan.varies_across_rows[input_idx]) {
+                offset += varies_within_row ? row * row_size : row;
+              }
+              row_data_ptrs[input_idx] = inputs_data_ptrs[input_idx] + offset;
+            }
+            apply_elementwise_fn_to_row<
+                CTYPE_COMPUTE,
+                CTYPE_OUT,
+                use_vectorized>(
+                compute_fun,
+                row_data_ptrs,
+                plan.varies_within_row,
+                &data_out[idx],
+                n);
+            idx += n;
+          }
+        });
+    return;
+  }
+
   ::executorch::extension::parallel_for(
       0,
       out.numel(),
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Row gather shared by the embedding and indexing kernels. Index values are
+// expected to be validated by the caller.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/// How many indices ahead of the current one gather_rows() prefetches.
+constexpr int64_t kGatherPrefetchDistance = 8;
+
+/// Upper bound on the bytes of each upcoming row that are prefetched.
+constexpr size_t kGatherPrefetchMaxBytes = 512;
+
+/// Minimum number of bytes copied by each parallel_for work item of
+/// gather_rows().
+constexpr size_t kGatherParallelMinBytes = 64 * 1024;
+
+namespace internal {
+
+inline void prefetch_row(const char* row, size_t nbytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  const size_t prefetch_nbytes = std::min(nbytes, kGatherPrefetchMaxBytes);
+  for (size_t offset = 0; offset < prefetch_nbytes; offset += 64) {
+    __builtin_prefetch(row + offset);
+  }
+#else
+  (void)row;
+  (void)nbytes;
+#endif
+}
+
+// kRowBytes is the row size when it is known at compile time, which turns
+// the memcpy of single elements into a plain load and store; 0 means the
+// size is only known at runtime.
+template <size_t kRowBytes, typename INDEX_T>
+void gather_rows_impl(
+    char* dst,
+    size_t dst_block_nbytes,
+    const char* src,
+    size_t src_block_nbytes,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    size_t row_nbytes,
+    int64_t num_blocks) {
+  const size_t nbytes = kRowBytes != 0 ? kRowBytes : row_nbytes;
+  const int64_t grain_size = std::max<int64_t>(
+      1, kGatherParallelMinBytes / std::max<size_t>(1, nbytes));
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_blocks * num_indices,
+      grain_size,
+      [&](const auto begin, const auto end) {
+        int64_t block = begin / num_indices;
+        int64_t i = begin % num_indices;
+        const char* block_src = src + block * src_block_nbytes;
+        char* out = dst + block * dst_block_nbytes + i * nbytes;
+        for (int64_t item = begin; item < end; ++item) {
+          const int64_t ahead = i + kGatherPrefetchDistance;
+          if (ahead < num_indices) {
+            prefetch_row(block_src + indices[ahead] * nbytes, nbytes);
+          }
+          std::memcpy(out, block_src + indices[i] * nbytes, nbytes);
+          out += nbytes;
+          // Move on to the next block, unless this was the last row of the
+          // range: past the last block the pointers would be out of bounds.
+          if (++i == num_indices && item + 1 < end) {
+            i = 0;
+            ++block;
+            block_src += src_block_nbytes;
+            out = dst + block * dst_block_nbytes;
+          }
+        }
+      });
+}
+
+} // namespace internal
+
+/**
+ * For each of `num_blocks` blocks, copies the rows selected by `indices` from
+ * the block in `src` to consecutive rows of the block in `dst`:
+ *
+ *   dst[b][i] = src[b][indices[i]]   for b < num_blocks, i < num_indices
+ *
+ * where block b starts at byte offset b * src_block_nbytes in `src` and
+ * b * dst_block_nbytes in `dst`, and every row is `row_nbytes` long. This is
+ * the access pattern of embedding (one block) and of index_select along any
+ * dim (one block per leading index).
+ *
+ * Rows are copied in parallel, and the rows a few indices ahead are
+ * prefetched so that random accesses into tables larger than the cache
+ * overlap with the copies. Element-sized rows are copied without calling
+ * memcpy.
+ *
+ * All indices must be in bounds; the destination must not alias the source.
+ */
+template <typename INDEX_T>
+void gather_rows(
+    void* dst,
+    size_t dst_block_nbytes,
+    const void* src,
+    size_t src_block_nbytes,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    size_t row_nbytes,
+    int64_t num_blocks = 1) {
+  if (num_indices == 0 || num_blocks == 0 || row_nbytes == 0) {
+    return;
+  }
+  char* const dst_bytes = static_cast<char*>(dst);
+  const char* const src_bytes = static_cast<const char*>(src);
+  const auto gather = [&](auto row_bytes_constant) {
+    internal::gather_rows_impl<decltype(row_bytes_constant)::value>(
+        dst_bytes,
+        dst_block_nbytes,
+        src_bytes,
+        src_block_nbytes,
+        indices,
+        num_indices,
+        row_nbytes,
+        num_blocks);
+  };
+  switch (row_nbytes) {
+    case 1:
+      gather(std::integral_constant<size_t, 1>());
+      break;
+    case 2:
+      gather(std::integral_constant<size_t, 2>());
+      break;
+    case 4:
+      gather(std::integral_constant<size_t, 4>());
+      break;
+    case 8:
+      gather(std::integral_constant<size_t, 8>());
+      break;
+    default:
+      gather(std::integral_constant<size_t, 0>());
+      break;
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/permute_util.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace {
+
+// Edge of the square tiles, in elements, that the 2D transpose works on. A
+// tile of the largest element type is 8KB for each of the source and the
+// destination, so both stay in L1.
+constexpr int64_t kTileSize = 32;
+
+struct CopyDim {
+  int64_t size;
+  int64_t in_stride;
+  int64_t out_stride;
+};
+
+// Drops size-1 dims, orders the rest from the outermost to the innermost
+// output dim, and merges dims that are contiguous with each other in both
+// layouts. Returns the number of remaining dims.
+size_t simplify_dims(
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* in_strides,
+    const int64_t* out_strides,
+    CopyDim* dims) {
+  size_t n = 0;
+  for (const auto i : c10::irange(ndim)) {
+    if (sizes[i] != 1) {
+      dims[n++] = {sizes[i], in_strides[i], out_strides[i]};
+    }
+  }
+  std::stable_sort(dims, dims + n, [](const CopyDim& a, const CopyDim& b) {
+    return a.out_stride > b.out_stride;
+  });
+  size_t merged = 0;
+  for (const auto i : c10::irange(n)) {
+    if (merged > 0) {
+      CopyDim& outer = dims[merged - 1];
+      const CopyDim& inner = dims[i];
+      if (outer.in_stride == inner.size * inner.in_stride &&
+          outer.out_stride == inner.size * inner.out_stride) {
+        outer = {outer.size * inner.size, inner.in_stride, inner.out_stride};
+        continue;
+      }
+    }
+    dims[merged++] = dims[i];
+  }
+  return merged;
+}
+
+// Walks the coordinates of a set of outer dims in row-major order, tracking
+// the input and output offsets of the current coordinate.
+class OuterIndex {
+ public:
+  OuterIndex(const CopyDim* dims, size_t ndim, int64_t linear_index)
+      : dims_(dims), ndim_(ndim) {
+    for (size_t i = ndim_; i > 0; --i) {
+      const CopyDim& dim = dims_[i - 1];
+      index_[i - 1] = linear_index % dim.size;
+      linear_index /= dim.size;
+      in_offset_ += index_[i - 1] * dim.in_stride;
+      out_offset_ += index_[i - 1] * dim.out_stride;
+    }
+  }
+
+  int64_t in_offset() const {
+    return in_offset_;
+  }
+
+  int64_t out_offset() const {
+    return out_offset_;
+  }
+
+  void next() {
+    for (size_t i = ndim_; i > 0; --i) {
+      const CopyDim& dim = dims_[i - 1];
+      in_offset_ += dim.in_stride;
+      out_offset_ += dim.out_stride;
+      if (++index_[i - 1] < dim.size) {
+        return;
+      }
+      in_offset_ -= dim.size * dim.in_stride;
+      out_offset_ -= dim.size * dim.out_stride;
+      index_[i - 1] = 0;
+    }
+  }
+
+ private:
+  const CopyDim* dims_;
+  size_t ndim_;
+  int64_t index_[kTensorDimensionLimit] = {};
+  int64_t in_offset_ = 0;
+  int64_t out_offset_ = 0;
+};
+
+template <size_t N>
+struct Bytes {
+  uint8_t data[N];
+};
+
+// Element types used to move data of each supported element size.
+template <size_t N>
+struct ElementOfSize {
+  using type = Bytes<N>;
+};
+template <>
+struct ElementOfSize<1> {
+  using type = uint8_t;
+};
+template <>
+struct ElementOfSize<2> {
+  using type = uint16_t;
+};
+template <>
+struct ElementOfSize<4> {
+  using type = uint32_t;
+};
+template <>
+struct ElementOfSize<8> {
+  using type = uint64_t;
+};
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+// Transposes a 4x4 block of 32-bit elements in registers.
+inline void transpose_4x4(
+    const uint32_t* src,
+    int64_t src_stride,
+    uint32_t* dst,
+    int64_t dst_stride) {
+#if defined(__SSE2__)
+  const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i r1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_stride));
+  const __m128i r2 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * src_stride));
+  const __m128i r3 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * src_stride));
+  const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+  const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+  const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+  const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(t0, t1));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst + dst_stride),
+      _mm_unpackhi_epi64(t0, t1));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst + 2 * dst_stride),
+      _mm_unpacklo_epi64(t2, t3));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst + 3 * dst_stride),
+      _mm_unpackhi_epi64(t2, t3));
+#else
+  const uint32x4x2_t t01 =
+      vtrnq_u32(vld1q_u32(src), vld1q_u32(src + src_stride));
+  const uint32x4x2_t t23 = vtrnq_u32(
+      vld1q_u32(src + 2 * src_stride), vld1q_u32(src + 3 * src_stride));
+  vst1q_u32(
+      dst, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+  vst1q_u32(
+      dst + dst_stride,
+      vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+  vst1q_u32(
+      dst + 2 * dst_stride,
+      vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+  vst1q_u32(
+      dst + 3 * dst_stride,
+      vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+#endif
+}
+#endif
+
+// dst[c * dst_stride + r] = src[r * src_stride + c] for a tile of at most
+// kTileSize x kTileSize elements.
+template <typename T>
+void transpose_tile(
+    const T* src,
+    int64_t src_stride,
+    T* dst,
+    int64_t dst_stride,
+    int64_t rows,
+    int64_t cols) {
+  int64_t r_begin = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+  if constexpr (sizeof(T) == 4) {
+    const int64_t rows4 = rows - rows % 4;
+    const int64_t cols4 = cols - cols % 4;
+    for (int64_t r = 0; r < rows4; r += 4) {
+      for (int64_t c = 0; c < cols4; c += 4) {
+        transpose_4x4(
+            reinterpret_cast<const uint32_t*>(src + r * src_stride + c),
+            src_stride,
+            reinterpret_cast<uint32_t*>(dst + c * dst_stride + r),
+            dst_stride);
+      }
+      for (int64_t c = cols4; c < cols; ++c) {
+        for (int64_t rr = r; rr < r + 4; ++rr) {
+          dst[c * dst_stride + rr] = src[rr * src_stride + c];
+        }
+      }
+    }
+    r_begin = rows4;
+  }
+#endif
+  for (int64_t r = r_begin; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+}
+
+// memcpy with non-temporal stores. The caller must issue a store fence
+// before the data is read by another thread.
+void copy_bytes_non_temporal(void* dst, const void* src, size_t nbytes) {
+#if defined(__SSE2__)
+  auto* d = static_cast<char*>(dst);
+  const auto* s = static_cast<const char*>(src);
+  // Streaming stores need 16 byte aligned destinations.
+  const size_t head = std::min<size_t>(
+      (16 - reinterpret_cast<uintptr_t>(d) % 16) % 16, nbytes);
+  std::memcpy(d, s, head);
+  d += head;
+  s += head;
+  nbytes -= head;
+  for (; nbytes >= 64; nbytes -= 64, d += 64, s += 64) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    const __m128i v1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+    const __m128i v2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+    const __m128i v3 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), v0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), v1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), v2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), v3);
+  }
+  std::memcpy(d, s, nbytes);
+#else
+  std::memcpy(dst, src, nbytes);
+#endif
+}
+
+void store_fence() {
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+void copy_bytes(void* dst, const void* src, size_t nbytes, bool non_temporal) {
+  if (non_temporal) {
+    copy_bytes_non_temporal(dst, src, nbytes);
+  } else {
+    std::memcpy(dst, src, nbytes);
+  }
+}
+
+template <typename T>
+void strided_copy_impl(
+    const T* in_data,
+    T* out_data,
+    const CopyDim* dims,
+    size_t ndim) {
+  using ::executorch::extension::parallel_for;
+  using ::executorch::extension::internal::GRAIN_SIZE;
+
+  if (ndim == 0) {
+    out_data[0] = in_data[0];
+    return;
+  }
+  const CopyDim& inner = dims[ndim - 1];
+
+  if (inner.in_stride == 1 && inner.out_stride == 1) {
+    // Rows are contiguous in both layouts.
+    if (ndim <= 2) {
+      const int64_t num_rows = ndim == 2 ? dims[0].size : 1;
+      const int64_t in_row_stride = ndim == 2 ? dims[0].in_stride : 0;
+      const int64_t out_row_stride = ndim == 2 ? dims[0].out_stride : 0;
+      copy_rows(
+          out_data,
+          out_row_stride * sizeof(T),
+          in_data,
+          in_row_stride * sizeof(T),
+          inner.size * sizeof(T),
+          num_rows);
+      return;
+    }
+    int64_t num_rows = 1;
+    for (const auto i : c10::irange(ndim - 1)) {
+      num_rows *= dims[i].size;
+    }
+    const int64_t grain = std::max<int64_t>(GRAIN_SIZE / inner.size, 1);
+    parallel_for(0, num_rows, grain, [&](int64_t begin, int64_t end) {
+      OuterIndex index(dims, ndim - 1, begin);
+      for (int64_t row = begin; row < end; ++row) {
+        std::memcpy(
+            out_data + index.out_offset(),
+            in_data + index.in_offset(),
+            inner.size * sizeof(T));
+        index.next();
+      }
+    });
+    return;
+  }
+
+  // Look for the dim that is contiguous in the input. If the innermost
+  // output dim is contiguous in the output, the two form a 2D transpose.
+  size_t in_contiguous_dim = ndim;
+  for (const auto i : c10::irange(ndim - 1)) {
+    if (dims[i].in_stride == 1) {
+      in_contiguous_dim = i;
+    }
+  }
+  if (inner.out_stride == 1 && in_contiguous_dim < ndim) {
+    const CopyDim& cols_dim = dims[in_contiguous_dim];
+    // The remaining dims are iterated over around the transpose.
+    CopyDim outer_dims[kTensorDimensionLimit];
+    size_t num_outer_dims = 0;
+    int64_t num_outer = 1;
+    for (const auto i : c10::irange(ndim - 1)) {
+      if (i != in_contiguous_dim) {
+        outer_dims[num_outer_dims++] = dims[i];
+        num_outer *= dims[i].size;
+      }
+    }
+    // Each work item transposes a strip of kTileSize input columns.
+    const int64_t num_strips = (cols_dim.size + kTileSize - 1) / kTileSize;
+    const int64_t grain =
+        std::max<int64_t>(GRAIN_SIZE / (kTileSize * inner.size), 1);
+    parallel_for(
+        0, num_outer * num_strips, grain, [&](int64_t begin, int64_t end) {
+          OuterIndex index(outer_dims, num_outer_dims, begin / num_strips);
+          int64_t strip = begin % num_strips;
+          for (int64_t item = begin; item < end; ++item) {
+            const int64_t c = strip * kTileSize;
+            const int64_t cols = std::min(kTileSize, cols_dim.size - c);
+            const T* src = in_data + index.in_offset() + c;
+            T* dst = out_data + index.out_offset() + c * cols_dim.out_stride;
+            for (int64_t r = 0; r < inner.size; r += kTileSize) {
+              transpose_tile(
+                  src + r * inner.in_stride,
+                  inner.in_stride,
+                  dst + r,
+                  cols_dim.out_stride,
+                  std::min(kTileSize, inner.size - r),
+                  cols);
+            }
+            if (++strip == num_strips) {
+              strip = 0;
+              index.next();
+            }
+          }
+        });
+    return;
+  }
+
+  // Generic strided copy along the innermost output dim.
+  int64_t num_rows = 1;
+  for (const auto i : c10::irange(ndim - 1)) {
+    num_rows *= dims[i].size;
+  }
+  const int64_t grain = std::max<int64_t>(GRAIN_SIZE / inner.size, 1);
+  parallel_for(0, num_rows, grain, [&](int64_t begin, int64_t end) {
+    OuterIndex index(dims, ndim - 1, begin);
+    for (int64_t row = begin; row < end; ++row) {
+      const T* src = in_data + index.in_offset();
+      T* dst = out_data + index.out_offset();
+      for (int64_t i = 0; i < inner.size; ++i) {
+        dst[i * inner.out_stride] = src[i * inner.in_stride];
+      }
+      index.next();
+    }
+  });
+}
+
+template <size_t N>
+void strided_copy_of_size(
+    const void* in_data,
+    void* out_data,
+    const CopyDim* dims,
+    size_t ndim) {
+  using T = typename ElementOfSize<N>::type;
+  strided_copy_impl<T>(
+      static_cast<const T*>(in_data), static_cast<T*>(out_data), dims, ndim);
+}
+
+} // namespace
+
+bool is_strided_copy_dtype(executorch::aten::ScalarType type) {
+  if (!executorch::runtime::isValid(type)) {
+    return false;
+  }
+  switch (executorch::runtime::elementSize(type)) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+    case 16:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void strided_copy(
+    const void* in_data,
+    void* out_data,
+    size_t element_size,
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* in_strides,
+    const int64_t* out_strides) {
+  ET_CHECK_MSG(
+      ndim <= kTensorDimensionLimit,
+      "ndim %zu exceeds the dimension limit",
+      ndim);
+  for (const auto i : c10::irange(ndim)) {
+    if (sizes[i] == 0) {
+      return;
+    }
+  }
+  CopyDim dims[kTensorDimensionLimit];
+  const size_t n = simplify_dims(ndim, sizes, in_strides, out_strides, dims);
+  switch (element_size) {
+    case 1:
+      strided_copy_of_size<1>(in_data, out_data, dims, n);
+      break;
+    case 2:
+      strided_copy_of_size<2>(in_data, out_data, dims, n);
+      break;
+    case 4:
+      strided_copy_of_size<4>(in_data, out_data, dims, n);
+      break;
+    case 8:
+      strided_copy_of_size<8>(in_data, out_data, dims, n);
+      break;
+    case 16:
+      strided_copy_of_size<16>(in_data, out_data, dims, n);
+      break;
+    default:
+      ET_CHECK_MSG(false, "Unsupported element size %zu", element_size);
+  }
+}
+
+void copy_rows(
+    void* dst,
+    size_t dst_stride_nbytes,
+    const void* src,
+    size_t src_stride_nbytes,
+    size_t row_nbytes,
+    size_t num_rows) {
+  using ::executorch::extension::parallel_for;
+
+  if (row_nbytes == 0 || num_rows == 0) {
+    return;
+  }
+  if (num_rows == 1 ||
+      (src_stride_nbytes == row_nbytes && dst_stride_nbytes == row_nbytes)) {
+    row_nbytes *= num_rows;
+    num_rows = 1;
+  }
+  const bool non_temporal = row_nbytes * num_rows >= kNonTemporalCopyMinBytes;
+  auto* const dst_bytes = static_cast<char*>(dst);
+  const auto* const src_bytes = static_cast<const char*>(src);
+
+  if (num_rows == 1) {
+    // Split a single block into chunks.
+    const int64_t num_chunks = static_cast<int64_t>(
+        (row_nbytes + kParallelCopyMinBytes - 1) / kParallelCopyMinBytes);
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      const size_t offset = begin * kParallelCopyMinBytes;
+      const size_t nbytes =
+          std::min(end * kParallelCopyMinBytes, row_nbytes) - offset;
+      copy_bytes(dst_bytes + offset, src_bytes + offset, nbytes, non_temporal);
+      if (non_temporal) {
+        store_fence();
+      }
+    });
+    return;
+  }
+
+  const int64_t grain =
+      std::max<int64_t>(kParallelCopyMinBytes / row_nbytes, 1);
+  const int64_t rows = static_cast<int64_t>(num_rows);
+  parallel_for(0, rows, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      copy_bytes(
+          dst_bytes + row * dst_stride_nbytes,
+          src_bytes + row * src_stride_nbytes,
+          row_nbytes,
+          non_temporal);
+    }
+    if (non_temporal) {
+      store_fence();
+    }
+  });
+}
+
+void permute_tensor_data(
+    const Tensor& in,
+    executorch::aten::ArrayRef<int64_t> dims,
+    Tensor& out) {
+  const size_t ndim = out.dim();
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+  for (const auto i : c10::irange(ndim)) {
+    const int64_t in_dim = dims[i] >= 0 ? dims[i] : dims[i] + in.dim();
+    sizes[i] = out.size(i);
+    in_strides[i] = in.strides()[in_dim];
+    out_strides[i] = out.strides()[i];
+  }
+  strided_copy(
+      in.const_data_ptr(),
+      out.mutable_data_ptr(),
+      in.element_size(),
+      ndim,
+      sizes,
+      in_strides,
+      out_strides);
+}
+
+void copy_tensor_data_to_strides(const Tensor& in, Tensor& out) {
+  const size_t ndim = out.dim();
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+  for (const auto i : c10::irange(ndim)) {
+    sizes[i] = out.size(i);
+    in_strides[i] = in.strides()[i];
+    out_strides[i] = out.strides()[i];
+  }
+  strided_copy(
+      in.const_data_ptr(),
+      out.mutable_data_ptr(),
+      in.element_size(),
+      ndim,
+      sizes,
+      in_strides,
+      out_strides);
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Copies `ndim` dimensional data between two strided layouts. Element
+ * (i_0, ..., i_{ndim-1}) is read from in_data at offset sum(i_k *
+ * in_strides[k]) and written to out_data at offset sum(i_k * out_strides[k]),
+ * where offsets are in elements of `element_size` bytes.
+ *
+ * Size-1 dimensions are dropped and dimensions that are contiguous in both
+ * layouts are collapsed before copying. The copy then uses one of:
+ * - memcpy of whole rows when the innermost dimension is contiguous in both
+ *   layouts,
+ * - a cache-blocked 2D transpose when the dimension that is contiguous in the
+ *   input is not the one that is contiguous in the output,
+ * - a strided element loop otherwise.
+ * The work is split over the outer dimensions with parallel_for.
+ *
+ * The output must not alias the input.
+ */
+void strided_copy(
+    const void* in_data,
+    void* out_data,
+    size_t element_size,
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* in_strides,
+    const int64_t* out_strides);
+
+/**
+ * Returns true if strided_copy() and the tensor copies built on it support
+ * tensors of dtype `type`. The copies only move bytes, so this only depends
+ * on the element size.
+ */
+bool is_strided_copy_dtype(executorch::aten::ScalarType type);
+
+/**
+ * Copies `num_rows` rows of `row_nbytes` bytes each from `src` to `dst`. Row i
+ * starts at byte offset i * src_stride_nbytes in `src` and i *
+ * dst_stride_nbytes in `dst`.
+ *
+ * Rows that are contiguous in both buffers are merged into a single block.
+ * Copies are split into blocks of at least kParallelCopyMinBytes that run in
+ * parallel, and copies of at least kNonTemporalCopyMinBytes use non-temporal
+ * stores where supported so that they don't evict the rest of the cache.
+ *
+ * The destination must not alias the source.
+ */
+void copy_rows(
+    void* dst,
+    size_t dst_stride_nbytes,
+    const void* src,
+    size_t src_stride_nbytes,
+    size_t row_nbytes,
+    size_t num_rows);
+
+/// Minimum number of bytes copied by each parallel_for work item of
+/// copy_rows().
+constexpr size_t kParallelCopyMinBytes = 64 * 1024;
+
+/// Copies of at least this many bytes bypass the cache in copy_rows().
+constexpr size_t kNonTemporalCopyMinBytes = 8 * 1024 * 1024;
+
+/**
+ * Copies the data of `in` into `out` so that dimension i of `out` is
+ * dimension dims[i] of `in`, as permute_copy does. `dims` may contain
+ * negative dimensions. `out` must already have the permuted sizes and the same
+ * dtype as `in`; both tensors may have any dim order.
+ */
+void permute_tensor_data(
+    const Tensor& in,
+    executorch::aten::ArrayRef<int64_t> dims,
+    Tensor& out);
+
+/**
+ * Copies the data of `in` into `out`, which has the same sizes and dtype but
+ * may have different strides, e.g. because it has a different dim order.
+ */
+void copy_tensor_data_to_strides(const Tensor& in, Tensor& out);
+
+} // namespace executor
+} // namespace torch
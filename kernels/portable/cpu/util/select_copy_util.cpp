@@ -6,8 +6,6 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <cstring>
-
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include "executorch/kernels/portable/cpu/util/select_copy_util.h"
@@ -58,27 +56,29 @@ Error select_copy_util(
   size_t trailing_dims = getTrailingDims(in, dim);
   size_t dim_length = in.size(dim);
 
-  // Number of bytes to copy in the each memcpy operation
+  // Number of bytes to copy for each leading index
   size_t copy_size_per_op = trailing_dims * out.element_size();
 
-  // Step between the src locations of two adjcant memcpy operations
+  // Step between the src locations of two adjacent leading indices
   size_t src_step_per_op = dim_length * trailing_dims * in.element_size();
 
   // the start point of data need to be copied is the start point of overall
   // data chunk plus the offset between the overall start point and the first
   // data to be copied.
-  char* input_data = in.mutable_data_ptr<char>();
+  const char* input_data = in.const_data_ptr<char>();
 
   size_t start_offset = index * trailing_dims * in.element_size();
-  char* src = input_data + start_offset;
+  const char* src = input_data + start_offset;
 
   char* dest = out.mutable_data_ptr<char>();
 
-  for (size_t j = 0; j < leading_dims; ++j) {
-    memcpy(dest, src, copy_size_per_op);
-    src += src_step_per_op;
-    dest += copy_size_per_op;
-  }
+  copy_rows(
+      dest,
+      copy_size_per_op,
+      src,
+      src_step_per_op,
+      copy_size_per_op,
+      leading_dims);
 
   return Error::Ok;
 }
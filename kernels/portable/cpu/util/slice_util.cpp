@@ -7,9 +7,9 @@
  */
 
 #include <c10/util/irange.h>
+#include <executorch/kernels/portable/cpu/util/permute_util.h>
 #include <executorch/kernels/portable/cpu/util/slice_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
-#include <cstring>
 
 namespace torch {
 namespace executor {
@@ -170,14 +170,40 @@ void compute_slice(
   const char* input_data = in.const_data_ptr<char>();
   char* dest = out.mutable_data_ptr<char>();
 
-  for (const auto i : c10::irange(leading_dims)) {
-    const char* src = input_data + (i * dim_length + start) * length_per_step;
-    for ([[maybe_unused]] const auto j : c10::irange(length)) {
-      memcpy(dest, src, length_per_step);
-      src += step * length_per_step;
-      dest += length_per_step;
-    }
+  if (step == 1) {
+    // Each leading index contributes one contiguous block.
+    copy_rows(
+        dest,
+        length * length_per_step,
+        input_data + start * length_per_step,
+        dim_length * length_per_step,
+        length * length_per_step,
+        leading_dims);
+    return;
   }
+  // Otherwise every selected slice is a row of `trailing_dims` elements.
+  // Copy all `leading_dims * length` rows at once so that they are split
+  // across threads together, rather than one small copy per leading index.
+  const int64_t sizes[3] = {
+      static_cast<int64_t>(leading_dims),
+      length,
+      static_cast<int64_t>(trailing_dims)};
+  const int64_t in_strides[3] = {
+      static_cast<int64_t>(dim_length * trailing_dims),
+      step * static_cast<int64_t>(trailing_dims),
+      1};
+  const int64_t out_strides[3] = {
+      length * static_cast<int64_t>(trailing_dims),
+      static_cast<int64_t>(trailing_dims),
+      1};
+  strided_copy(
+      input_data + start * length_per_step,
+      dest,
+      in.element_size(),
+      3,
+      sizes,
+      in_strides,
+      out_strides);
 }
 
 } // namespace executor
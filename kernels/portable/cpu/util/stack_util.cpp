@@ -6,7 +6,6 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <cstring>
 #include <tuple>
 
 #include <c10/util/irange.h>
@@ -95,25 +94,41 @@ Tensor& stack_out_impl(
   const size_t outer = getLeadingDims(out, dim);
   const size_t inner = getTrailingDims(out, dim);
   const size_t ninputs = tensors.size();
+  const size_t out_row = ninputs * inner;
 
+  // Each input is copied into a column of `outer` rows of the output.
   const auto out_type = out.scalar_type();
-  ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "stack.out", CTYPE_OUT, [&] {
-    CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
-    for (size_t i = 0; i < outer; ++i) {
-      for (size_t j = 0; j < ninputs; ++j) {
-        const auto in_type = tensors[j].scalar_type();
-        ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "stack.out", CTYPE_IN, [&] {
-          const CTYPE_IN* const in_ptr =
-              tensors[j].const_data_ptr<CTYPE_IN>() + i * inner;
-
+  const size_t out_element_size = out.element_size();
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+  for (size_t j = 0; j < ninputs; ++j) {
+    const auto in_type = tensors[j].scalar_type();
+    if (in_type == out_type) {
+      // Same dtype: a byte copy, once the dtype is known to be supported.
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "stack.out", CTYPE, [&] {
+        copy_rows(
+            out_data + j * inner * out_element_size,
+            out_row * out_element_size,
+            tensors[j].const_data_ptr(),
+            inner * out_element_size,
+            inner * out_element_size,
+            outer);
+      });
+      continue;
+    }
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "stack.out", CTYPE_OUT, [&] {
+      ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "stack.out", CTYPE_IN, [&] {
+        const CTYPE_IN* const in_ptr = tensors[j].const_data_ptr<CTYPE_IN>();
+        CTYPE_OUT* const out_ptr =
+            out.mutable_data_ptr<CTYPE_OUT>() + j * inner;
+        for (size_t i = 0; i < outer; ++i) {
           for (size_t k = 0; k < inner; ++k) {
-            out_ptr[k] = static_cast<CTYPE_OUT>(in_ptr[k]);
+            out_ptr[i * out_row + k] =
+                static_cast<CTYPE_OUT>(in_ptr[i * inner + k]);
           }
-          out_ptr += inner;
-        });
-      }
-    }
-  });
+        }
+      });
+    });
+  }
 
   return out;
 }
@@ -21,6 +21,8 @@ def define_common_targets():
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
             "//executorch/kernels/portable/cpu/util:transpose_util",
+            "//executorch/kernels/portable/cpu/util:permute_util",
+            "//executorch/kernels/portable/cpu/util:gather_util",
             "//executorch/kernels/portable/cpu/util:index_util",
             "//executorch/kernels/portable/cpu/util:math_util",
             "//executorch/kernels/portable/cpu/util:padding_util",
@@ -150,6 +152,7 @@ def define_common_targets():
         compiler_flags = ["-Wno-missing-prototypes"],
         exported_deps = [
             ":broadcast_util",
+            ":permute_util",
         ],
         deps = [
             "//executorch/runtime/kernel:kernel_includes",
@@ -228,6 +231,9 @@ def define_common_targets():
         exported_headers = [
             "transpose_util.h",
         ],
+        exported_deps = [
+            ":permute_util",
+        ],
         deps = [
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
@@ -235,6 +241,36 @@ def define_common_targets():
         visibility = ["//executorch/kernels/portable/cpu/..."],
     )
 
+    # Strided copy engine shared by the permute, transpose and dim order copy
+    # ops.
+    runtime.cxx_library(
+        name = "permute_util",
+        srcs = ["permute_util.cpp"],
+        exported_headers = [
+            "permute_util.h",
+        ],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        exported_deps = [
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
+    )
+
+    # Parallel row gather shared by the embedding and indexing ops
+    runtime.cxx_library(
+        name = "gather_util",
+        srcs = [],
+        exported_headers = ["gather_util.h"],
+        exported_deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
+    )
+
     # Utility functions that can be used by operators that perform indexing
     runtime.cxx_library(
         name = "index_util",
@@ -244,7 +280,7 @@ def define_common_targets():
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/quantized/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/...", "//executorch/kernels/quantized/..."],
     )
 
     # Utility functions that can be used by operators that repeat the same computation for each element in the tensor
@@ -291,6 +327,7 @@ def define_common_targets():
         srcs = ["slice_util.cpp"],
         exported_headers = ["slice_util.h"],
         deps = [
+            ":permute_util",
             "//executorch/runtime/kernel:kernel_includes",
         ],
         visibility = ["//executorch/kernels/portable/cpu/..."],
@@ -316,7 +353,7 @@ def define_common_targets():
         deps = [
             "//executorch/runtime/kernel:kernel_includes",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
     )
 
     runtime.cxx_library(
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/permute_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::copy_rows;
+using torch::executor::copy_tensor_data_to_strides;
+using torch::executor::is_strided_copy_dtype;
+using torch::executor::kNonTemporalCopyMinBytes;
+using torch::executor::kParallelCopyMinBytes;
+using torch::executor::permute_tensor_data;
+using torch::executor::strided_copy;
+
+namespace {
+
+std::vector<int64_t> contiguous_strides(const std::vector<int64_t>& sizes) {
+  std::vector<int64_t> strides(sizes.size());
+  int64_t stride = 1;
+  for (size_t i = sizes.size(); i > 0; --i) {
+    strides[i - 1] = stride;
+    stride *= sizes[i - 1];
+  }
+  return strides;
+}
+
+// Permutes a contiguous input of `in_sizes` into a contiguous output with
+// strided_copy and checks the result element by element.
+template <typename T>
+void check_permute(
+    const std::vector<int64_t>& in_sizes,
+    const std::vector<int64_t>& dims) {
+  const auto in_strides = contiguous_strides(in_sizes);
+  std::vector<int64_t> out_sizes(dims.size());
+  std::vector<int64_t> permuted_in_strides(dims.size());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    out_sizes[i] = in_sizes[dims[i]];
+    permuted_in_strides[i] = in_strides[dims[i]];
+  }
+  const auto out_strides = contiguous_strides(out_sizes);
+  const int64_t numel = std::accumulate(
+      in_sizes.begin(), in_sizes.end(), int64_t{1}, std::multiplies<>());
+
+  std::vector<T> in(numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    in[i] = static_cast<T>(i * 7 + 3);
+  }
+  std::vector<T> out(numel, T(0));
+  strided_copy(
+      in.data(),
+      out.data(),
+      sizeof(T),
+      dims.size(),
+      out_sizes.data(),
+      permuted_in_strides.data(),
+      out_strides.data());
+
+  std::vector<int64_t> index(dims.size(), 0);
+  for (int64_t i = 0; i < numel; ++i) {
+    int64_t in_offset = 0;
+    for (size_t d = 0; d < dims.size(); ++d) {
+      in_offset += index[d] * permuted_in_strides[d];
+    }
+    ASSERT_EQ(out[i], in[in_offset]) << "at output element " << i;
+    for (size_t d = dims.size(); d > 0; --d) {
+      if (++index[d - 1] < out_sizes[d - 1]) {
+        break;
+      }
+      index[d - 1] = 0;
+    }
+  }
+}
+
+template <typename T>
+void check_common_permutations() {
+  // 2D transposes, with sizes that are not multiples of the tile sizes.
+  check_permute<T>({67, 45}, {1, 0});
+  check_permute<T>({4, 129}, {1, 0});
+  // NCHW -> NHWC and back.
+  check_permute<T>({2, 19, 13, 11}, {0, 2, 3, 1});
+  check_permute<T>({2, 13, 11, 19}, {0, 3, 1, 2});
+  // Attention head transpose [B, S, H, D] -> [B, H, S, D].
+  check_permute<T>({2, 37, 6, 16}, {0, 2, 1, 3});
+  // No data reorder, and a permutation of size-1 dims only.
+  check_permute<T>({3, 1, 5, 7}, {1, 0, 2, 3});
+  // Strided inner loop: innermost dim of the input lands in the middle.
+  check_permute<T>({5, 6, 7}, {2, 0, 1});
+  check_permute<T>({3, 4, 5, 6, 7}, {4, 2, 0, 3, 1});
+}
+
+} // namespace
+
+TEST(PermuteUtilTest, CommonPermutationsAllElementSizes) {
+  check_common_permutations<uint8_t>();
+  check_common_permutations<uint16_t>();
+  check_common_permutations<uint32_t>();
+  check_common_permutations<uint64_t>();
+}
+
+TEST(PermuteUtilTest, LargeTransposeIsParallelized) {
+  // Large enough to be split over several parallel_for work items.
+  check_permute<float>({300, 517}, {1, 0});
+  check_permute<float>({4, 128, 130}, {0, 2, 1});
+}
+
+TEST(PermuteUtilTest, EmptyCopyIsNoop) {
+  std::vector<int64_t> sizes = {3, 0, 2};
+  const auto strides = contiguous_strides(sizes);
+  float in = 1.f;
+  float out = 2.f;
+  strided_copy(
+      &in,
+      &out,
+      sizeof(float),
+      sizes.size(),
+      sizes.data(),
+      strides.data(),
+      strides.data());
+  EXPECT_EQ(out, 2.f);
+}
+
+TEST(PermuteUtilTest, PermuteTensorData) {
+  TensorFactory<ScalarType::Int> tf;
+  Tensor in = tf.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor out = tf.zeros({3, 2});
+  const int64_t dims[] = {-1, 0};
+  permute_tensor_data(in, {dims, 2}, out);
+  EXPECT_TENSOR_EQ(out, tf.make({3, 2}, {1, 4, 2, 5, 3, 6}));
+}
+
+TEST(PermuteUtilTest, CopyToChannelsLast) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor in = tf.make({1, 3, 2, 2}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  Tensor out = tf.full_channels_last({1, 3, 2, 2}, 0.0);
+  copy_tensor_data_to_strides(in, out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make_with_dimorder(
+          {1, 3, 2, 2},
+          {0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11},
+          /*dim_order=*/{0, 2, 3, 1}));
+}
+
+TEST(PermuteUtilTest, CopyRowsBetweenStridedBuffers) {
+  // Copy column 1 of a [5, 3] int buffer into column 0 of a [5, 2] buffer.
+  std::vector<int32_t> src(15);
+  std::iota(src.begin(), src.end(), 0);
+  std::vector<int32_t> dst(10, -1);
+  copy_rows(
+      dst.data(),
+      2 * sizeof(int32_t),
+      src.data() + 1,
+      3 * sizeof(int32_t),
+      sizeof(int32_t),
+      5);
+  EXPECT_EQ(
+      dst, std::vector<int32_t>({1, -1, 4, -1, 7, -1, 10, -1, 13, -1}));
+}
+
+TEST(PermuteUtilTest, CopyRowsLargeContiguous) {
+  // Contiguous rows are merged into one block that spans several work items,
+  // with a size that is not a multiple of the work item size.
+  const size_t num_rows = 3 * kParallelCopyMinBytes / 1000 + 1;
+  std::vector<uint8_t> src(num_rows * 1000);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  std::vector<uint8_t> dst(src.size(), 0);
+  copy_rows(dst.data(), 1000, src.data(), 1000, 1000, num_rows);
+  EXPECT_EQ(dst, src);
+}
+
+TEST(PermuteUtilTest, CopyRowsNonTemporal) {
+  // Large enough for non-temporal stores, with an unaligned destination and a
+  // row size that is not a multiple of the vector width.
+  const size_t row_nbytes = 4099;
+  const size_t num_rows = kNonTemporalCopyMinBytes / row_nbytes + 1;
+  std::vector<uint8_t> src(num_rows * row_nbytes);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 13 + 1);
+  }
+  const size_t dst_stride = row_nbytes + 3;
+  std::vector<uint8_t> dst(num_rows * dst_stride + 1, 0);
+  copy_rows(
+      dst.data() + 1, dst_stride, src.data(), row_nbytes, row_nbytes, num_rows);
+  for (size_t r = 0; r < num_rows; ++r) {
+    ASSERT_EQ(
+        std::memcmp(
+            dst.data() + 1 + r * dst_stride,
+            src.data() + r * row_nbytes,
+            row_nbytes),
+        0)
+        << "at row " << r;
+  }
+  EXPECT_EQ(dst[0], 0);
+}
+
+TEST(PermuteUtilTest, StridedCopyDtypes) {
+  EXPECT_TRUE(is_strided_copy_dtype(ScalarType::Bool));
+  EXPECT_TRUE(is_strided_copy_dtype(ScalarType::BFloat16));
+  EXPECT_TRUE(is_strided_copy_dtype(ScalarType::Float));
+  EXPECT_TRUE(is_strided_copy_dtype(ScalarType::Long));
+  EXPECT_TRUE(is_strided_copy_dtype(ScalarType::ComplexDouble));
+  EXPECT_FALSE(is_strided_copy_dtype(ScalarType::Undefined));
+  EXPECT_FALSE(is_strided_copy_dtype(ScalarType::NumOptions));
+}
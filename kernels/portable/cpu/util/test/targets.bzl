@@ -23,6 +23,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "permute_util_test",
+        srcs = ["permute_util_test.cpp"],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/portable/cpu/util:permute_util",
+        ],
+    )
+
     runtime.cxx_test(
         name = "reduce_test",
         srcs = ["reduce_test.cpp"],
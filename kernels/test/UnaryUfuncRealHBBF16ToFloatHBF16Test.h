@@ -105,6 +105,26 @@ class UnaryUfuncRealHBBF16ToFloatHBF16Test : public OperatorTest {
     ET_EXPECT_KERNEL_FAILURE(context_, op_out(in, out));
   }
 
+  // Large enough to exercise vectorized loop tails and multithreading.
+  template <executorch::aten::ScalarType DTYPE>
+  void test_large_input() {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename decltype(tf)::ctype;
+
+    const int32_t numel = 3 * 32768 + 7;
+    std::vector<CTYPE> in_data(numel);
+    std::vector<CTYPE> expected_data(numel);
+    for (int32_t ii = 0; ii < numel; ++ii) {
+      // Cover [-1, 3], which is inside the domain of most of these ops.
+      in_data[ii] = static_cast<CTYPE>(ii % 401) / 100 - 1;
+      expected_data[ii] = static_cast<CTYPE>(this->op_reference(in_data[ii]));
+    }
+
+    executorch::aten::Tensor out = tf.zeros({numel});
+    op_out(tf.make({numel}, in_data), out);
+    EXPECT_TENSOR_CLOSE(out, tf.make({numel}, expected_data));
+  }
+
   void test_bool_input();
 
   void test_mismatched_input_shapes_dies();
@@ -182,6 +202,14 @@ class UnaryUfuncRealHBBF16ToFloatHBF16Test : public OperatorTest {
                                                                       \
   TEST_F(TestName, MismatchedInputShapesDies) {                       \
     test_mismatched_input_shapes_dies();                              \
+  }                                                                   \
+                                                                      \
+  TEST_F(TestName, LargeFloatInput) {                                 \
+    test_large_input<executorch::aten::ScalarType::Float>();          \
+  }                                                                   \
+                                                                      \
+  TEST_F(TestName, LargeDoubleInput) {                                \
+    test_large_input<executorch::aten::ScalarType::Double>();         \
   }
 
 } // namespace torch::executor::testing
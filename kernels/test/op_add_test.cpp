@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace ::testing;
 using executorch::aten::Scalar;
 using executorch::aten::ScalarType;
@@ -217,6 +219,89 @@ class OpAddOutKernelTest : public OperatorTest {
     EXPECT_TENSOR_CLOSE(op_add_out(b, a, 1.0, out), expected);
   }
 
+  // Adds inputs of the given sizes with random data and compares the result
+  // with a reference that computes the broadcast index of every element.
+  template <ScalarType DTYPE>
+  void test_broadcast_matches_reference(
+      const std::vector<int32_t>& a_sizes,
+      const std::vector<int32_t>& b_sizes) {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+
+    const size_t ndim = std::max(a_sizes.size(), b_sizes.size());
+    const auto padded = [ndim](const std::vector<int32_t>& sizes) {
+      std::vector<int32_t> result(ndim - sizes.size(), 1);
+      result.insert(result.end(), sizes.begin(), sizes.end());
+      return result;
+    };
+    const std::vector<int32_t> a_padded = padded(a_sizes);
+    const std::vector<int32_t> b_padded = padded(b_sizes);
+    std::vector<int32_t> out_sizes(ndim);
+    for (size_t d = 0; d < ndim; ++d) {
+      out_sizes[d] = std::max(a_padded[d], b_padded[d]);
+    }
+
+    const auto make_data = [](const std::vector<int32_t>& sizes, int seed) {
+      int64_t numel = 1;
+      for (const auto size : sizes) {
+        numel *= size;
+      }
+      std::vector<CTYPE> data(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        data[i] = static_cast<CTYPE>((i * seed) % 17);
+      }
+      return data;
+    };
+    const std::vector<CTYPE> a_data = make_data(a_sizes, 3);
+    const std::vector<CTYPE> b_data = make_data(b_sizes, 7);
+
+    std::vector<CTYPE> expected;
+    std::vector<int32_t> index(ndim, 0);
+    do {
+      int64_t a_index = 0;
+      int64_t b_index = 0;
+      for (size_t d = 0; d < ndim; ++d) {
+        a_index = a_index * a_padded[d] + (a_padded[d] == 1 ? 0 : index[d]);
+        b_index = b_index * b_padded[d] + (b_padded[d] == 1 ? 0 : index[d]);
+      }
+      expected.push_back(a_data[a_index] + b_data[b_index]);
+      size_t d = ndim;
+      for (; d > 0 && ++index[d - 1] == out_sizes[d - 1]; --d) {
+        index[d - 1] = 0;
+      }
+      if (d == 0) {
+        break;
+      }
+    } while (true);
+
+    Tensor a = tf.make(a_sizes, a_data);
+    Tensor b = tf.make(b_sizes, b_data);
+    Tensor out = tf.zeros(out_sizes);
+    EXPECT_TENSOR_EQ(op_add_out(a, b, 1, out), tf.make(out_sizes, expected));
+    EXPECT_TENSOR_EQ(op_add_out(b, a, 1, out), tf.make(out_sizes, expected));
+  }
+
+  template <ScalarType DTYPE>
+  void test_common_broadcast_patterns() {
+    // Scalar.
+    test_broadcast_matches_reference<DTYPE>({5, 9}, {1, 1});
+    test_broadcast_matches_reference<DTYPE>({3, 37}, {1});
+    // Row, e.g. bias add.
+    test_broadcast_matches_reference<DTYPE>({6, 19}, {19});
+    test_broadcast_matches_reference<DTYPE>({2, 3, 4, 21}, {4, 21});
+    // Column, e.g. per-channel scale.
+    test_broadcast_matches_reference<DTYPE>({4, 23}, {4, 1});
+    test_broadcast_matches_reference<DTYPE>({2, 3, 5, 7}, {2, 3, 1, 1});
+    // Row and column.
+    test_broadcast_matches_reference<DTYPE>({5, 1}, {1, 11});
+    // Large enough to be split over several work items in the middle of rows.
+    test_broadcast_matches_reference<DTYPE>({131, 517}, {517});
+    test_broadcast_matches_reference<DTYPE>({517, 131}, {517, 1});
+    // Needs general broadcasting.
+    test_broadcast_matches_reference<DTYPE>({2, 4, 3}, {2, 1, 3});
+    test_broadcast_matches_reference<DTYPE>({3, 1, 5}, {1, 4, 1});
+  }
+
   template <ScalarType DTYPE>
   void test_broadcast_last_dim() {
     TensorFactory<DTYPE> tf_a;
@@ -591,6 +676,11 @@ TEST_F(OpAddOutKernelTest, BroadcastNDTest) {
   test_broadcast_last_dim<ScalarType::BFloat16>();
 }
 
+TEST_F(OpAddOutKernelTest, BroadcastPatternsMatchReference) {
+  test_common_broadcast_patterns<ScalarType::Float>();
+  test_common_broadcast_patterns<ScalarType::Int>();
+}
+
 TEST_F(OpAddOutKernelTest, BroadcastBToA) {
   TensorFactory<ScalarType::Float> tf_a;
   Tensor a = tf_a.make({1, 3}, /*data=*/{1, 2, 3});
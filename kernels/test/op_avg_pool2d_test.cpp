@@ -1116,3 +1116,48 @@ TEST_F(OpAvgPool2DOutTest, SanityCheck4DCeilModeNoIncludePadding) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY)
 #undef TEST_ENTRY
 }
+
+TEST_F(OpAvgPool2DOutTest, ChannelsLastMatchesContiguous) {
+  if (!torch::executor::testing::SupportedFeatures::get()
+           ->op_avg_pool2d_channels_last) {
+    GTEST_SKIP() << "Kernel does not support channels last dim order";
+  }
+  torch::executor::testing::TensorFactory<ScalarType::Float> tf;
+
+  // 11 channels leaves a remainder after any vector width.
+  const std::vector<int32_t> in_sizes = {2, 11, 9, 13};
+  std::vector<float> in_data(2 * 11 * 9 * 13);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 4;
+  }
+  const executorch::aten::Tensor self = tf.make(in_sizes, in_data);
+
+  std::vector<int64_t> kernel_size = {3, 3};
+  std::vector<int64_t> stride = {2, 2};
+  std::vector<int64_t> padding = {1, 1};
+
+  for (const bool count_include_pad : {false, true}) {
+    executorch::aten::Tensor expected = tf.zeros({2, 11, 5, 7});
+    op_avg_pool2d_out(
+        self,
+        kernel_size,
+        stride,
+        padding,
+        /*ceil_mode=*/false,
+        count_include_pad,
+        /*divisor_override=*/{},
+        expected);
+
+    executorch::aten::Tensor out = tf.zeros_channels_last({2, 11, 5, 7});
+    op_avg_pool2d_out(
+        tf.channels_last_like(self),
+        kernel_size,
+        stride,
+        padding,
+        /*ceil_mode=*/false,
+        count_include_pad,
+        /*divisor_override=*/{},
+        out);
+    EXPECT_TENSOR_CLOSE(out, tf.channels_last_like(expected));
+  }
+}
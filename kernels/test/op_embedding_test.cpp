@@ -461,3 +461,41 @@ TEST_F(OpEmbeddingOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpEmbeddingOutTest, LargeTableScatteredIndices) {
+  TensorFactory<ScalarType::Float> tff;
+  TensorFactory<ScalarType::Int> tfi;
+
+  // Enough rows that the lookup is split across several parallel chunks, with
+  // indices that jump around the table.
+  constexpr int32_t kNumEmbeddings = 4096;
+  constexpr int32_t kEmbeddingDim = 24;
+  constexpr int32_t kNumIndices = 2100;
+
+  std::vector<float> weight_data(kNumEmbeddings * kEmbeddingDim);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<float>(i);
+  }
+  std::vector<int32_t> indices_data(kNumIndices);
+  std::vector<float> expected_data;
+  expected_data.reserve(kNumIndices * kEmbeddingDim);
+  for (int32_t i = 0; i < kNumIndices; ++i) {
+    indices_data[i] = (i * 2971 + 7) % kNumEmbeddings;
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      expected_data.push_back(weight_data[indices_data[i] * kEmbeddingDim + j]);
+    }
+  }
+
+  Tensor weight = tff.make({kNumEmbeddings, kEmbeddingDim}, weight_data);
+  Tensor indices = tfi.make({3, kNumIndices / 3}, indices_data);
+  Tensor out = tff.zeros({3, kNumIndices / 3, kEmbeddingDim});
+  op_embedding_out(
+      weight,
+      indices,
+      /*padding_idx=*/0,
+      /*scale_grad_by_freq=*/false,
+      /*sparse=*/false,
+      out);
+  EXPECT_TENSOR_EQ(
+      out, tff.make({3, kNumIndices / 3, kEmbeddingDim}, expected_data));
+}
@@ -275,6 +275,45 @@ TEST_F(OpGatherOutTest, DynamicShapeUnbound) {
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
 
+TEST_F(OpGatherOutTest, LargeIndexAlongEachDim) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  const std::vector<int32_t> in_sizes = {4, 50, 70};
+  int32_t in_numel = 1;
+  for (const auto size : in_sizes) {
+    in_numel *= size;
+  }
+  std::vector<float> in_data(in_numel);
+  for (int32_t i = 0; i < in_numel; ++i) {
+    in_data[i] = static_cast<float>(i);
+  }
+  Tensor self = tf_data.make(in_sizes, in_data);
+
+  for (int64_t dim = 0; dim < 3; ++dim) {
+    // The index matches the input everywhere except along `dim`.
+    std::vector<int32_t> sizes = in_sizes;
+    sizes[dim] = 33;
+    const int32_t numel = sizes[0] * sizes[1] * sizes[2];
+
+    std::vector<int64_t> index_data(numel);
+    std::vector<float> expected_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      int32_t coord[3] = {
+          i / (sizes[1] * sizes[2]), (i / sizes[2]) % sizes[1], i % sizes[2]};
+      index_data[i] = (i * 37 + 5) % in_sizes[dim];
+      coord[dim] = static_cast<int32_t>(index_data[i]);
+      expected_data[i] =
+          in_data[(coord[0] * in_sizes[1] + coord[1]) * in_sizes[2] + coord[2]];
+    }
+
+    Tensor index = tf_index.make(sizes, index_data);
+    Tensor out = tf_data.zeros(sizes);
+    op_gather_out(self, dim, index, /*sparse_grad=*/false, out);
+    EXPECT_TENSOR_EQ(out, tf_data.make(sizes, expected_data));
+  }
+}
+
 TEST_F(OpGatherOutTest, EmptyIndex) {
   TensorFactory<ScalarType::Long> tf_index;
   TensorFactory<ScalarType::Float> tf_data;
@@ -436,6 +436,46 @@ TEST_F(OpIndexSelectOutTest, IndexWithInvalidDimDies) {
       context_, op_index_select_out(x, /*dim=*/1, /*index=*/index, out));
 }
 
+TEST_F(OpIndexSelectOutTest, SelectMiddleDimManyIndexes) {
+  TensorFactory<ScalarType::Int> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Several leading blocks, each with many scattered rows to select, so that
+  // the copies are split across parallel chunks.
+  constexpr int32_t kLeading = 6;
+  constexpr int32_t kDimLength = 1000;
+  constexpr int32_t kTrailing = 5;
+  constexpr int32_t kNumIndexes = 777;
+
+  std::vector<int32_t> x_data(kLeading * kDimLength * kTrailing);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = static_cast<int32_t>(i);
+  }
+  std::vector<int64_t> index_data(kNumIndexes);
+  for (int32_t j = 0; j < kNumIndexes; ++j) {
+    index_data[j] = (j * 613 + 11) % kDimLength;
+  }
+  std::vector<int32_t> expected_data;
+  expected_data.reserve(kLeading * kNumIndexes * kTrailing);
+  for (int32_t i = 0; i < kLeading; ++i) {
+    for (int32_t j = 0; j < kNumIndexes; ++j) {
+      for (int32_t k = 0; k < kTrailing; ++k) {
+        expected_data.push_back(
+            x_data[(i * kDimLength + index_data[j]) * kTrailing + k]);
+      }
+    }
+  }
+
+  Tensor x = tf.make({kLeading, kDimLength, kTrailing}, x_data);
+  Tensor index = tfl.make({kNumIndexes}, index_data);
+  Tensor out = tf.zeros({kLeading, kNumIndexes, kTrailing});
+
+  Tensor ret = op_index_select_out(x, /*dim=*/1, index, out);
+  EXPECT_TENSOR_EQ(out, ret);
+  EXPECT_TENSOR_EQ(
+      ret, tf.make({kLeading, kNumIndexes, kTrailing}, expected_data));
+}
+
 #if !defined(USE_ATEN_LIB)
 TEST_F(OpIndexSelectOutTest, UpperBoundOutTensor) {
   TensorFactory<ScalarType::Double> tf;
@@ -387,3 +387,50 @@ TEST_F(OpMaxPool2DWithIndicesOutTest, CeilMode) {
       self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST_F(OpMaxPool2DWithIndicesOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tfFloat;
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Long>
+      tfLong;
+
+  // 11 channels leaves a remainder after any vector width.
+  const std::vector<int32_t> in_sizes = {2, 11, 9, 13};
+  std::vector<float> in_data(2 * 11 * 9 * 13);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 4;
+  }
+  const executorch::aten::Tensor self = tfFloat.make(in_sizes, in_data);
+
+  ::std::vector<int64_t> kernel_size = {3, 3};
+  ::std::vector<int64_t> stride = {2, 2};
+  ::std::vector<int64_t> padding = {1, 1};
+  ::std::vector<int64_t> dilation = {1, 2};
+
+  executorch::aten::Tensor out_expected = tfFloat.zeros({2, 11, 5, 6});
+  executorch::aten::Tensor indices_expected = tfLong.zeros({2, 11, 5, 6});
+  op_max_pool2d_with_indices_out(
+      self,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      /*ceil_mode=*/false,
+      out_expected,
+      indices_expected);
+
+  executorch::aten::Tensor out = tfFloat.zeros_channels_last({2, 11, 5, 6});
+  executorch::aten::Tensor indices =
+      tfLong.zeros_channels_last({2, 11, 5, 6});
+  op_max_pool2d_with_indices_out(
+      tfFloat.channels_last_like(self),
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      /*ceil_mode=*/false,
+      out,
+      indices);
+  EXPECT_TENSOR_CLOSE(out, tfFloat.channels_last_like(out_expected));
+  EXPECT_TENSOR_CLOSE(indices, tfLong.channels_last_like(indices_expected));
+}
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 using namespace ::testing;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
@@ -336,3 +338,43 @@ TEST_F(OpNativeGroupNormTest, IntTensorsDies) {
   // Cannot be represented by a type other than float.
   run_int_test_cases<ScalarType::Int>();
 }
+
+TEST_F(OpNativeGroupNormTest, LargeGroupsWithoutAffine) {
+  // Large enough that the (batch, group) blocks are normalized in parallel.
+  TensorFactory<ScalarType::Float> tf;
+  constexpr int32_t N = 3;
+  constexpr int32_t C = 4;
+  constexpr int32_t HxW = 4096;
+  constexpr int32_t group = 2;
+
+  // Every group repeats 0, 1, ..., 7, so mean = 3.5 and variance = 5.25.
+  std::vector<float> input_data(N * C * HxW);
+  std::vector<float> expected_data(N * C * HxW);
+  const float rstd = 1.0f / std::sqrt(5.25f + 1e-5f);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>(i % 8);
+    expected_data[i] = (input_data[i] - 3.5f) * rstd;
+  }
+
+  Tensor in = tf.make({N, C, HxW}, input_data);
+  Tensor out = tf.zeros({N, C, HxW});
+  Tensor mean = tf.zeros({N, group});
+  Tensor rstd_out = tf.zeros({N, group});
+
+  op_native_group_norm_out(
+      in,
+      std::nullopt,
+      std::nullopt,
+      N,
+      C,
+      HxW,
+      group,
+      1e-5,
+      out,
+      mean,
+      rstd_out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({N, C, HxW}, expected_data));
+  EXPECT_TENSOR_CLOSE(mean, tf.full({N, group}, 3.5f));
+  EXPECT_TENSOR_CLOSE(rstd_out, tf.full({N, group}, rstd));
+}
@@ -1174,6 +1174,13 @@ ET_NODISCARD Error resize_tensor_impl(
     executorch::aten::TensorImpl* impl,
     executorch::aten::ArrayRef<executorch::aten::SizesType> new_sizes);
 
+/**
+ * Set the maximum number of elements a bounded tensor can be resized to. Used
+ * when the memory behind the tensor changes size. Not supported in ATen mode.
+ */
+ET_NODISCARD Error
+set_tensor_numel_bound(const executorch::aten::Tensor& t, size_t numel_bound);
+
 } // namespace internal
 
 /**
@@ -1403,6 +1410,7 @@ using ::executorch::ET_RUNTIME_NAMESPACE::internal::copy_tensor_data;
 using ::executorch::ET_RUNTIME_NAMESPACE::internal::reset_data_ptr;
 using ::executorch::ET_RUNTIME_NAMESPACE::internal::resize_tensor_impl;
 using ::executorch::ET_RUNTIME_NAMESPACE::internal::set_tensor_data;
+using ::executorch::ET_RUNTIME_NAMESPACE::internal::set_tensor_numel_bound;
 using ::executorch::ET_RUNTIME_NAMESPACE::internal::share_tensor_data;
 } // namespace internal
 } // namespace executor
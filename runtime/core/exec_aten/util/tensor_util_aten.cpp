@@ -214,6 +214,13 @@ Error resize_tensor_impl(
   return torch::executor::Error::Ok;
 }
 
+Error set_tensor_numel_bound(
+    ET_UNUSED const at::Tensor& t,
+    ET_UNUSED size_t numel_bound) {
+  ET_LOG(Error, "Tensor numel bounds are not supported in ATen mode");
+  return torch::executor::Error::NotSupported;
+}
+
 } // namespace internal
 } // namespace ET_RUNTIME_NAMESPACE
 } // namespace executorch
@@ -210,6 +210,12 @@ class TensorResizerFriend final {
       executorch::aten::ArrayRef<executorch::aten::SizesType> new_sizes) {
     return impl->internal_resize_contiguous(new_sizes);
   }
+
+  static void set_numel_bound(
+      executorch::aten::TensorImpl* impl,
+      size_t numel_bound) {
+    impl->numel_bound_ = numel_bound;
+  }
 };
 
 Error resize_tensor_impl(
@@ -217,6 +223,19 @@ Error resize_tensor_impl(
     torch::executor::ArrayRef<executorch::aten::SizesType> new_sizes) {
   return TensorResizerFriend::resize_tensor_impl(impl, new_sizes);
 }
+
+Error set_tensor_numel_bound(
+    const torch::executor::Tensor& t,
+    size_t numel_bound) {
+  ET_CHECK_OR_RETURN_ERROR(
+      static_cast<size_t>(t.numel()) <= numel_bound,
+      InvalidArgument,
+      "numel bound %zu is smaller than the tensor numel %zd",
+      numel_bound,
+      t.numel());
+  TensorResizerFriend::set_numel_bound(t.unsafeGetTensorImpl(), numel_bound);
+  return Error::Ok;
+}
 } // namespace internal
 
 } // namespace runtime
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/dynamic_memory_plan.h>
+
+#include <algorithm>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace runtime {
+namespace internal {
+
+namespace {
+
+size_t align_offset(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+bool lifetimes_overlap(const PlannedBlock& a, const PlannedBlock& b) {
+  return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+bool ranges_overlap(
+    size_t a_offset,
+    size_t a_size,
+    size_t b_offset,
+    size_t b_size) {
+  return a_offset < b_offset + b_size && b_offset < a_offset + a_size;
+}
+
+} // namespace
+
+Error plan_memory(
+    Span<PlannedBlock> blocks,
+    Span<size_t> order,
+    Span<size_t> footprints,
+    size_t alignment) {
+  ET_CHECK_OR_RETURN_ERROR(
+      alignment > 0 && (alignment & (alignment - 1)) == 0,
+      InvalidArgument,
+      "Alignment %zu is not a power of 2",
+      alignment);
+  ET_CHECK_OR_RETURN_ERROR(
+      order.size() >= blocks.size(),
+      InvalidArgument,
+      "Scratch space for %zu blocks is too small for %zu blocks",
+      order.size(),
+      blocks.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        blocks[i].memory_id < footprints.size(),
+        InvalidArgument,
+        "Block %zu has memory id %u but there are only %zu footprints",
+        i,
+        static_cast<unsigned int>(blocks[i].memory_id),
+        footprints.size());
+    order[i] = i;
+  }
+
+  // Pinned blocks go first since they can't move, then the largest blocks,
+  // which are the hardest to fit.
+  std::sort(
+      order.begin(), order.begin() + blocks.size(), [&](size_t a, size_t b) {
+        if (blocks[a].pinned != blocks[b].pinned) {
+          return blocks[a].pinned;
+        }
+        if (blocks[a].size != blocks[b].size) {
+          return blocks[a].size > blocks[b].size;
+        }
+        return a < b;
+      });
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    PlannedBlock& block = blocks[order[i]];
+    if (block.pinned) {
+      continue;
+    }
+    // Bump the candidate offset past every conflicting block that was
+    // already placed until it fits. Each pass either finds a fit or moves
+    // the candidate strictly forward.
+    size_t offset = 0;
+    bool moved = true;
+    while (moved) {
+      moved = false;
+      for (size_t j = 0; j < i; ++j) {
+        const PlannedBlock& placed = blocks[order[j]];
+        if (placed.memory_id == block.memory_id && placed.size > 0 &&
+            lifetimes_overlap(placed, block) &&
+            ranges_overlap(offset, block.size, placed.offset, placed.size)) {
+          offset = align_offset(placed.offset + placed.size, alignment);
+          moved = true;
+        }
+      }
+    }
+    block.offset = offset;
+  }
+
+  for (size_t i = 0; i < footprints.size(); ++i) {
+    footprints[i] = 0;
+  }
+  for (const PlannedBlock& block : blocks) {
+    footprints[block.memory_id] =
+        std::max(footprints[block.memory_id], block.offset + block.size);
+  }
+  return Error::Ok;
+}
+
+} // namespace internal
+} // namespace runtime
+} // namespace executorch
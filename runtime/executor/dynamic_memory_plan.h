@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/span.h>
+
+namespace executorch {
+namespace runtime {
+namespace internal {
+
+/**
+ * A region of memory-planned storage that must not overlap any other block
+ * of the same memory id that is live at the same time.
+ */
+struct PlannedBlock {
+  /// The planned buffer the block lives in.
+  uint32_t memory_id;
+  /// Size of the block in bytes.
+  size_t size;
+  /// Index of the first instruction that uses the block.
+  size_t first_use;
+  /// Index of the last instruction that uses the block, inclusive.
+  size_t last_use;
+  /// If true, the block keeps the offset it was given.
+  bool pinned;
+  /// Offset of the block in its buffer. An input for pinned blocks, and an
+  /// output of plan_memory() for the others.
+  size_t offset;
+};
+
+/**
+ * Assigns an offset to every block that is not pinned, so that no two blocks
+ * in the same buffer overlap while both are live. Blocks are placed largest
+ * first, each at the lowest aligned offset that fits between the blocks that
+ * were already placed; pinned blocks are placed before everything else.
+ *
+ * Does not allocate memory, so it can run on systems without a heap.
+ *
+ * @param[in,out] blocks The blocks to plan.
+ * @param[out] order Scratch space with one entry per block.
+ * @param[out] footprints One entry per memory id. Receives the number of bytes
+ *     of each buffer used by the plan.
+ * @param[in] alignment The alignment of every offset assigned by the plan.
+ *     Must be a power of two.
+ *
+ * @returns Error::Ok on success, or Error::InvalidArgument if the scratch
+ *     space is too small, a memory id is out of range, or the alignment is
+ *     invalid.
+ */
+ET_NODISCARD Error plan_memory(
+    Span<PlannedBlock> blocks,
+    Span<size_t> order,
+    Span<size_t> footprints,
+    size_t alignment);
+
+} // namespace internal
+} // namespace runtime
+} // namespace executorch
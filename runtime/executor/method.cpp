@@ -9,6 +9,7 @@
 #include <executorch/runtime/executor/method.h>
 
 #include <c10/util/irange.h>
+#include <algorithm>
 #include <array>
 #include <cinttypes> // @donotremove
 #include <cstdint>
@@ -19,6 +20,7 @@
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/dynamic_memory_plan.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/merged_data_map.h>
 #include <executorch/runtime/executor/platform_memory_allocator.h>
@@ -225,6 +227,60 @@ struct Chain {
   OpFunction* kernels_;
 };
 
+/**
+ * A memory-planned tensor considered by Method::replan_dynamic_memory().
+ */
+struct ReplannedTensor {
+  /// Index of the tensor in the values table.
+  size_t value_index;
+  /// Location and size of the tensor in the ahead-of-time memory plan.
+  uint32_t memory_id;
+  size_t aot_offset;
+  size_t aot_numel;
+  size_t aot_nbytes;
+  /// Range of instructions that use the tensor.
+  size_t first_use;
+  size_t last_use;
+  /// True if the tensor must keep its planned location.
+  bool pinned;
+  /// Tensors that alias each other in the ahead-of-time plan move together.
+  /// Index of the group's block, and offset of the tensor in that block.
+  size_t block;
+  size_t block_offset;
+};
+
+/**
+ * State used by Method::replan_dynamic_memory(). Everything that doesn't
+ * depend on the tensor shapes is computed once, on the first call.
+ */
+struct MemoryReplanState {
+  size_t n_tensor;
+  ReplannedTensor* tensors;
+  size_t n_block;
+  ::executorch::runtime::internal::PlannedBlock* blocks;
+  /// Offset of each block in the ahead-of-time plan.
+  size_t* block_aot_offsets;
+  /// Scratch space for the planner.
+  size_t* order;
+  size_t n_buffer;
+  size_t* footprints;
+  /// True while the ahead-of-time plan is replaced.
+  bool replanned;
+  /// True if the memory is replanned at the end of the next execution.
+  bool pending;
+  /// The sizes of the tensor inputs and the values of the scalar ones,
+  /// flattened. The plan assumes that these determine every intermediate
+  /// shape, which doesn't hold for data-dependent shapes such as the outputs
+  /// of nonzero or masked_select. If such a tensor grows past its replanned
+  /// size, the next execution fails to resize it.
+  size_t n_input_sizes;
+  /// Inputs of the most recent execution, which completed if `executed`.
+  int64_t* executed_input_sizes;
+  bool executed;
+  /// Inputs of the execution that the current plan was made for.
+  int64_t* planned_input_sizes;
+};
+
 namespace {
 
 Result<InstructionArgs> gen_instruction_arguments(
@@ -1508,6 +1564,522 @@ Error Method::experimental_reset_execution() {
   return reset_execution(); // @lint-ignore CLANGTIDY facebook-hte-Deprecated
 }
 
+Error Method::init_memory_replan() {
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto flatbuffer_values = serialization_plan_->values();
+  const auto buffer_sizes = serialization_plan_->non_const_buffer_sizes();
+  // Index zero of the buffer sizes is reserved.
+  const size_t n_buffer = (buffer_sizes != nullptr && buffer_sizes->size() > 0)
+      ? buffer_sizes->size() - 1
+      : 0;
+
+  // Only straight-line programs can be replanned, since lifetimes are derived
+  // from the order of the instructions.
+  for (size_t i = 0; i < n_chains_; ++i) {
+    const auto instructions = chains_[i].s_chain_->instructions();
+    for (size_t j = 0; j < instructions->size(); ++j) {
+      const auto type = instructions->Get(j)->instr_args_type();
+      ET_CHECK_OR_RETURN_ERROR(
+          type == executorch_flatbuffer::InstructionArguments::KernelCall ||
+              type == executorch_flatbuffer::InstructionArguments::DelegateCall,
+          NotSupported,
+          "Cannot replan memory of a method with control flow: instruction "
+          "%" ET_PRIsize_t ":%" ET_PRIsize_t " has type %hhu",
+          i,
+          j,
+          static_cast<uint8_t>(type));
+    }
+  }
+
+  // Find the memory-planned tensors.
+  auto* tensor_index = method_allocator->allocateList<int32_t>(n_value_);
+  if (tensor_index == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  size_t n_tensor = 0;
+  for (size_t i = 0; i < n_value_; ++i) {
+    tensor_index[i] = -1;
+    const auto s_value = flatbuffer_values->Get(i);
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::Tensor &&
+        s_value->val_as_Tensor()->allocation_info() != nullptr &&
+        values_[i].isTensor()) {
+      tensor_index[i] = static_cast<int32_t>(n_tensor++);
+    }
+  }
+
+  auto* state = method_allocator->allocateInstance<MemoryReplanState>();
+  auto* tensors = method_allocator->allocateList<ReplannedTensor>(n_tensor);
+  auto* blocks =
+      method_allocator
+          ->allocateList<::executorch::runtime::internal::PlannedBlock>(
+              n_tensor);
+  auto* block_aot_offsets = method_allocator->allocateList<size_t>(n_tensor);
+  auto* order = method_allocator->allocateList<size_t>(n_tensor);
+  auto* footprints = method_allocator->allocateList<size_t>(n_buffer);
+  // Tensors can be resized, but not to a different rank.
+  size_t n_input_sizes = 0;
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    const EValue& input = values_[get_input_index(i)];
+    if (input.isTensor()) {
+      n_input_sizes += input.toTensor().dim();
+    } else if (input.isInt() || input.isBool()) {
+      ++n_input_sizes;
+    }
+  }
+  auto* executed_input_sizes =
+      method_allocator->allocateList<int64_t>(n_input_sizes);
+  auto* planned_input_sizes =
+      method_allocator->allocateList<int64_t>(n_input_sizes);
+  if (state == nullptr ||
+      (n_tensor > 0 &&
+       (tensors == nullptr || blocks == nullptr ||
+        block_aot_offsets == nullptr || order == nullptr)) ||
+      (n_buffer > 0 && footprints == nullptr) ||
+      (n_input_sizes > 0 &&
+       (executed_input_sizes == nullptr || planned_input_sizes == nullptr))) {
+    return Error::MemoryAllocationFailed;
+  }
+
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (tensor_index[i] < 0) {
+      continue;
+    }
+    const auto s_tensor = flatbuffer_values->Get(i)->val_as_Tensor();
+    const auto allocation_info = s_tensor->allocation_info();
+    const auto& t = values_[i].toTensor();
+    size_t aot_numel = 1;
+    for (const auto size : *s_tensor->sizes()) {
+      aot_numel *= static_cast<size_t>(size);
+    }
+    size_t aot_offset = allocation_info->memory_offset_low();
+    if (sizeof(size_t) > sizeof(uint32_t)) {
+      aot_offset |= static_cast<size_t>(allocation_info->memory_offset_high())
+          << 32;
+    }
+    ReplannedTensor& tensor = tensors[tensor_index[i]];
+    tensor.value_index = i;
+    tensor.memory_id = allocation_info->memory_id() - 1;
+    tensor.aot_offset = aot_offset;
+    tensor.aot_numel = aot_numel;
+    tensor.aot_nbytes = aot_numel * elementSize(t.scalar_type());
+    tensor.first_use = SIZE_MAX;
+    tensor.last_use = 0;
+    // Static tensors can't shrink, and tensors with initial data or extra
+    // info are mutable buffers whose contents live across executions.
+    const auto dynamism = static_cast<executorch::aten::TensorShapeDynamism>(
+        s_tensor->shape_dynamism());
+    tensor.pinned =
+        dynamism == executorch::aten::TensorShapeDynamism::STATIC ||
+        s_tensor->data_buffer_idx() > 0 ||
+        s_tensor->extra_tensor_info() != nullptr ||
+        tensor.memory_id >= n_buffer;
+  }
+
+  // The caller owns the memory of inputs and outputs.
+  const auto pin_values = [&](const flatbuffers::Vector<int32_t>* indices) {
+    if (indices == nullptr) {
+      return;
+    }
+    for (const auto index : *indices) {
+      if (index >= 0 && static_cast<size_t>(index) < n_value_ &&
+          tensor_index[index] >= 0) {
+        tensors[tensor_index[index]].pinned = true;
+      }
+    }
+  };
+  pin_values(serialization_plan_->inputs());
+  pin_values(serialization_plan_->outputs());
+
+  // Compute the lifetimes, expanding tensor lists to their elements.
+  size_t n_instruction = 0;
+  const auto use_value = [&](size_t index, bool pin) {
+    if (tensor_index[index] < 0) {
+      return;
+    }
+    ReplannedTensor& tensor = tensors[tensor_index[index]];
+    tensor.first_use = std::min(tensor.first_use, n_instruction);
+    tensor.last_use = std::max(tensor.last_use, n_instruction);
+    tensor.pinned = tensor.pinned || pin;
+  };
+  for (size_t i = 0; i < n_chains_; ++i) {
+    const auto instructions = chains_[i].s_chain_->instructions();
+    for (size_t j = 0; j < instructions->size(); ++j, ++n_instruction) {
+      const auto instruction = instructions->Get(j);
+      // Delegates may hold on to the addresses of their arguments.
+      const bool is_delegate = instruction->instr_args_type() ==
+          executorch_flatbuffer::InstructionArguments::DelegateCall;
+      const auto args = is_delegate
+          ? instruction->instr_args_as_DelegateCall()->args()
+          : instruction->instr_args_as_KernelCall()->args();
+      for (const auto arg : *args) {
+        const auto s_value = flatbuffer_values->Get(arg);
+        const flatbuffers::Vector<int32_t>* items = nullptr;
+        if (s_value->val_type() ==
+            executorch_flatbuffer::KernelTypes::TensorList) {
+          items = s_value->val_as_TensorList()->items();
+        } else if (
+            s_value->val_type() ==
+            executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+          items = s_value->val_as_OptionalTensorList()->items();
+        }
+        use_value(arg, is_delegate);
+        if (items != nullptr) {
+          for (const auto item : *items) {
+            if (item >= 0) {
+              use_value(item, is_delegate);
+            }
+          }
+        }
+      }
+    }
+  }
+  const size_t last_instruction = n_instruction > 0 ? n_instruction - 1 : 0;
+  for (size_t i = 0; i < n_tensor; ++i) {
+    if (tensors[i].first_use == SIZE_MAX) {
+      // Unused by any instruction; leave it where it is.
+      tensors[i].pinned = true;
+    }
+    if (tensors[i].pinned) {
+      tensors[i].first_use = 0;
+      tensors[i].last_use = last_instruction;
+    }
+    tensors[i].block = i;
+  }
+
+  // Tensors that overlap in both memory and time in the ahead-of-time plan
+  // alias each other, so they must keep their relative placement. Union them
+  // into groups; `block` temporarily holds the union-find parent.
+  const auto find = [&](size_t i) {
+    while (tensors[i].block != i) {
+      tensors[i].block = tensors[tensors[i].block].block;
+      i = tensors[i].block;
+    }
+    return i;
+  };
+  for (size_t i = 0; i < n_tensor; ++i) {
+    for (size_t j = i + 1; j < n_tensor; ++j) {
+      const ReplannedTensor& a = tensors[i];
+      const ReplannedTensor& b = tensors[j];
+      if (a.memory_id == b.memory_id &&
+          a.aot_offset < b.aot_offset + b.aot_nbytes &&
+          b.aot_offset < a.aot_offset + a.aot_nbytes &&
+          a.first_use <= b.last_use && b.first_use <= a.last_use) {
+        tensors[find(j)].block = find(i);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < n_tensor; ++i) {
+    tensors[i].block = find(i);
+  }
+
+  // Create one block per group, spanning all of its members. `order` isn't
+  // needed until planning, so use it to map each group root to its block.
+  size_t n_block = 0;
+  for (size_t i = 0; i < n_tensor; ++i) {
+    if (tensors[i].block == i) {
+      order[i] = n_block;
+      blocks[n_block++] = {
+          tensors[i].memory_id,
+          /*size=*/0,
+          /*first_use=*/SIZE_MAX,
+          /*last_use=*/0,
+          /*pinned=*/false,
+          /*offset=*/SIZE_MAX};
+    }
+  }
+  for (size_t i = 0; i < n_tensor; ++i) {
+    ReplannedTensor& tensor = tensors[i];
+    tensor.block = order[tensor.block];
+    auto& block = blocks[tensor.block];
+    block.first_use = std::min(block.first_use, tensor.first_use);
+    block.last_use = std::max(block.last_use, tensor.last_use);
+    block.pinned = block.pinned || tensor.pinned;
+    block.offset = std::min(block.offset, tensor.aot_offset);
+  }
+  for (size_t i = 0; i < n_tensor; ++i) {
+    ReplannedTensor& tensor = tensors[i];
+    tensor.pinned = blocks[tensor.block].pinned;
+    tensor.block_offset = tensor.aot_offset - blocks[tensor.block].offset;
+  }
+  for (size_t i = 0; i < n_block; ++i) {
+    block_aot_offsets[i] = blocks[i].offset;
+  }
+
+  state->n_tensor = n_tensor;
+  state->tensors = tensors;
+  state->n_block = n_block;
+  state->blocks = blocks;
+  state->block_aot_offsets = block_aot_offsets;
+  state->order = order;
+  state->n_buffer = n_buffer;
+  state->footprints = footprints;
+  state->replanned = false;
+  state->pending = false;
+  state->n_input_sizes = n_input_sizes;
+  state->executed_input_sizes = executed_input_sizes;
+  // Nothing is known about the executions before the first replan.
+  state->executed = false;
+  state->planned_input_sizes = planned_input_sizes;
+  memory_replan_ = state;
+  return Error::Ok;
+}
+
+void Method::read_input_sizes(int64_t* sizes) const {
+  size_t n = 0;
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    const EValue& input = values_[get_input_index(i)];
+    if (input.isTensor()) {
+      for (const auto size : input.toTensor().sizes()) {
+        sizes[n++] = size;
+      }
+    } else if (input.isInt()) {
+      sizes[n++] = input.toInt();
+    } else if (input.isBool()) {
+      sizes[n++] = input.toBool();
+    }
+  }
+}
+
+Result<size_t> Method::plan_dynamic_memory() {
+  auto& state = *memory_replan_;
+  auto planned_memory = memory_manager_->planned_memory();
+  const auto buffer_sizes = serialization_plan_->non_const_buffer_sizes();
+
+  // Size each block for the current shapes of the tensors that can move, and
+  // the upper bounds of the pinned ones.
+  for (size_t i = 0; i < state.n_block; ++i) {
+    state.blocks[i].size = 0;
+    state.blocks[i].offset = state.block_aot_offsets[i];
+  }
+  for (size_t i = 0; i < state.n_tensor; ++i) {
+    const ReplannedTensor& tensor = state.tensors[i];
+    const size_t nbytes = tensor.pinned
+        ? tensor.aot_nbytes
+        : values_[tensor.value_index].toTensor().nbytes();
+    auto& block = state.blocks[tensor.block];
+    block.size = std::max(block.size, tensor.block_offset + nbytes);
+  }
+
+  Error err = ::executorch::runtime::internal::plan_memory(
+      {state.blocks, state.n_block},
+      {state.order, state.n_block},
+      {state.footprints, state.n_buffer},
+      MemoryAllocator::kDefaultAlignment);
+  if (err != Error::Ok) {
+    return err;
+  }
+
+  // Keep the ahead-of-time plan of any buffer the new plan doesn't fit in.
+  // Pinned blocks are within their buffers, so moving blocks can only
+  // overflow if the tensors are larger than their upper bounds.
+  size_t aot_total = 0;
+  size_t total = 0;
+  for (size_t i = 0; i < state.n_buffer; ++i) {
+    const size_t buffer_size = buffer_sizes->Get(i + 1);
+    aot_total += buffer_size;
+    if (state.footprints[i] > buffer_size) {
+      ET_LOG(
+          Info,
+          "Keeping the original plan of buffer %" ET_PRIsize_t
+          ": %" ET_PRIsize_t " > %" ET_PRIsize_t " bytes",
+          i,
+          state.footprints[i],
+          buffer_size);
+      state.footprints[i] = buffer_size;
+      for (size_t j = 0; j < state.n_block; ++j) {
+        if (state.blocks[j].memory_id == i) {
+          state.blocks[j].offset = state.block_aot_offsets[j];
+        }
+      }
+    }
+    total += state.footprints[i];
+  }
+
+  // Lets restore_memory_plan() undo a partial move.
+  state.replanned = true;
+  size_t n_moved = 0;
+  for (size_t i = 0; i < state.n_tensor; ++i) {
+    const ReplannedTensor& tensor = state.tensors[i];
+    if (tensor.pinned) {
+      continue;
+    }
+    const auto& t = values_[tensor.value_index].toTensor();
+    const size_t nbytes = t.nbytes();
+    const size_t offset =
+        state.blocks[tensor.block].offset + tensor.block_offset;
+    auto data = planned_memory->get_offset_address(
+        tensor.memory_id, offset, nbytes);
+    if (!data.ok()) {
+      return data.error();
+    }
+    err = internal::set_tensor_data(t, data.get(), nbytes);
+    if (err != Error::Ok) {
+      return err;
+    }
+    // Tensors may now overlap the memory of others beyond their current size.
+    err = internal::set_tensor_numel_bound(t, t.numel());
+    if (err != Error::Ok) {
+      return err;
+    }
+    if (offset != tensor.aot_offset) {
+      ++n_moved;
+    }
+  }
+  std::copy(
+      state.executed_input_sizes,
+      state.executed_input_sizes + state.n_input_sizes,
+      state.planned_input_sizes);
+  state.pending = false;
+
+  ET_LOG(
+      Info,
+      "Replanned memory of method %s: moved %" ET_PRIsize_t
+      " tensors, %" ET_PRIsize_t " -> %" ET_PRIsize_t " bytes",
+      serialization_plan_->name()->c_str(),
+      n_moved,
+      aot_total,
+      total);
+  return total;
+}
+
+Error Method::restore_memory_plan() {
+  auto& state = *memory_replan_;
+  if (!state.replanned) {
+    return Error::Ok;
+  }
+  auto planned_memory = memory_manager_->planned_memory();
+  for (size_t i = 0; i < state.n_tensor; ++i) {
+    const ReplannedTensor& tensor = state.tensors[i];
+    if (tensor.pinned) {
+      continue;
+    }
+    const auto& t = values_[tensor.value_index].toTensor();
+    auto data = planned_memory->get_offset_address(
+        tensor.memory_id, tensor.aot_offset, tensor.aot_nbytes);
+    if (!data.ok()) {
+      return data.error();
+    }
+    Error err = internal::set_tensor_numel_bound(t, tensor.aot_numel);
+    if (err != Error::Ok) {
+      return err;
+    }
+    err = internal::set_tensor_data(t, data.get(), tensor.aot_nbytes);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  state.replanned = false;
+  return Error::Ok;
+}
+
+Error Method::prepare_memory_plan() {
+  auto& state = *memory_replan_;
+  state.executed = false;
+  read_input_sizes(state.executed_input_sizes);
+  if (state.replanned &&
+      !std::equal(
+          state.executed_input_sizes,
+          state.executed_input_sizes + state.n_input_sizes,
+          state.planned_input_sizes)) {
+    // The intermediate tensors may not fit the plan made for other inputs.
+    // Run on the ahead-of-time plan, and replan for these inputs afterwards.
+    Error err = restore_memory_plan();
+    if (err != Error::Ok) {
+      return err;
+    }
+    state.pending = true;
+  }
+  return Error::Ok;
+}
+
+Error Method::update_memory_plan() {
+  auto& state = *memory_replan_;
+  state.executed = true;
+  if (!state.pending) {
+    return Error::Ok;
+  }
+  auto total = plan_dynamic_memory();
+  if (!total.ok()) {
+    ET_LOG(
+        Error,
+        "Failed to replan memory of method %s: 0x%" PRIx32,
+        serialization_plan_->name()->c_str(),
+        static_cast<uint32_t>(total.error()));
+    // The outputs are still valid; keep running on the ahead-of-time plan.
+    state.pending = false;
+    return restore_memory_plan();
+  }
+  return Error::Ok;
+}
+
+Result<size_t> Method::replan_dynamic_memory() {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot replan memory until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.chain_idx == 0 && step_state_.instr_idx == 0,
+      InvalidState,
+      "Cannot replan memory in the middle of an execution.");
+#ifdef USE_ATEN_LIB
+  ET_LOG(Error, "Memory replanning is not supported in ATen mode.");
+  return Error::NotSupported;
+#else
+  if (memory_replan_ == nullptr) {
+    Error err = init_memory_replan();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  auto& state = *memory_replan_;
+
+  // The intermediate tensors have the shapes of the last execution, so they
+  // can only be planned for now if it ran with the current inputs. Until the
+  // next execution, planned_input_sizes is free to hold the current ones.
+  read_input_sizes(state.planned_input_sizes);
+  if (state.executed &&
+      std::equal(
+          state.executed_input_sizes,
+          state.executed_input_sizes + state.n_input_sizes,
+          state.planned_input_sizes)) {
+    auto total = plan_dynamic_memory();
+    if (!total.ok()) {
+      Error err = restore_memory_plan();
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    return total;
+  }
+
+  // Otherwise, plan at the end of the next execution.
+  Error err = restore_memory_plan();
+  if (err != Error::Ok) {
+    return err;
+  }
+  state.pending = true;
+  const auto buffer_sizes = serialization_plan_->non_const_buffer_sizes();
+  size_t aot_total = 0;
+  for (size_t i = 0; i < state.n_buffer; ++i) {
+    aot_total += buffer_sizes->Get(i + 1);
+  }
+  return aot_total;
+#endif
+}
+
+Error Method::reset_memory_plan() {
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.chain_idx == 0 && step_state_.instr_idx == 0,
+      InvalidState,
+      "Cannot reset the memory plan in the middle of an execution.");
+  if (memory_replan_ == nullptr) {
+    return Error::Ok;
+  }
+  memory_replan_->pending = false;
+  return restore_memory_plan();
+}
+
 // Log all the outputs of this method to the event tracer.
 void Method::log_outputs() {
 #ifdef ET_EVENT_TRACER_ENABLED
@@ -1544,6 +2116,15 @@ Error Method::step() {
   if (step_state_.chain_idx == n_chains_) {
     return Error::EndOfMethod;
   }
+  // Stepping doesn't replan at the end, but must not run with a plan made
+  // for other inputs.
+  if (memory_replan_ != nullptr && step_state_.chain_idx == 0 &&
+      step_state_.instr_idx == 0) {
+    Error err = prepare_memory_plan();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
 
   auto num_instructions =
       chains_[step_state_.chain_idx].s_chain_->instructions()->size();
@@ -1596,6 +2177,12 @@ Error Method::execute() {
   if (temp_allocator_ != nullptr) {
     temp_allocator_->reset();
   }
+  if (memory_replan_ != nullptr) {
+    Error err = prepare_memory_plan();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
 
   // Chains are executed sequentially today, but future async designs may
   // branch and run many in parallel or out of order.
@@ -1631,7 +2218,12 @@ Error Method::execute() {
 
   // TODO(jakeszwe, dbort): Decide on calling execute back to back without
   // going through the reset api first.
-  return reset_execution(); // @lint-ignore CLANGTIDY facebook-hte-Deprecated
+  Error err =
+      reset_execution(); // @lint-ignore CLANGTIDY facebook-hte-Deprecated
+  if (err != Error::Ok || memory_replan_ == nullptr) {
+    return err;
+  }
+  return update_memory_plan();
 }
 
 MethodMeta Method::method_meta() const {
@@ -47,6 +47,7 @@ class Program;
 // Forward declare internal types.
 class BackendDelegate;
 struct Chain;
+struct MemoryReplanState;
 class KernelRuntimeContext;
 using OpFunction = void (*)(KernelRuntimeContext&, Span<EValue*>);
 /// A list of pointers into the master values table that together compose the
@@ -81,6 +82,7 @@ class Method final {
         merged_data_map_(std::move(rhs.merged_data_map_)),
         external_constants_(rhs.external_constants_),
         n_external_constants_(rhs.n_external_constants_),
+        memory_replan_(rhs.memory_replan_),
         init_state_(rhs.init_state_) {
     // Required: clear out fields that the dtor looks at, so that we don't free
     // anything twice.
@@ -93,6 +95,7 @@ class Method final {
     rhs.merged_data_map_ = nullptr;
     rhs.n_external_constants_ = 0;
     rhs.external_constants_ = nullptr;
+    rhs.memory_replan_ = nullptr;
 
     // Helpful: Try to ensure that any other interactions with the old object
     // result in failures.
@@ -250,6 +253,46 @@ class Method final {
   /// DEPRECATED: Use `reset_execution()` instead.
   ET_DEPRECATED ET_NODISCARD Error experimental_reset_execution();
 
+  /**
+   * EXPERIMENTAL: Re-plans the memory of the Method's bounded dynamic-shape
+   * intermediate tensors for the shapes they take with the current inputs.
+   *
+   * The ahead-of-time memory plan reserves room for the upper bound of every
+   * dynamic shape. When the actual shapes are smaller, this packs the
+   * intermediate tensors into a smaller prefix of the planned buffers, using
+   * their lifetimes in the instruction stream so that tensors which are never
+   * live at the same time share memory. Inputs, outputs, static-shape tensors
+   * and mutable buffers keep their planned locations, and so do the arguments
+   * of delegate calls. The untouched tail of each planned buffer is not
+   * written to, so memory that is allocated lazily by the OS stays
+   * non-resident.
+   *
+   * Intermediate shapes are only known once the Method has run. If the most
+   * recent execution used the current inputs, the plan is made immediately.
+   * Otherwise the Method keeps the ahead-of-time plan, and the new plan is
+   * made at the end of the next execution. From then on, an execution whose
+   * input shapes or scalar inputs differ from the ones the plan was made for
+   * runs on the ahead-of-time plan and replans at its end, until
+   * reset_memory_plan() is called.
+   *
+   * Methods with control flow instructions are not supported.
+   *
+   * @returns The number of bytes of the planned buffers used by the current
+   *     plan on success, or an error if the Method can't be replanned, in
+   *     which case it keeps the ahead-of-time plan.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> replan_dynamic_memory();
+
+  /**
+   * EXPERIMENTAL: Restores the ahead-of-time memory plan after a call to
+   * replan_dynamic_memory(), and stops replanning when the inputs change.
+   * Does nothing if the memory was not replanned.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if called in the middle of an execution.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error reset_memory_plan();
+
   /**
    * Returns the MethodMeta that corresponds to the calling Method.
    */
@@ -328,6 +371,7 @@ class Method final {
         merged_data_map_(nullptr),
         external_constants_(nullptr),
         n_external_constants_(0),
+        memory_replan_(nullptr),
         init_state_(InitializationState::Uninitialized) {}
 
   /// Static factory used by Program.
@@ -360,6 +404,20 @@ class Method final {
   // Executes a single instruction using the state in step_state_
   ET_NODISCARD Error execute_instruction();
 
+  // Allocates and fills memory_replan_ on the first call to
+  // replan_dynamic_memory().
+  ET_NODISCARD Error init_memory_replan();
+
+  // Helpers of replan_dynamic_memory(), used once memory_replan_ exists.
+  void read_input_sizes(int64_t* sizes) const;
+  // Plans the intermediate tensors for their current shapes.
+  ET_NODISCARD Result<size_t> plan_dynamic_memory();
+  ET_NODISCARD Error restore_memory_plan();
+  // Called before and after an execution to keep the plan in sync with the
+  // inputs.
+  ET_NODISCARD Error prepare_memory_plan();
+  ET_NODISCARD Error update_memory_plan();
+
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
@@ -381,6 +439,8 @@ class Method final {
   NamedData* external_constants_;
   size_t n_external_constants_ = 0;
 
+  MemoryReplanState* memory_replan_;
+
   InitializationState init_state_;
 
   /**
@@ -29,6 +29,22 @@ def define_common_targets():
     TARGETS and BUCK files that call this function.
     """
 
+    runtime.cxx_library(
+        name = "dynamic_memory_plan",
+        srcs = [
+            "dynamic_memory_plan.cpp",
+        ],
+        exported_headers = [
+            "dynamic_memory_plan.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/runtime/executor/...",
+        ],
+    )
+
     runtime.cxx_library(
         name = "memory_manager",
         exported_headers = [
@@ -129,6 +145,7 @@ def define_common_targets():
                 "//executorch/schema:extended_header",
             ],
             deps = [
+                ":dynamic_memory_plan",
                 "//executorch/schema:program",
                 "//executorch/runtime/core/exec_aten/util:tensor_dimension_limit"
             ],
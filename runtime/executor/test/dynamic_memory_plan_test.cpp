@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/dynamic_memory_plan.h>
+
+#include <vector>
+
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::Span;
+using executorch::runtime::internal::plan_memory;
+using executorch::runtime::internal::PlannedBlock;
+
+class DynamicMemoryPlanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+
+  Error plan(std::vector<PlannedBlock>& blocks, size_t num_memory_ids = 1) {
+    order_.resize(blocks.size());
+    footprints_.assign(num_memory_ids, 0);
+    return plan_memory(
+        {blocks.data(), blocks.size()},
+        {order_.data(), order_.size()},
+        {footprints_.data(), footprints_.size()},
+        /*alignment=*/16);
+  }
+
+  std::vector<size_t> order_;
+  std::vector<size_t> footprints_;
+};
+
+namespace {
+
+PlannedBlock block(size_t size, size_t first_use, size_t last_use) {
+  return {
+      /*memory_id=*/0,
+      size,
+      first_use,
+      last_use,
+      /*pinned=*/false,
+      /*offset=*/0};
+}
+
+PlannedBlock pinned_block(
+    size_t size,
+    size_t first_use,
+    size_t last_use,
+    size_t offset) {
+  return {/*memory_id=*/0, size, first_use, last_use, /*pinned=*/true, offset};
+}
+
+bool overlaps(const PlannedBlock& a, const PlannedBlock& b) {
+  return a.memory_id == b.memory_id && a.first_use <= b.last_use &&
+      b.first_use <= a.last_use && a.offset < b.offset + b.size &&
+      b.offset < a.offset + a.size;
+}
+
+void expect_no_overlaps(const std::vector<PlannedBlock>& blocks) {
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      EXPECT_FALSE(overlaps(blocks[i], blocks[j]))
+          << "blocks " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(DynamicMemoryPlanTest, EmptyPlan) {
+  std::vector<PlannedBlock> blocks;
+  EXPECT_EQ(plan(blocks), Error::Ok);
+  EXPECT_EQ(footprints_[0], 0);
+}
+
+TEST_F(DynamicMemoryPlanTest, DisjointLifetimesShareMemory) {
+  std::vector<PlannedBlock> blocks = {
+      block(100, 0, 1),
+      block(64, 2, 3),
+      block(80, 4, 5),
+  };
+  EXPECT_EQ(plan(blocks), Error::Ok);
+  for (const auto& b : blocks) {
+    EXPECT_EQ(b.offset, 0);
+  }
+  EXPECT_EQ(footprints_[0], 100);
+}
+
+TEST_F(DynamicMemoryPlanTest, OverlappingLifetimesAreSeparated) {
+  std::vector<PlannedBlock> blocks = {
+      block(10, 0, 2),
+      block(100, 1, 3),
+      block(20, 2, 4),
+  };
+  EXPECT_EQ(plan(blocks), Error::Ok);
+  expect_no_overlaps(blocks);
+
+  // Blocks are placed largest first, each after the blocks it conflicts with,
+  // at aligned offsets.
+  EXPECT_EQ(blocks[1].offset, 0);
+  EXPECT_EQ(blocks[2].offset, 112);
+  EXPECT_EQ(blocks[0].offset, 144);
+  EXPECT_EQ(footprints_[0], 154);
+}
+
+TEST_F(DynamicMemoryPlanTest, FillsGapsBetweenPlacedBlocks) {
+  std::vector<PlannedBlock> blocks = {
+      block(64, 0, 1),
+      block(64, 1, 2),
+      block(64, 2, 3),
+      // Only conflicts with the blocks live at instruction 3, so it can reuse
+      // the memory of the first block.
+      block(32, 3, 3),
+  };
+  EXPECT_EQ(plan(blocks), Error::Ok);
+  expect_no_overlaps(blocks);
+  EXPECT_EQ(footprints_[0], 128);
+}
+
+TEST_F(DynamicMemoryPlanTest, PinnedBlocksKeepTheirOffsets) {
+  std::vector<PlannedBlock> blocks = {
+      pinned_block(32, 0, 10, 64),
+      block(48, 0, 1),
+      block(16, 0, 1),
+      block(8, 1, 2),
+  };
+  EXPECT_EQ(plan(blocks), Error::Ok);
+  expect_no_overlaps(blocks);
+  EXPECT_EQ(blocks[0].offset, 64);
+  // Both blocks fit in the gap in front of the pinned block.
+  EXPECT_EQ(blocks[1].offset, 0);
+  EXPECT_EQ(blocks[2].offset, 48);
+  // The last block conflicts with everything in that gap and goes after the
+  // pinned block.
+  EXPECT_EQ(blocks[3].offset, 96);
+  EXPECT_EQ(footprints_[0], 104);
+}
+
+TEST_F(DynamicMemoryPlanTest, MemoryIdsArePlannedIndependently) {
+  std::vector<PlannedBlock> blocks = {
+      block(64, 0, 1),
+      block(32, 0, 1),
+  };
+  blocks[1].memory_id = 1;
+  EXPECT_EQ(plan(blocks, /*num_memory_ids=*/2), Error::Ok);
+  EXPECT_EQ(blocks[0].offset, 0);
+  EXPECT_EQ(blocks[1].offset, 0);
+  EXPECT_EQ(footprints_[0], 64);
+  EXPECT_EQ(footprints_[1], 32);
+}
+
+TEST_F(DynamicMemoryPlanTest, SmallerSizesShrinkTheFootprint) {
+  // Model the same graph planned at its upper bound and at a smaller shape.
+  auto make_blocks = [](size_t scale) {
+    return std::vector<PlannedBlock>{
+        block(4 * scale, 0, 1),
+        block(8 * scale, 1, 2),
+        block(4 * scale, 2, 3),
+        block(2 * scale, 1, 3),
+    };
+  };
+  auto upper_bound = make_blocks(1024);
+  EXPECT_EQ(plan(upper_bound), Error::Ok);
+  expect_no_overlaps(upper_bound);
+  const size_t upper_bound_footprint = footprints_[0];
+
+  auto actual = make_blocks(64);
+  EXPECT_EQ(plan(actual), Error::Ok);
+  expect_no_overlaps(actual);
+  EXPECT_LT(footprints_[0] * 8, upper_bound_footprint);
+}
+
+TEST_F(DynamicMemoryPlanTest, InvalidArguments) {
+  std::vector<PlannedBlock> blocks = {block(16, 0, 0)};
+  std::vector<size_t> order(1);
+  std::vector<size_t> footprints(1);
+
+  // Bad alignment.
+  EXPECT_EQ(
+      plan_memory(
+          {blocks.data(), blocks.size()},
+          {order.data(), order.size()},
+          {footprints.data(), footprints.size()},
+          /*alignment=*/12),
+      Error::InvalidArgument);
+
+  // Not enough scratch space.
+  EXPECT_EQ(
+      plan_memory(
+          {blocks.data(), blocks.size()},
+          {order.data(), size_t(0)},
+          {footprints.data(), footprints.size()},
+          /*alignment=*/16),
+      Error::InvalidArgument);
+
+  // Memory id out of range.
+  blocks[0].memory_id = 1;
+  EXPECT_EQ(
+      plan_memory(
+          {blocks.data(), blocks.size()},
+          {order.data(), order.size()},
+          {footprints.data(), footprints.size()},
+          /*alignment=*/16),
+      Error::InvalidArgument);
+}
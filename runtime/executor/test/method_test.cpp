@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <filesystem>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
@@ -80,6 +81,8 @@ class MethodTest : public ::testing::Test {
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(std::getenv("ET_MODULE_ADD_MUL_PATH"), "add_mul");
+    load_program(
+        std::getenv("ET_MODULE_DYNAMIC_ADD_MUL_PATH"), "dynamic_add_mul");
     load_program(std::getenv("ET_MODULE_STATEFUL_PATH"), "stateful");
     load_program(
         std::getenv("DEPRECATED_ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH"),
@@ -127,6 +130,119 @@ TEST_F(MethodTest, MoveTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, ReplanDynamicMemoryTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["add_mul"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& output = method->get_output(0).toTensor();
+  std::vector<float> expected(
+      output.const_data_ptr<float>(),
+      output.const_data_ptr<float>() + output.numel());
+
+  // Nothing is known about the earlier execution, so the plan is made at the
+  // end of the next one.
+  Result<size_t> planned_size = method->replan_dynamic_memory();
+  ASSERT_EQ(planned_size.error(), Error::Ok);
+  size_t aot_size = 0;
+  auto method_meta = method->method_meta();
+  for (size_t i = 0; i < method_meta.num_memory_planned_buffers(); ++i) {
+    aot_size += method_meta.memory_planned_buffer_size(i).get();
+  }
+  EXPECT_EQ(planned_size.get(), aot_size);
+  ASSERT_EQ(method->execute(), Error::Ok);
+
+  // The plan never grows past the ahead-of-time plan.
+  planned_size = method->replan_dynamic_memory();
+  ASSERT_EQ(planned_size.error(), Error::Ok);
+  EXPECT_LE(planned_size.get(), aot_size);
+
+  // The replanned method computes the same outputs.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& replanned_output = method->get_output(0).toTensor();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(replanned_output.const_data_ptr<float>()[i], expected[i]);
+  }
+
+  // Restore the original plan and run again.
+  ASSERT_EQ(method->reset_memory_plan(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& reset_output = method->get_output(0).toTensor();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(reset_output.const_data_ptr<float>()[i], expected[i]);
+  }
+}
+
+TEST_F(MethodTest, ReplanDynamicMemoryFollowsInputShapesTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["dynamic_add_mul"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Computes (3 * x + 2)^2 for a [n, 4] input, with n <= 8.
+  float buffer[8 * 4];
+  int32_t sizes[2] = {0, 4};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {4, 1};
+  const auto run = [&](int32_t rows) {
+    sizes[0] = rows;
+    for (int32_t i = 0; i < rows * 4; ++i) {
+      buffer[i] = static_cast<float>(i % 5) - 2.0f;
+    }
+    executorch::aten::TensorImpl impl(
+        executorch::aten::ScalarType::Float,
+        2,
+        sizes,
+        buffer,
+        dim_order,
+        strides);
+    ASSERT_EQ(
+        method->set_input(EValue(executorch::aten::Tensor(&impl)), 0),
+        Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    const auto& output = method->get_output(0).toTensor();
+    ASSERT_EQ(output.size(0), rows);
+    for (int32_t i = 0; i < rows * 4; ++i) {
+      const float z = 3.0f * buffer[i] + 2.0f;
+      EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], z * z);
+    }
+  };
+
+  size_t aot_size = 0;
+  auto method_meta = method->method_meta();
+  for (size_t i = 0; i < method_meta.num_memory_planned_buffers(); ++i) {
+    aot_size += method_meta.memory_planned_buffer_size(i).get();
+  }
+
+  // Replanning before the first execution takes effect at its end.
+  Result<size_t> planned_size = method->replan_dynamic_memory();
+  ASSERT_EQ(planned_size.error(), Error::Ok);
+  EXPECT_EQ(planned_size.get(), aot_size);
+  run(2);
+  // Planned for 2 of the up to 8 rows, the footprint shrinks.
+  planned_size = method->replan_dynamic_memory();
+  ASSERT_EQ(planned_size.error(), Error::Ok);
+  EXPECT_LT(planned_size.get(), aot_size);
+
+  // Larger inputs than the plan was made for run on the ahead-of-time plan,
+  // and are replanned for. So are smaller ones.
+  run(2);
+  run(7);
+  run(8);
+  run(1);
+  run(1);
+  run(5);
+
+  // Without replanning, the inputs can change freely.
+  ASSERT_EQ(method->reset_memory_plan(), Error::Ok);
+  run(8);
+  run(3);
+}
+
 TEST_F(MethodTest, GetInputTests) {
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
   Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
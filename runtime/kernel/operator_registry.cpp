@@ -48,6 +48,53 @@ Kernel* registered_kernels = reinterpret_cast<Kernel*>(registered_kernels_data);
 /// The number of kernels registered in the table.
 size_t num_registered_kernels = 0;
 
+// Returns the smallest power of two that is at least `n`.
+constexpr uint32_t next_power_of_two(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+// Number of slots in the operator name index. Keeping it at most half full
+// keeps the probe sequences short.
+constexpr uint32_t kNumIndexSlots =
+    next_power_of_two(2 * kMaxRegisteredKernels);
+
+/// Open-addressed hash index from operator name to the most recently
+/// registered kernel with that name. Each entry holds a kernel index plus one;
+/// zero marks an empty slot, so the zero-initialized table starts empty.
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+uint32_t op_name_index[kNumIndexSlots];
+
+/// For each kernel, the index plus one of the previously registered kernel
+/// with the same name, or zero if it is the first kernel of its operator.
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+uint32_t next_kernel_with_same_name[kMaxRegisteredKernels];
+
+// FNV-1a hash of a NUL-terminated string.
+uint32_t hash_op_name(const char* name) {
+  uint32_t hash = 2166136261u;
+  for (; *name != '\0'; ++name) {
+    hash ^= static_cast<uint8_t>(*name);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Returns the index slot for `name`: either the slot that holds its kernels,
+// or the empty slot where they should be added.
+uint32_t* find_index_slot(const char* name) {
+  uint32_t slot = hash_op_name(name) & (kNumIndexSlots - 1);
+  // The table is never full, so this always terminates.
+  while (op_name_index[slot] != 0 &&
+         strcmp(registered_kernels[op_name_index[slot] - 1].name_, name) != 0) {
+    slot = (slot + 1) & (kNumIndexSlots - 1);
+  }
+  return &op_name_index[slot];
+}
+
 // Registers the kernels, but may return an error.
 Error register_kernels_internal(const Span<const Kernel> kernels) {
   // Operator registration happens in static initialization time before or after
@@ -81,17 +128,18 @@ Error register_kernels_internal(const Span<const Kernel> kernels) {
       et_pal_get_shared_library_name(kernels.data());
 
   for (const auto& kernel : kernels) {
-    // Linear search. This is fine if the number of kernels is small.
-    for (size_t i = 0; i < num_registered_kernels; i++) {
-      Kernel k = registered_kernels[i];
-      if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
+    uint32_t* slot = find_index_slot(kernel.name_);
+    for (uint32_t i = *slot; i != 0; i = next_kernel_with_same_name[i - 1]) {
+      const Kernel& k = registered_kernels[i - 1];
+      if (kernel.kernel_key_ == k.kernel_key_) {
         ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
         ET_LOG_KERNEL_KEY(k.kernel_key_);
         return Error::RegistrationAlreadyRegistered;
       }
     }
+    next_kernel_with_same_name[num_registered_kernels] = *slot;
     registered_kernels[num_registered_kernels++] = kernel;
+    *slot = static_cast<uint32_t>(num_registered_kernels);
   }
   ET_LOG(
       Debug,
@@ -239,19 +287,20 @@ Result<OpFunction> get_op_function_from_registry(
   }
   KernelKey kernel_key = KernelKey(key_string.data());
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < num_registered_kernels; idx++) {
-    if (strcmp(registered_kernels[idx].name_, name) == 0) {
-      if (registered_kernels[idx].kernel_key_ == kernel_key) {
-        return registered_kernels[idx].op_;
-      }
-      if (registered_kernels[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
+  // Only the kernels registered for this operator are compared.
+  const Kernel* fallback = nullptr;
+  for (uint32_t i = *find_index_slot(name); i != 0;
+       i = next_kernel_with_same_name[i - 1]) {
+    const Kernel& kernel = registered_kernels[i - 1];
+    if (kernel.kernel_key_ == kernel_key) {
+      return kernel.op_;
+    }
+    if (kernel.kernel_key_.is_fallback()) {
+      fallback = &kernel;
     }
   }
-  if (fallback_idx != -1) {
-    return registered_kernels[fallback_idx].op_;
+  if (fallback != nullptr) {
+    return fallback->op_;
   }
   ET_LOG(Error, "kernel '%s' not found.", name);
   ET_LOG_TENSOR_META(meta_list);
@@ -7,6 +7,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -515,3 +516,79 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   auto val = values[0].toScalar().to<int64_t>();
   ASSERT_EQ(val, 100);
 }
+
+TEST_F(OperatorRegistryTest, SpecializedAndFallbackKernelsOfOneOp) {
+  std::array<char, kKernelKeyBufSize> buf_long_contiguous;
+  Error err = make_kernel_key(
+      {{ScalarType::Long, {0, 1, 2, 3}}},
+      buf_long_contiguous.data(),
+      buf_long_contiguous.size());
+  ASSERT_EQ(err, Error::Ok);
+
+  Kernel kernels[] = {
+      Kernel(
+          "test::grault",
+          KernelKey(buf_long_contiguous.data()),
+          [](KernelRuntimeContext& context, Span<EValue*> stack) {
+            (void)context;
+            *(stack[0]) = Scalar(100);
+          }),
+      Kernel(
+          "test::grault",
+          KernelKey{},
+          [](KernelRuntimeContext& context, Span<EValue*> stack) {
+            (void)context;
+            *(stack[0]) = Scalar(50);
+          })};
+  err = register_kernels(kernels);
+  ASSERT_EQ(err, Error::Ok);
+
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+
+  EValue values[1];
+  EValue* stack_data[1] = {&values[0]};
+  Span<EValue*> stack(stack_data, 1);
+  KernelRuntimeContext context{};
+
+  // The specialized kernel wins when the key matches, even though the
+  // fallback was registered after it.
+  Result<OpFunction> func_long =
+      get_op_function_from_registry("test::grault", meta_long);
+  ASSERT_EQ(func_long.error(), Error::Ok);
+  (*func_long)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+
+  // Other keys use the fallback.
+  Result<OpFunction> func_float =
+      get_op_function_from_registry("test::grault", meta_float);
+  ASSERT_EQ(func_float.error(), Error::Ok);
+  (*func_float)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 50);
+}
+
+TEST_F(OperatorRegistryTest, LookupAmongManyOperators) {
+  // Register enough operators that a name lookup has to tell apart many
+  // entries, including names that share long prefixes. The names must outlive
+  // the registry.
+  constexpr int kNumOps = 300;
+  static std::vector<std::string> names;
+  for (int i = 0; i < kNumOps; i++) {
+    names.push_back("test::many_ops." + std::to_string(i));
+  }
+  std::vector<Kernel> kernels;
+  for (const auto& name : names) {
+    kernels.emplace_back(
+        name.c_str(), [](KernelRuntimeContext&, Span<EValue*>) {});
+  }
+  Error err = register_kernels({kernels.data(), kernels.size()});
+  ASSERT_EQ(err, Error::Ok);
+
+  for (const auto& name : names) {
+    EXPECT_TRUE(registry_has_op_function(name.c_str())) << name;
+  }
+  EXPECT_FALSE(registry_has_op_function("test::many_ops."));
+  EXPECT_FALSE(registry_has_op_function("test::many_ops.300"));
+}
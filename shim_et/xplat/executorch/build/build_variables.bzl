@@ -55,6 +55,7 @@ EXECUTORCH_CORE_SRCS = sorted([
     "runtime/core/portable_type/tensor_impl.cpp",
     "runtime/core/tag.cpp",
     "runtime/core/tensor_layout.cpp",
+    "runtime/executor/dynamic_memory_plan.cpp",
     "runtime/executor/tensor_parser_portable.cpp",
     "runtime/executor/pte_data_map.cpp",
     "runtime/kernel/operator_registry.cpp",
@@ -250,6 +251,7 @@ KERNELS_UTIL_ALL_DEPS_SRCS = [
     "kernels/portable/cpu/util/matmul_ops_util.cpp",
     "kernels/portable/cpu/util/normalization_ops_util.cpp",
     "kernels/portable/cpu/util/padding_util.cpp",
+    "kernels/portable/cpu/util/permute_util.cpp",
     "kernels/portable/cpu/util/reduce_util.cpp",
     "kernels/portable/cpu/util/repeat_util.cpp",
     "kernels/portable/cpu/util/select_copy_util.cpp",
@@ -260,20 +262,28 @@ KERNELS_UTIL_ALL_DEPS_SRCS = [
 OPTIMIZED_KERNELS_SRCS = [
     "kernels/optimized/cpu/binary_ops.cpp",
     "kernels/optimized/cpu/op_add.cpp",
+    "kernels/optimized/cpu/op_avg_pool2d.cpp",
     "kernels/optimized/cpu/op_bmm.cpp",
     "kernels/optimized/cpu/op_div.cpp",
     "kernels/optimized/cpu/op_elu.cpp",
+    "kernels/optimized/cpu/op_embedding.cpp",
     "kernels/optimized/cpu/op_exp.cpp",
     "kernels/optimized/cpu/op_fft_c2r.cpp",
     "kernels/optimized/cpu/op_fft_r2c.cpp",
+    "kernels/optimized/cpu/op_gather.cpp",
     "kernels/optimized/cpu/op_gelu.cpp",
     "kernels/optimized/cpu/op_le.cpp",
     "kernels/optimized/cpu/op_linear.cpp",
     "kernels/optimized/cpu/op_log_softmax.cpp",
+    "kernels/optimized/cpu/op_max_pool2d_with_indices.cpp",
     "kernels/optimized/cpu/op_mm.cpp",
     "kernels/optimized/cpu/op_mul.cpp",
+    "kernels/optimized/cpu/op_native_batch_norm.cpp",
+    "kernels/optimized/cpu/op_native_group_norm.cpp",
     "kernels/optimized/cpu/op_native_layer_norm.cpp",
     "kernels/optimized/cpu/op_sub.cpp",
+    "kernels/optimized/cpu/op_upsample_bilinear2d.cpp",
+    "kernels/optimized/cpu/op_upsample_nearest2d.cpp",
     "kernels/optimized/cpu/op_where.cpp",
 ]
 
@@ -302,20 +312,28 @@ OPTIMIZED_NATIVE_CPU_OPS_SRCS = [
     "codegen/templates/RegisterSchema.cpp",
     "kernels/optimized/cpu/binary_ops.cpp",
     "kernels/optimized/cpu/op_add.cpp",
+    "kernels/optimized/cpu/op_avg_pool2d.cpp",
     "kernels/optimized/cpu/op_bmm.cpp",
     "kernels/optimized/cpu/op_div.cpp",
     "kernels/optimized/cpu/op_elu.cpp",
+    "kernels/optimized/cpu/op_embedding.cpp",
     "kernels/optimized/cpu/op_exp.cpp",
     "kernels/optimized/cpu/op_fft_c2r.cpp",
     "kernels/optimized/cpu/op_fft_r2c.cpp",
+    "kernels/optimized/cpu/op_gather.cpp",
     "kernels/optimized/cpu/op_gelu.cpp",
     "kernels/optimized/cpu/op_le.cpp",
     "kernels/optimized/cpu/op_linear.cpp",
     "kernels/optimized/cpu/op_log_softmax.cpp",
+    "kernels/optimized/cpu/op_max_pool2d_with_indices.cpp",
     "kernels/optimized/cpu/op_mm.cpp",
     "kernels/optimized/cpu/op_mul.cpp",
+    "kernels/optimized/cpu/op_native_batch_norm.cpp",
+    "kernels/optimized/cpu/op_native_group_norm.cpp",
     "kernels/optimized/cpu/op_native_layer_norm.cpp",
     "kernels/optimized/cpu/op_sub.cpp",
+    "kernels/optimized/cpu/op_upsample_bilinear2d.cpp",
+    "kernels/optimized/cpu/op_upsample_nearest2d.cpp",
     "kernels/optimized/cpu/op_where.cpp",
 ]
 
@@ -347,18 +365,24 @@ EXTENSION_RUNNER_UTIL_SRCS = [
 ]
 
 EXTENSION_LLM_RUNNER_SRCS = [
+    "extension/llm/runner/encoder_cache.cpp",
+    "extension/llm/runner/kv_cache_snapshot.cpp",
     "extension/llm/runner/llm_runner_helper.cpp",
     "extension/llm/runner/multimodal_prefiller.cpp",
     "extension/llm/runner/multimodal_runner.cpp",
+    "extension/llm/runner/prompt_lookup.cpp",
     "extension/llm/runner/text_decoder_runner.cpp",
     "extension/llm/runner/text_llm_runner.cpp",
     "extension/llm/runner/text_prefiller.cpp",
+    "extension/llm/runner/token_constraint.cpp",
+    "extension/llm/runner/token_streamer.cpp",
     "extension/llm/sampler/sampler.cpp",
 ]
 
 EXTENSION_TENSOR_SRCS = [
     "extension/tensor/tensor_ptr.cpp",
     "extension/tensor/tensor_ptr_maker.cpp",
+    "extension/tensor/tensor_storage_pool.cpp",
 ]
 
 THREADPOOL_SRCS = [
@@ -482,6 +506,8 @@ VULKAN_SCHEMA_SRCS = [
 EXTENSION_LLM_CUSTOM_OPS_BUCK_SRCS = [
     "op_fallback.cpp",
     "op_fast_hadamard_transform.cpp",
+    "op_fused_elementwise.cpp",
+    "op_rms_norm.cpp",
     "op_sdpa.cpp",
     "op_update_cache.cpp",
 ]
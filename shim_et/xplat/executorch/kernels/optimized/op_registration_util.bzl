@@ -159,6 +159,15 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":pool2d_utils",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
@@ -197,6 +206,13 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_embedding",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:gather_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_exp",
         deps = [
@@ -219,6 +235,13 @@ OPTIMIZED_ATEN_OPS = (
         ],
         deps = [":fft_utils"],
     ),
+    op_target(
+        name = "op_gather",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_gelu",
         deps = [
@@ -252,6 +275,14 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_max_pool2d_with_indices",
+        deps = [
+            ":pool2d_utils",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_mm",
         deps = [
@@ -271,6 +302,24 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_native_batch_norm",
+        deps = [
+            ":moments_utils",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
+    op_target(
+        name = "op_native_group_norm",
+        deps = [
+            ":moments_utils",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_native_layer_norm",
         deps = [
@@ -291,6 +340,21 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
     op_target(
         name = "op_where",
         deps = [
@@ -651,6 +651,7 @@ ATEN_OPS = (
         deps = [
             "//executorch/kernels/portable/cpu/util:advanced_index_util",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/kernels/portable/cpu/util:gather_util",
         ],
     ),
     op_target(
@@ -663,6 +664,7 @@ ATEN_OPS = (
     op_target(
         name = "op_index_select",
         deps = [
+            "//executorch/kernels/portable/cpu/util:gather_util",
             "//executorch/kernels/portable/cpu/util:index_util",
         ],
     ),
@@ -950,6 +952,7 @@ ATEN_OPS = (
         name = "op_permute_copy",
         deps = [
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
+            "//executorch/kernels/portable/cpu/util:permute_util",
         ],
     ),
     op_target(
@@ -131,6 +131,21 @@ class ModuleDynamicCatUnallocatedIO(nn.Module):
         return {"capture_config": CaptureConfig(pt2_mode=True, enable_aot=True)}
 
 
+class ModuleDynamicAddMul(nn.Module):
+    """Bounded dynamic shapes, with memory-planned intermediate tensors."""
+
+    def forward(self, x: torch.Tensor):
+        y = torch.mul(x, 3.0)
+        z = torch.add(y, 2.0)
+        return torch.mul(z, z)
+
+    def get_random_inputs(self):
+        return (torch.randn(8, 4),)
+
+    def get_dynamic_shapes(self):
+        return ({0: Dim("dim0_x", max=8)},)
+
+
 class ModuleAddMul(torch.nn.Module):
     def __init__(self):
         super().__init__()